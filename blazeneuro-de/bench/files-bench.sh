@@ -0,0 +1,112 @@
+#!/bin/bash
+# BlazeNeuro Files listing benchmark
+# Opens synthetic folders of 1k to 1M entries (bench/gen-tree.py) in a
+# headless blazeneuro-files and prints one JSON object per size on
+# stdout, so results can be kept and compared between builds:
+#
+#   first_paint_ms      startup to the first frame showing any entry
+#   populated_ms        startup to the first frame after the last entry
+#   peak_rss_kib        peak resident set size
+#   syscalls            system calls of a whole run (strace -c -f)
+#   syscalls_per_entry  the same less an empty folder's run, per entry
+#
+# Figures are medians of BENCH_RUNS runs (default 3) after one warm-up,
+# so the page cache is warm. Runs on a private Xvfb when it is installed,
+# else on $DISPLAY; syscall figures need strace and are null without it.
+# Trees are generated once into BENCH_DIR and reused.
+#
+#   make bench-files                            # 1k 10k 100k 1M
+#   make bench-files BENCH_SIZES="1000 10000"
+#   bench/files-bench.sh 100000 > before.jsonl
+
+cd "$(dirname "$0")/.." || exit 1
+
+bin=${BLAZENEURO_FILES_BIN:-./blazeneuro-files}
+runs=${BENCH_RUNS:-3}
+trees=${BENCH_DIR:-/tmp/blazeneuro-files-bench}
+sizes=${*:-1000 10000 100000 1000000}
+
+if [ ! -x "$bin" ]; then
+    echo "files-bench: $bin not built (make blazeneuro-files)" >&2
+    exit 1
+fi
+
+# App caches and the trash go to a scratch directory, not the user's
+work=$(mktemp -d)
+export XDG_CACHE_HOME="$work/cache" XDG_DATA_HOME="$work/data"
+export NO_AT_BRIDGE=1 GDK_BACKEND=x11
+xvfb_pid=
+trap '[ -n "$xvfb_pid" ] && kill "$xvfb_pid" 2>/dev/null; rm -rf "$work"' EXIT
+
+if command -v Xvfb >/dev/null; then
+    display=90
+    while [ -e "/tmp/.X11-unix/X$display" ]; do display=$((display + 1)); done
+    Xvfb ":$display" -screen 0 1280x800x24 -nolisten tcp >/dev/null 2>&1 &
+    xvfb_pid=$!
+    for _ in $(seq 50); do
+        [ -e "/tmp/.X11-unix/X$display" ] && break
+        sleep 0.1
+    done
+    export DISPLAY=":$display"
+elif [ -z "$DISPLAY" ]; then
+    echo "files-bench: needs Xvfb or a running X display" >&2
+    exit 1
+fi
+
+# One timed run of the app on folder $1; prints its key=value report
+run_once() {
+    BLAZENEURO_FILES_BENCH=1 timeout 600 "$bin" "$1" 2>/dev/null
+}
+
+# Total calls of one run under strace, empty when strace is missing
+count_syscalls() {
+    command -v strace >/dev/null || return
+    BLAZENEURO_FILES_BENCH=1 timeout 1800 strace -f -c -qq -o "$work/strace" \
+        "$bin" "$1" >/dev/null 2>&1
+    awk '$NF == "total" { print $4 }' "$work/strace"
+}
+
+median() {
+    sort -n | awk '{ v[NR] = $1 } END { print NR ? v[int((NR + 1) / 2)] : "null" }'
+}
+
+# Median of key $1 over the reports collected in $work/runs
+field() {
+    awk -F= -v k="$1" '$1 == k { print $2 }' "$work/runs" | median
+}
+
+mkdir -p "$trees/empty"
+baseline=$(count_syscalls "$trees/empty")
+
+for size in $sizes; do
+    dir="$trees/$size"
+    echo "files-bench: $size entries" >&2
+    ./bench/gen-tree.py "$dir" "$size" || exit 1
+
+    run_once "$dir" >/dev/null
+    : >"$work/runs"
+    for _ in $(seq "$runs"); do
+        run_once "$dir" >>"$work/runs"
+    done
+
+    first_paint=$(field bench_first_paint_us)
+    populated=$(field bench_populated_us)
+    rss=$(field bench_peak_rss_kib)
+    if [ "$populated" = null ]; then
+        echo "files-bench: no report from $bin for $dir" >&2
+        exit 1
+    fi
+
+    calls=$(count_syscalls "$dir")
+    per_entry=null
+    if [ -n "$calls" ] && [ -n "$baseline" ]; then
+        per_entry=$(awk -v c="$calls" -v b="$baseline" -v n="$size" \
+                        'BEGIN { printf "%.2f", (c - b) / n }')
+    fi
+
+    printf '{"entries":%s,"runs":%s,"first_paint_ms":%.1f,"populated_ms":%.1f,' \
+           "$size" "$runs" "$(echo "$first_paint" | awk '{ print $1 / 1000 }')" \
+           "$(echo "$populated" | awk '{ print $1 / 1000 }')"
+    printf '"peak_rss_kib":%s,"syscalls":%s,"syscalls_per_entry":%s}\n' \
+           "$rss" "${calls:-null}" "$per_entry"
+done
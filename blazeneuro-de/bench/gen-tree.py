@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""Generate a synthetic folder for bench/files-bench.sh.
+
+    bench/gen-tree.py DIR ENTRIES
+
+DIR gets ENTRIES direct children, what the file manager lists: mostly
+files with a spread of extensions (so every icon and type path is
+taken), some empty and some with a few KiB of data, plus folders,
+symlinks (a few dangling) and hidden files. Every 50th folder holds a
+chain nested 24 deep, for the walker behind search.
+
+The same ENTRIES always produces the same names and sizes. A finished
+tree is marked with .complete and left alone on the next run; an
+unfinished one is removed and made again.
+"""
+
+import os
+import random
+import shutil
+import sys
+
+EXTENSIONS = ("txt md c h py js json png jpg svg pdf mp3 flac mkv mp4 zip tar.gz "
+              "deb iso odt xlsx ttf sh log conf html").split() + ["", ""]
+NEST_DEPTH = 24
+
+
+def make_file(path, size):
+    fd = os.open(path, os.O_WRONLY | os.O_CREAT | os.O_TRUNC, 0o644)
+    if size:
+        os.write(fd, os.urandom(size))
+    os.close(fd)
+
+
+def make_chain(top, rng):
+    path = top
+    for depth in range(NEST_DEPTH):
+        path = os.path.join(path, "level%02d" % depth)
+        os.mkdir(path)
+        for i in range(4):
+            make_file(os.path.join(path, "item%d.%s" % (i, rng.choice(EXTENSIONS[:-2]))),
+                      rng.choice((0, 512)))
+
+
+def generate(root, entries):
+    rng = random.Random(entries)
+    os.makedirs(root, exist_ok=True)
+    folders = 0
+    for i in range(entries):
+        roll = rng.random()
+        if roll < 0.08:
+            path = os.path.join(root, "folder %07d" % i)
+            os.mkdir(path)
+            if folders % 50 == 0:
+                make_chain(path, rng)
+            folders += 1
+        elif roll < 0.10:
+            target = "file%07d.txt" % rng.randrange(entries) if roll < 0.095 else "missing"
+            os.symlink(target, os.path.join(root, "link%07d" % i))
+        elif roll < 0.12:
+            make_file(os.path.join(root, ".hidden%07d" % i), 0)
+        else:
+            ext = rng.choice(EXTENSIONS)
+            name = "file%07d%s" % (i, "." + ext if ext else "")
+            make_file(os.path.join(root, name), rng.choice((0, 0, 64, 4096)))
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: gen-tree.py DIR ENTRIES")
+    root, entries = sys.argv[1], int(sys.argv[2])
+    stamp = os.path.join(root, ".complete")
+    if os.path.exists(stamp):
+        return
+    shutil.rmtree(root, ignore_errors=True)
+    generate(root, entries)
+    make_file(stamp, 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,131 @@
+#!/bin/bash
+# BlazeNeuro session memory, multi-call vs. separate executables
+# Starts the always-running components (desktop, topbar, dock) the way
+# the session does, once per layout, on a private Xvfb, lets them settle
+# and prints one JSON object per layout on stdout:
+#
+#   layout        "multicall": the zygote forking applets of ./blazeneuro
+#                 "standalone": ./blazeneuro-desktop etc., started directly
+#   processes     processes counted
+#   pss_kib       their summed PSS (shared pages split between mappers)
+#   rss_kib       their summed RSS, for reference
+#
+# Only the processes each run started are counted (the process tree below
+# it; the zygote's children start sessions of their own), and the zygote
+# listens in a private XDG_RUNTIME_DIR, so a live BlazeNeuro session on
+# the same machine does not skew the figures.
+# Figures are medians of BENCH_RUNS runs (default 3); BENCH_SETTLE sets
+# the seconds to wait before reading (default 5).
+#
+#   make bench-session
+#   bench/session-ab.sh > session.jsonl
+
+cd "$(dirname "$0")/.." || exit 1
+
+runs=${BENCH_RUNS:-3}
+settle=${BENCH_SETTLE:-5}
+applets="desktop topbar dock"
+
+for bin in blazeneuro $(printf "blazeneuro-%s " $applets); do
+    if [ ! -x "./$bin" ]; then
+        echo "session-ab: ./$bin not built (make blazeneuro standalone)" >&2
+        exit 1
+    fi
+done
+if ! command -v Xvfb >/dev/null; then
+    echo "session-ab: needs Xvfb" >&2
+    exit 1
+fi
+
+# Settings, caches and logs go to a scratch home, not the user's, and the
+# zygote socket to a scratch runtime dir so a running session's zygote
+# does not answer in place of the one under test
+work=$(mktemp -d)
+export HOME="$work/home" XDG_CACHE_HOME="$work/cache" XDG_CONFIG_HOME="$work/config"
+export XDG_DATA_HOME="$work/data" XDG_RUNTIME_DIR="$work/run"
+export NO_AT_BRIDGE=1 GDK_BACKEND=x11
+mkdir -p "$HOME"
+mkdir -m 700 "$XDG_RUNTIME_DIR"
+xvfb_pid=
+trap '[ -n "$xvfb_pid" ] && kill "$xvfb_pid" 2>/dev/null; rm -rf "$work"' EXIT
+
+display=90
+while [ -e "/tmp/.X11-unix/X$display" ]; do display=$((display + 1)); done
+Xvfb ":$display" -screen 0 1280x800x24 -nolisten tcp >/dev/null 2>&1 &
+xvfb_pid=$!
+for _ in $(seq 50); do
+    [ -e "/tmp/.X11-unix/X$display" ] && break
+    sleep 0.1
+done
+export DISPLAY=":$display"
+
+# The names the session runs, pointing at this build's layout $1
+make_bin_dir() {
+    local dir="$work/bin-$1"
+    mkdir -p "$dir"
+    for applet in $applets zygote; do
+        if [ "$1" = multicall ]; then
+            ln -sf "$PWD/blazeneuro" "$dir/blazeneuro-$applet"
+        elif [ "$applet" != zygote ]; then
+            ln -sf "$PWD/blazeneuro-$applet" "$dir/blazeneuro-$applet"
+        fi
+    done
+    echo "$dir"
+}
+
+# $1 and every process below it
+tree() {
+    ps -e -o pid=,ppid= | awk -v root="$1" '
+        { parent[$1] = $2 }
+        END {
+            keep[root] = 1; print root
+            do {
+                more = 0
+                for (p in parent)
+                    if (!(p in keep) && (parent[p] in keep)) { keep[p] = 1; print p; more = 1 }
+            } while (more)
+        }'
+}
+
+# Prints "processes pss_kib rss_kib" for the tree below $1
+measure() {
+    local n=0 pss=0 rss=0 p r
+    for pid in $(tree "$1"); do
+        read -r p r < <(awk '/^Pss:/ { p += $2 } /^Rss:/ { r += $2 }
+                             END { print p + 0, r + 0 }' \
+                         "/proc/$pid/smaps_rollup" 2>/dev/null || echo "0 0")
+        [ "$p" -gt 0 ] 2>/dev/null || continue
+        n=$((n + 1)) pss=$((pss + p)) rss=$((rss + r))
+    done
+    echo "$n $pss $rss"
+}
+
+# One session of layout $1; prints its measure line
+run_once() {
+    local dir cmd
+    dir=$(make_bin_dir "$1")
+    if [ "$1" = multicall ]; then
+        cmd="blazeneuro-zygote $(printf "blazeneuro-%s " $applets)"
+    else
+        cmd=$(printf "blazeneuro-%s & " $applets)"wait"
+    fi
+    PATH="$dir:$PATH" bash -c "$cmd" >/dev/null 2>&1 &
+    local root=$!
+    sleep "$settle"
+    measure "$root"
+    kill $(tree "$root") 2>/dev/null
+    wait "$root" 2>/dev/null
+}
+
+median() {
+    sort -n | awk '{ v[NR] = $1 } END { print NR ? v[int((NR + 1) / 2)] : "null" }'
+}
+
+for layout in multicall standalone; do
+    : > "$work/runs"
+    for _ in $(seq "$runs"); do run_once "$layout" >> "$work/runs"; done
+    printf '{"layout":"%s","processes":%s,"pss_kib":%s,"rss_kib":%s}\n' "$layout" \
+        "$(awk '{ print $1 }' "$work/runs" | median)" \
+        "$(awk '{ print $2 }' "$work/runs" | median)" \
+        "$(awk '{ print $3 }' "$work/runs" | median)"
+done
@@ -0,0 +1,40 @@
+#!/bin/bash
+# BlazeNeuro session memory report
+# Sums proportional set size (PSS) over every running BlazeNeuro process,
+# so shared pages are split fairly between the processes mapping them.
+#
+# Compare an installed multi-call build (`make install`) against separate
+# executables (`make standalone`, installed over the symlinks) by running
+# this in an otherwise idle session after each login:
+#
+#   bench/session-pss.sh            # per-process table + total
+#   bench/session-pss.sh --total    # total PSS in KiB only
+
+total_only=0
+[ "$1" = "--total" ] && total_only=1
+
+total=0
+[ $total_only -eq 0 ] && printf "%8s %10s %10s  %s\n" PID "PSS KiB" "RSS KiB" COMMAND
+
+for dir in /proc/[0-9]*; do
+    cmd=$(tr '\0' ' ' <"$dir/cmdline" 2>/dev/null)
+    case "${cmd%% *}" in
+        *blazeneuro*) ;;
+        *) continue ;;
+    esac
+
+    # smaps_rollup (Linux 4.14+) is one read instead of one per mapping
+    read -r pss rss < <(awk '/^Pss:/ { p += $2 } /^Rss:/ { r += $2 }
+                               END { print p + 0, r + 0 }' \
+                           "$dir/smaps_rollup" 2>/dev/null || echo "0 0")
+    [ "$pss" -gt 0 ] 2>/dev/null || continue
+
+    total=$((total + pss))
+    [ $total_only -eq 0 ] && printf "%8s %10s %10s  %s\n" "${dir#/proc/}" "$pss" "$rss" "$cmd"
+done
+
+if [ $total_only -eq 1 ]; then
+    echo "$total"
+else
+    printf "%8s %10s\n" TOTAL "$total"
+fi
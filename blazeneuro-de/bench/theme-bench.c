@@ -0,0 +1,89 @@
+/*
+ * BlazeNeuro Theme Startup Benchmark
+ * Times what every app launch pays to get its stylesheet:
+ *
+ *   legacy    four g_file_test() probes + parsing blazeneuro.css from disk,
+ *             twice (once by the app, once by GTK via ~/.config/gtk-3.0/gtk.css)
+ *   resource  one parse of the copy compiled into the binary as a GResource
+ *
+ * Needs no display. Prints one "key=value" line per result.
+ *
+ * Usage: theme-bench [theme/blazeneuro.css] [iterations]
+ */
+
+#include <gtk/gtk.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/common/theme.h"
+
+static gint64 load_legacy(const char *css_path) {
+    const char *paths[] = {
+        "/usr/local/share/blazeneuro/blazeneuro.css",
+        "theme/blazeneuro.css",
+        "../theme/blazeneuro.css",
+        "../../theme/blazeneuro.css",
+        NULL
+    };
+    gint64 start = g_get_monotonic_time();
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; paths[i]; i++)
+            g_file_test(paths[i], G_FILE_TEST_EXISTS);
+        GtkCssProvider *css = gtk_css_provider_new();
+        gtk_css_provider_load_from_path(css, css_path, NULL);
+        g_object_unref(css);
+    }
+    return g_get_monotonic_time() - start;
+}
+
+static gint64 load_resource(void) {
+    gint64 start = g_get_monotonic_time();
+    GtkCssProvider *css = gtk_css_provider_new();
+    gtk_css_provider_load_from_resource(css, BLAZENEURO_THEME_RESOURCE);
+    g_object_unref(css);
+    return g_get_monotonic_time() - start;
+}
+
+static int cmp_gint64(const void *a, const void *b) {
+    gint64 x = *(const gint64 *)a, y = *(const gint64 *)b;
+    return (x > y) - (x < y);
+}
+
+static gint64 median(gint64 *samples, int n) {
+    qsort(samples, n, sizeof(*samples), cmp_gint64);
+    return samples[n / 2];
+}
+
+int main(int argc, char *argv[]) {
+    gtk_parse_args(&argc, &argv);
+    const char *css_path = argc > 1 ? argv[1] : "theme/blazeneuro.css";
+    int iterations = argc > 2 ? atoi(argv[2]) : 50;
+    if (iterations < 1) iterations = 1;
+
+    if (!g_file_test(css_path, G_FILE_TEST_EXISTS)) {
+        fprintf(stderr, "theme-bench: %s not found\n", css_path);
+        return 1;
+    }
+
+    /* Warm-up: type registration and page cache are not what we measure */
+    load_legacy(css_path);
+    load_resource();
+
+    gint64 *legacy = g_new(gint64, iterations);
+    gint64 *resource = g_new(gint64, iterations);
+    for (int i = 0; i < iterations; i++) {
+        legacy[i] = load_legacy(css_path);
+        resource[i] = load_resource();
+    }
+
+    gint64 legacy_us = median(legacy, iterations);
+    gint64 resource_us = median(resource, iterations);
+    printf("iterations=%d\n", iterations);
+    printf("theme_legacy_median_us=%" G_GINT64_FORMAT "\n", legacy_us);
+    printf("theme_resource_median_us=%" G_GINT64_FORMAT "\n", resource_us);
+    printf("theme_saved_per_launch_us=%" G_GINT64_FORMAT "\n", legacy_us - resource_us);
+
+    g_free(legacy);
+    g_free(resource);
+    return 0;
+}
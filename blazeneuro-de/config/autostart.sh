@@ -41,12 +41,13 @@ export XDG_CURRENT_DESKTOP="BlazeNeuro"
 export XDG_SESSION_DESKTOP="blazeneuro"
 export XDG_SESSION_TYPE="x11"
 
-# ── Apply GTK Theme ─────────────────────────────────────
-mkdir -p "$HOME/.config/gtk-3.0"
-if [ -f "$SHARE_DIR/blazeneuro.css" ]; then
-    cp "$SHARE_DIR/blazeneuro.css" "$HOME/.config/gtk-3.0/gtk.css"
+# ── GTK Theme ───────────────────────────────────────────
+# BlazeNeuro apps carry their stylesheet compiled in. Drop the copy older
+# sessions put in gtk.css, which made GTK parse the theme a second time.
+if head -n 3 "$HOME/.config/gtk-3.0/gtk.css" 2>/dev/null | grep -q "BlazeNeuro GTK3 Theme"; then
+    rm -f "$HOME/.config/gtk-3.0/gtk.css"
+    log "Removed stale theme copy from gtk.css"
 fi
-log "GTK theme applied"
 
 # ── Disable screen saver / DPMS to prevent color issues ─
 xset s off 2>/dev/null
@@ -98,18 +99,29 @@ start_compositor() {
 
 start_compositor || true
 
-# ── Start desktop components (parallelized) ────────────
+# ── Start desktop components ───────────────────────────
 log "Starting desktop components..."
 
 # Minimal delay for X server
 sleep 0.3
 
-blazeneuro-desktop 2>>"$SESSION_LOG" &
-blazeneuro-topbar 2>>"$SESSION_LOG" &
-blazeneuro-dock 2>>"$SESSION_LOG" &
+# The zygote forks desktop, topbar and dock from one pre-initialized
+# image (and later every app the dock, launcher and WM start), so they
+# share its pages copy-on-write. Without it, start them directly.
+if command -v blazeneuro-zygote >/dev/null 2>&1; then
+    blazeneuro-zygote blazeneuro-desktop blazeneuro-topbar blazeneuro-dock 2>>"$SESSION_LOG" &
+    log "Zygote started"
+else
+    blazeneuro-desktop 2>>"$SESSION_LOG" &
+    blazeneuro-topbar 2>>"$SESSION_LOG" &
+    blazeneuro-dock 2>>"$SESSION_LOG" &
+fi
 
 log "Desktop, topbar, dock started"
 
+# ── Path index for "find anywhere" in Files and the Launcher ──
+blazeneuro-indexer 2>>"$SESSION_LOG" &
+
 # ── Network Manager applet ─────────────────────────────
 nm-applet 2>/dev/null &
 
@@ -10,9 +10,11 @@
 #include <string.h>
 #include <math.h>
 
+#include "../common/applet.h"
 #include "../common/theme.h"
 #include "../common/titlebar.h"
 
+static GtkWidget *main_window;
 static GtkWidget *display_label;
 static GtkWidget *expr_label;
 static char expression[512] = "";
@@ -135,18 +137,17 @@ static GtkWidget *make_btn(const char *label, const char *css_class,
     return btn;
 }
 
-/* ── Main ───────────────────────────────────────────────── */
-int main(int argc, char *argv[]) {
-    gtk_init(&argc, &argv);
-    blazeneuro_load_theme();
-
+/* ── Window ─────────────────────────────────────────────── */
+static void build_window(GtkApplication *app) {
     GtkWidget *win = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    main_window = win;
+    gtk_window_set_application(GTK_WINDOW(win), app);
     gtk_window_set_title(GTK_WINDOW(win), "Calculator");
     gtk_window_set_default_size(GTK_WINDOW(win), 320, 480);
     gtk_window_set_resizable(GTK_WINDOW(win), FALSE);
     blazeneuro_style_window(win, "app-calculator");
 
-    g_signal_connect(win, "destroy", G_CALLBACK(gtk_main_quit), NULL);
+    g_signal_connect(win, "destroy", G_CALLBACK(gtk_widget_destroyed), &main_window);
 
     /* Main content */
     GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
@@ -220,7 +221,28 @@ int main(int argc, char *argv[]) {
     blazeneuro_add_titlebar(win, "Calculator", vbox);
 
     gtk_widget_show_all(win);
-    gtk_main();
+}
+
+/* ── Single Instance ────────────────────────────────────── */
+static void on_startup(GApplication *app, gpointer data) {
+    (void)app; (void)data;
+    blazeneuro_load_theme();
+}
 
-    return 0;
+static void on_activate(GApplication *app, gpointer data) {
+    (void)data;
+    if (!main_window) build_window(GTK_APPLICATION(app));
+    gtk_window_present(GTK_WINDOW(main_window));
+}
+
+/* ── Main ───────────────────────────────────────────────── */
+int BLAZENEURO_MAIN(calculator)(int argc, char *argv[]) {
+    GtkApplication *app = gtk_application_new("org.blazeneuro.Calculator",
+                                              G_APPLICATION_FLAGS_NONE);
+    g_signal_connect(app, "startup", G_CALLBACK(on_startup), NULL);
+    g_signal_connect(app, "activate", G_CALLBACK(on_activate), NULL);
+
+    int status = g_application_run(G_APPLICATION(app), argc, argv);
+    g_object_unref(app);
+    return status;
 }
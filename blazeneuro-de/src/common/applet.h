@@ -0,0 +1,45 @@
+/*
+ * BlazeNeuro Applet Entry Points
+ * Lets a shell component be built either as its own executable or as an
+ * applet of the multi-call "blazeneuro" binary, which the zygote also
+ * forks from.
+ *
+ * Usage:
+ *   int BLAZENEURO_MAIN(files)(int argc, char *argv[]) { ... }
+ *
+ * Standalone builds get a plain main(); builds with -DBLAZENEURO_APPLET
+ * get blazeneuro_files_main() instead.
+ */
+
+#ifndef BLAZENEURO_APPLET_H
+#define BLAZENEURO_APPLET_H
+
+#ifdef BLAZENEURO_APPLET
+#define BLAZENEURO_MAIN(name) blazeneuro_##name##_main
+
+typedef struct {
+    const char *name;
+    int (*main)(int argc, char *argv[]);
+} BlazeneuroApplet;
+
+/* Look up an applet by executable name ("blazeneuro-files", a path to
+ * it, or plain "files"). Defined in src/multicall/multicall.c. */
+const BlazeneuroApplet *blazeneuro_find_applet(const char *exec);
+
+int blazeneuro_desktop_main(int argc, char *argv[]);
+int blazeneuro_dock_main(int argc, char *argv[]);
+int blazeneuro_topbar_main(int argc, char *argv[]);
+int blazeneuro_files_main(int argc, char *argv[]);
+int blazeneuro_notes_main(int argc, char *argv[]);
+int blazeneuro_calculator_main(int argc, char *argv[]);
+int blazeneuro_settings_main(int argc, char *argv[]);
+int blazeneuro_taskviewer_main(int argc, char *argv[]);
+int blazeneuro_launcher_main(int argc, char *argv[]);
+int blazeneuro_terminal_main(int argc, char *argv[]);
+int blazeneuro_zygote_main(int argc, char *argv[]);
+int blazeneuro_indexer_main(int argc, char *argv[]);
+#else
+#define BLAZENEURO_MAIN(name) main
+#endif
+
+#endif /* BLAZENEURO_APPLET_H */
@@ -0,0 +1,71 @@
+/*
+ * BlazeNeuro App Launch Helper
+ * Starts a command line, routing BlazeNeuro apps through the zygote
+ * and everything else through a regular async spawn.
+ */
+
+#ifndef BLAZENEURO_LAUNCH_H
+#define BLAZENEURO_LAUNCH_H
+
+#include <gio/gio.h>
+
+#include "zygote.h"
+
+static inline gboolean blazeneuro_launch(const char *cmdline) {
+    gchar **argv = NULL;
+    if (!g_shell_parse_argv(cmdline, NULL, &argv, NULL)) return FALSE;
+
+    gboolean ok = blazeneuro_zygote_launch((const char *const *)argv) > 0;
+    if (!ok)
+        ok = g_spawn_async(NULL, argv, NULL, G_SPAWN_SEARCH_PATH,
+                           NULL, NULL, NULL, NULL);
+    g_strfreev(argv);
+    return ok;
+}
+
+/* ── Single-instance activation ────────────────────────── */
+static void _bn_activate_done(GObject *source, GAsyncResult *res, gpointer data) {
+    gchar *cmdline = data;
+    GError *err = NULL;
+    GVariant *ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &err);
+    if (ret) {
+        g_variant_unref(ret);
+    } else {
+        /* Not running yet: start it (through the zygote when possible) */
+        g_error_free(err);
+        blazeneuro_launch(cmdline);
+    }
+    g_free(cmdline);
+}
+
+/**
+ * blazeneuro_activate:
+ * @app_id: GApplication id of a single-instance app, e.g. "org.blazeneuro.Files"
+ * @cmdline: command that starts the app when no instance is running
+ *
+ * Raises a running instance with one org.freedesktop.Application.Activate
+ * call instead of starting a new process. Returns immediately.
+ */
+static inline void blazeneuro_activate(const char *app_id, const char *cmdline) {
+    GDBusConnection *bus = g_bus_get_sync(G_BUS_TYPE_SESSION, NULL, NULL);
+    if (!bus) {
+        blazeneuro_launch(cmdline);
+        return;
+    }
+
+    gchar *object_path = g_strdelimit(g_strconcat("/", app_id, NULL), ".", '/');
+    GVariantBuilder platform_data;
+    g_variant_builder_init(&platform_data, G_VARIANT_TYPE_VARDICT);
+
+    /* NO_AUTO_START: a cold start is cheaper through the zygote than
+     * through the bus daemon's exec of the .service file */
+    g_dbus_connection_call(bus, app_id, object_path,
+                           "org.freedesktop.Application", "Activate",
+                           g_variant_new("(a{sv})", &platform_data),
+                           NULL, G_DBUS_CALL_FLAGS_NO_AUTO_START, 1000, NULL,
+                           _bn_activate_done, g_strdup(cmdline));
+    g_free(object_path);
+    g_object_unref(bus);
+}
+
+#endif /* BLAZENEURO_LAUNCH_H */
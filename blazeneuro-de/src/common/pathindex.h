@@ -0,0 +1,453 @@
+/*
+ * BlazeNeuro Path Index
+ * A trigram index of the file and folder names under $HOME. The indexer
+ * (src/indexer) writes it; Files and the Launcher map it read-only, so a
+ * "find anywhere" query reads a few posting lists instead of the disk.
+ *
+ * File layout (native endian, sections back to back):
+ *   PathIndexHeader
+ *   PathIndexEntry  entries[n_entries]     sorted by path
+ *   PathIndexGram   grams[n_grams]         sorted by gram
+ *   guint32         postings[n_postings]   entry ids, ascending per gram
+ *   char            strings[strings_size]  NUL-terminated paths
+ *
+ * Paths are relative to $HOME. A name is indexed by the trigrams of its
+ * g_utf8_casefold() bytes: a query of three bytes or more (casefolded)
+ * only looks at entries holding every one of its trigrams, shorter ones
+ * scan names. Names are matched as the Files walker matches them, so a
+ * query gives the same results whether or not its folder is indexed.
+ * Since entries are sorted, the paths below one folder form a range, so
+ * a query limited to a folder never looks outside it.
+ *
+ * The indexer replaces the file with rename(); a reader keeps its old
+ * mapping until pathindex_refresh() sees the new file.
+ *
+ * Usage:
+ *   PathIndex *idx = pathindex_open();
+ *   pathindex_refresh(idx);
+ *   pathindex_query(idx, "report", "Documents", 50, on_match, data);
+ */
+
+#ifndef BLAZENEURO_PATHINDEX_H
+#define BLAZENEURO_PATHINDEX_H
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define PATHINDEX_MAGIC     0x58444950u     /* "PIDX" */
+#define PATHINDEX_VERSION   2
+#define PATHINDEX_DIR       0x1             /* PathIndexEntry.flags */
+
+typedef struct {
+    guint32 magic;
+    guint32 version;
+    guint32 n_entries;
+    guint32 n_grams;
+    guint32 n_postings;
+    guint32 strings_size;
+    gint64 built;           /* g_get_real_time() of the last full pass */
+} PathIndexHeader;
+
+typedef struct {
+    guint32 path;           /* offset into strings */
+    guint16 base;           /* offset of the name within the path */
+    guint16 flags;
+} PathIndexEntry;
+
+typedef struct {
+    guint32 gram;           /* three casefolded bytes, first in the high byte */
+    guint32 first;          /* index into postings */
+    guint32 count;
+} PathIndexGram;
+
+/* Where the index lives: $XDG_CACHE_HOME/blazeneuro/pathindex */
+static gchar *pathindex_file(void) {
+    return g_build_filename(g_get_user_cache_dir(), "blazeneuro", "pathindex", NULL);
+}
+
+static inline guint32 _pathindex_gram(const char *s) {
+    return (guint32)(guchar)s[0] << 16 | (guint32)(guchar)s[1] << 8 | (guint32)(guchar)s[2];
+}
+
+static int _pathindex_cmp_u32(const void *a, const void *b) {
+    guint32 x = *(const guint32 *)a, y = *(const guint32 *)b;
+    return (x > y) - (x < y);
+}
+
+/* ── Writer ─────────────────────────────────────────────── */
+typedef struct {
+    const char *path;       /* relative to $HOME */
+    gboolean is_dir;
+} PathIndexItem;
+
+static int _pathindex_cmp_item(const void *a, const void *b) {
+    return strcmp(((const PathIndexItem *)a)->path, ((const PathIndexItem *)b)->path);
+}
+
+static int _pathindex_cmp_u64(const void *a, const void *b) {
+    guint64 x = *(const guint64 *)a, y = *(const guint64 *)b;
+    return (x > y) - (x < y);
+}
+
+/* Writes an index of @items (sorted in place) to @file, replacing it
+ * atomically. FALSE with errno set on failure. */
+static gboolean pathindex_write(const char *file, PathIndexItem *items, guint n, gint64 built) {
+    qsort(items, n, sizeof(PathIndexItem), _pathindex_cmp_item);
+
+    GArray *entries = g_array_sized_new(FALSE, FALSE, sizeof(PathIndexEntry), n);
+    GArray *pairs = g_array_new(FALSE, FALSE, sizeof(guint64));    /* gram << 32 | id */
+    GString *strings = g_string_new(NULL);
+
+    for (guint i = 0; i < n; i++) {
+        const char *path = items[i].path;
+        const char *slash = strrchr(path, '/');
+        gsize base = slash ? (gsize)(slash - path) + 1 : 0;
+        if (base > G_MAXUINT16 || strings->len + strlen(path) + 1 > G_MAXUINT32) continue;
+
+        guint32 id = entries->len;
+        PathIndexEntry e = { (guint32)strings->len, (guint16)base,
+                             items[i].is_dir ? PATHINDEX_DIR : 0 };
+        g_array_append_val(entries, e);
+        g_string_append_len(strings, path, (gssize)strlen(path) + 1);
+
+        /* Each distinct trigram of the casefolded name once */
+        gchar *name = g_utf8_casefold(path + base, -1);
+        gsize len = strlen(name);
+        if (len < 3) {
+            g_free(name);
+            continue;
+        }
+        guint n_grams = (guint)len - 2;
+        guint32 *grams = g_new(guint32, n_grams);
+        for (guint k = 0; k < n_grams; k++) grams[k] = _pathindex_gram(name + k);
+        qsort(grams, n_grams, sizeof(guint32), _pathindex_cmp_u32);
+        for (guint k = 0; k < n_grams; k++) {
+            if (k > 0 && grams[k] == grams[k - 1]) continue;
+            guint64 pair = (guint64)grams[k] << 32 | id;
+            g_array_append_val(pairs, pair);
+        }
+        g_free(grams);
+        g_free(name);
+    }
+
+    /* Ids were appended in order, so sorting by the whole key keeps
+     * every posting list ascending */
+    qsort(pairs->data, pairs->len, sizeof(guint64), _pathindex_cmp_u64);
+    GArray *gram_table = g_array_new(FALSE, FALSE, sizeof(PathIndexGram));
+    guint32 *postings = g_new(guint32, MAX(pairs->len, 1));
+    for (guint i = 0; i < pairs->len; i++) {
+        guint64 pair = g_array_index(pairs, guint64, i);
+        guint32 gram = (guint32)(pair >> 32);
+        if (gram_table->len == 0 ||
+            g_array_index(gram_table, PathIndexGram, gram_table->len - 1).gram != gram) {
+            PathIndexGram g = { gram, i, 0 };
+            g_array_append_val(gram_table, g);
+        }
+        g_array_index(gram_table, PathIndexGram, gram_table->len - 1).count++;
+        postings[i] = (guint32)pair;
+    }
+
+    PathIndexHeader hdr = {
+        .magic = PATHINDEX_MAGIC,
+        .version = PATHINDEX_VERSION,
+        .n_entries = entries->len,
+        .n_grams = gram_table->len,
+        .n_postings = pairs->len,
+        .strings_size = (guint32)strings->len,
+        .built = built,
+    };
+
+    gchar *dir = g_path_get_dirname(file);
+    g_mkdir_with_parents(dir, 0700);
+    g_free(dir);
+
+    gchar *tmp = g_strconcat(file, ".tmp", NULL);
+    FILE *fp = fopen(tmp, "we");
+    gboolean ok = fp != NULL;
+    if (ok) {
+        ok = fwrite(&hdr, sizeof(hdr), 1, fp) == 1 &&
+             fwrite(entries->data, sizeof(PathIndexEntry), entries->len, fp) == entries->len &&
+             fwrite(gram_table->data, sizeof(PathIndexGram), gram_table->len, fp) == gram_table->len &&
+             fwrite(postings, sizeof(guint32), pairs->len, fp) == pairs->len &&
+             fwrite(strings->str, 1, strings->len, fp) == strings->len;
+        ok = fclose(fp) == 0 && ok;
+        ok = ok && rename(tmp, file) == 0;
+        if (!ok) unlink(tmp);
+    }
+
+    g_free(tmp);
+    g_free(postings);
+    g_array_free(gram_table, TRUE);
+    g_array_free(pairs, TRUE);
+    g_array_free(entries, TRUE);
+    g_string_free(strings, TRUE);
+    return ok;
+}
+
+/* ── Reader ─────────────────────────────────────────────── */
+typedef struct {
+    gchar *file;
+    gchar *home;
+    gsize home_len;
+
+    void *map;
+    gsize size;
+    dev_t dev;
+    ino_t ino;
+    gint64 mtime;
+
+    const PathIndexHeader *hdr;
+    const PathIndexEntry *entries;
+    const PathIndexGram *grams;
+    const guint32 *postings;
+    const char *strings;
+} PathIndex;
+
+/* Called for each match, in path order; @path is relative to $HOME and
+ * @path + @base is the name. Return FALSE to stop. */
+typedef gboolean (*PathIndexFunc)(const char *path, guint base, gboolean is_dir, gpointer data);
+
+static void _pathindex_unmap(PathIndex *idx) {
+    if (idx->map) munmap(idx->map, idx->size);
+    idx->map = NULL;
+    idx->size = 0;
+    idx->hdr = NULL;
+}
+
+/* Checks that every section and offset lies inside the mapping */
+static gboolean _pathindex_valid(PathIndex *idx) {
+    if (idx->size < sizeof(PathIndexHeader)) return FALSE;
+    const PathIndexHeader *h = idx->map;
+    if (h->magic != PATHINDEX_MAGIC || h->version != PATHINDEX_VERSION) return FALSE;
+
+    guint64 expect = sizeof(PathIndexHeader) +
+                     (guint64)h->n_entries * sizeof(PathIndexEntry) +
+                     (guint64)h->n_grams * sizeof(PathIndexGram) +
+                     (guint64)h->n_postings * sizeof(guint32) + h->strings_size;
+    if (expect != idx->size) return FALSE;
+
+    const char *p = idx->map;
+    idx->hdr = h;
+    idx->entries = (const PathIndexEntry *)(p + sizeof(PathIndexHeader));
+    idx->grams = (const PathIndexGram *)(idx->entries + h->n_entries);
+    idx->postings = (const guint32 *)(idx->grams + h->n_grams);
+    idx->strings = (const char *)(idx->postings + h->n_postings);
+
+    if (h->strings_size > 0 && idx->strings[h->strings_size - 1] != '\0') return FALSE;
+    /* The name too, so path + base stops at a NUL inside the blob */
+    for (guint32 i = 0; i < h->n_entries; i++)
+        if ((guint64)idx->entries[i].path + idx->entries[i].base >= h->strings_size) return FALSE;
+    for (guint32 i = 0; i < h->n_grams; i++)
+        if ((guint64)idx->grams[i].first + idx->grams[i].count > h->n_postings) return FALSE;
+    return TRUE;
+}
+
+/* Maps the current index file if it changed since the last call. FALSE
+ * when there is no usable index (indexer not running yet). */
+static gboolean pathindex_refresh(PathIndex *idx) {
+    struct stat st;
+    if (g_stat(idx->file, &st) != 0) {
+        _pathindex_unmap(idx);
+        return FALSE;
+    }
+    gint64 mtime = (gint64)st.st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) + st.st_mtim.tv_nsec;
+    if (idx->map && st.st_dev == idx->dev && st.st_ino == idx->ino && mtime == idx->mtime)
+        return idx->hdr != NULL;
+
+    _pathindex_unmap(idx);
+    int fd = open(idx->file, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return FALSE;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return FALSE;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return FALSE;
+
+    idx->map = map;
+    idx->size = (gsize)st.st_size;
+    idx->dev = st.st_dev;
+    idx->ino = st.st_ino;
+    idx->mtime = (gint64)st.st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) + st.st_mtim.tv_nsec;
+    if (_pathindex_valid(idx)) return TRUE;
+    _pathindex_unmap(idx);
+    return FALSE;
+}
+
+static PathIndex *pathindex_open(void) {
+    PathIndex *idx = g_new0(PathIndex, 1);
+    idx->file = pathindex_file();
+    idx->home = g_strdup(g_get_home_dir());
+    idx->home_len = strlen(idx->home);
+    while (idx->home_len > 1 && idx->home[idx->home_len - 1] == '/')
+        idx->home[--idx->home_len] = '\0';
+    pathindex_refresh(idx);
+    return idx;
+}
+
+static void pathindex_close(PathIndex *idx) {
+    if (!idx) return;
+    _pathindex_unmap(idx);
+    g_free(idx->file);
+    g_free(idx->home);
+    g_free(idx);
+}
+
+/* @abs relative to $HOME ("" for $HOME itself), pointing into @abs; NULL
+ * if it lies outside */
+static const char *pathindex_relative(PathIndex *idx, const char *abs) {
+    if (strncmp(abs, idx->home, idx->home_len) != 0) return NULL;
+    const char *rest = abs + idx->home_len;
+    if (*rest == '\0') return rest;
+    if (*rest != '/') return NULL;
+    return rest + 1;
+}
+
+static inline const char *_pathindex_path(PathIndex *idx, guint32 id) {
+    return idx->strings + idx->entries[id].path;
+}
+
+/* First entry whose path sorts at or after @key, from @lo */
+static guint32 _pathindex_lower(PathIndex *idx, guint32 lo, const char *key, gsize len) {
+    guint32 hi = idx->hdr->n_entries;
+    while (lo < hi) {
+        guint32 mid = lo + (hi - lo) / 2;
+        if (strncmp(_pathindex_path(idx, mid), key, len) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* First entry past the paths starting with @prefix, from @lo */
+static guint32 _pathindex_upper(PathIndex *idx, guint32 lo, const char *prefix, gsize len) {
+    guint32 hi = idx->hdr->n_entries;
+    while (lo < hi) {
+        guint32 mid = lo + (hi - lo) / 2;
+        if (strncmp(_pathindex_path(idx, mid), prefix, len) <= 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static const PathIndexGram *_pathindex_find_gram(PathIndex *idx, guint32 gram) {
+    guint32 lo = 0, hi = idx->hdr->n_grams;
+    while (lo < hi) {
+        guint32 mid = lo + (hi - lo) / 2;
+        if (idx->grams[mid].gram < gram) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < idx->hdr->n_grams && idx->grams[lo].gram == gram ? &idx->grams[lo] : NULL;
+}
+
+/* Case-insensitive substring test, the same as the walker's: an ASCII
+ * @needle compares ASCII case only, any other is found in the casefolded
+ * name. @needle is already casefolded. */
+static gboolean _pathindex_contains(const char *hay, const char *needle, gsize len,
+                                    gboolean ascii) {
+    if (ascii) {
+        for (; *hay; hay++) {
+            gsize k = 0;
+            while (k < len && hay[k] && g_ascii_tolower(hay[k]) == needle[k]) k++;
+            if (k == len) return TRUE;
+        }
+        return len == 0;
+    }
+    gchar *folded = g_utf8_casefold(hay, -1);
+    gboolean found = strstr(folded, needle) != NULL;
+    g_free(folded);
+    return found;
+}
+
+static int _pathindex_cmp_count(const void *a, const void *b) {
+    guint32 x = (*(const PathIndexGram *const *)a)->count;
+    guint32 y = (*(const PathIndexGram *const *)b)->count;
+    return (x > y) - (x < y);
+}
+
+/* Calls @func for up to @limit entries below the folder @within (relative
+ * to $HOME, "" or NULL for all) whose name contains @query, ignoring
+ * case. Returns the number of matches reported. */
+static guint pathindex_query(PathIndex *idx, const char *query, const char *within,
+                             guint limit, PathIndexFunc func, gpointer data) {
+    if (!idx->hdr || !query[0] || limit == 0) return 0;
+
+    /* Restrict to the range of paths below @within */
+    guint32 lo = 0, hi = idx->hdr->n_entries;
+    gchar *prefix = within && within[0] ? g_strconcat(within, "/", NULL) : NULL;
+    if (prefix) {
+        gsize plen = strlen(prefix);
+        lo = _pathindex_lower(idx, 0, prefix, plen);
+        hi = _pathindex_upper(idx, lo, prefix, plen);
+        g_free(prefix);
+    }
+
+    gchar *needle = g_utf8_casefold(query, -1);
+    gsize len = strlen(needle);
+    gboolean ascii = g_str_is_ascii(needle);
+    guint found = 0;
+
+    if (len < 3) {
+        for (guint32 id = lo; id < hi && found < limit; id++) {
+            const PathIndexEntry *e = &idx->entries[id];
+            const char *path = idx->strings + e->path;
+            if (!_pathindex_contains(path + e->base, needle, len, ascii)) continue;
+            found++;
+            if (!func(path, e->base, e->flags & PATHINDEX_DIR, data)) break;
+        }
+        g_free(needle);
+        return found;
+    }
+
+    /* Posting lists of every trigram, shortest first; a missing trigram
+     * means no name can match */
+    guint n_lists = (guint)len - 2;
+    const PathIndexGram **lists = g_new(const PathIndexGram *, n_lists);
+    for (guint k = 0; k < n_lists; k++) {
+        lists[k] = _pathindex_find_gram(idx, _pathindex_gram(needle + k));
+        if (!lists[k]) {
+            g_free(lists);
+            g_free(needle);
+            return 0;
+        }
+    }
+    qsort(lists, n_lists, sizeof(*lists), _pathindex_cmp_count);
+
+    guint32 *cursor = g_new0(guint32, n_lists);
+    const guint32 *shortest = idx->postings + lists[0]->first;
+    for (guint32 i = 0; i < lists[0]->count && found < limit; i++) {
+        guint32 id = shortest[i];
+        if (id < lo) continue;
+        if (id >= hi || id >= idx->hdr->n_entries) break;
+
+        /* Lists are ascending, so each cursor only moves forward */
+        gboolean all = TRUE;
+        for (guint k = 1; k < n_lists && all; k++) {
+            const guint32 *post = idx->postings + lists[k]->first;
+            while (cursor[k] < lists[k]->count && post[cursor[k]] < id) cursor[k]++;
+            all = cursor[k] < lists[k]->count && post[cursor[k]] == id;
+        }
+        if (!all) continue;
+
+        /* Trigrams can match out of order; check the name itself */
+        const PathIndexEntry *e = &idx->entries[id];
+        const char *path = idx->strings + e->path;
+        if (!_pathindex_contains(path + e->base, needle, len, ascii)) continue;
+        found++;
+        if (!func(path, e->base, e->flags & PATHINDEX_DIR, data)) break;
+    }
+
+    g_free(cursor);
+    g_free(lists);
+    g_free(needle);
+    return found;
+}
+
+#endif /* BLAZENEURO_PATHINDEX_H */
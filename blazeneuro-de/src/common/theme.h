@@ -9,21 +9,36 @@
 
 #include <gtk/gtk.h>
 
-static inline void blazeneuro_load_theme(void) {
+#ifdef BLAZENEURO_APPLET
+/* Parsed once by the zygote before it forks; NULL in a cold start */
+extern GtkCssProvider *blazeneuro_zygote_theme;
+#endif
+
+#define BLAZENEURO_THEME_RESOURCE "/org/blazeneuro/theme/blazeneuro.css"
+
+/**
+ * Parse the theme CSS into a new provider.
+ * The stylesheet is compiled into the binary as a GResource, so this
+ * touches no files; BLAZENEURO_THEME_CSS=<path> loads a working copy
+ * instead while editing the theme. Needs no display, so the zygote can
+ * call it before gtk_init().
+ */
+static inline GtkCssProvider *blazeneuro_parse_theme(void) {
     GtkCssProvider *css = gtk_css_provider_new();
-    const char *paths[] = {
-        "/usr/local/share/blazeneuro/blazeneuro.css",
-        "theme/blazeneuro.css",
-        "../theme/blazeneuro.css",
-        "../../theme/blazeneuro.css",
-        NULL
-    };
-    for (int i = 0; paths[i]; i++) {
-        if (g_file_test(paths[i], G_FILE_TEST_EXISTS)) {
-            gtk_css_provider_load_from_path(css, paths[i], NULL);
-            break;
-        }
-    }
+    const char *override = g_getenv("BLAZENEURO_THEME_CSS");
+    if (override && override[0])
+        gtk_css_provider_load_from_path(css, override, NULL);
+    else
+        gtk_css_provider_load_from_resource(css, BLAZENEURO_THEME_RESOURCE);
+    return css;
+}
+
+static inline void blazeneuro_load_theme(void) {
+    GtkCssProvider *css = NULL;
+#ifdef BLAZENEURO_APPLET
+    if (blazeneuro_zygote_theme) css = g_object_ref(blazeneuro_zygote_theme);
+#endif
+    if (!css) css = blazeneuro_parse_theme();
     gtk_style_context_add_provider_for_screen(
         gdk_screen_get_default(),
         GTK_STYLE_PROVIDER(css),
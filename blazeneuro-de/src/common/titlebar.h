@@ -41,15 +41,18 @@ static void _bn_titlebar_fullscreen(GtkWidget *btn, gpointer data) {
     }
 }
 
-/* ── Drag support: move window by dragging the title bar ─ */
+/* ── Drag support: move window by dragging the title bar ─
+ * Once the pointer passes the drag threshold the move is handed to the
+ * window manager (_NET_WM_MOVERESIZE), which runs it under its own
+ * pointer grab: no position queries or move requests from the app. */
 static gdouble _bn_drag_x, _bn_drag_y;
-static gboolean _bn_dragging = FALSE;
+static guint _bn_drag_button = 0;
 
 static gboolean _bn_titlebar_press(GtkWidget *widget, GdkEventButton *ev, gpointer data) {
     (void)widget;
     (void)data;
-    if (ev->button == 1) {
-        _bn_dragging = TRUE;
+    if (ev->type == GDK_BUTTON_PRESS && ev->button == 1) {
+        _bn_drag_button = ev->button;
         _bn_drag_x = ev->x_root;
         _bn_drag_y = ev->y_root;
     }
@@ -58,25 +61,100 @@ static gboolean _bn_titlebar_press(GtkWidget *widget, GdkEventButton *ev, gpoint
 
 static gboolean _bn_titlebar_release(GtkWidget *widget, GdkEventButton *ev, gpointer data) {
     (void)widget; (void)ev; (void)data;
-    _bn_dragging = FALSE;
+    _bn_drag_button = 0;
     return FALSE;
 }
 
 static gboolean _bn_titlebar_motion(GtkWidget *widget, GdkEventMotion *ev, gpointer data) {
-    (void)widget;
-    if (_bn_dragging) {
-        GtkWidget *win = GTK_WIDGET(data);
-        gint wx, wy;
-        gtk_window_get_position(GTK_WINDOW(win), &wx, &wy);
-        gtk_window_move(GTK_WINDOW(win),
-                        wx + (gint)(ev->x_root - _bn_drag_x),
-                        wy + (gint)(ev->y_root - _bn_drag_y));
-        _bn_drag_x = ev->x_root;
-        _bn_drag_y = ev->y_root;
+    if (_bn_drag_button &&
+        gtk_drag_check_threshold(widget, (gint)_bn_drag_x, (gint)_bn_drag_y,
+                                 (gint)ev->x_root, (gint)ev->y_root)) {
+        gtk_window_begin_move_drag(GTK_WINDOW(data), (gint)_bn_drag_button,
+                                   (gint)_bn_drag_x, (gint)_bn_drag_y, ev->time);
+        _bn_drag_button = 0;
     }
     return FALSE;
 }
 
+/* ── Edge resize handles ───────────────────────────────────
+ * Thin input-only strips along the window border that hand the resize
+ * to the window manager, the same way the title bar hands off moves. */
+#define _BN_RESIZE_BORDER 6
+
+static gboolean _bn_resize_enabled(GtkWindow *win) {
+    return !_bn_is_fullscreen && gtk_window_get_resizable(win) &&
+           !gtk_window_is_maximized(win);
+}
+
+static gboolean _bn_resize_press(GtkWidget *handle, GdkEventButton *ev, gpointer data) {
+    GtkWindow *win = GTK_WINDOW(data);
+    if (ev->type != GDK_BUTTON_PRESS || ev->button != 1 || !_bn_resize_enabled(win))
+        return FALSE;
+    GdkWindowEdge edge = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(handle), "bn-edge"));
+    gtk_window_begin_resize_drag(win, edge, (gint)ev->button,
+                                 (gint)ev->x_root, (gint)ev->y_root, ev->time);
+    return TRUE;
+}
+
+static gboolean _bn_resize_enter(GtkWidget *handle, GdkEventCrossing *ev, gpointer data) {
+    (void)ev;
+    GtkWidget *win = GTK_WIDGET(data);
+    GdkWindow *gdk_win = gtk_widget_get_window(win);
+    if (!gdk_win || !_bn_resize_enabled(GTK_WINDOW(win))) return FALSE;
+    GdkCursor *cursor = gdk_cursor_new_from_name(
+        gtk_widget_get_display(win), g_object_get_data(G_OBJECT(handle), "bn-cursor"));
+    gdk_window_set_cursor(gdk_win, cursor);
+    if (cursor) g_object_unref(cursor);
+    return FALSE;
+}
+
+static gboolean _bn_resize_leave(GtkWidget *handle, GdkEventCrossing *ev, gpointer data) {
+    (void)handle; (void)ev;
+    GdkWindow *gdk_win = gtk_widget_get_window(GTK_WIDGET(data));
+    if (gdk_win) gdk_window_set_cursor(gdk_win, NULL);
+    return FALSE;
+}
+
+static void _bn_add_resize_handles(GtkWidget *win, GtkOverlay *overlay) {
+    static const struct {
+        GdkWindowEdge edge;
+        const char *cursor;
+        GtkAlign halign, valign;
+        gint width, height;
+    } handles[] = {
+        /* Edges first so the corners stack above them */
+        { GDK_WINDOW_EDGE_NORTH, "n-resize", GTK_ALIGN_FILL,  GTK_ALIGN_START, -1, _BN_RESIZE_BORDER },
+        { GDK_WINDOW_EDGE_SOUTH, "s-resize", GTK_ALIGN_FILL,  GTK_ALIGN_END,   -1, _BN_RESIZE_BORDER },
+        { GDK_WINDOW_EDGE_WEST,  "w-resize", GTK_ALIGN_START, GTK_ALIGN_FILL,  _BN_RESIZE_BORDER, -1 },
+        { GDK_WINDOW_EDGE_EAST,  "e-resize", GTK_ALIGN_END,   GTK_ALIGN_FILL,  _BN_RESIZE_BORDER, -1 },
+        { GDK_WINDOW_EDGE_NORTH_WEST, "nw-resize", GTK_ALIGN_START, GTK_ALIGN_START,
+          2 * _BN_RESIZE_BORDER, 2 * _BN_RESIZE_BORDER },
+        { GDK_WINDOW_EDGE_NORTH_EAST, "ne-resize", GTK_ALIGN_END, GTK_ALIGN_START,
+          2 * _BN_RESIZE_BORDER, 2 * _BN_RESIZE_BORDER },
+        { GDK_WINDOW_EDGE_SOUTH_WEST, "sw-resize", GTK_ALIGN_START, GTK_ALIGN_END,
+          2 * _BN_RESIZE_BORDER, 2 * _BN_RESIZE_BORDER },
+        { GDK_WINDOW_EDGE_SOUTH_EAST, "se-resize", GTK_ALIGN_END, GTK_ALIGN_END,
+          2 * _BN_RESIZE_BORDER, 2 * _BN_RESIZE_BORDER },
+    };
+
+    for (gsize i = 0; i < G_N_ELEMENTS(handles); i++) {
+        GtkWidget *handle = gtk_event_box_new();
+        gtk_event_box_set_visible_window(GTK_EVENT_BOX(handle), FALSE);
+        gtk_event_box_set_above_child(GTK_EVENT_BOX(handle), TRUE);
+        gtk_widget_set_halign(handle, handles[i].halign);
+        gtk_widget_set_valign(handle, handles[i].valign);
+        gtk_widget_set_size_request(handle, handles[i].width, handles[i].height);
+        gtk_widget_add_events(handle, GDK_BUTTON_PRESS_MASK |
+                                      GDK_ENTER_NOTIFY_MASK | GDK_LEAVE_NOTIFY_MASK);
+        g_object_set_data(G_OBJECT(handle), "bn-edge", GINT_TO_POINTER(handles[i].edge));
+        g_object_set_data(G_OBJECT(handle), "bn-cursor", (gpointer)handles[i].cursor);
+        g_signal_connect(handle, "button-press-event", G_CALLBACK(_bn_resize_press), win);
+        g_signal_connect(handle, "enter-notify-event", G_CALLBACK(_bn_resize_enter), win);
+        g_signal_connect(handle, "leave-notify-event", G_CALLBACK(_bn_resize_leave), win);
+        gtk_overlay_add_overlay(overlay, handle);
+    }
+}
+
 /* ── Double-click title bar to toggle fullscreen ───────── */
 static gboolean _bn_titlebar_dblclick(GtkWidget *widget, GdkEventButton *ev, gpointer data) {
     (void)widget;
@@ -106,7 +184,8 @@ static GtkWidget *_bn_make_circle_btn(const char *css_class,
  * @content: the main content widget (will be packed below the title bar)
  *
  * Wraps the window content in a vbox with a custom title bar on top.
- * The title bar has macOS-style traffic-light buttons (close, minimize, fullscreen).
+ * The title bar has macOS-style traffic-light buttons (close, minimize, fullscreen);
+ * dragging it or the window edges is carried out by the window manager.
  * Must be called BEFORE gtk_widget_show_all().
  */
 static inline void blazeneuro_add_titlebar(GtkWidget *win,
@@ -166,11 +245,15 @@ static inline void blazeneuro_add_titlebar(GtkWidget *win,
     gtk_widget_set_size_request(spacer, 70, -1); /* ~same width as 3 buttons */
     gtk_box_pack_end(GTK_BOX(titlebar), spacer, FALSE, FALSE, 0);
 
-    /* Assemble: titlebar on top, content below */
+    /* Assemble: titlebar on top, content below, resize handles above both */
     gtk_box_pack_start(GTK_BOX(vbox), titlebar_ebox, FALSE, FALSE, 0);
     gtk_box_pack_start(GTK_BOX(vbox), content, TRUE, TRUE, 0);
 
-    gtk_container_add(GTK_CONTAINER(win), vbox);
+    GtkWidget *overlay = gtk_overlay_new();
+    gtk_container_add(GTK_CONTAINER(overlay), vbox);
+    _bn_add_resize_handles(win, GTK_OVERLAY(overlay));
+
+    gtk_container_add(GTK_CONTAINER(win), overlay);
 }
 
 #endif /* BLAZENEURO_TITLEBAR_H */
@@ -0,0 +1,103 @@
+/*
+ * BlazeNeuro Zygote Client
+ * Asks the running blazeneuro-zygote to fork a pre-initialized app.
+ * Plain POSIX so the Xlib-only window manager can use it too.
+ *
+ * Request: argv strings, each NUL-terminated, followed by an empty string.
+ * Reply:   the child's pid as a 32-bit int (<= 0 means "unknown app").
+ */
+
+#ifndef BLAZENEURO_ZYGOTE_H
+#define BLAZENEURO_ZYGOTE_H
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define BLAZENEURO_ZYGOTE_MAX_REQUEST 4096
+
+static inline int blazeneuro_zygote_socket_path(char *buf, size_t len) {
+    const char *dir = getenv("XDG_RUNTIME_DIR");
+    int n;
+    if (dir && dir[0])
+        n = snprintf(buf, len, "%s/blazeneuro-zygote.sock", dir);
+    else
+        n = snprintf(buf, len, "/tmp/blazeneuro-zygote-%u.sock", (unsigned)getuid());
+    return (n > 0 && (size_t)n < len) ? 0 : -1;
+}
+
+/**
+ * blazeneuro_zygote_applet:
+ * @exec: an executable name or path, e.g. "blazeneuro-files"
+ *
+ * Returns the applet name ("files") if @exec is one of the components
+ * the zygote can start, NULL otherwise.
+ */
+static inline const char *blazeneuro_zygote_applet(const char *exec) {
+    static const char *const applets[] = {
+        "desktop", "dock", "topbar",
+        "files", "notes", "calculator", "settings",
+        "taskviewer", "launcher", "terminal", NULL
+    };
+    if (!exec) return NULL;
+    const char *base = strrchr(exec, '/');
+    base = base ? base + 1 : exec;
+    if (strncmp(base, "blazeneuro-", 11) != 0) return NULL;
+    base += 11;
+    for (int i = 0; applets[i]; i++)
+        if (strcmp(base, applets[i]) == 0) return applets[i];
+    return NULL;
+}
+
+/**
+ * blazeneuro_zygote_launch:
+ * @argv: NULL-terminated argument vector; argv[0] is the executable name
+ *
+ * Returns the pid of the forked app, or -1 if the zygote is not running
+ * or does not know the app. Callers fall back to a normal spawn on -1.
+ */
+static inline pid_t blazeneuro_zygote_launch(const char *const argv[]) {
+    if (!argv || !blazeneuro_zygote_applet(argv[0])) return -1;
+
+    char req[BLAZENEURO_ZYGOTE_MAX_REQUEST];
+    size_t len = 0;
+    for (int i = 0; argv[i]; i++) {
+        size_t n = strlen(argv[i]) + 1;
+        if (n == 1 || len + n + 1 > sizeof(req)) return -1;
+        memcpy(req + len, argv[i], n);
+        len += n;
+    }
+    req[len++] = '\0';
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (blazeneuro_zygote_socket_path(addr.sun_path, sizeof(addr.sun_path)) != 0)
+        return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    /* Never let a wedged zygote stall the dock or the WM event loop */
+    struct timeval tv = { 0, 500 * 1000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    int32_t pid = -1;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+        send(fd, req, len, MSG_NOSIGNAL) == (ssize_t)len &&
+        recv(fd, &pid, sizeof(pid), MSG_WAITALL) == (ssize_t)sizeof(pid)) {
+        close(fd);
+        return pid > 0 ? (pid_t)pid : -1;
+    }
+    close(fd);
+    return -1;
+}
+
+#endif /* BLAZENEURO_ZYGOTE_H */
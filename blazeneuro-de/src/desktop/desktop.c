@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../common/applet.h"
 #include "../common/theme.h"
 
 static GtkWidget *desktop_win;
@@ -247,7 +248,7 @@ static gboolean on_button_press(GtkWidget *widget, GdkEventButton *ev, gpointer
 }
 
 /* ── Main ───────────────────────────────────────────────── */
-int main(int argc, char *argv[]) {
+int BLAZENEURO_MAIN(desktop)(int argc, char *argv[]) {
     gtk_init(&argc, &argv);
     blazeneuro_load_theme();
 
@@ -10,6 +10,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "../common/applet.h"
+#include "../common/launch.h"
 #include "../common/theme.h"
 
 #define DOCK_HEIGHT  64
@@ -22,29 +24,31 @@ typedef struct {
     const char *name;
     const char *exec;
     const char *icon;
+    const char *app_id;   /* single-instance GApplication id, or NULL */
 } DockApp;
 
 static DockApp dock_apps[] = {
-    { "Files",       "blazeneuro-files",     "system-file-manager" },
-    { "Terminal",    "blazeneuro-terminal",  "utilities-terminal" },
-    { "Chromium",    "chromium-browser",     "chromium-browser" },
-    { "VS Code",     "code",                "com.visualstudio.code" },
-    { "Settings",    "blazeneuro-settings",  "preferences-system" },
-    { "Software",    "gnome-software",       "org.gnome.Software" },
-    { "Text Editor", "mousepad",             "accessories-text-editor" },
-    { "Calculator",  "blazeneuro-calculator","accessories-calculator" },
-    { "Notes",       "blazeneuro-notes",     "accessories-text-editor" },
-    { "Task Viewer", "blazeneuro-taskviewer","utilities-system-monitor" },
-    { NULL, NULL, NULL }
+    { "Files",       "blazeneuro-files",     "system-file-manager",      "org.blazeneuro.Files" },
+    { "Terminal",    "blazeneuro-terminal",  "utilities-terminal",       NULL },
+    { "Chromium",    "chromium-browser",     "chromium-browser",         NULL },
+    { "VS Code",     "code",                "com.visualstudio.code",    NULL },
+    { "Settings",    "blazeneuro-settings",  "preferences-system",       "org.blazeneuro.Settings" },
+    { "Software",    "gnome-software",       "org.gnome.Software",       NULL },
+    { "Text Editor", "mousepad",             "accessories-text-editor",  NULL },
+    { "Calculator",  "blazeneuro-calculator","accessories-calculator",   "org.blazeneuro.Calculator" },
+    { "Notes",       "blazeneuro-notes",     "accessories-text-editor",  "org.blazeneuro.Notes" },
+    { "Task Viewer", "blazeneuro-taskviewer","utilities-system-monitor", "org.blazeneuro.TaskViewer" },
+    { NULL, NULL, NULL, NULL }
 };
 
 /* ── Launch App ─────────────────────────────────────────── */
 static void launch_app(GtkWidget *widget, gpointer data) {
     (void)widget;
-    const char *cmd = (const char *)data;
-    gchar *full_cmd = g_strdup_printf("%s &", cmd);
-    g_spawn_command_line_async(full_cmd, NULL);
-    g_free(full_cmd);
+    const DockApp *app = data;
+    if (app->app_id)
+        blazeneuro_activate(app->app_id, app->exec);
+    else
+        blazeneuro_launch(app->exec);
 }
 
 /* ── Set Window as Dock Type ────────────────────────────── */
@@ -74,10 +78,7 @@ static void on_realize(GtkWidget *widget, gpointer data) {
 /* ── Dock Button Context Menu ───────────────────────────── */
 static void ctx_launch(GtkWidget *w, gpointer d) {
     (void)w;
-    const char *cmd = (const char *)d;
-    gchar *full_cmd = g_strdup_printf("%s &", cmd);
-    g_spawn_command_line_async(full_cmd, NULL);
-    g_free(full_cmd);
+    blazeneuro_launch((const char *)d);
 }
 
 static GtkWidget *_dock_make_menu_item(const char *icon_name, const char *label,
@@ -126,7 +127,7 @@ static gboolean on_dock_button_press(GtkWidget *widget, GdkEventButton *ev, gpoi
 }
 
 /* ── Main ───────────────────────────────────────────────── */
-int main(int argc, char *argv[]) {
+int BLAZENEURO_MAIN(dock)(int argc, char *argv[]) {
     gtk_init(&argc, &argv);
     blazeneuro_load_theme();
 
@@ -165,7 +166,7 @@ int main(int argc, char *argv[]) {
         gtk_container_add(GTK_CONTAINER(btn), icon);
 
         /* Left-click: launch */
-        g_signal_connect(btn, "clicked", G_CALLBACK(launch_app), (gpointer)dock_apps[i].exec);
+        g_signal_connect(btn, "clicked", G_CALLBACK(launch_app), &dock_apps[i]);
 
         /* Right-click: context menu */
         gtk_widget_add_events(btn, GDK_BUTTON_PRESS_MASK);
@@ -0,0 +1,794 @@
+/*
+ * BlazeNeuro Files — Archive Browsing
+ * Shows .zip, .tar.* and the other formats libarchive reads as read-only
+ * folders. Opening an archive reads its index and nothing else: zip and
+ * 7z answer from their central directory, a tarball is read header by
+ * header with the data skipped (a compressed one still has to be
+ * decompressed on the way, but nothing is written). Folders inside are
+ * paths below the archive file, "/home/me/src.tar.gz/src/lib", so
+ * history, Up and the path bar need nothing special.
+ *
+ * Only what is opened or copied out gets unpacked, by a FILEOP_EXTRACT
+ * job on the file operations queue: one pass over the archive writing
+ * just the chosen members. Entries that would land outside the target
+ * (absolute paths, "..", or below a link the archive itself made) are
+ * skipped. Every path is resolved one folder at a time from the target
+ * without following symlinks, so a link unpacked earlier, into the
+ * shared cache folder say, cannot lead a later member out of it.
+ *
+ * Usage:
+ *   ArchiveLoad *load = archivefs_load(file, on_index, data);
+ *   archivefs_populate(index, "src/lib", model);
+ *   ArchiveSearch *search = archivefs_search(index, "src", "main", on_found, data);
+ *   FileOp *op = fileop_extract(index, members, dest_dir, &callbacks, data);
+ *   FileOp *op = fileop_extract_cached(index, members, &callbacks, data);
+ */
+
+#ifndef BLAZENEURO_FILES_ARCHIVEFS_H
+#define BLAZENEURO_FILES_ARCHIVEFS_H
+
+#include <gio/gio.h>
+#include <archive.h>
+#include <archive_entry.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "fileops.h"
+#include "filesmodel.h"
+#include "filetype.h"
+
+#define ARCHIVEFS_BLOCK        (64 << 10)   /* libarchive read size */
+#define ARCHIVEFS_MAX_RESULTS  200000      /* search matches, as for a walk */
+
+typedef struct {
+    const char *path;       /* no leading "./" or "/", no trailing "/" */
+    const char *key;        /* collation key of the basename */
+    gint64 size;
+    gint64 mtime;           /* ns */
+    guint16 base;           /* offset of the basename in path */
+    gboolean is_dir;
+} ArchiveEntry;
+
+typedef struct {
+    gint ref_count;
+    gchar *file;
+    gint64 file_mtime;      /* ns; a changed archive is read again */
+    GStringChunk *strings;  /* paths and keys */
+    GArray *entries;        /* ArchiveEntry */
+    GHashTable *by_path;    /* path -> entry + 1 */
+    GHashTable *children;   /* folder path, "" for the top -> GArray of guint32 entry */
+} ArchiveIndex;
+
+/* Archive file mtime in ns, or -1 if it cannot be read */
+static gint64 archivefs_file_mtime(const char *file) {
+    struct stat st;
+    if (stat(file, &st) != 0 || !S_ISREG(st.st_mode)) return -1;
+    return (gint64)st.st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) + st.st_mtim.tv_nsec;
+}
+
+/* By name: opening is decided before anything is read */
+static gboolean archivefs_supported(const char *file) {
+    const char *slash = strrchr(file, '/');
+    return filetype_lookup(slash ? slash + 1 : file) == FT_KIND_ARCHIVE;
+}
+
+/* The archive @path lies in, with the path inside it in @inner ("" for
+ * its top; may be NULL), or NULL for a plain path. Only stats when
+ * @path is not a folder, one per component. */
+static gchar *archivefs_split(const char *path, const char **inner) {
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISDIR(st.st_mode)) return NULL;
+
+    gsize len = strlen(path);
+    for (gsize i = 1; i <= len; i++) {
+        if (i < len && path[i] != '/') continue;
+        gchar *prefix = g_strndup(path, i);
+        if (stat(prefix, &st) != 0) {
+            g_free(prefix);
+            return NULL;
+        }
+        if (S_ISREG(st.st_mode)) {
+            if (archivefs_supported(prefix)) {
+                if (inner) *inner = path[i] == '/' ? path + i + 1 : path + i;
+                return prefix;
+            }
+            g_free(prefix);
+            return NULL;
+        }
+        g_free(prefix);
+    }
+    return NULL;
+}
+
+/* ── Index ──────────────────────────────────────────────── */
+static ArchiveIndex *archivefs_index_ref(ArchiveIndex *ix) {
+    g_atomic_int_inc(&ix->ref_count);
+    return ix;
+}
+
+static void archivefs_index_unref(ArchiveIndex *ix) {
+    if (!ix || !g_atomic_int_dec_and_test(&ix->ref_count)) return;
+    g_hash_table_destroy(ix->children);
+    g_hash_table_destroy(ix->by_path);
+    g_array_free(ix->entries, TRUE);
+    g_string_chunk_free(ix->strings);
+    g_free(ix->file);
+    g_free(ix);
+}
+
+static ArchiveEntry *_archivefs_entry(ArchiveIndex *ix, guint i) {
+    return &g_array_index(ix->entries, ArchiveEntry, i);
+}
+
+/* The entry at @path, or NULL */
+static ArchiveEntry *archivefs_lookup(ArchiveIndex *ix, const char *path) {
+    gpointer v = g_hash_table_lookup(ix->by_path, path);
+    return v ? _archivefs_entry(ix, GPOINTER_TO_UINT(v) - 1) : NULL;
+}
+
+/* FALSE for a path below an entry that is not a folder (a symlink, say):
+ * it would be unpacked through whatever that entry became on disk */
+static gboolean archivefs_extractable(ArchiveIndex *ix, const char *path) {
+    gchar *buf = g_strdup(path);
+    gboolean ok = TRUE;
+    for (gchar *cut = strrchr(buf, '/'); cut && ok; cut = strrchr(buf, '/')) {
+        *cut = '\0';
+        ArchiveEntry *e = archivefs_lookup(ix, buf);
+        ok = !e || e->is_dir;
+    }
+    g_free(buf);
+    return ok;
+}
+
+/* Archive paths as they will be shown, or NULL for one that must not be
+ * extracted: "..", or nothing left after the leading "./" and "/" */
+static gchar *_archivefs_normalize(const char *raw) {
+    if (!raw) return NULL;
+    while (raw[0] == '/' || (raw[0] == '.' && raw[1] == '/')) raw += raw[0] == '/' ? 1 : 2;
+    gchar *path = g_strdup(raw);
+    gsize len = strlen(path);
+    while (len > 0 && path[len - 1] == '/') path[--len] = '\0';
+
+    gboolean ok = len > 0 && strcmp(path, ".") != 0;
+    gchar **parts = g_strsplit(path, "/", -1);
+    for (gchar **p = parts; ok && *p; p++)
+        if (strcmp(*p, "..") == 0 || (*p)[0] == '\0') ok = FALSE;
+    g_strfreev(parts);
+    if (!ok) {
+        g_free(path);
+        return NULL;
+    }
+    return path;
+}
+
+static guint _archivefs_add(ArchiveIndex *ix, const char *path, gboolean is_dir,
+                            gint64 size, gint64 mtime);
+
+/* Children of folder @path; archives often list only files, so the
+ * folders above them are made up as they are met */
+static GArray *_archivefs_dir(ArchiveIndex *ix, const char *path) {
+    GArray *kids = g_hash_table_lookup(ix->children, path);
+    if (kids) return kids;
+    if (path[0] && !g_hash_table_contains(ix->by_path, path))
+        _archivefs_add(ix, path, TRUE, 0, 0);
+    kids = g_array_new(FALSE, FALSE, sizeof(guint32));
+    g_hash_table_insert(ix->children, g_string_chunk_insert_const(ix->strings, path), kids);
+    return kids;
+}
+
+static guint _archivefs_add(ArchiveIndex *ix, const char *path, gboolean is_dir,
+                            gint64 size, gint64 mtime) {
+    gpointer v = g_hash_table_lookup(ix->by_path, path);
+    if (v) {
+        /* Listed again, or listed after its contents: the last one wins */
+        ArchiveEntry *e = _archivefs_entry(ix, GPOINTER_TO_UINT(v) - 1);
+        e->is_dir = is_dir;
+        e->size = size;
+        if (mtime) e->mtime = mtime;
+        return GPOINTER_TO_UINT(v) - 1;
+    }
+
+    const char *slash = strrchr(path, '/');
+    gchar *parent = slash ? g_strndup(path, slash - path) : g_strdup("");
+    GArray *kids = _archivefs_dir(ix, parent);
+    g_free(parent);
+
+    ArchiveEntry e;
+    e.path = g_string_chunk_insert_const(ix->strings, path);
+    e.base = (guint16)MIN(slash ? slash - path + 1 : 0, G_MAXUINT16);
+    gchar *key = files_collate_key(e.path + e.base);
+    e.key = g_string_chunk_insert(ix->strings, key);
+    g_free(key);
+    e.size = size;
+    e.mtime = mtime;
+    e.is_dir = is_dir;
+    g_array_append_val(ix->entries, e);
+
+    guint32 i = ix->entries->len - 1;
+    g_array_append_val(kids, i);
+    g_hash_table_insert(ix->by_path, (gpointer)e.path, GUINT_TO_POINTER(i + 1));
+    return i;
+}
+
+static struct archive *_archivefs_open(const char *file, gchar **error) {
+    struct archive *a = archive_read_new();
+    archive_read_support_filter_all(a);
+    archive_read_support_format_all(a);
+    if (archive_read_open_filename(a, file, ARCHIVEFS_BLOCK) != ARCHIVE_OK) {
+        *error = g_strdup(archive_error_string(a) ? archive_error_string(a) : g_strerror(errno));
+        archive_read_free(a);
+        return NULL;
+    }
+    return a;
+}
+
+/* ── Loading ────────────────────────────────────────────── */
+/* On the main thread, never after archivefs_load_cancel(); @index is
+ * NULL on failure. Take a reference to keep it. */
+typedef void (*ArchiveLoadFunc)(ArchiveIndex *index, const char *error, gpointer data);
+
+typedef struct {
+    gint ref_count;
+    gchar *file;
+    GCancellable *cancellable;
+    ArchiveIndex *index;
+    gchar *error;
+    ArchiveLoadFunc func;
+    gpointer data;
+} ArchiveLoad;
+
+/* Once its callback has run */
+static void archivefs_load_unref(ArchiveLoad *load) {
+    if (!g_atomic_int_dec_and_test(&load->ref_count)) return;
+    archivefs_index_unref(load->index);
+    g_object_unref(load->cancellable);
+    g_free(load->error);
+    g_free(load->file);
+    g_free(load);
+}
+
+static gboolean _archivefs_load_deliver(gpointer data) {
+    ArchiveLoad *load = data;
+    if (!g_cancellable_is_cancelled(load->cancellable))
+        load->func(load->index, load->error, load->data);
+    return G_SOURCE_REMOVE;
+}
+
+/* Headers only: moving to the next header skips the data, by seeking
+ * where the format allows it */
+static gpointer _archivefs_load_worker(gpointer data) {
+    ArchiveLoad *load = data;
+    ArchiveIndex *ix = g_new0(ArchiveIndex, 1);
+    ix->ref_count = 1;
+    ix->file = g_strdup(load->file);
+    ix->file_mtime = archivefs_file_mtime(load->file);
+    ix->strings = g_string_chunk_new(64 * 1024);
+    ix->entries = g_array_new(FALSE, FALSE, sizeof(ArchiveEntry));
+    ix->by_path = g_hash_table_new(g_str_hash, g_str_equal);
+    ix->children = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+                                         (GDestroyNotify)g_array_unref);
+    _archivefs_dir(ix, "");
+
+    struct archive *a = _archivefs_open(load->file, &load->error);
+    if (a) {
+        struct archive_entry *ae;
+        int r;
+        while (!g_cancellable_is_cancelled(load->cancellable) &&
+               (r = archive_read_next_header(a, &ae)) != ARCHIVE_EOF) {
+            if (r == ARCHIVE_RETRY) continue;
+            if (r < ARCHIVE_WARN) {
+                load->error = g_strdup(archive_error_string(a));
+                break;
+            }
+            gchar *path = _archivefs_normalize(archive_entry_pathname(ae));
+            if (!path) continue;
+            gint64 mtime = (gint64)archive_entry_mtime(ae) * G_GINT64_CONSTANT(1000000000) +
+                           archive_entry_mtime_nsec(ae);
+            gboolean is_dir = archive_entry_filetype(ae) == AE_IFDIR;
+            _archivefs_add(ix, path, is_dir, is_dir ? 0 : archive_entry_size(ae), mtime);
+            g_free(path);
+        }
+        archive_read_free(a);
+    }
+
+    /* A damaged tail still leaves what was read browsable */
+    if (!load->error || ix->entries->len > 0) {
+        load->index = ix;
+        g_clear_pointer(&load->error, g_free);
+    } else {
+        archivefs_index_unref(ix);
+    }
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, _archivefs_load_deliver, load,
+                    (GDestroyNotify)archivefs_load_unref);
+    return NULL;
+}
+
+static ArchiveLoad *archivefs_load(const char *file, ArchiveLoadFunc func, gpointer data) {
+    ArchiveLoad *load = g_new0(ArchiveLoad, 1);
+    load->ref_count = 2;    /* caller + worker */
+    load->file = g_strdup(file);
+    load->cancellable = g_cancellable_new();
+    load->func = func;
+    load->data = data;
+    g_thread_unref(g_thread_new("archive-index", _archivefs_load_worker, load));
+    return load;
+}
+
+/* No callback follows. NULL is ignored. */
+static void archivefs_load_cancel(ArchiveLoad *load) {
+    if (!load) return;
+    g_cancellable_cancel(load->cancellable);
+    archivefs_load_unref(load);
+}
+
+/* ── Listing ────────────────────────────────────────────── */
+static void _archivefs_append(const ArchiveEntry *ae, gsize skip, GArray *entries, GArray *stats) {
+    DirEntry e = { 0 };
+    e.name = (gchar *)ae->path + skip;
+    e.base = ae->base - (guint)skip;
+    e.key = (gchar *)ae->key;
+    e.is_dir = ae->is_dir;
+    e.type_known = TRUE;
+    if (ae->is_dir) {
+        e.kind = FT_KIND_FOLDER;
+    } else {
+        e.kind = filetype_lookup(ae->path + ae->base);
+        if (e.kind == FT_KIND_UNKNOWN) e.kind = FT_KIND_FILE;
+    }
+    e.icon = filetype_icons[e.kind];
+    g_array_append_val(entries, e);
+
+    FilesStat st = { ae->size, ae->mtime };
+    g_array_append_val(stats, st);
+}
+
+/* Adds @n entries, with their sizes and dates, to @model's listing */
+static void archivefs_fill(FilesModel *model, const DirEntry *entries, const FilesStat *stats,
+                           guint n) {
+    FilesListing *l = files_model_get_listing(model);
+    guint first = l->records->len;
+    files_model_append(model, entries, n);
+    g_array_set_size(l->stats, first);
+    g_array_append_vals(l->stats, stats, n);
+    files_model_flush(model);
+}
+
+/* Fills @model's new, empty listing with folder @inner of the archive.
+ * Sizes and dates come from the index, so every sort works without a
+ * stat. FALSE if @inner is not a folder in it. */
+static gboolean archivefs_populate(ArchiveIndex *ix, const char *inner, FilesModel *model) {
+    ArchiveEntry *dir = inner[0] ? archivefs_lookup(ix, inner) : NULL;
+    if (inner[0] && (!dir || !dir->is_dir)) return FALSE;
+
+    GArray *entries = g_array_new(FALSE, FALSE, sizeof(DirEntry));
+    GArray *stats = g_array_new(FALSE, FALSE, sizeof(FilesStat));
+    gsize skip = inner[0] ? strlen(inner) + 1 : 0;
+    GArray *kids = g_hash_table_lookup(ix->children, inner);
+    for (guint i = 0; kids && i < kids->len; i++)
+        _archivefs_append(_archivefs_entry(ix, g_array_index(kids, guint32, i)),
+                          skip, entries, stats);
+    archivefs_fill(model, (const DirEntry *)entries->data, (const FilesStat *)stats->data,
+                   entries->len);
+    g_array_free(entries, TRUE);
+    g_array_free(stats, TRUE);
+    return TRUE;
+}
+
+/* ── Search ─────────────────────────────────────────────── */
+/* On the main thread, never after archivefs_search_cancel(); the names
+ * point into the index and last until the callback returns */
+typedef void (*ArchiveSearchFunc)(const DirEntry *entries, const FilesStat *stats, guint n,
+                                  gpointer data);
+
+typedef struct {
+    gint ref_count;
+    ArchiveIndex *index;
+    gchar *inner;
+    gchar *query;           /* casefolded */
+    gboolean query_ascii;
+    GCancellable *cancellable;
+    GArray *entries;        /* DirEntry */
+    GArray *stats;          /* FilesStat */
+    ArchiveSearchFunc func;
+    gpointer data;
+} ArchiveSearch;
+
+/* Once its callback has run */
+static void archivefs_search_unref(ArchiveSearch *search) {
+    if (!g_atomic_int_dec_and_test(&search->ref_count)) return;
+    archivefs_index_unref(search->index);
+    g_object_unref(search->cancellable);
+    g_array_free(search->entries, TRUE);
+    g_array_free(search->stats, TRUE);
+    g_free(search->query);
+    g_free(search->inner);
+    g_free(search);
+}
+
+static gboolean _archivefs_search_deliver(gpointer data) {
+    ArchiveSearch *search = data;
+    if (!g_cancellable_is_cancelled(search->cancellable))
+        search->func((const DirEntry *)search->entries->data,
+                     (const FilesStat *)search->stats->data, search->entries->len, search->data);
+    return G_SOURCE_REMOVE;
+}
+
+/* As the folder search matches (_walk_match()): an ASCII query ignores
+ * ASCII case only, any other is looked for in the casefolded name */
+static gboolean _archivefs_match(ArchiveSearch *search, const char *name) {
+    if (search->query_ascii) return strcasestr(name, search->query) != NULL;
+    gchar *folded = g_utf8_casefold(name, -1);
+    gboolean found = strstr(folded, search->query) != NULL;
+    g_free(folded);
+    return found;
+}
+
+static gpointer _archivefs_search_worker(gpointer data) {
+    ArchiveSearch *search = data;
+    ArchiveIndex *ix = search->index;
+    const char *inner = search->inner;
+    gsize skip = inner[0] ? strlen(inner) + 1 : 0;
+    for (guint i = 0; i < ix->entries->len && search->entries->len < ARCHIVEFS_MAX_RESULTS &&
+                      !g_cancellable_is_cancelled(search->cancellable); i++) {
+        const ArchiveEntry *ae = _archivefs_entry(ix, i);
+        if (skip && (strncmp(ae->path, inner, skip - 1) != 0 || ae->path[skip - 1] != '/'))
+            continue;
+        if (_archivefs_match(search, ae->path + ae->base))
+            _archivefs_append(ae, skip, search->entries, search->stats);
+    }
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, _archivefs_search_deliver, search,
+                    (GDestroyNotify)archivefs_search_unref);
+    return NULL;
+}
+
+/* Everything below folder @inner whose name contains @query, found on a
+ * worker thread: a large archive does not hold up typing */
+static ArchiveSearch *archivefs_search(ArchiveIndex *ix, const char *inner, const char *query,
+                                       ArchiveSearchFunc func, gpointer data) {
+    ArchiveSearch *search = g_new0(ArchiveSearch, 1);
+    search->ref_count = 2;  /* caller + worker */
+    search->index = archivefs_index_ref(ix);
+    search->inner = g_strdup(inner);
+    search->query = g_utf8_casefold(query, -1);
+    search->query_ascii = g_str_is_ascii(search->query);
+    search->cancellable = g_cancellable_new();
+    search->entries = g_array_new(FALSE, FALSE, sizeof(DirEntry));
+    search->stats = g_array_new(FALSE, FALSE, sizeof(FilesStat));
+    search->func = func;
+    search->data = data;
+    g_thread_unref(g_thread_new("archive-search", _archivefs_search_worker, search));
+    return search;
+}
+
+/* No callback follows. NULL is ignored. */
+static void archivefs_search_cancel(ArchiveSearch *search) {
+    if (!search) return;
+    g_cancellable_cancel(search->cancellable);
+    archivefs_search_unref(search);
+}
+
+/* The members of folder @inner, NULL-terminated, for extracting all of
+ * it; free the array, not the strings */
+static const char **archivefs_children(ArchiveIndex *ix, const char *inner) {
+    GArray *kids = g_hash_table_lookup(ix->children, inner);
+    guint n = kids ? kids->len : 0;
+    const char **members = g_new0(const char *, n + 1);
+    for (guint i = 0; i < n; i++)
+        members[i] = _archivefs_entry(ix, g_array_index(kids, guint32, i))->path;
+    return members;
+}
+
+/* Where opened members are unpacked: one folder per archive version,
+ * so a second open of the same file is instant */
+static gchar *archivefs_cache_dir(ArchiveIndex *ix) {
+    gchar *id = g_strdup_printf("%s\n%" G_GINT64_FORMAT, ix->file, ix->file_mtime);
+    gchar *sum = g_compute_checksum_for_string(G_CHECKSUM_SHA1, id, -1);
+    gchar *dir = g_build_filename(g_get_user_cache_dir(), "blazeneuro", "archives", sum, NULL);
+    g_free(sum);
+    g_free(id);
+    return dir;
+}
+
+/* ── Extraction ─────────────────────────────────────────── */
+/* The key of @table that is @path or a folder above it, or NULL */
+static const char *_archivefs_under(GHashTable *table, const char *path, gboolean self) {
+    gchar *buf = g_strdup(path);
+    gpointer key = NULL;
+    gboolean found = FALSE;
+    for (gchar *cut = self ? buf + strlen(buf) : strrchr(buf, '/'); cut; cut = strrchr(buf, '/')) {
+        *cut = '\0';
+        if (g_hash_table_lookup_extended(table, buf, &key, NULL)) {
+            found = TRUE;
+            break;
+        }
+    }
+    g_free(buf);
+    return found ? key : NULL;
+}
+
+/* Where @out goes given what is there already; NULL to skip. Folders
+ * merge, anything else asks. */
+static gchar *_archivefs_target(FileOp *op, const char *name, const char *out, gboolean is_dir) {
+    struct stat st;
+    if (lstat(out, &st) != 0) return g_strdup(out);
+    if (is_dir && S_ISDIR(st.st_mode)) return g_strdup(out);
+
+    switch (_fileop_ask(op, name, out)) {
+    case FILEOP_REPLACE:
+        return _fileop_remove_tree(op, out, FALSE) ? g_strdup(out) : NULL;
+    case FILEOP_KEEP_BOTH:
+        return _fileop_free_name(out, is_dir);
+    default:
+        return NULL;
+    }
+}
+
+/* The entry's data into a new file @name in @dfd (@out for messages),
+ * holes and all */
+static gboolean _archivefs_write(FileOp *op, struct archive *a, struct archive_entry *ae,
+                                 int dfd, const char *name, const char *out) {
+    int fd = openat(dfd, name, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        _fileop_fail(op, out);
+        return FALSE;
+    }
+
+    const void *buf;
+    size_t len;
+    la_int64_t offset;
+    int r;
+    gboolean ok = TRUE;
+    while (ok && (r = archive_read_data_block(a, &buf, &len, &offset)) == ARCHIVE_OK) {
+        for (size_t done = 0; ok && done < len;) {
+            ssize_t n = pwrite(fd, (const char *)buf + done, len - done, offset + (off_t)done);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                _fileop_fail(op, out);
+                ok = FALSE;
+            } else {
+                done += (size_t)n;
+            }
+        }
+        _fileop_add(op, len, 0);
+        if (_fileop_cancelled(op)) ok = FALSE;
+    }
+    if (ok && r != ARCHIVE_EOF) {
+        _fileop_fail_with(op, out, archive_error_string(a));
+        ok = FALSE;
+    }
+
+    if (ok) {
+        /* A sparse file may end in a hole */
+        if (archive_entry_size_is_set(ae) && ftruncate(fd, archive_entry_size(ae)) != 0)
+            _fileop_fail(op, out);
+        fchmod(fd, archive_entry_perm(ae) & 0777);
+        struct timespec times[2] = {
+            { .tv_nsec = UTIME_OMIT },
+            { archive_entry_mtime(ae), archive_entry_mtime_nsec(ae) },
+        };
+        futimens(fd, times);
+    }
+    close(fd);
+    if (!ok) unlinkat(dfd, name, 0);
+    return ok;
+}
+
+typedef struct {
+    int destfd;             /* op->dest, where every path is resolved from */
+    GHashTable *roots;      /* member -> where it goes, "" to skip; absent: undecided */
+    GHashTable *links;      /* archive paths written as symlinks */
+    GHashTable *written;    /* archive path -> file written, for hard links */
+    gboolean keep_paths;    /* members go to dest/their path, not dest/their name */
+} ArchiveExtract;
+
+/* Opens the folder holding @out, a path below op->dest, making missing
+ * folders on the way. Each step is opened with O_NOFOLLOW, so no symlink
+ * below op->dest is followed. -1 with the failure recorded. */
+static int _archivefs_parent_fd(FileOp *op, ArchiveExtract *x, const char *out) {
+    gsize len = strlen(op->dest);
+    if (strncmp(out, op->dest, len) != 0) {
+        _fileop_fail_with(op, out, "it is outside the destination");
+        return -1;
+    }
+    gchar **parts = g_strsplit(out + len, "/", -1);
+    guint n = g_strv_length(parts);
+    int fd = fcntl(x->destfd, F_DUPFD_CLOEXEC, 0);
+    for (guint i = 0; i + 1 < n && fd >= 0; i++) {
+        if (!parts[i][0]) continue;
+        int next = openat(fd, parts[i], O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (next < 0 && errno == ENOENT &&
+            (mkdirat(fd, parts[i], 0755) == 0 || errno == EEXIST))
+            next = openat(fd, parts[i], O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        int err = errno;
+        close(fd);
+        errno = err;
+        fd = next;
+    }
+    g_strfreev(parts);
+
+    if (fd < 0 && (errno == ELOOP || errno == ENOTDIR))
+        _fileop_fail_with(op, out, "it is inside a link or a file, not a folder");
+    else if (fd < 0)
+        _fileop_fail(op, out);
+    return fd;
+}
+
+static void _archivefs_extract_entry(FileOp *op, ArchiveExtract *x, struct archive *a,
+                                     struct archive_entry *ae, const char *member,
+                                     const char *path) {
+    mode_t type = archive_entry_filetype(ae);
+    gboolean is_dir = type == AE_IFDIR;
+    const char *rest = path + strlen(member);   /* "" or "/..." */
+
+    gchar *root = g_hash_table_lookup(x->roots, member);
+    if (!root) {
+        gchar *base = x->keep_paths ? g_strdup(member) : g_path_get_basename(member);
+        gchar *out = g_build_filename(op->dest, base, NULL);
+        int pfd = _archivefs_parent_fd(op, x, out);
+        if (pfd >= 0) {
+            close(pfd);
+            root = _archivefs_target(op, member, out, is_dir || rest[0]);
+        }
+        if (!root) root = g_strdup("");
+        g_hash_table_insert(x->roots, (gpointer)member, root);
+        g_free(out);
+        g_free(base);
+    }
+    if (!root[0]) return;
+
+    gchar *out = g_strconcat(root, rest, NULL);
+    /* The folders above are real ones from here on, so path lookups of
+     * @out itself see what is there, not where a link points */
+    int dfd = _archivefs_parent_fd(op, x, out);
+    if (dfd < 0) {
+        g_free(out);
+        return;
+    }
+    if (rest[0]) {
+        gchar *target = _archivefs_target(op, path, out, is_dir);
+        g_free(out);
+        if (!target) {
+            close(dfd);
+            return;
+        }
+        out = target;
+    }
+    const char *name = strrchr(out, '/') + 1;
+
+    const char *hardlink = archive_entry_hardlink(ae);
+    if (hardlink) {
+        gchar *linked = _archivefs_normalize(hardlink);
+        const char *from = linked ? g_hash_table_lookup(x->written, linked) : NULL;
+        int ffd = from ? _archivefs_parent_fd(op, x, from) : -1;
+        if (!from)
+            _fileop_fail_with(op, out, "it is a link to a file that is not being extracted");
+        else if (ffd >= 0 && linkat(ffd, strrchr(from, '/') + 1, dfd, name, 0) != 0)
+            _fileop_fail(op, out);
+        else if (ffd >= 0)
+            _fileop_add(op, 0, 1);
+        if (ffd >= 0) close(ffd);
+        g_free(linked);
+    } else if (is_dir) {
+        if (mkdirat(dfd, name, 0755) != 0 && errno != EEXIST) _fileop_fail(op, out);
+    } else if (type == AE_IFLNK) {
+        if (symlinkat(archive_entry_symlink(ae), dfd, name) != 0) {
+            _fileop_fail(op, out);
+        } else {
+            g_hash_table_add(x->links, g_strdup(path));
+            _fileop_add(op, 0, 1);
+        }
+    } else if (type == AE_IFREG) {
+        if (_archivefs_write(op, a, ae, dfd, name, out)) {
+            g_hash_table_insert(x->written, g_strdup(path), g_strdup(out));
+            _fileop_add(op, 0, 1);
+        }
+    }
+    /* Devices and pipes are left out */
+    close(dfd);
+    g_free(out);
+}
+
+/* sources: the archive, then the members */
+static void _archivefs_extract(FileOp *op, gboolean keep_paths) {
+    const char *file = op->sources[0];
+    ArchiveExtract x;
+    x.keep_paths = keep_paths;
+    g_mkdir_with_parents(op->dest, 0755);
+    x.destfd = open(op->dest, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (x.destfd < 0) {
+        _fileop_fail(op, op->dest);
+        return;
+    }
+    x.roots = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_free);
+    x.links = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    x.written = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    GHashTable *members = g_hash_table_new(g_str_hash, g_str_equal);
+    for (gchar **m = op->sources + 1; *m; m++) g_hash_table_add(members, *m);
+
+    gchar *error = NULL;
+    struct archive *a = _archivefs_open(file, &error);
+    if (!a) {
+        _fileop_fail_with(op, file, error);
+        g_free(error);
+    }
+
+    struct archive_entry *ae;
+    int r;
+    while (a && !_fileop_cancelled(op) && (r = archive_read_next_header(a, &ae)) != ARCHIVE_EOF) {
+        if (r == ARCHIVE_RETRY) continue;
+        if (r < ARCHIVE_WARN) {
+            _fileop_fail_with(op, file, archive_error_string(a));
+            break;
+        }
+        gchar *path = _archivefs_normalize(archive_entry_pathname(ae));
+        const char *member = path ? _archivefs_under(members, path, TRUE) : NULL;
+        if (member && !_archivefs_under(x.links, path, FALSE))
+            _archivefs_extract_entry(op, &x, a, ae, member, path);
+        g_free(path);
+    }
+    if (a) archive_read_free(a);
+
+    g_hash_table_destroy(members);
+    g_hash_table_destroy(x.written);
+    g_hash_table_destroy(x.links);
+    g_hash_table_destroy(x.roots);
+    close(x.destfd);
+}
+
+static void _archivefs_run_extract(FileOp *op) {
+    _archivefs_extract(op, FALSE);
+}
+
+static void _archivefs_run_cache(FileOp *op) {
+    _archivefs_extract(op, TRUE);
+}
+
+/* The totals come from the index, so the progress bar is right from
+ * the start */
+static FileOp *_archivefs_job(ArchiveIndex *ix, const char *const *members, const char *dest_dir,
+                              void (*run)(FileOp *op), const FileOpCallbacks *cb, gpointer data) {
+    GPtrArray *sources = g_ptr_array_new();
+    g_ptr_array_add(sources, ix->file);
+    for (const char *const *m = members; *m; m++)
+        if (archivefs_extractable(ix, *m)) g_ptr_array_add(sources, (gpointer)*m);
+    g_ptr_array_add(sources, NULL);
+    FileOp *op = _fileop_new(FILEOP_EXTRACT, run, (const char *const *)sources->pdata,
+                             dest_dir, cb, data);
+    g_ptr_array_free(sources, TRUE);
+    for (const char *const *m = members; *m; m++)
+        if (!archivefs_extractable(ix, *m))
+            _fileop_fail_with(op, *m, "it is inside a link or a file, not a folder");
+
+    GHashTable *chosen = g_hash_table_new(g_str_hash, g_str_equal);
+    for (gchar **m = op->sources + 1; *m; m++) g_hash_table_add(chosen, *m);
+    for (guint i = 0; i < ix->entries->len; i++) {
+        const ArchiveEntry *ae = _archivefs_entry(ix, i);
+        if (ae->is_dir || !_archivefs_under(chosen, ae->path, TRUE)) continue;
+        op->progress.files_total++;
+        op->progress.bytes_total += (guint64)ae->size;
+    }
+    g_hash_table_destroy(chosen);
+    op->progress.counting = FALSE;
+    return _fileop_push(op);
+}
+
+/* Unpacks @members (paths inside @ix) into @dest_dir */
+static FileOp *fileop_extract(ArchiveIndex *ix, const char *const *members, const char *dest_dir,
+                              const FileOpCallbacks *cb, gpointer data) {
+    return _archivefs_job(ix, members, dest_dir, _archivefs_run_extract, cb, data);
+}
+
+/* Unpacks @members into archivefs_cache_dir(), each at its path in the
+ * archive, for opening or copying them from there */
+static FileOp *fileop_extract_cached(ArchiveIndex *ix, const char *const *members,
+                                     const FileOpCallbacks *cb, gpointer data) {
+    gchar *cache = archivefs_cache_dir(ix);
+    FileOp *op = _archivefs_job(ix, members, cache, _archivefs_run_cache, cb, data);
+    g_free(cache);
+    return op;
+}
+
+#endif /* BLAZENEURO_FILES_ARCHIVEFS_H */
@@ -0,0 +1,274 @@
+/*
+ * BlazeNeuro Files — Directory Loader
+ * Reads a directory on a worker thread and streams the entries back to
+ * the main loop in batches, so opening /usr/lib or a huge log folder
+ * never blocks the window. The first batch is about one screenful and
+ * is delivered as soon as it is read; later batches are larger.
+ *
+ * Entry types come from readdir's d_type, so a local listing costs no
+ * stat at all. Only entries the filesystem reports as DT_UNKNOWN, and
+ * symlinks (which need their target's type), are resolved with statx()
+ * relative to the open directory fd, grouped once per batch.
+ * Each entry also gets its sort key (see filesort.h) and its kind from
+ * the name here, off the main thread; no file is opened, and names that
+ * say nothing stay FT_KIND_UNKNOWN until their row is on screen.
+ *
+ * dirload_start_names() looks up a given set of names instead of reading
+ * the whole directory; names that no longer exist come back marked gone.
+ * The live-update path uses it to apply file monitor changes.
+ *
+ * Usage:
+ *   DirLoad *load = dirload_start(path, show_hidden, on_batch, on_done, data);
+ *   ...
+ *   dirload_cancel(load);   // navigated away: no further callbacks
+ */
+
+#ifndef BLAZENEURO_FILES_DIRLOAD_H
+#define BLAZENEURO_FILES_DIRLOAD_H
+
+#include <gio/gio.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "filesort.h"
+#include "filetype.h"
+
+#define DIRLOAD_FIRST_BATCH   128      /* entries: roughly one screenful */
+#define DIRLOAD_BATCH         2048     /* entries per later batch */
+#define DIRLOAD_FLUSH_USEC    (40 * 1000)  /* slow filesystems: flush anyway */
+
+typedef struct {
+    gchar *name;            /* search results: path relative to the root */
+    guint base;             /* offset of the basename in name */
+    gchar *key;             /* collation key of the basename; NULL: made on append */
+    const char *icon;       /* static icon name */
+    FileKind kind;
+    gboolean is_dir;
+    gboolean type_known;    /* FALSE until d_type or statx said what it is */
+    gboolean gone;          /* dirload_start_names(): no longer exists */
+} DirEntry;
+
+/* Both run on the main thread and never after dirload_cancel() */
+typedef void (*DirLoadBatchFunc)(const DirEntry *entries, guint n, gpointer data);
+typedef void (*DirLoadDoneFunc)(gboolean ok, gpointer data);
+
+typedef struct {
+    gint ref_count;
+    gchar *path;
+    gchar **names;          /* NULL: list the whole directory */
+    gboolean show_hidden;
+    GCancellable *cancellable;
+    gint64 dir_mtime;       /* ns, from the open directory; -1 if unread. Set before
+                             * the first batch is posted. */
+    DirLoadBatchFunc batch_func;
+    DirLoadDoneFunc done_func;
+    gpointer data;
+} DirLoad;
+
+typedef struct {
+    DirLoad *load;
+    GArray *entries;        /* DirEntry */
+    gboolean last;
+    gboolean ok;
+} DirLoadBatch;
+
+static DirLoad *dirload_ref(DirLoad *load) {
+    g_atomic_int_inc(&load->ref_count);
+    return load;
+}
+
+static void dirload_unref(DirLoad *load) {
+    if (!g_atomic_int_dec_and_test(&load->ref_count)) return;
+    g_object_unref(load->cancellable);
+    g_strfreev(load->names);
+    g_free(load->path);
+    g_free(load);
+}
+
+/* ── Main-thread delivery ──────────────────────────────── */
+static void _dirload_batch_free(gpointer data) {
+    DirLoadBatch *batch = data;
+    for (guint i = 0; i < batch->entries->len; i++) {
+        DirEntry *e = &g_array_index(batch->entries, DirEntry, i);
+        g_free(e->name);
+        g_free(e->key);
+    }
+    g_array_free(batch->entries, TRUE);
+    dirload_unref(batch->load);
+    g_free(batch);
+}
+
+static gboolean _dirload_deliver(gpointer data) {
+    DirLoadBatch *batch = data;
+    DirLoad *load = batch->load;
+    if (g_cancellable_is_cancelled(load->cancellable)) return G_SOURCE_REMOVE;
+
+    if (batch->entries->len > 0)
+        load->batch_func((const DirEntry *)batch->entries->data,
+                         batch->entries->len, load->data);
+    if (batch->last && load->done_func && !g_cancellable_is_cancelled(load->cancellable))
+        load->done_func(batch->ok, load->data);
+    return G_SOURCE_REMOVE;
+}
+
+/* Below redraw priority, so the first screenful paints before the rest
+ * of a large directory is inserted */
+static void _dirload_post(DirLoad *load, GArray *entries, gboolean last, gboolean ok) {
+    DirLoadBatch *batch = g_new(DirLoadBatch, 1);
+    batch->load = dirload_ref(load);
+    batch->entries = entries;
+    batch->last = last;
+    batch->ok = ok;
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, _dirload_deliver, batch, _dirload_batch_free);
+}
+
+/* ── Worker ─────────────────────────────────────────────── */
+/* Is @name (relative to @dfd) a directory? Follows symlinks. AT_STATX_DONT_SYNC
+ * lets network filesystems answer from their attribute cache. */
+static gboolean _dirload_stat_is_dir(int dfd, const char *name) {
+#ifdef STATX_TYPE
+    struct statx stx;
+    if (statx(dfd, name, AT_NO_AUTOMOUNT | AT_STATX_DONT_SYNC, STATX_TYPE, &stx) == 0)
+        return S_ISDIR(stx.stx_mode);
+    if (errno != ENOSYS) return FALSE;
+#endif
+    struct stat st;
+    return fstatat(dfd, name, &st, AT_NO_AUTOMOUNT) == 0 && S_ISDIR(st.st_mode);
+}
+
+/* Fill in the entries readdir could not type, then classify them and
+ * make their sort keys, so the main thread only copies them */
+static void _dirload_resolve(int dfd, GArray *batch) {
+    for (guint i = 0; i < batch->len; i++) {
+        DirEntry *e = &g_array_index(batch, DirEntry, i);
+        if (e->gone) continue;
+        if (!e->type_known) {
+            e->is_dir = _dirload_stat_is_dir(dfd, e->name);
+            e->type_known = TRUE;
+        }
+        e->kind = filetype_classify_name(e->name, e->is_dir);
+        e->icon = filetype_icons[e->kind];
+        e->key = files_collate_key(e->name);
+    }
+}
+
+/* The next name to report: from readdir, or from load->names */
+static gboolean _dirload_next(DirLoad *load, DIR *dir, guint *index, DirEntry *e) {
+    if (load->names) {
+        const char *name = load->names[*index];
+        if (!name) return FALSE;
+        (*index)++;
+
+        struct stat st;
+        e->name = g_strdup(name);
+        e->key = NULL;
+        e->gone = fstatat(dirfd(dir), name, &st, AT_SYMLINK_NOFOLLOW) != 0;
+        e->is_dir = !e->gone && S_ISDIR(st.st_mode);
+        e->type_known = e->gone || !S_ISLNK(st.st_mode);
+        return TRUE;
+    }
+
+    struct dirent *de = readdir(dir);
+    if (!de) return FALSE;
+    e->name = g_strdup(de->d_name);
+    e->key = NULL;
+    e->gone = FALSE;
+    e->is_dir = de->d_type == DT_DIR;
+    e->type_known = de->d_type != DT_UNKNOWN && de->d_type != DT_LNK;
+    return TRUE;
+}
+
+static gpointer _dirload_worker(gpointer data) {
+    DirLoad *load = data;
+    GArray *batch = g_array_new(FALSE, FALSE, sizeof(DirEntry));
+    guint limit = DIRLOAD_FIRST_BATCH;
+    gint64 last_post = g_get_monotonic_time();
+
+    int dfd = open(load->path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    DIR *dir = dfd >= 0 ? fdopendir(dfd) : NULL;
+    if (!dir && dfd >= 0) close(dfd);
+    struct stat st;
+    if (dir && fstat(dfd, &st) == 0)
+        load->dir_mtime = (gint64)st.st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) +
+                          st.st_mtim.tv_nsec;
+
+    if (dir) {
+        DirEntry e;
+        guint index = 0;
+        while (!g_cancellable_is_cancelled(load->cancellable) &&
+               _dirload_next(load, dir, &index, &e)) {
+            const char *name = e.name;
+            if (name[0] == '.' &&
+                (!load->show_hidden || name[1] == '\0' ||
+                 (name[1] == '.' && name[2] == '\0'))) {
+                g_free(e.name);
+                continue;
+            }
+
+            e.base = 0;
+            e.icon = NULL;
+            e.kind = FT_KIND_UNKNOWN;
+            g_array_append_val(batch, e);
+
+            if (batch->len >= limit ||
+                g_get_monotonic_time() - last_post > DIRLOAD_FLUSH_USEC) {
+                _dirload_resolve(dirfd(dir), batch);
+                _dirload_post(load, batch, FALSE, TRUE);
+                batch = g_array_new(FALSE, FALSE, sizeof(DirEntry));
+                limit = DIRLOAD_BATCH;
+                last_post = g_get_monotonic_time();
+            }
+        }
+        _dirload_resolve(dirfd(dir), batch);
+        closedir(dir);
+    }
+
+    _dirload_post(load, batch, TRUE, dir != NULL);
+    dirload_unref(load);
+    return NULL;
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+static DirLoad *_dirload_new(const char *path, const char *const *names, gboolean show_hidden,
+                             DirLoadBatchFunc batch_func, DirLoadDoneFunc done_func,
+                             gpointer data) {
+    DirLoad *load = g_new0(DirLoad, 1);
+    load->ref_count = 1;
+    load->path = g_strdup(path);
+    load->names = g_strdupv((gchar **)names);
+    load->show_hidden = show_hidden;
+    load->cancellable = g_cancellable_new();
+    load->dir_mtime = -1;
+    load->batch_func = batch_func;
+    load->done_func = done_func;
+    load->data = data;
+
+    g_thread_unref(g_thread_new("dirload", _dirload_worker, dirload_ref(load)));
+    return load;
+}
+
+static DirLoad *dirload_start(const char *path, gboolean show_hidden,
+                              DirLoadBatchFunc batch_func, DirLoadDoneFunc done_func,
+                              gpointer data) {
+    return _dirload_new(path, NULL, show_hidden, batch_func, done_func, data);
+}
+
+/* Re-examines @names (NULL-terminated) in @path */
+static DirLoad *dirload_start_names(const char *path, const char *const *names,
+                                    gboolean show_hidden, DirLoadBatchFunc batch_func,
+                                    DirLoadDoneFunc done_func, gpointer data) {
+    return _dirload_new(path, names, show_hidden, batch_func, done_func, data);
+}
+
+/* Stops the worker at its next entry and drops batches still queued */
+static void dirload_cancel(DirLoad *load) {
+    if (!load) return;
+    g_cancellable_cancel(load->cancellable);
+    dirload_unref(load);
+}
+
+#endif /* BLAZENEURO_FILES_DIRLOAD_H */
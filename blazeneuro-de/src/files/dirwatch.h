@@ -0,0 +1,135 @@
+/*
+ * BlazeNeuro Files — Directory Watch
+ * Follows changes to the open folder through a GFileMonitor (inotify on
+ * local disks) and reports them as a set of dirty names, coalesced over
+ * a short window so a burst such as `tar x` arrives in a few callbacks
+ * instead of one per event.
+ *
+ * The callback decides whether a name still exists; the watcher only
+ * says which names to look at again. A callback that returns FALSE
+ * (busy applying the previous set) keeps the names for the next tick.
+ *
+ * Usage:
+ *   DirWatch *w = dirwatch_new(path, on_changes, on_vanished, data);
+ *   ...
+ *   dirwatch_free(w);
+ */
+
+#ifndef BLAZENEURO_FILES_DIRWATCH_H
+#define BLAZENEURO_FILES_DIRWATCH_H
+
+#include <gio/gio.h>
+
+#define DIRWATCH_COALESCE_MSEC  100
+
+/* @names: NULL-terminated; owned by the watcher */
+typedef gboolean (*DirWatchFunc)(const char *const *names, gpointer data);
+typedef void (*DirWatchVanishedFunc)(gpointer data);
+
+typedef struct {
+    GFile *dir;
+    GFileMonitor *monitor;
+    GHashTable *dirty;          /* name -> NULL */
+    guint flush_source;
+    DirWatchFunc func;
+    DirWatchVanishedFunc vanished_func;
+    gpointer data;
+} DirWatch;
+
+static gboolean _dirwatch_flush(gpointer data) {
+    DirWatch *w = data;
+    guint n = g_hash_table_size(w->dirty);
+    if (n == 0) {
+        w->flush_source = 0;
+        return G_SOURCE_REMOVE;
+    }
+
+    const char **names = (const char **)g_hash_table_get_keys_as_array(w->dirty, NULL);
+    gboolean taken = w->func(names, w->data);
+    g_free(names);
+    if (!taken) return G_SOURCE_CONTINUE;
+
+    g_hash_table_remove_all(w->dirty);
+    w->flush_source = 0;
+    return G_SOURCE_REMOVE;
+}
+
+static void _dirwatch_mark(DirWatch *w, GFile *file) {
+    if (!file) return;
+    GFile *parent = g_file_get_parent(file);
+    gboolean direct = parent && g_file_equal(parent, w->dir);
+    if (parent) g_object_unref(parent);
+    if (!direct) return;
+
+    g_hash_table_add(w->dirty, g_file_get_basename(file));
+    if (!w->flush_source)
+        w->flush_source = g_timeout_add(DIRWATCH_COALESCE_MSEC, _dirwatch_flush, w);
+}
+
+static void _dirwatch_event(GFileMonitor *monitor, GFile *file, GFile *other,
+                            GFileMonitorEvent event, gpointer data) {
+    (void)monitor;
+    DirWatch *w = data;
+
+    if ((event == G_FILE_MONITOR_EVENT_DELETED || event == G_FILE_MONITOR_EVENT_MOVED_OUT) &&
+        g_file_equal(file, w->dir)) {
+        if (w->vanished_func) w->vanished_func(w->data);
+        return;
+    }
+
+    switch (event) {
+    case G_FILE_MONITOR_EVENT_RENAMED:
+        _dirwatch_mark(w, file);
+        _dirwatch_mark(w, other);
+        break;
+    case G_FILE_MONITOR_EVENT_CREATED:
+    case G_FILE_MONITOR_EVENT_DELETED:
+    case G_FILE_MONITOR_EVENT_MOVED_IN:
+    case G_FILE_MONITOR_EVENT_MOVED_OUT:
+    case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+        _dirwatch_mark(w, file);
+        break;
+    default:
+        /* CHANGED fires per write(); wait for CHANGES_DONE_HINT */
+        break;
+    }
+}
+
+/* NULL when the folder cannot be watched; it then just does not update live */
+static DirWatch *dirwatch_new(const char *path, DirWatchFunc func,
+                              DirWatchVanishedFunc vanished_func, gpointer data) {
+    GFile *dir = g_file_new_for_path(path);
+    GFileMonitor *monitor = g_file_monitor_directory(dir, G_FILE_MONITOR_WATCH_MOVES, NULL, NULL);
+    if (!monitor) {
+        g_object_unref(dir);
+        return NULL;
+    }
+
+    DirWatch *w = g_new0(DirWatch, 1);
+    w->dir = dir;
+    w->monitor = monitor;
+    w->dirty = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    w->func = func;
+    w->vanished_func = vanished_func;
+    w->data = data;
+    g_signal_connect(monitor, "changed", G_CALLBACK(_dirwatch_event), w);
+    return w;
+}
+
+/* Changes seen but not yet handed to the callback? */
+static gboolean dirwatch_pending(DirWatch *w) {
+    return w && g_hash_table_size(w->dirty) > 0;
+}
+
+static void dirwatch_free(DirWatch *w) {
+    if (!w) return;
+    if (w->flush_source) g_source_remove(w->flush_source);
+    g_signal_handlers_disconnect_by_data(w->monitor, w);
+    g_file_monitor_cancel(w->monitor);
+    g_object_unref(w->monitor);
+    g_object_unref(w->dir);
+    g_hash_table_destroy(w->dirty);
+    g_free(w);
+}
+
+#endif /* BLAZENEURO_FILES_DIRWATCH_H */
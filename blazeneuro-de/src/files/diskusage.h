@@ -0,0 +1,501 @@
+/*
+ * BlazeNeuro Files — Disk Usage Scanner
+ * Sizes a folder tree on the search walker's pool of threads (WalkPool,
+ * walker.h). Sizes are allocated bytes (st_blocks), a file with several
+ * hard links is counted once, and the scan stays on the root's
+ * filesystem without following symlinks.
+ *
+ * What each folder holds directly (its own and its files' bytes, its
+ * hard-linked inodes, its subfolders' names) is cached in
+ * ~/.cache/blazeneuro/dusizes, keyed by (dev, inode, mtime). A folder
+ * whose mtime has not moved is not read again: only its subfolders are
+ * visited, one stat each. A file rewritten in place leaves its folder's
+ * mtime alone, so a scan without the cache stays on offer.
+ *
+ * The result is a tree of folders, each one's children largest first.
+ *
+ * Usage:
+ *   DuScan *scan = du_scan_start(path, TRUE, on_done, data);
+ *   du_scan_progress(scan, &folders, &bytes);   // from a timer
+ *   du_scan_cancel(scan);     // no callback after this; also once done
+ */
+
+#ifndef BLAZENEURO_FILES_DISKUSAGE_H
+#define BLAZENEURO_FILES_DISKUSAGE_H
+
+#include <gio/gio.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "walker.h"             /* WalkPool, struct walk_dirent64 */
+
+#define DU_MAX_WORKERS   8
+#define DU_CACHE_MAGIC   0x55444e42     /* "BNDU" */
+#define DU_CACHE_VERSION 1
+#define DU_CACHE_MAX     (1 << 20)      /* records kept from earlier scans */
+
+typedef struct DuNode DuNode;
+struct DuNode {
+    gchar *name;                /* the root's is its full path */
+    DuNode *parent;
+    GPtrArray *children;        /* DuNode*, largest first */
+    guint64 size;               /* allocated bytes of everything below */
+    guint64 files;              /* non-folders below */
+    guint64 own_size;           /* the folder itself and its files */
+    guint64 own_files;
+    gboolean foreign;           /* became a mount point; dropped */
+};
+
+/* @root is the caller's to free with du_node_free(); NULL when the
+ * folder could not be read */
+typedef void (*DuDoneFunc)(DuNode *root, gpointer data);
+
+typedef struct {
+    guint64 ino;
+    guint64 size;
+} DuLink;
+
+typedef struct {
+    guint64 dev;
+    guint64 ino;
+    gint64 mtime;               /* nanoseconds */
+    guint64 own_size;           /* without the hard-linked files */
+    guint64 own_files;
+    GArray *links;              /* DuLink, files with st_nlink > 1 */
+    gchar **subdirs;
+    gboolean seen;              /* reused by this scan */
+} DuRecord;
+
+typedef struct {
+    gint ref_count;
+    gchar *root_path;
+    gboolean use_cache;
+    GCancellable *cancellable;
+    DuDoneFunc done_func;
+    gpointer data;
+
+    int root_fd;
+    dev_t root_dev;
+    DuNode *root;
+    GHashTable *cache;          /* DuRecord set from disk; read only while scanning */
+    GMutex lock;                /* the three below */
+    GHashTable *fresh;          /* DuRecord set read by this scan */
+    GHashTable *linked;         /* hard-linked inodes counted so far */
+    guint64 bytes;
+
+    WalkPool pool;              /* DuNode* items, owned by the tree */
+    char **dents;               /* one per pool thread */
+    gint folders;
+} DuScan;
+
+static DuScan *du_scan_ref(DuScan *scan) {
+    g_atomic_int_inc(&scan->ref_count);
+    return scan;
+}
+
+static void du_node_free(DuNode *node) {
+    if (!node) return;
+    if (node->children) {
+        for (guint i = 0; i < node->children->len; i++)
+            du_node_free(g_ptr_array_index(node->children, i));
+        g_ptr_array_free(node->children, TRUE);
+    }
+    g_free(node->name);
+    g_free(node);
+}
+
+static void du_scan_unref(DuScan *scan) {
+    if (!g_atomic_int_dec_and_test(&scan->ref_count)) return;
+    walk_pool_clear(&scan->pool);
+    if (scan->root_fd >= 0) close(scan->root_fd);
+    if (scan->cache) g_hash_table_destroy(scan->cache);
+    if (scan->fresh) g_hash_table_destroy(scan->fresh);
+    if (scan->linked) g_hash_table_destroy(scan->linked);
+    du_node_free(scan->root);
+    g_mutex_clear(&scan->lock);
+    g_object_unref(scan->cancellable);
+    g_free(scan->root_path);
+    g_free(scan);
+}
+
+static DuNode *_du_node_new(DuNode *parent, const char *name) {
+    DuNode *node = g_new0(DuNode, 1);
+    node->name = g_strdup(name);
+    node->parent = parent;
+    if (parent) {
+        if (!parent->children) parent->children = g_ptr_array_new();
+        g_ptr_array_add(parent->children, node);
+    }
+    return node;
+}
+
+/* @node's path below the root, "." for the root */
+static gchar *_du_rel_path(DuNode *node) {
+    if (!node->parent) return g_strdup(".");
+    GPtrArray *parts = g_ptr_array_new();
+    for (DuNode *n = node; n->parent; n = n->parent) g_ptr_array_insert(parts, 0, n->name);
+    g_ptr_array_add(parts, NULL);
+    gchar *rel = g_strjoinv("/", (gchar **)parts->pdata);
+    g_ptr_array_free(parts, TRUE);
+    return rel;
+}
+
+/* ── Cache ──────────────────────────────────────────────── */
+static gchar *du_cache_file(void) {
+    return g_build_filename(g_get_user_cache_dir(), "blazeneuro", "dusizes", NULL);
+}
+
+static guint _du_record_hash(gconstpointer key) {
+    const DuRecord *r = key;
+    return (guint)(r->ino ^ (r->ino >> 32) ^ (r->dev * 31));
+}
+
+static gboolean _du_record_equal(gconstpointer a, gconstpointer b) {
+    const DuRecord *x = a, *y = b;
+    return x->ino == y->ino && x->dev == y->dev;
+}
+
+static void _du_record_free(gpointer data) {
+    DuRecord *r = data;
+    if (r->links) g_array_free(r->links, TRUE);
+    g_strfreev(r->subdirs);
+    g_free(r);
+}
+
+static GHashTable *_du_records_new(void) {
+    return g_hash_table_new_full(_du_record_hash, _du_record_equal, _du_record_free, NULL);
+}
+
+/* Bounds-checked reads from the cache file */
+typedef struct {
+    const guchar *p;
+    const guchar *end;
+} DuReader;
+
+static gboolean _du_read(DuReader *r, void *out, gsize len) {
+    if ((gsize)(r->end - r->p) < len) return FALSE;
+    memcpy(out, r->p, len);
+    r->p += len;
+    return TRUE;
+}
+
+/* Header (magic, version, count), then per record: dev, ino, mtime,
+ * own_size, own_files, the link count and the links, the subfolder
+ * count and each name as a 16-bit length and bytes */
+static GHashTable *_du_cache_load(void) {
+    GHashTable *records = _du_records_new();
+    gchar *file = du_cache_file();
+    gchar *contents = NULL;
+    gsize len = 0;
+    if (!g_file_get_contents(file, &contents, &len, NULL)) {
+        g_free(file);
+        return records;
+    }
+    DuReader r = { (const guchar *)contents, (const guchar *)contents + len };
+    guint32 magic = 0, version = 0, count = 0;
+    if (_du_read(&r, &magic, 4) && _du_read(&r, &version, 4) && _du_read(&r, &count, 4) &&
+        magic == DU_CACHE_MAGIC && version == DU_CACHE_VERSION) {
+        for (guint32 i = 0; i < count; i++) {
+            DuRecord *rec = g_new0(DuRecord, 1);
+            guint32 n_links = 0, n_subdirs = 0;
+            gboolean ok = _du_read(&r, &rec->dev, 8) && _du_read(&r, &rec->ino, 8) &&
+                          _du_read(&r, &rec->mtime, 8) && _du_read(&r, &rec->own_size, 8) &&
+                          _du_read(&r, &rec->own_files, 8) && _du_read(&r, &n_links, 4) &&
+                          (gsize)(r.end - r.p) / sizeof(DuLink) >= n_links;
+            if (ok) {
+                rec->links = g_array_sized_new(FALSE, FALSE, sizeof(DuLink), n_links);
+                g_array_append_vals(rec->links, r.p, n_links);
+                r.p += n_links * sizeof(DuLink);
+                ok = _du_read(&r, &n_subdirs, 4) && (gsize)(r.end - r.p) / 2 >= n_subdirs;
+            }
+            if (ok) {
+                rec->subdirs = g_new0(gchar *, n_subdirs + 1);
+                for (guint32 j = 0; j < n_subdirs && ok; j++) {
+                    guint16 name_len = 0;
+                    ok = _du_read(&r, &name_len, 2) && (gsize)(r.end - r.p) >= name_len;
+                    if (ok) {
+                        rec->subdirs[j] = g_strndup((const char *)r.p, name_len);
+                        r.p += name_len;
+                    }
+                }
+            }
+            if (!ok) {
+                _du_record_free(rec);
+                break;
+            }
+            g_hash_table_add(records, rec);
+        }
+    }
+    g_free(contents);
+    g_free(file);
+    return records;
+}
+
+static void _du_write_record(GByteArray *out, const DuRecord *rec) {
+    guint32 n_links = rec->links ? rec->links->len : 0;
+    guint32 n_subdirs = rec->subdirs ? g_strv_length(rec->subdirs) : 0;
+    g_byte_array_append(out, (const guint8 *)&rec->dev, 8);
+    g_byte_array_append(out, (const guint8 *)&rec->ino, 8);
+    g_byte_array_append(out, (const guint8 *)&rec->mtime, 8);
+    g_byte_array_append(out, (const guint8 *)&rec->own_size, 8);
+    g_byte_array_append(out, (const guint8 *)&rec->own_files, 8);
+    g_byte_array_append(out, (const guint8 *)&n_links, 4);
+    if (n_links) g_byte_array_append(out, (const guint8 *)rec->links->data, n_links * sizeof(DuLink));
+    g_byte_array_append(out, (const guint8 *)&n_subdirs, 4);
+    for (guint32 i = 0; i < n_subdirs; i++) {
+        guint16 len = (guint16)MIN(strlen(rec->subdirs[i]), G_MAXUINT16);
+        g_byte_array_append(out, (const guint8 *)&len, 2);
+        g_byte_array_append(out, (const guint8 *)rec->subdirs[i], len);
+    }
+}
+
+/* What this scan read, plus what earlier scans read elsewhere; once
+ * that grows past DU_CACHE_MAX, only what this scan saw is kept */
+static void _du_cache_save(DuScan *scan) {
+    gboolean keep_old = g_hash_table_size(scan->cache) + g_hash_table_size(scan->fresh) <= DU_CACHE_MAX;
+    GByteArray *out = g_byte_array_new();
+    guint32 header[3] = { DU_CACHE_MAGIC, DU_CACHE_VERSION, 0 };
+    g_byte_array_append(out, (const guint8 *)header, sizeof(header));
+
+    guint32 count = 0;
+    GHashTableIter iter;
+    gpointer key;
+    g_hash_table_iter_init(&iter, scan->fresh);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        _du_write_record(out, key);
+        count++;
+    }
+    g_hash_table_iter_init(&iter, scan->cache);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        DuRecord *rec = key;
+        if (g_hash_table_contains(scan->fresh, rec) || (!keep_old && !rec->seen)) continue;
+        _du_write_record(out, rec);
+        count++;
+    }
+    memcpy(out->data + 8, &count, 4);
+
+    gchar *file = du_cache_file();
+    gchar *dir = g_path_get_dirname(file);
+    g_mkdir_with_parents(dir, 0700);
+    g_file_set_contents(file, (const gchar *)out->data, (gssize)out->len, NULL);
+    g_free(dir);
+    g_free(file);
+    g_byte_array_free(out, TRUE);
+}
+
+/* ── Worker ─────────────────────────────────────────────── */
+/* Bytes of the hard-linked files not counted yet; @scan->lock held */
+static guint64 _du_count_links(DuScan *scan, const GArray *links) {
+    guint64 bytes = 0;
+    for (guint i = 0; links && i < links->len; i++) {
+        const DuLink *l = &g_array_index(links, DuLink, i);
+        if (g_hash_table_contains(scan->linked, &l->ino)) continue;
+        gint64 *ino = g_new(gint64, 1);
+        *ino = (gint64)l->ino;
+        g_hash_table_add(scan->linked, ino);
+        bytes += l->size;
+    }
+    return bytes;
+}
+
+/* Replays a cached folder: its subfolders are queued, nothing is read */
+static void _du_replay(DuScan *scan, guint worker, DuNode *node, DuRecord *rec) {
+    rec->seen = TRUE;
+    g_mutex_lock(&scan->lock);
+    guint64 linked = _du_count_links(scan, rec->links);
+    scan->bytes += rec->own_size + linked;
+    g_mutex_unlock(&scan->lock);
+    node->own_size = rec->own_size + linked;
+    node->own_files = rec->own_files;
+    for (gchar **s = rec->subdirs; s && *s; s++)
+        walk_pool_push(&scan->pool, worker, _du_node_new(node, *s));
+}
+
+static void _du_dir(guint worker, gpointer item, gpointer data) {
+    DuScan *scan = data;
+    DuNode *node = item;
+    char *dents = scan->dents[worker];
+    gchar *rel = _du_rel_path(node);
+    int fd = openat(scan->root_fd, rel, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    g_free(rel);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_dev != scan->root_dev) {
+        node->foreign = TRUE;
+        close(fd);
+        return;
+    }
+    g_atomic_int_inc(&scan->folders);
+
+    DuRecord probe = { .dev = st.st_dev, .ino = st.st_ino };
+    DuRecord *cached = scan->use_cache ? g_hash_table_lookup(scan->cache, &probe) : NULL;
+    gint64 mtime = (gint64)st.st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) + st.st_mtim.tv_nsec;
+    if (cached && cached->mtime == mtime) {
+        _du_replay(scan, worker, node, cached);
+        close(fd);
+        return;
+    }
+
+    /* mtime is taken before reading, so a change made meanwhile makes
+     * the next scan read the folder again */
+    DuRecord *rec = g_new0(DuRecord, 1);
+    rec->dev = st.st_dev;
+    rec->ino = st.st_ino;
+    rec->mtime = mtime;
+    rec->own_size = (guint64)st.st_blocks * 512;
+    rec->links = g_array_new(FALSE, FALSE, sizeof(DuLink));
+    GPtrArray *subdirs = g_ptr_array_new();
+
+    long n;
+    while (!g_cancellable_is_cancelled(scan->cancellable) &&
+           (n = syscall(SYS_getdents64, fd, dents, WALK_DENTS_BUF)) > 0) {
+        for (long off = 0; off < n;) {
+            struct walk_dirent64 *de = (struct walk_dirent64 *)(dents + off);
+            off += de->d_reclen;
+            const char *name = de->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                continue;
+
+            struct stat cst;
+            if (fstatat(fd, name, &cst, AT_SYMLINK_NOFOLLOW) != 0) continue;
+            if (S_ISDIR(cst.st_mode)) {
+                if (cst.st_dev != scan->root_dev) continue;
+                g_ptr_array_add(subdirs, g_strdup(name));
+                walk_pool_push(&scan->pool, worker, _du_node_new(node, name));
+                continue;
+            }
+            guint64 bytes = (guint64)cst.st_blocks * 512;
+            rec->own_files++;
+            if (cst.st_nlink > 1) {
+                DuLink link = { (guint64)cst.st_ino, bytes };
+                g_array_append_val(rec->links, link);
+            } else {
+                rec->own_size += bytes;
+            }
+        }
+    }
+    close(fd);
+    g_ptr_array_add(subdirs, NULL);
+    rec->subdirs = (gchar **)g_ptr_array_free(subdirs, FALSE);
+
+    node->own_files = rec->own_files;
+    g_mutex_lock(&scan->lock);
+    guint64 linked = _du_count_links(scan, rec->links);
+    scan->bytes += rec->own_size + linked;
+    if (g_cancellable_is_cancelled(scan->cancellable)) _du_record_free(rec);
+    else g_hash_table_replace(scan->fresh, rec, NULL);
+    g_mutex_unlock(&scan->lock);
+    node->own_size = rec->own_size + linked;
+}
+
+/* ── Totals ─────────────────────────────────────────────── */
+static gint _du_by_size(gconstpointer a, gconstpointer b) {
+    const DuNode *x = *(DuNode *const *)a, *y = *(DuNode *const *)b;
+    return x->size < y->size ? 1 : x->size > y->size ? -1 : g_strcmp0(x->name, y->name);
+}
+
+static void _du_total(DuNode *node) {
+    node->size = node->own_size;
+    node->files = node->own_files;
+    if (!node->children) return;
+    for (guint i = 0; i < node->children->len;) {
+        DuNode *child = g_ptr_array_index(node->children, i);
+        if (child->foreign) {
+            du_node_free(child);
+            g_ptr_array_remove_index_fast(node->children, i);
+            continue;
+        }
+        _du_total(child);
+        node->size += child->size;
+        node->files += child->files;
+        i++;
+    }
+    g_ptr_array_sort(node->children, _du_by_size);
+}
+
+/* ── Main-thread delivery ──────────────────────────────── */
+static gboolean _du_deliver(gpointer data) {
+    DuScan *scan = data;
+    if (g_cancellable_is_cancelled(scan->cancellable)) return G_SOURCE_REMOVE;
+    DuNode *root = scan->root;
+    scan->root = NULL;
+    scan->done_func(root, scan->data);
+    return G_SOURCE_REMOVE;
+}
+
+static void _du_post(DuScan *scan) {
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, _du_deliver, du_scan_ref(scan),
+                    (GDestroyNotify)du_scan_unref);
+}
+
+/* Loads the cache, runs the workers, then totals and saves */
+static gpointer _du_run(gpointer data) {
+    DuScan *scan = data;
+    scan->cache = _du_cache_load();
+
+    struct stat st;
+    scan->root_fd = open(scan->root_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (scan->root_fd < 0 || fstat(scan->root_fd, &st) != 0) {
+        _du_post(scan);
+        du_scan_unref(scan);
+        return NULL;
+    }
+    scan->root_dev = st.st_dev;
+    scan->root = _du_node_new(NULL, scan->root_path);
+
+    scan->dents = g_new(char *, scan->pool.n_workers);
+    for (guint i = 0; i < scan->pool.n_workers; i++) scan->dents[i] = g_malloc(WALK_DENTS_BUF);
+    walk_pool_run(&scan->pool, scan->root);
+    for (guint i = 0; i < scan->pool.n_workers; i++) g_free(scan->dents[i]);
+    g_clear_pointer(&scan->dents, g_free);
+
+    if (!g_cancellable_is_cancelled(scan->cancellable)) {
+        _du_total(scan->root);
+        _du_cache_save(scan);
+        _du_post(scan);
+    }
+    du_scan_unref(scan);
+    return NULL;
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+/* @use_cache FALSE reads every folder, and refreshes the cache */
+static DuScan *du_scan_start(const char *root, gboolean use_cache, DuDoneFunc done_func,
+                             gpointer data) {
+    DuScan *scan = g_new0(DuScan, 1);
+    scan->ref_count = 1;
+    scan->root_path = g_strdup(root);
+    scan->use_cache = use_cache;
+    scan->cancellable = g_cancellable_new();
+    scan->done_func = done_func;
+    scan->data = data;
+    scan->root_fd = -1;
+    scan->fresh = _du_records_new();
+    scan->linked = g_hash_table_new_full(g_int64_hash, g_int64_equal, g_free, NULL);
+    g_mutex_init(&scan->lock);
+    walk_pool_init(&scan->pool, DU_MAX_WORKERS, "du", scan->cancellable, _du_dir, NULL, NULL,
+                   scan);
+    g_thread_unref(g_thread_new("du-scan", _du_run, du_scan_ref(scan)));
+    return scan;
+}
+
+static void du_scan_progress(DuScan *scan, guint *folders, guint64 *bytes) {
+    *folders = (guint)g_atomic_int_get(&scan->folders);
+    g_mutex_lock(&scan->lock);
+    *bytes = scan->bytes;
+    g_mutex_unlock(&scan->lock);
+}
+
+/* Stops the workers at their next folder; the callback will not run */
+static void du_scan_cancel(DuScan *scan) {
+    if (!scan) return;
+    g_cancellable_cancel(scan->cancellable);
+    du_scan_unref(scan);
+}
+
+#endif /* BLAZENEURO_FILES_DISKUSAGE_H */
@@ -0,0 +1,568 @@
+/*
+ * BlazeNeuro Files — Duplicate Finder
+ * Finds files with the same contents below a folder, in stages that
+ * each read only what the one before could not settle:
+ *   1. size, from the walk: a file of a size nobody else has is unique;
+ *   2. a hash of its first and last DUP_EDGE bytes: most same-sized
+ *      files differ near one end (headers, trailers, appended data);
+ *   3. a hash of everything, for the files still paired.
+ * Hashes are XXH3 (libxxhash), which runs at memory bandwidth on
+ * SSE2/AVX2, so the disks stay the limit. Stage 3 reads on DUP_READERS
+ * threads in DUP_READ_BLOCK reads, taking files in inode order (close
+ * to disk order on ext4 and XFS), telling the kernel each read is
+ * sequential and dropping the pages behind it, so a scan of a large
+ * home neither seeks more than it must nor flushes the page cache.
+ *
+ * Hard links to one inode count as one file: they take no extra space.
+ * The walk runs on the search walker's pool (walker.h), stays on the
+ * folder's filesystem and skips symlinks, empty files and, unless
+ * asked, hidden ones.
+ *
+ * fileop_dedupe() replaces duplicates with hard links to a kept copy,
+ * as a job on the file operations queue (fileops.h).
+ *
+ * Usage:
+ *   DupScan *scan = dup_scan_start(path, show_hidden, on_done, data);
+ *   dup_scan_progress(scan, &p);      // from a timer
+ *   dup_scan_cancel(scan);            // no callback after this; also once done
+ *   FileOp *op = fileop_dedupe(pairs, &callbacks, data);
+ */
+
+#ifndef BLAZENEURO_FILES_DUPFIND_H
+#define BLAZENEURO_FILES_DUPFIND_H
+
+#include <gio/gio.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <xxhash.h>
+
+#include "fileops.h"
+#include "walker.h"             /* WalkPool, struct walk_dirent64 */
+
+#define DUP_MAX_WALKERS   8
+#define DUP_READERS       4             /* files hashed at once */
+#define DUP_EDGE          (16 << 10)    /* bytes hashed at each end in stage 2 */
+#define DUP_READ_BLOCK    (1 << 20)
+
+typedef enum {
+    DUP_STAGE_WALK,
+    DUP_STAGE_EDGES,
+    DUP_STAGE_FULL,
+} DupStage;
+
+typedef struct {
+    DupStage stage;
+    guint files;                /* found by the walk */
+    guint64 bytes_done;         /* read by the current stage */
+    guint64 bytes_total;
+} DupProgress;
+
+/* Files with the same contents, by path */
+typedef struct {
+    guint64 size;
+    GPtrArray *paths;           /* gchar* */
+} DupGroup;
+
+/* @groups (DupGroup*, most space wasted first) is the caller's to free
+ * with g_ptr_array_free(); NULL when the folder could not be read */
+typedef void (*DupDoneFunc)(GPtrArray *groups, gpointer data);
+
+typedef struct {
+    const char *path;           /* in the walker's string chunk */
+    guint64 size;
+    guint64 ino;
+    gint64 mtime;               /* ns; a file changed since is dropped */
+    guint64 hash;
+    gboolean failed;            /* unreadable or changed: not a duplicate */
+} DupFile;
+
+typedef struct DupScan DupScan;
+
+typedef struct {
+    GStringChunk *strings;
+    GArray *files;              /* DupFile */
+    char *dents;
+} DupWalker;
+
+struct DupScan {
+    gint ref_count;
+    gchar *root_path;
+    gboolean show_hidden;
+    GCancellable *cancellable;
+    DupDoneFunc done_func;
+    gpointer data;
+    GPtrArray *groups;
+
+    dev_t root_dev;
+    WalkPool pool;              /* gchar* full paths of folders */
+    DupWalker *walkers;         /* one per pool thread */
+    GMutex lock;                /* bytes_done and bytes_total */
+
+    gint stage;
+    gint files;
+    gint64 bytes_done;
+    gint64 bytes_total;
+};
+
+static void _dup_group_free(gpointer data) {
+    DupGroup *g = data;
+    g_ptr_array_free(g->paths, TRUE);
+    g_free(g);
+}
+
+static void _dup_scan_unref(DupScan *scan) {
+    if (!g_atomic_int_dec_and_test(&scan->ref_count)) return;
+    for (guint i = 0; i < scan->pool.n_workers; i++) {
+        if (scan->walkers[i].strings) g_string_chunk_free(scan->walkers[i].strings);
+        if (scan->walkers[i].files) g_array_free(scan->walkers[i].files, TRUE);
+    }
+    g_free(scan->walkers);
+    walk_pool_clear(&scan->pool);
+    if (scan->groups) g_ptr_array_free(scan->groups, TRUE);
+    g_mutex_clear(&scan->lock);
+    g_object_unref(scan->cancellable);
+    g_free(scan->root_path);
+    g_free(scan);
+}
+
+static gboolean _dup_cancelled(DupScan *scan) {
+    return g_cancellable_is_cancelled(scan->cancellable);
+}
+
+/* ── Stage 1: walk ──────────────────────────────────────── */
+static void _dup_dir(guint worker, gpointer item, gpointer data) {
+    DupScan *scan = data;
+    DupWalker *w = &scan->walkers[worker];
+    const char *dir = item;
+    /* The root may itself be a symlink to a folder (a linked ~/Documents);
+     * only the subfolders the walk finds are held to O_NOFOLLOW */
+    int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+    if (strcmp(dir, scan->root_path) != 0) flags |= O_NOFOLLOW;
+    int fd = open(dir, flags);
+    if (fd < 0) return;
+
+    long n;
+    while (!_dup_cancelled(scan) && (n = syscall(SYS_getdents64, fd, w->dents, WALK_DENTS_BUF)) > 0) {
+        for (long off = 0; off < n;) {
+            struct walk_dirent64 *de = (struct walk_dirent64 *)(w->dents + off);
+            off += de->d_reclen;
+            const char *name = de->d_name;
+            if (name[0] == '.' &&
+                (!scan->show_hidden || name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                continue;
+            if (de->d_type == DT_LNK) continue;
+
+            struct stat st;
+            if (fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0 || st.st_dev != scan->root_dev)
+                continue;
+            if (S_ISDIR(st.st_mode)) {
+                walk_pool_push(&scan->pool, worker, g_build_filename(dir, name, NULL));
+            } else if (S_ISREG(st.st_mode) && st.st_size > 0) {
+                gchar *path = g_build_filename(dir, name, NULL);
+                DupFile f = { 0 };
+                f.path = g_string_chunk_insert(w->strings, path);
+                f.size = (guint64)st.st_size;
+                f.ino = (guint64)st.st_ino;
+                f.mtime = (gint64)st.st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) +
+                          st.st_mtim.tv_nsec;
+                g_array_append_val(w->files, f);
+                g_atomic_int_inc(&scan->files);
+                g_free(path);
+            }
+        }
+    }
+    close(fd);
+}
+
+/* ── Stages 2 and 3: hashing ────────────────────────────── */
+static GPrivate dup_buffer = G_PRIVATE_INIT(g_free);
+
+static guchar *_dup_buffer(void) {
+    guchar *buf = g_private_get(&dup_buffer);
+    if (!buf) {
+        buf = g_malloc(DUP_READ_BLOCK);
+        g_private_set(&dup_buffer, buf);
+    }
+    return buf;
+}
+
+/* O_NOATIME where we own the file, so hashing leaves atimes alone */
+static int _dup_open(const char *path) {
+    int fd = open(path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC | O_NOATIME);
+    if (fd < 0 && errno == EPERM) fd = open(path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    return fd;
+}
+
+static gboolean _dup_unchanged(int fd, const DupFile *f) {
+    struct stat st;
+    return fstat(fd, &st) == 0 && (guint64)st.st_size == f->size && (guint64)st.st_ino == f->ino &&
+           (gint64)st.st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) + st.st_mtim.tv_nsec == f->mtime;
+}
+
+static gboolean _dup_read_at(int fd, guchar *buf, gsize len, off_t offset) {
+    for (gsize done = 0; done < len;) {
+        ssize_t n = pread(fd, buf + done, len - done, offset + (off_t)done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return FALSE;
+        done += (gsize)n;
+    }
+    return TRUE;
+}
+
+/* Files of up to 2 * DUP_EDGE are read whole, which settles them */
+static gboolean _dup_edges_are_all(guint64 size) {
+    return size <= 2 * DUP_EDGE;
+}
+
+static void _dup_hash_edges(DupScan *scan, DupFile *f) {
+    int fd = _dup_open(f->path);
+    if (fd < 0 || !_dup_unchanged(fd, f)) {
+        f->failed = TRUE;
+        if (fd >= 0) close(fd);
+        return;
+    }
+    guchar *buf = _dup_buffer();
+    gsize len;
+    gboolean ok;
+    if (_dup_edges_are_all(f->size)) {
+        len = (gsize)f->size;
+        ok = _dup_read_at(fd, buf, len, 0);
+    } else {
+        len = 2 * DUP_EDGE;
+        ok = _dup_read_at(fd, buf, DUP_EDGE, 0) &&
+             _dup_read_at(fd, buf + DUP_EDGE, DUP_EDGE, (off_t)(f->size - DUP_EDGE));
+    }
+    close(fd);
+    if (ok) f->hash = XXH3_64bits(buf, len);
+    else f->failed = TRUE;
+    g_mutex_lock(&scan->lock);
+    scan->bytes_done += len;
+    g_mutex_unlock(&scan->lock);
+}
+
+static void _dup_hash_full(DupScan *scan, DupFile *f) {
+    int fd = _dup_open(f->path);
+    if (fd < 0 || !_dup_unchanged(fd, f)) {
+        f->failed = TRUE;
+        if (fd >= 0) close(fd);
+        return;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    guchar *buf = _dup_buffer();
+    XXH3_state_t *state = XXH3_createState();
+    XXH3_64bits_reset(state);
+
+    guint64 off = 0;
+    while (off < f->size && !_dup_cancelled(scan)) {
+        ssize_t n = read(fd, buf, DUP_READ_BLOCK);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        XXH3_64bits_update(state, buf, (size_t)n);
+        /* Read once: keep the page cache for what the user is doing */
+        posix_fadvise(fd, (off_t)off, n, POSIX_FADV_DONTNEED);
+        off += (guint64)n;
+        g_mutex_lock(&scan->lock);
+        scan->bytes_done += (guint64)n;
+        g_mutex_unlock(&scan->lock);
+    }
+    if (off == f->size && _dup_unchanged(fd, f)) f->hash = XXH3_64bits_digest(state);
+    else f->failed = TRUE;
+    XXH3_freeState(state);
+    close(fd);
+}
+
+static void _dup_hash_one(gpointer item, gpointer data) {
+    DupScan *scan = data;
+    if (_dup_cancelled(scan)) return;
+    if (scan->stage == DUP_STAGE_EDGES) _dup_hash_edges(scan, item);
+    else _dup_hash_full(scan, item);
+}
+
+static gint _dup_by_ino(gconstpointer a, gconstpointer b) {
+    const DupFile *x = *(DupFile *const *)a, *y = *(DupFile *const *)b;
+    return x->ino < y->ino ? -1 : x->ino > y->ino;
+}
+
+/* Hashes @files (DupFile*) on the readers, in inode order */
+static void _dup_hash(DupScan *scan, DupStage stage, GPtrArray *files) {
+    guint64 total = 0;
+    for (guint i = 0; i < files->len; i++) {
+        const DupFile *f = files->pdata[i];
+        total += stage == DUP_STAGE_FULL ? f->size : MIN(f->size, 2 * DUP_EDGE);
+    }
+    g_mutex_lock(&scan->lock);
+    scan->bytes_done = 0;
+    scan->bytes_total = (gint64)total;
+    g_mutex_unlock(&scan->lock);
+    g_atomic_int_set(&scan->stage, stage);
+
+    g_ptr_array_sort(files, _dup_by_ino);
+    GThreadPool *pool = g_thread_pool_new(_dup_hash_one, scan, DUP_READERS, FALSE, NULL);
+    for (guint i = 0; i < files->len; i++) g_thread_pool_push(pool, files->pdata[i], NULL);
+    g_thread_pool_free(pool, FALSE, TRUE);
+}
+
+/* ── Grouping ───────────────────────────────────────────── */
+static gint _dup_by_content(gconstpointer a, gconstpointer b) {
+    const DupFile *x = *(DupFile *const *)a, *y = *(DupFile *const *)b;
+    if (x->size != y->size) return x->size < y->size ? -1 : 1;
+    if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+    return x->ino < y->ino ? -1 : x->ino > y->ino;
+}
+
+/* Keeps the files that share their size and hash with another inode;
+ * extra links to one inode go */
+static GPtrArray *_dup_narrow(GPtrArray *files) {
+    g_ptr_array_sort(files, _dup_by_content);
+    GPtrArray *out = g_ptr_array_new();
+    for (guint i = 0; i < files->len;) {
+        const DupFile *first = files->pdata[i];
+        guint j = i, inodes = 0;
+        guint64 last_ino = 0;
+        for (; j < files->len; j++) {
+            const DupFile *f = files->pdata[j];
+            if (f->size != first->size || f->hash != first->hash) break;
+            if (!f->failed && (inodes == 0 || f->ino != last_ino)) {
+                inodes++;
+                last_ino = f->ino;
+            }
+        }
+        if (inodes > 1) {
+            last_ino = 0;
+            for (guint k = i; k < j; k++) {
+                DupFile *f = files->pdata[k];
+                if (f->failed || f->ino == last_ino) continue;
+                last_ino = f->ino;
+                g_ptr_array_add(out, f);
+            }
+        }
+        i = j;
+    }
+    g_ptr_array_free(files, TRUE);
+    return out;
+}
+
+static gint _dup_by_waste(gconstpointer a, gconstpointer b) {
+    const DupGroup *x = *(DupGroup *const *)a, *y = *(DupGroup *const *)b;
+    guint64 wx = x->size * (x->paths->len - 1), wy = y->size * (y->paths->len - 1);
+    return wx < wy ? 1 : wx > wy ? -1 : 0;
+}
+
+static gint _dup_by_path(gconstpointer a, gconstpointer b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+static GPtrArray *_dup_groups(GPtrArray *files) {
+    GPtrArray *groups = g_ptr_array_new_with_free_func(_dup_group_free);
+    for (guint i = 0; i < files->len;) {
+        const DupFile *first = files->pdata[i];
+        DupGroup *g = g_new0(DupGroup, 1);
+        g->size = first->size;
+        g->paths = g_ptr_array_new_with_free_func(g_free);
+        for (; i < files->len; i++) {
+            const DupFile *f = files->pdata[i];
+            if (f->size != first->size || f->hash != first->hash) break;
+            g_ptr_array_add(g->paths, g_strdup(f->path));
+        }
+        g_ptr_array_sort(g->paths, _dup_by_path);
+        g_ptr_array_add(groups, g);
+    }
+    g_ptr_array_sort(groups, _dup_by_waste);
+    return groups;
+}
+
+/* ── Main-thread delivery ──────────────────────────────── */
+static gboolean _dup_deliver(gpointer data) {
+    DupScan *scan = data;
+    if (_dup_cancelled(scan)) return G_SOURCE_REMOVE;
+    GPtrArray *groups = scan->groups;
+    scan->groups = NULL;
+    scan->done_func(groups, scan->data);
+    return G_SOURCE_REMOVE;
+}
+
+static gpointer _dup_run(gpointer data) {
+    DupScan *scan = data;
+    struct stat st;
+    if (stat(scan->root_path, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, _dup_deliver, scan,
+                        (GDestroyNotify)_dup_scan_unref);
+        return NULL;
+    }
+    scan->root_dev = st.st_dev;
+
+    for (guint i = 0; i < scan->pool.n_workers; i++) {
+        DupWalker *w = &scan->walkers[i];
+        w->strings = g_string_chunk_new(64 * 1024);
+        w->files = g_array_new(FALSE, FALSE, sizeof(DupFile));
+        w->dents = g_malloc(WALK_DENTS_BUF);
+    }
+    walk_pool_run(&scan->pool, g_strdup(scan->root_path));
+    for (guint i = 0; i < scan->pool.n_workers; i++) g_clear_pointer(&scan->walkers[i].dents, g_free);
+
+    /* Stage 1 needs no reading: the hash is 0 for everyone */
+    GPtrArray *files = g_ptr_array_new();
+    for (guint i = 0; i < scan->pool.n_workers; i++) {
+        GArray *wf = scan->walkers[i].files;
+        for (guint k = 0; k < wf->len; k++) g_ptr_array_add(files, &g_array_index(wf, DupFile, k));
+    }
+    files = _dup_narrow(files);
+
+    if (!_dup_cancelled(scan)) {
+        _dup_hash(scan, DUP_STAGE_EDGES, files);
+        files = _dup_narrow(files);
+    }
+    if (!_dup_cancelled(scan)) {
+        GPtrArray *rest = g_ptr_array_new();
+        for (guint i = 0; i < files->len; i++) {
+            DupFile *f = files->pdata[i];
+            if (!_dup_edges_are_all(f->size)) g_ptr_array_add(rest, f);
+        }
+        _dup_hash(scan, DUP_STAGE_FULL, rest);
+        g_ptr_array_free(rest, TRUE);
+        files = _dup_narrow(files);
+    }
+    if (!_dup_cancelled(scan)) scan->groups = _dup_groups(files);
+    g_ptr_array_free(files, TRUE);
+
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, _dup_deliver, scan, (GDestroyNotify)_dup_scan_unref);
+    return NULL;
+}
+
+/* ── Hard links ─────────────────────────────────────────── */
+/* Byte for byte, as the last word before one of them is replaced */
+static gboolean _dup_same_contents(FileOp *op, const char *a, const char *b, guint64 size) {
+    int fa = _dup_open(a), fb = _dup_open(b);
+    gboolean same = fa >= 0 && fb >= 0;
+    guchar *ba = same ? g_malloc(DUP_READ_BLOCK) : NULL;
+    guchar *bb = same ? g_malloc(DUP_READ_BLOCK) : NULL;
+    if (same) {
+        posix_fadvise(fa, 0, 0, POSIX_FADV_SEQUENTIAL);
+        posix_fadvise(fb, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+    for (guint64 off = 0; same && off < size && !_fileop_cancelled(op);) {
+        gsize len = (gsize)MIN(size - off, DUP_READ_BLOCK);
+        same = _dup_read_at(fa, ba, len, (off_t)off) && _dup_read_at(fb, bb, len, (off_t)off) &&
+               memcmp(ba, bb, len) == 0;
+        off += len;
+        _fileop_add(op, len, 0);
+    }
+    g_free(ba);
+    g_free(bb);
+    if (fa >= 0) close(fa);
+    if (fb >= 0) close(fb);
+    return same && !_fileop_cancelled(op);
+}
+
+/* @dup becomes a link to @keep: made beside it, then renamed over it,
+ * so @dup is never missing */
+static void _dup_link(FileOp *op, const char *keep, const char *dup) {
+    struct stat ks, ds;
+    if (lstat(keep, &ks) != 0) {
+        _fileop_fail(op, keep);
+        return;
+    }
+    if (lstat(dup, &ds) != 0) {
+        _fileop_fail(op, dup);
+        return;
+    }
+    if (ks.st_dev == ds.st_dev && ks.st_ino == ds.st_ino) {
+        _fileop_add(op, (guint64)ds.st_size, 1);   /* linked already */
+        return;
+    }
+    if (!S_ISREG(ks.st_mode) || !S_ISREG(ds.st_mode) || ks.st_size != ds.st_size ||
+        !_dup_same_contents(op, keep, dup, (guint64)ks.st_size)) {
+        if (!_fileop_cancelled(op))
+            _fileop_fail_with(op, dup, "it no longer matches the copy being kept");
+        return;
+    }
+
+    gchar *dir = g_path_get_dirname(dup);
+    gchar *base = g_path_get_basename(dup);
+    for (guint tries = 0; tries < 100; tries++) {
+        gchar *tmp = g_strdup_printf("%s/.%s.link-%08x", dir, base, g_random_int());
+        if (link(keep, tmp) != 0) {
+            int err = errno;
+            g_free(tmp);
+            if (err == EEXIST) continue;
+            errno = err;
+            _fileop_fail(op, dup);
+            break;
+        }
+        if (rename(tmp, dup) != 0) {
+            _fileop_fail(op, dup);
+            unlink(tmp);
+        } else {
+            _fileop_add(op, 0, 1);
+        }
+        g_free(tmp);
+        break;
+    }
+    g_free(base);
+    g_free(dir);
+}
+
+/* sources: pairs of the file kept and the one to link to it */
+static void _dup_run_dedupe(FileOp *op) {
+    for (gchar **s = op->sources; s[0] && s[1]; s += 2) {
+        struct stat st;
+        g_mutex_lock(&op->lock);
+        op->progress.files_total++;
+        if (lstat(s[1], &st) == 0) op->progress.bytes_total += (guint64)st.st_size;
+        g_mutex_unlock(&op->lock);
+    }
+    g_mutex_lock(&op->lock);
+    op->progress.counting = FALSE;
+    g_mutex_unlock(&op->lock);
+
+    for (gchar **s = op->sources; s[0] && s[1] && !_fileop_cancelled(op); s += 2)
+        _dup_link(op, s[0], s[1]);
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+static DupScan *dup_scan_start(const char *root, gboolean show_hidden, DupDoneFunc done_func,
+                               gpointer data) {
+    DupScan *scan = g_new0(DupScan, 1);
+    scan->ref_count = 2;        /* caller + worker */
+    scan->root_path = g_strdup(root);
+    scan->show_hidden = show_hidden;
+    scan->cancellable = g_cancellable_new();
+    scan->done_func = done_func;
+    scan->data = data;
+    g_mutex_init(&scan->lock);
+    walk_pool_init(&scan->pool, DUP_MAX_WALKERS, "dup-walk", scan->cancellable, _dup_dir, NULL,
+                   g_free, scan);
+    scan->walkers = g_new0(DupWalker, scan->pool.n_workers);
+    g_thread_unref(g_thread_new("dup-scan", _dup_run, scan));
+    return scan;
+}
+
+static void dup_scan_progress(DupScan *scan, DupProgress *p) {
+    p->stage = (DupStage)g_atomic_int_get(&scan->stage);
+    p->files = (guint)g_atomic_int_get(&scan->files);
+    g_mutex_lock(&scan->lock);
+    p->bytes_done = (guint64)scan->bytes_done;
+    p->bytes_total = (guint64)scan->bytes_total;
+    g_mutex_unlock(&scan->lock);
+}
+
+/* Stops at the next folder or read; the callback will not run */
+static void dup_scan_cancel(DupScan *scan) {
+    if (!scan) return;
+    g_cancellable_cancel(scan->cancellable);
+    _dup_scan_unref(scan);
+}
+
+/* @pairs: the file kept, then the duplicate to replace by a link to it,
+ * and so on; each is compared byte for byte first. Same contract as
+ * fileop_copy(). */
+static FileOp *fileop_dedupe(const char *const *pairs, const FileOpCallbacks *cb, gpointer data) {
+    return _fileop_queue(FILEOP_LINK, _dup_run_dedupe, pairs, NULL, cb, data);
+}
+
+#endif /* BLAZENEURO_FILES_DUPFIND_H */
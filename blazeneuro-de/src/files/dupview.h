@@ -0,0 +1,393 @@
+/*
+ * BlazeNeuro Files — Duplicates View
+ * A window listing the sets of identical files the finder (dupfind.h)
+ * turns up below a folder, most space wasted first. Every copy but the
+ * first of a set is ticked; ticked copies can be moved to the Trash or
+ * replaced with hard links to the set's first unticked one, as jobs on
+ * the file operations queue. Activating a file shows its folder.
+ *
+ * Usage:
+ *   dupview_open(GTK_WINDOW(main_window), path, show_hidden, navigate_to,
+ *                &op_callbacks, track_op);
+ */
+
+#ifndef BLAZENEURO_FILES_DUPVIEW_H
+#define BLAZENEURO_FILES_DUPVIEW_H
+
+#include <gtk/gtk.h>
+
+#include "dupfind.h"
+#include "trash.h"
+
+#define DUPVIEW_TICK_MSEC  200
+#define DUPVIEW_EXPAND     50       /* sets shown open */
+
+enum { DUP_COL_NAME, DUP_COL_PATH, DUP_COL_SIZE, DUP_COL_TICK, DUP_COL_IS_FILE, DUP_N_COLS };
+
+typedef void (*DupViewOpenFunc)(const char *path);
+typedef void (*DupViewTrackFunc)(FileOp *op);
+
+typedef struct {
+    GtkWidget *window;
+    GtkWidget *tree;
+    GtkWidget *status;
+    GtkWidget *spinner;
+    GtkWidget *trash_btn;
+    GtkWidget *link_btn;
+    GtkTreeStore *store;
+    gchar *path;
+    gboolean show_hidden;
+    DupViewOpenFunc open_func;
+    const FileOpCallbacks *op_callbacks;
+    DupViewTrackFunc track_func;
+    DupScan *scan;
+    guint timer;
+} DupView;
+
+/* ── Results ────────────────────────────────────────────── */
+static void _dupview_set_title(DupView *v, GtkTreeIter *set) {
+    GtkTreeModel *model = GTK_TREE_MODEL(v->store);
+    gint n = gtk_tree_model_iter_n_children(model, set);
+    guint64 size = 0;
+    gtk_tree_model_get(model, set, DUP_COL_SIZE, &size, -1);
+    GtkTreeIter first;
+    gchar *path = NULL;
+    if (gtk_tree_model_iter_children(model, &first, set))
+        gtk_tree_model_get(model, &first, DUP_COL_PATH, &path, -1);
+
+    gchar *name = path ? g_filename_display_basename(path) : g_strdup("");
+    gchar *each = g_format_size(size);
+    gchar *wasted = g_format_size(size * (guint64)MAX(n - 1, 0));
+    gchar *title = g_strdup_printf("%s — %d copies of %s, %s to gain", name, n, each, wasted);
+    gtk_tree_store_set(v->store, set, DUP_COL_NAME, title, -1);
+    g_free(title);
+    g_free(wasted);
+    g_free(each);
+    g_free(name);
+    g_free(path);
+}
+
+static void _dupview_update_status(DupView *v) {
+    GtkTreeModel *model = GTK_TREE_MODEL(v->store);
+    GtkTreeIter set;
+    guint sets = 0;
+    guint64 wasted = 0;
+    for (gboolean ok = gtk_tree_model_get_iter_first(model, &set); ok;
+         ok = gtk_tree_model_iter_next(model, &set)) {
+        guint64 size;
+        gtk_tree_model_get(model, &set, DUP_COL_SIZE, &size, -1);
+        wasted += size * (guint64)(gtk_tree_model_iter_n_children(model, &set) - 1);
+        sets++;
+    }
+    gchar *size = g_format_size(wasted);
+    gchar *text = sets ? g_strdup_printf("%u sets of identical files, %s to gain", sets, size)
+                       : g_strdup("No identical files");
+    gtk_label_set_text(GTK_LABEL(v->status), text);
+    gtk_widget_set_sensitive(v->trash_btn, sets > 0);
+    gtk_widget_set_sensitive(v->link_btn, sets > 0);
+    g_free(text);
+    g_free(size);
+}
+
+static void _dupview_fill(DupView *v, GPtrArray *groups) {
+    /* Detached while filling: a row at a time is slow with the view on */
+    gtk_tree_view_set_model(GTK_TREE_VIEW(v->tree), NULL);
+    gsize skip = strlen(v->path);
+    for (guint i = 0; i < groups->len; i++) {
+        DupGroup *g = g_ptr_array_index(groups, i);
+        GtkTreeIter set;
+        gtk_tree_store_insert_with_values(v->store, &set, NULL, -1, DUP_COL_SIZE, g->size, -1);
+        for (guint k = 0; k < g->paths->len; k++) {
+            const char *path = g_ptr_array_index(g->paths, k);
+            const char *rel = path + skip;
+            while (*rel == '/') rel++;
+            gchar *display = g_filename_display_name(rel);
+            gtk_tree_store_insert_with_values(v->store, NULL, &set, -1,
+                                              DUP_COL_NAME, display, DUP_COL_PATH, path,
+                                              DUP_COL_SIZE, g->size, DUP_COL_TICK, k > 0,
+                                              DUP_COL_IS_FILE, TRUE, -1);
+            g_free(display);
+        }
+        _dupview_set_title(v, &set);
+    }
+    gtk_tree_view_set_model(GTK_TREE_VIEW(v->tree), GTK_TREE_MODEL(v->store));
+    for (guint i = 0; i < MIN(groups->len, DUPVIEW_EXPAND); i++) {
+        GtkTreePath *path = gtk_tree_path_new_from_indices((gint)i, -1);
+        gtk_tree_view_expand_row(GTK_TREE_VIEW(v->tree), path, FALSE);
+        gtk_tree_path_free(path);
+    }
+}
+
+static void on_dupview_toggled(GtkCellRendererToggle *cell, gchar *path_str, gpointer data) {
+    (void)cell;
+    DupView *v = data;
+    GtkTreeIter iter;
+    if (!gtk_tree_model_get_iter_from_string(GTK_TREE_MODEL(v->store), &iter, path_str)) return;
+    gboolean tick, is_file;
+    gtk_tree_model_get(GTK_TREE_MODEL(v->store), &iter, DUP_COL_TICK, &tick,
+                       DUP_COL_IS_FILE, &is_file, -1);
+    if (is_file) gtk_tree_store_set(v->store, &iter, DUP_COL_TICK, !tick, -1);
+}
+
+static void on_dupview_activated(GtkTreeView *tree, GtkTreePath *path, GtkTreeViewColumn *col,
+                                 gpointer data) {
+    (void)tree; (void)col;
+    DupView *v = data;
+    GtkTreeIter iter;
+    gchar *file = NULL;
+    if (gtk_tree_model_get_iter(GTK_TREE_MODEL(v->store), &iter, path))
+        gtk_tree_model_get(GTK_TREE_MODEL(v->store), &iter, DUP_COL_PATH, &file, -1);
+    if (file && v->open_func) {
+        gchar *dir = g_path_get_dirname(file);
+        v->open_func(dir);
+        g_free(dir);
+    }
+    g_free(file);
+}
+
+/* ── Actions ────────────────────────────────────────────── */
+/* The ticked files, and for each the set's first unticked one. NULL,
+ * after saying why, when a set has every copy ticked. */
+static GPtrArray *_dupview_ticked(DupView *v, GPtrArray **keeps) {
+    GtkTreeModel *model = GTK_TREE_MODEL(v->store);
+    GPtrArray *ticked = g_ptr_array_new_with_free_func(g_free);
+    *keeps = g_ptr_array_new_with_free_func(g_free);
+    GtkTreeIter set, file;
+    for (gboolean ok = gtk_tree_model_get_iter_first(model, &set); ok;
+         ok = gtk_tree_model_iter_next(model, &set)) {
+        gchar *keep = NULL;
+        guint first = ticked->len;
+        for (gboolean f = gtk_tree_model_iter_children(model, &file, &set); f;
+             f = gtk_tree_model_iter_next(model, &file)) {
+            gboolean tick;
+            gchar *path;
+            gtk_tree_model_get(model, &file, DUP_COL_TICK, &tick, DUP_COL_PATH, &path, -1);
+            if (tick) g_ptr_array_add(ticked, path);
+            else if (!keep) keep = path;
+            else g_free(path);
+        }
+        if (ticked->len > first && !keep) {
+            GtkWidget *dialog = gtk_message_dialog_new(
+                GTK_WINDOW(v->window), GTK_DIALOG_MODAL, GTK_MESSAGE_WARNING, GTK_BUTTONS_CLOSE,
+                "Every copy of “%s” is ticked", (const char *)g_ptr_array_index(ticked, first));
+            gtk_message_dialog_format_secondary_text(GTK_MESSAGE_DIALOG(dialog),
+                                                     "Untick the copy to keep.");
+            gtk_dialog_run(GTK_DIALOG(dialog));
+            gtk_widget_destroy(dialog);
+            g_ptr_array_free(ticked, TRUE);
+            g_ptr_array_free(*keeps, TRUE);
+            *keeps = NULL;
+            return NULL;
+        }
+        for (guint i = first; i < ticked->len; i++) g_ptr_array_add(*keeps, g_strdup(keep));
+        g_free(keep);
+    }
+    return ticked;
+}
+
+/* Drops the ticked rows, and the sets no longer holding two files */
+static void _dupview_remove_ticked(DupView *v) {
+    GtkTreeModel *model = GTK_TREE_MODEL(v->store);
+    GtkTreeIter set, file;
+    gboolean ok = gtk_tree_model_get_iter_first(model, &set);
+    while (ok) {
+        gboolean f = gtk_tree_model_iter_children(model, &file, &set);
+        while (f) {
+            gboolean tick;
+            gtk_tree_model_get(model, &file, DUP_COL_TICK, &tick, -1);
+            f = tick ? gtk_tree_store_remove(v->store, &file) : gtk_tree_model_iter_next(model, &file);
+        }
+        if (gtk_tree_model_iter_n_children(model, &set) < 2) {
+            ok = gtk_tree_store_remove(v->store, &set);
+        } else {
+            _dupview_set_title(v, &set);
+            ok = gtk_tree_model_iter_next(model, &set);
+        }
+    }
+    _dupview_update_status(v);
+}
+
+static void on_dupview_trash(GtkWidget *button, gpointer data) {
+    (void)button;
+    DupView *v = data;
+    GPtrArray *keeps;
+    GPtrArray *ticked = _dupview_ticked(v, &keeps);
+    if (!ticked) return;
+    if (ticked->len > 0) {
+        g_ptr_array_add(ticked, NULL);
+        v->track_func(fileop_trash((const char *const *)ticked->pdata, v->op_callbacks, NULL));
+        _dupview_remove_ticked(v);
+    }
+    g_ptr_array_free(ticked, TRUE);
+    g_ptr_array_free(keeps, TRUE);
+}
+
+static void on_dupview_link(GtkWidget *button, gpointer data) {
+    (void)button;
+    DupView *v = data;
+    GPtrArray *keeps;
+    GPtrArray *ticked = _dupview_ticked(v, &keeps);
+    if (!ticked) return;
+    if (ticked->len > 0) {
+        GPtrArray *pairs = g_ptr_array_new();
+        for (guint i = 0; i < ticked->len; i++) {
+            g_ptr_array_add(pairs, keeps->pdata[i]);
+            g_ptr_array_add(pairs, ticked->pdata[i]);
+        }
+        g_ptr_array_add(pairs, NULL);
+        v->track_func(fileop_dedupe((const char *const *)pairs->pdata, v->op_callbacks, NULL));
+        g_ptr_array_free(pairs, TRUE);
+        _dupview_remove_ticked(v);
+    }
+    g_ptr_array_free(ticked, TRUE);
+    g_ptr_array_free(keeps, TRUE);
+}
+
+/* ── Scanning ───────────────────────────────────────────── */
+static gboolean _dupview_tick(gpointer data) {
+    DupView *v = data;
+    DupProgress p;
+    dup_scan_progress(v->scan, &p);
+    gchar *done = g_format_size(p.bytes_done);
+    gchar *total = g_format_size(p.bytes_total);
+    gchar *text;
+    if (p.stage == DUP_STAGE_WALK)
+        text = g_strdup_printf("Listing files — %u so far", p.files);
+    else if (p.stage == DUP_STAGE_EDGES)
+        text = g_strdup_printf("Comparing the start and end of same-sized files — %s of %s",
+                               done, total);
+    else
+        text = g_strdup_printf("Comparing contents — %s of %s", done, total);
+    gtk_label_set_text(GTK_LABEL(v->status), text);
+    g_free(text);
+    g_free(total);
+    g_free(done);
+    return G_SOURCE_CONTINUE;
+}
+
+static void _dupview_scan_done(GPtrArray *groups, gpointer data) {
+    DupView *v = data;
+    dup_scan_cancel(v->scan);
+    v->scan = NULL;
+    g_source_remove(v->timer);
+    v->timer = 0;
+    gtk_spinner_stop(GTK_SPINNER(v->spinner));
+    gtk_widget_hide(v->spinner);
+
+    if (!groups) {
+        gtk_label_set_text(GTK_LABEL(v->status), "The folder could not be read");
+        return;
+    }
+    _dupview_fill(v, groups);
+    g_ptr_array_free(groups, TRUE);
+    _dupview_update_status(v);
+}
+
+static void _dupview_scan(DupView *v) {
+    dup_scan_cancel(v->scan);
+    if (v->timer) g_source_remove(v->timer);
+    gtk_tree_store_clear(v->store);
+    gtk_widget_set_sensitive(v->trash_btn, FALSE);
+    gtk_widget_set_sensitive(v->link_btn, FALSE);
+
+    gtk_widget_show(v->spinner);
+    gtk_spinner_start(GTK_SPINNER(v->spinner));
+    gtk_label_set_text(GTK_LABEL(v->status), "Listing files…");
+    v->scan = dup_scan_start(v->path, v->show_hidden, _dupview_scan_done, v);
+    v->timer = g_timeout_add(DUPVIEW_TICK_MSEC, _dupview_tick, v);
+}
+
+static void on_dupview_rescan(GtkWidget *button, gpointer data) {
+    (void)button;
+    _dupview_scan(data);
+}
+
+static void on_dupview_destroy(GtkWidget *widget, gpointer data) {
+    (void)widget;
+    DupView *v = data;
+    dup_scan_cancel(v->scan);
+    if (v->timer) g_source_remove(v->timer);
+    g_signal_handlers_disconnect_by_data(v->tree, v);
+    g_object_unref(v->store);
+    g_free(v->path);
+    g_free(v);
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+/* Jobs are made with @op_callbacks and handed to @track_func */
+static void dupview_open(GtkWindow *parent, const char *path, gboolean show_hidden,
+                         DupViewOpenFunc open_func, const FileOpCallbacks *op_callbacks,
+                         DupViewTrackFunc track_func) {
+    DupView *v = g_new0(DupView, 1);
+    v->path = g_strdup(path);
+    v->show_hidden = show_hidden;
+    v->open_func = open_func;
+    v->op_callbacks = op_callbacks;
+    v->track_func = track_func;
+    v->store = gtk_tree_store_new(DUP_N_COLS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_UINT64,
+                                  G_TYPE_BOOLEAN, G_TYPE_BOOLEAN);
+
+    v->window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    gtk_window_set_transient_for(GTK_WINDOW(v->window), parent);
+    gtk_window_set_application(GTK_WINDOW(v->window), gtk_window_get_application(parent));
+    gtk_window_set_default_size(GTK_WINDOW(v->window), 760, 560);
+    gchar *name = g_path_get_basename(path);
+    gchar *title = g_strdup_printf("Duplicates — %s", name);
+    gtk_window_set_title(GTK_WINDOW(v->window), title);
+    g_free(title);
+    g_free(name);
+    g_signal_connect(v->window, "destroy", G_CALLBACK(on_dupview_destroy), v);
+
+    GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+    GtkWidget *header = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    gtk_container_set_border_width(GTK_CONTAINER(header), 6);
+    v->spinner = gtk_spinner_new();
+    v->status = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(v->status), 0);
+    gtk_label_set_ellipsize(GTK_LABEL(v->status), PANGO_ELLIPSIZE_END);
+    GtkWidget *rescan = gtk_button_new_with_label("Rescan");
+    g_signal_connect(rescan, "clicked", G_CALLBACK(on_dupview_rescan), v);
+    gtk_box_pack_start(GTK_BOX(header), v->spinner, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(header), v->status, TRUE, TRUE, 0);
+    gtk_box_pack_end(GTK_BOX(header), rescan, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(vbox), header, FALSE, FALSE, 0);
+
+    GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll),
+                                   GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+    v->tree = gtk_tree_view_new_with_model(GTK_TREE_MODEL(v->store));
+    gtk_tree_view_set_headers_visible(GTK_TREE_VIEW(v->tree), FALSE);
+    GtkCellRenderer *toggle = gtk_cell_renderer_toggle_new();
+    g_signal_connect(toggle, "toggled", G_CALLBACK(on_dupview_toggled), v);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(v->tree),
+        gtk_tree_view_column_new_with_attributes("", toggle, "active", DUP_COL_TICK,
+                                                 "visible", DUP_COL_IS_FILE, NULL));
+    GtkCellRenderer *text = gtk_cell_renderer_text_new();
+    g_object_set(text, "ellipsize", PANGO_ELLIPSIZE_MIDDLE, NULL);
+    GtkTreeViewColumn *col = gtk_tree_view_column_new_with_attributes("Name", text,
+                                                                       "text", DUP_COL_NAME, NULL);
+    gtk_tree_view_column_set_expand(col, TRUE);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(v->tree), col);
+    g_signal_connect(v->tree, "row-activated", G_CALLBACK(on_dupview_activated), v);
+    gtk_container_add(GTK_CONTAINER(scroll), v->tree);
+    gtk_box_pack_start(GTK_BOX(vbox), scroll, TRUE, TRUE, 0);
+
+    GtkWidget *actions = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    gtk_container_set_border_width(GTK_CONTAINER(actions), 6);
+    v->trash_btn = gtk_button_new_with_label("Move Ticked to Trash");
+    g_signal_connect(v->trash_btn, "clicked", G_CALLBACK(on_dupview_trash), v);
+    v->link_btn = gtk_button_new_with_label("Replace Ticked with Hard Links");
+    gtk_widget_set_tooltip_text(v->link_btn,
+        "Each ticked file becomes another name for the copy kept: the space is freed and "
+        "every path still opens the same contents. Edits to one then show in all.");
+    g_signal_connect(v->link_btn, "clicked", G_CALLBACK(on_dupview_link), v);
+    gtk_box_pack_end(GTK_BOX(actions), v->link_btn, FALSE, FALSE, 0);
+    gtk_box_pack_end(GTK_BOX(actions), v->trash_btn, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(vbox), actions, FALSE, FALSE, 0);
+
+    gtk_container_add(GTK_CONTAINER(v->window), vbox);
+    gtk_widget_show_all(v->window);
+    _dupview_scan(v);
+}
+
+#endif /* BLAZENEURO_FILES_DUPVIEW_H */
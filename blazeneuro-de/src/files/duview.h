@@ -0,0 +1,431 @@
+/*
+ * BlazeNeuro Files — Disk Usage View
+ * A window showing where a folder's space goes: its folders as a tree,
+ * largest first, beside a squarified treemap of the selected one. The
+ * sizes come from the scanner (diskusage.h); tree rows are added as
+ * folders are expanded, so a tree of a million folders opens at once.
+ *
+ * Clicking in the map selects that folder in the tree, which opens it
+ * in the map; activating a row calls @open_func with the folder's path.
+ *
+ * Usage:
+ *   duview_open(GTK_WINDOW(main_window), path, navigate_to);
+ */
+
+#ifndef BLAZENEURO_FILES_DUVIEW_H
+#define BLAZENEURO_FILES_DUVIEW_H
+
+#include <gtk/gtk.h>
+
+#include "diskusage.h"
+
+#define DUVIEW_TICK_MSEC   200
+#define DUVIEW_MAP_DEPTH   3          /* levels drawn in the treemap */
+#define DUVIEW_MIN_RECT    6.0        /* pixels; smaller areas are not split */
+#define DUVIEW_PAD         3.0
+
+enum { DU_COL_NODE, DU_COL_NAME, DU_COL_SIZE, DU_COL_PERCENT, DU_COL_FILES, DU_N_COLS };
+
+typedef void (*DuViewOpenFunc)(const char *path);
+
+typedef struct {
+    gdouble x, y, w, h;
+    DuNode *node;
+    guint depth;
+    guint hue;                  /* index of its top-level ancestor */
+} DuRect;
+
+typedef struct {
+    GtkWidget *window;
+    GtkWidget *tree;
+    GtkWidget *map;
+    GtkWidget *status;
+    GtkWidget *spinner;
+    GtkTreeStore *store;
+    gchar *path;
+    DuViewOpenFunc open_func;
+    DuScan *scan;
+    DuNode *root;
+    DuNode *shown;              /* the treemap's folder */
+    DuNode *selected;
+    GArray *rects;              /* DuRect from the last draw, parents first */
+    guint timer;
+} DuView;
+
+/* Full path of @node below the scanned folder */
+static gchar *_duview_node_path(DuNode *node) {
+    GPtrArray *parts = g_ptr_array_new();
+    for (DuNode *n = node; n; n = n->parent) g_ptr_array_insert(parts, 0, n->name);
+    g_ptr_array_add(parts, NULL);
+    gchar *path = g_build_filenamev((gchar **)parts->pdata);
+    g_ptr_array_free(parts, TRUE);
+    return path;
+}
+
+/* ── Tree ───────────────────────────────────────────────── */
+static void _duview_set_row(DuView *v, GtkTreeIter *iter, DuNode *node, const char *name) {
+    gchar *size = g_format_size(node->size);
+    guint64 total = node->parent ? node->parent->size : node->size;
+    gint percent = total > 0 ? (gint)(node->size * 100 / total) : 0;
+    gtk_tree_store_set(v->store, iter, DU_COL_NODE, node, DU_COL_NAME, name, DU_COL_SIZE, size,
+                       DU_COL_PERCENT, percent, DU_COL_FILES, node->files, -1);
+    g_free(size);
+    /* A placeholder child makes the row expandable until it is filled */
+    if (node->children && node->children->len > 0) {
+        GtkTreeIter dummy;
+        gtk_tree_store_append(v->store, &dummy, iter);
+    }
+}
+
+static void _duview_fill(DuView *v, GtkTreeIter *parent) {
+    DuNode *node = NULL;
+    GtkTreeIter child;
+    if (!gtk_tree_model_iter_children(GTK_TREE_MODEL(v->store), &child, parent)) return;
+    gtk_tree_model_get(GTK_TREE_MODEL(v->store), &child, DU_COL_NODE, &node, -1);
+    if (node) return;
+    gtk_tree_store_remove(v->store, &child);
+
+    gtk_tree_model_get(GTK_TREE_MODEL(v->store), parent, DU_COL_NODE, &node, -1);
+    for (guint i = 0; node && node->children && i < node->children->len; i++) {
+        DuNode *c = g_ptr_array_index(node->children, i);
+        GtkTreeIter iter;
+        gtk_tree_store_append(v->store, &iter, parent);
+        _duview_set_row(v, &iter, c, c->name);
+    }
+}
+
+static gboolean on_duview_expand(GtkTreeView *tree, GtkTreeIter *iter, GtkTreePath *path,
+                                 gpointer data) {
+    (void)tree; (void)path;
+    _duview_fill(data, iter);
+    return FALSE;
+}
+
+/* Expands the rows down to @node and selects it */
+static void _duview_select(DuView *v, DuNode *node) {
+    GPtrArray *chain = g_ptr_array_new();
+    for (DuNode *n = node; n; n = n->parent) g_ptr_array_insert(chain, 0, n);
+
+    GtkTreeModel *model = GTK_TREE_MODEL(v->store);
+    GtkTreeIter iter, parent;
+    gboolean found = gtk_tree_model_get_iter_first(model, &iter);
+    for (guint i = 1; found && i < chain->len; i++) {
+        parent = iter;
+        _duview_fill(v, &parent);
+        found = gtk_tree_model_iter_children(model, &iter, &parent);
+        while (found) {
+            DuNode *n = NULL;
+            gtk_tree_model_get(model, &iter, DU_COL_NODE, &n, -1);
+            if (n == chain->pdata[i]) break;
+            found = gtk_tree_model_iter_next(model, &iter);
+        }
+    }
+    g_ptr_array_free(chain, TRUE);
+    if (!found) return;
+
+    GtkTreePath *path = gtk_tree_model_get_path(model, &iter);
+    gtk_tree_view_expand_to_path(GTK_TREE_VIEW(v->tree), path);
+    gtk_tree_selection_select_path(gtk_tree_view_get_selection(GTK_TREE_VIEW(v->tree)), path);
+    gtk_tree_view_scroll_to_cell(GTK_TREE_VIEW(v->tree), path, NULL, FALSE, 0, 0);
+    gtk_tree_path_free(path);
+}
+
+static void on_duview_selection(GtkTreeSelection *sel, gpointer data) {
+    DuView *v = data;
+    GtkTreeModel *model;
+    GtkTreeIter iter;
+    DuNode *node = NULL;
+    if (gtk_tree_selection_get_selected(sel, &model, &iter))
+        gtk_tree_model_get(model, &iter, DU_COL_NODE, &node, -1);
+    if (!node) return;
+    v->selected = node;
+    /* A folder without subfolders is shown within its parent */
+    v->shown = node->children && node->children->len > 0 ? node : (node->parent ? node->parent : node);
+    gtk_widget_queue_draw(v->map);
+}
+
+static void on_duview_activated(GtkTreeView *tree, GtkTreePath *path, GtkTreeViewColumn *col,
+                                gpointer data) {
+    (void)col;
+    DuView *v = data;
+    GtkTreeIter iter;
+    DuNode *node = NULL;
+    if (gtk_tree_model_get_iter(gtk_tree_view_get_model(tree), &iter, path))
+        gtk_tree_model_get(gtk_tree_view_get_model(tree), &iter, DU_COL_NODE, &node, -1);
+    if (!node || !v->open_func) return;
+    gchar *full = _duview_node_path(node);
+    v->open_func(full);
+    g_free(full);
+}
+
+/* ── Treemap ────────────────────────────────────────────── */
+static void _duview_layout(DuView *v, DuNode *node, gdouble x, gdouble y, gdouble w, gdouble h,
+                           guint depth, guint hue);
+
+static void _duview_add_rect(DuView *v, DuNode *node, gdouble x, gdouble y, gdouble w, gdouble h,
+                             guint depth, guint hue) {
+    DuRect r = { x, y, w, h, node, depth, hue };
+    g_array_append_val(v->rects, r);
+    if (depth + 1 < DUVIEW_MAP_DEPTH && w > 4 * DUVIEW_PAD && h > 4 * DUVIEW_PAD)
+        _duview_layout(v, node, x + DUVIEW_PAD, y + DUVIEW_PAD,
+                       w - 2 * DUVIEW_PAD, h - 2 * DUVIEW_PAD, depth + 1, hue);
+}
+
+/* Squarified treemap (Bruls, Huizing, van Wijk): children, largest
+ * first, fill rows along the shorter side while that keeps their aspect
+ * ratios improving. The folder's own files keep the area left over. */
+static void _duview_layout(DuView *v, DuNode *node, gdouble x, gdouble y, gdouble w, gdouble h,
+                           guint depth, guint hue) {
+    if (!node->children || node->size == 0 || w < DUVIEW_MIN_RECT || h < DUVIEW_MIN_RECT) return;
+    gdouble scale = w * h / (gdouble)node->size;
+    GPtrArray *kids = node->children;
+
+    for (guint i = 0; i < kids->len;) {
+        gdouble side = MIN(w, h);
+        gdouble first = ((DuNode *)kids->pdata[i])->size * scale;
+        gdouble sum = 0, worst = G_MAXDOUBLE;
+        guint j = i;
+        for (; j < kids->len; j++) {
+            gdouble area = ((DuNode *)kids->pdata[j])->size * scale;
+            if (area <= 0) break;
+            gdouble s = sum + area;
+            gdouble ratio = MAX(side * side * first / (s * s), s * s / (side * side * area));
+            if (ratio > worst) break;
+            worst = ratio;
+            sum = s;
+        }
+        if (j == i || sum <= 0) break;
+
+        gdouble thick = sum / side;
+        gdouble off = 0;
+        for (guint k = i; k < j; k++) {
+            DuNode *c = kids->pdata[k];
+            gdouble len = c->size * scale / thick;
+            guint c_hue = depth == 0 ? k : hue;
+            if (w >= h) _duview_add_rect(v, c, x, y + off, thick, len, depth, c_hue);
+            else _duview_add_rect(v, c, x + off, y, len, thick, depth, c_hue);
+            off += len;
+        }
+        if (w >= h) { x += thick; w -= thick; }
+        else { y += thick; h -= thick; }
+        if (w < 1 || h < 1) break;
+        i = j;
+    }
+}
+
+static gboolean on_duview_draw(GtkWidget *widget, cairo_t *cr, gpointer data) {
+    DuView *v = data;
+    g_array_set_size(v->rects, 0);
+    if (!v->shown) return FALSE;
+
+    gdouble width = gtk_widget_get_allocated_width(widget);
+    gdouble height = gtk_widget_get_allocated_height(widget);
+    _duview_layout(v, v->shown, 0, 0, width, height, 0, 0);
+
+    static const gdouble palette[][3] = {
+        { 0.36, 0.54, 0.86 }, { 0.40, 0.73, 0.45 }, { 0.91, 0.62, 0.25 },
+        { 0.78, 0.38, 0.62 }, { 0.30, 0.70, 0.75 }, { 0.85, 0.40, 0.38 },
+        { 0.60, 0.52, 0.82 }, { 0.70, 0.68, 0.30 },
+    };
+    PangoLayout *layout = gtk_widget_create_pango_layout(widget, NULL);
+    for (guint i = 0; i < v->rects->len; i++) {
+        DuRect *r = &g_array_index(v->rects, DuRect, i);
+        const gdouble *c = palette[r->hue % G_N_ELEMENTS(palette)];
+        gdouble shade = 1.0 - 0.18 * r->depth;
+        cairo_set_source_rgb(cr, c[0] * shade, c[1] * shade, c[2] * shade);
+        cairo_rectangle(cr, r->x, r->y, r->w, r->h);
+        cairo_fill_preserve(cr);
+        cairo_set_source_rgba(cr, 0, 0, 0, 0.35);
+        cairo_set_line_width(cr, r->node == v->selected ? 3 : 1);
+        cairo_stroke(cr);
+
+        if (r->depth == 0 && r->w > 60 && r->h > 20) {
+            gchar *size = g_format_size(r->node->size);
+            gchar *text = g_strdup_printf("%s  %s", r->node->name, size);
+            pango_layout_set_text(layout, text, -1);
+            pango_layout_set_width(layout, (int)((r->w - 8) * PANGO_SCALE));
+            pango_layout_set_ellipsize(layout, PANGO_ELLIPSIZE_END);
+            cairo_set_source_rgb(cr, 1, 1, 1);
+            cairo_move_to(cr, r->x + 4, r->y + 2);
+            pango_cairo_show_layout(cr, layout);
+            g_free(text);
+            g_free(size);
+        }
+    }
+    g_object_unref(layout);
+    return FALSE;
+}
+
+static gboolean on_duview_map_press(GtkWidget *widget, GdkEventButton *ev, gpointer data) {
+    (void)widget;
+    DuView *v = data;
+    if (ev->type != GDK_BUTTON_PRESS || ev->button != 1) return FALSE;
+    /* The last hit is the deepest: children follow their parent */
+    DuNode *hit = NULL;
+    for (guint i = 0; i < v->rects->len; i++) {
+        DuRect *r = &g_array_index(v->rects, DuRect, i);
+        if (ev->x >= r->x && ev->x < r->x + r->w && ev->y >= r->y && ev->y < r->y + r->h)
+            hit = r->node;
+    }
+    if (hit) _duview_select(v, hit);
+    return TRUE;
+}
+
+/* ── Scanning ───────────────────────────────────────────── */
+static gboolean _duview_tick(gpointer data) {
+    DuView *v = data;
+    guint folders;
+    guint64 bytes;
+    du_scan_progress(v->scan, &folders, &bytes);
+    gchar *size = g_format_size(bytes);
+    gchar *text = g_strdup_printf("Scanning — %u folders, %s so far", folders, size);
+    gtk_label_set_text(GTK_LABEL(v->status), text);
+    g_free(text);
+    g_free(size);
+    return G_SOURCE_CONTINUE;
+}
+
+static void _duview_scan_done(DuNode *root, gpointer data) {
+    DuView *v = data;
+    g_source_remove(v->timer);
+    v->timer = 0;
+    gtk_spinner_stop(GTK_SPINNER(v->spinner));
+    gtk_widget_hide(v->spinner);
+
+    if (!root) {
+        gtk_label_set_text(GTK_LABEL(v->status), "The folder could not be read");
+        return;
+    }
+    v->root = root;
+    gchar *size = g_format_size(root->size);
+    gchar *text = g_strdup_printf("%s in %" G_GUINT64_FORMAT " files", size, root->files);
+    gtk_label_set_text(GTK_LABEL(v->status), text);
+    g_free(text);
+    g_free(size);
+
+    GtkTreeIter iter;
+    gchar *name = g_path_get_basename(root->name);
+    gtk_tree_store_append(v->store, &iter, NULL);
+    _duview_set_row(v, &iter, root, name);
+    g_free(name);
+    _duview_select(v, root);
+    GtkTreePath *path = gtk_tree_path_new_first();
+    gtk_tree_view_expand_row(GTK_TREE_VIEW(v->tree), path, FALSE);
+    gtk_tree_path_free(path);
+}
+
+static void _duview_scan(DuView *v, gboolean use_cache) {
+    du_scan_cancel(v->scan);
+    if (v->timer) g_source_remove(v->timer);
+    gtk_tree_store_clear(v->store);
+    du_node_free(v->root);
+    v->root = v->shown = v->selected = NULL;
+    gtk_widget_queue_draw(v->map);
+
+    gtk_widget_show(v->spinner);
+    gtk_spinner_start(GTK_SPINNER(v->spinner));
+    gtk_label_set_text(GTK_LABEL(v->status), "Scanning…");
+    v->scan = du_scan_start(v->path, use_cache, _duview_scan_done, v);
+    v->timer = g_timeout_add(DUVIEW_TICK_MSEC, _duview_tick, v);
+}
+
+/* Reads every folder again, for files changed in place */
+static void on_duview_rescan(GtkWidget *button, gpointer data) {
+    (void)button;
+    _duview_scan(data, FALSE);
+}
+
+static void on_duview_destroy(GtkWidget *widget, gpointer data) {
+    (void)widget;
+    DuView *v = data;
+    du_scan_cancel(v->scan);
+    if (v->timer) g_source_remove(v->timer);
+    /* The widgets outlive this */
+    g_signal_handlers_disconnect_by_data(gtk_tree_view_get_selection(GTK_TREE_VIEW(v->tree)), v);
+    g_signal_handlers_disconnect_by_data(v->tree, v);
+    g_signal_handlers_disconnect_by_data(v->map, v);
+    gtk_tree_store_clear(v->store);
+    g_object_unref(v->store);
+    du_node_free(v->root);
+    g_array_free(v->rects, TRUE);
+    g_free(v->path);
+    g_free(v);
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+static void duview_open(GtkWindow *parent, const char *path, DuViewOpenFunc open_func) {
+    DuView *v = g_new0(DuView, 1);
+    v->path = g_strdup(path);
+    v->open_func = open_func;
+    v->rects = g_array_new(FALSE, FALSE, sizeof(DuRect));
+    v->store = gtk_tree_store_new(DU_N_COLS, G_TYPE_POINTER, G_TYPE_STRING, G_TYPE_STRING,
+                                  G_TYPE_INT, G_TYPE_UINT64);
+
+    v->window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    gtk_window_set_transient_for(GTK_WINDOW(v->window), parent);
+    gtk_window_set_application(GTK_WINDOW(v->window), gtk_window_get_application(parent));
+    gtk_window_set_default_size(GTK_WINDOW(v->window), 960, 560);
+    gchar *name = g_path_get_basename(path);
+    gchar *title = g_strdup_printf("Disk Usage — %s", name);
+    gtk_window_set_title(GTK_WINDOW(v->window), title);
+    g_free(title);
+    g_free(name);
+    g_signal_connect(v->window, "destroy", G_CALLBACK(on_duview_destroy), v);
+
+    GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+    GtkWidget *header = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    gtk_container_set_border_width(GTK_CONTAINER(header), 6);
+    v->spinner = gtk_spinner_new();
+    v->status = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(v->status), 0);
+    GtkWidget *rescan = gtk_button_new_with_label("Rescan");
+    gtk_widget_set_tooltip_text(rescan, "Read every folder again");
+    g_signal_connect(rescan, "clicked", G_CALLBACK(on_duview_rescan), v);
+    gtk_box_pack_start(GTK_BOX(header), v->spinner, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(header), v->status, TRUE, TRUE, 0);
+    gtk_box_pack_end(GTK_BOX(header), rescan, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(vbox), header, FALSE, FALSE, 0);
+
+    GtkWidget *paned = gtk_paned_new(GTK_ORIENTATION_HORIZONTAL);
+    GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll),
+                                   GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+    v->tree = gtk_tree_view_new_with_model(GTK_TREE_MODEL(v->store));
+    GtkCellRenderer *text = gtk_cell_renderer_text_new();
+    g_object_set(text, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+    GtkTreeViewColumn *col = gtk_tree_view_column_new_with_attributes("Name", text,
+                                                                       "text", DU_COL_NAME, NULL);
+    gtk_tree_view_column_set_expand(col, TRUE);
+    gtk_tree_view_column_set_resizable(col, TRUE);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(v->tree), col);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(v->tree),
+        gtk_tree_view_column_new_with_attributes("Size", gtk_cell_renderer_text_new(),
+                                                 "text", DU_COL_SIZE, NULL));
+    gtk_tree_view_append_column(GTK_TREE_VIEW(v->tree),
+        gtk_tree_view_column_new_with_attributes("", gtk_cell_renderer_progress_new(),
+                                                 "value", DU_COL_PERCENT, NULL));
+    gtk_tree_view_append_column(GTK_TREE_VIEW(v->tree),
+        gtk_tree_view_column_new_with_attributes("Files", gtk_cell_renderer_text_new(),
+                                                 "text", DU_COL_FILES, NULL));
+    g_signal_connect(v->tree, "test-expand-row", G_CALLBACK(on_duview_expand), v);
+    g_signal_connect(v->tree, "row-activated", G_CALLBACK(on_duview_activated), v);
+    g_signal_connect(gtk_tree_view_get_selection(GTK_TREE_VIEW(v->tree)), "changed",
+                     G_CALLBACK(on_duview_selection), v);
+    gtk_container_add(GTK_CONTAINER(scroll), v->tree);
+    gtk_paned_pack1(GTK_PANED(paned), scroll, TRUE, FALSE);
+
+    v->map = gtk_drawing_area_new();
+    gtk_widget_set_size_request(v->map, 240, -1);
+    gtk_widget_add_events(v->map, GDK_BUTTON_PRESS_MASK);
+    g_signal_connect(v->map, "draw", G_CALLBACK(on_duview_draw), v);
+    g_signal_connect(v->map, "button-press-event", G_CALLBACK(on_duview_map_press), v);
+    gtk_paned_pack2(GTK_PANED(paned), v->map, TRUE, FALSE);
+    gtk_paned_set_position(GTK_PANED(paned), 420);
+    gtk_box_pack_start(GTK_BOX(vbox), paned, TRUE, TRUE, 0);
+
+    gtk_container_add(GTK_CONTAINER(v->window), vbox);
+    gtk_widget_show_all(v->window);
+    _duview_scan(v, TRUE);
+}
+
+#endif /* BLAZENEURO_FILES_DUVIEW_H */
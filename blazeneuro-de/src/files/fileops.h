@@ -0,0 +1,792 @@
+/*
+ * BlazeNeuro Files — File Operations
+ * Copy, move, delete and rename run as jobs on a queue, one job at a
+ * time and never on the main thread. Within a copy, files smaller than
+ * FILEOPS_SMALL_FILE go to a pool of copiers, so a tree of many small
+ * files is not bound by one thread's per-file latency; larger files are
+ * copied by the job itself in chunks, so cancel and progress stay live.
+ *
+ * Each file is copied the cheapest way the filesystems allow: a FICLONE
+ * reflink (btrfs, XFS: no data is copied), copy_file_range() (in the
+ * kernel, server-side on NFS and SMB), sendfile(), then read/write.
+ * Mode and timestamps are kept; folder modes are set once the job is
+ * done, so a read-only folder is still writable while it fills. A move
+ * within one filesystem is a rename, except a folder merged into an
+ * existing one, which is copied like a move across filesystems: the
+ * source is deleted only if all of it was copied, less the conflicts
+ * that were skipped: those stay where they were.
+ *
+ * When a destination exists, the job asks the main thread through the
+ * conflict callback and waits for fileop_resolve(); "apply to all"
+ * answers the rest of that job. A folder onto a folder merges without
+ * asking, and pasting into the folder it came from keeps both.
+ *
+ * Usage:
+ *   fileops_init();
+ *   FileOp *op = fileop_copy(paths, dest_dir, &callbacks, data);
+ *   fileop_progress(op, &p);     // from a timer, until done is called
+ *   fileop_cancel(op);
+ */
+
+#ifndef BLAZENEURO_FILES_FILEOPS_H
+#define BLAZENEURO_FILES_FILEOPS_H
+
+#include <gio/gio.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+
+#define FILEOPS_SMALL_FILE   (1 << 20)      /* handed to the copiers */
+#define FILEOPS_CHUNK        (8 << 20)      /* per kernel copy call */
+#define FILEOPS_BUFFER       (256 << 10)    /* read/write fallback */
+#define FILEOPS_MAX_COPIERS  4
+
+typedef enum {
+    FILEOP_COPY,
+    FILEOP_MOVE,
+    FILEOP_DELETE,
+    FILEOP_RENAME,
+    FILEOP_TRASH,           /* trash.h */
+    FILEOP_EMPTY_TRASH,
+    FILEOP_EXTRACT,         /* archivefs.h */
+    FILEOP_LINK,            /* dupfind.h */
+} FileOpKind;
+
+typedef enum {
+    FILEOP_ASK,             /* no answer yet */
+    FILEOP_REPLACE,
+    FILEOP_SKIP,
+    FILEOP_KEEP_BOTH,
+    FILEOP_ABORT,
+} FileOpChoice;
+
+typedef struct FileOp FileOp;
+
+typedef struct {
+    gchar *path;
+    mode_t mode;
+} FileOpDirMode;
+
+/* Both run on the main thread */
+typedef struct {
+    /* @src would overwrite @dest; answer with fileop_resolve() */
+    void (*conflict)(FileOp *op, const char *src, const char *dest, gpointer data);
+    /* Finished, failed or cancelled; @error sums up failures, else NULL.
+     * @op is freed when this returns. */
+    void (*done)(FileOp *op, const char *error, gpointer data);
+} FileOpCallbacks;
+
+typedef struct {
+    FileOpKind kind;
+    gboolean running;           /* FALSE while queued */
+    gboolean counting;          /* totals still growing */
+    guint64 bytes_done;
+    guint64 bytes_total;
+    guint files_done;           /* everything but folders */
+    guint files_total;
+} FileOpProgress;
+
+struct FileOp {
+    gint ref_count;
+    FileOpKind kind;
+    void (*run)(FileOp *op);    /* on the queue thread */
+    gchar **sources;
+    gchar *dest;                /* folder; the new path for a rename */
+    GCancellable *cancellable;
+    FileOpCallbacks cb;
+    gpointer data;
+
+    GMutex lock;                /* everything below */
+    GCond cond;
+    FileOpProgress progress;
+    guint n_errors;
+    gchar *first_error;
+    FileOpChoice answer;
+    FileOpChoice sticky;        /* "apply to all", else FILEOP_ASK */
+    guint pending;              /* files with the copiers */
+
+    GHashTable *kept;           /* sources skipped by a copy; job thread only */
+    GArray *dir_modes;          /* FileOpDirMode of copied folders, deepest first */
+};
+
+static struct {
+    GThreadPool *jobs;          /* one thread: jobs run in order */
+    GThreadPool *copiers;
+} fileops;
+
+static FileOp *_fileop_ref(FileOp *op) {
+    g_atomic_int_inc(&op->ref_count);
+    return op;
+}
+
+static void _fileop_unref(FileOp *op) {
+    if (!g_atomic_int_dec_and_test(&op->ref_count)) return;
+    g_strfreev(op->sources);
+    g_free(op->dest);
+    g_object_unref(op->cancellable);
+    g_mutex_clear(&op->lock);
+    g_cond_clear(&op->cond);
+    g_free(op->first_error);
+    g_hash_table_destroy(op->kept);
+    g_array_free(op->dir_modes, TRUE);
+    g_free(op);
+}
+
+static gboolean _fileop_cancelled(FileOp *op) {
+    return g_cancellable_is_cancelled(op->cancellable);
+}
+
+/* Records a failure with @reason, or the current errno */
+static void _fileop_fail_with(FileOp *op, const char *path, const char *reason) {
+    int err = errno;
+    if (!reason && err == ECANCELED) return;
+    static const char *const verbs[] = { "copy", "move", "delete", "rename", "trash", "delete",
+                                         "extract", "link" };
+    gchar *name = g_filename_display_basename(path);
+    g_mutex_lock(&op->lock);
+    if (op->n_errors++ == 0)
+        op->first_error = g_strdup_printf("Could not %s “%s”: %s", verbs[op->kind], name,
+                                          reason ? reason : g_strerror(err));
+    g_mutex_unlock(&op->lock);
+    g_free(name);
+}
+
+static void _fileop_fail(FileOp *op, const char *path) {
+    _fileop_fail_with(op, path, NULL);
+}
+
+static guint _fileop_errors(FileOp *op) {
+    g_mutex_lock(&op->lock);
+    guint n = op->n_errors;
+    g_mutex_unlock(&op->lock);
+    return n;
+}
+
+static void _fileop_add(FileOp *op, guint64 bytes, guint files) {
+    g_mutex_lock(&op->lock);
+    op->progress.bytes_done += bytes;
+    op->progress.files_done += files;
+    g_mutex_unlock(&op->lock);
+}
+
+/* Totals for everything below @path */
+static void _fileop_count(FileOp *op, const char *path) {
+    struct stat st;
+    if (_fileop_cancelled(op) || lstat(path, &st) != 0) return;
+    if (!S_ISDIR(st.st_mode)) {
+        g_mutex_lock(&op->lock);
+        op->progress.files_total++;
+        if (S_ISREG(st.st_mode) && op->kind != FILEOP_DELETE) op->progress.bytes_total += (guint64)st.st_size;
+        g_mutex_unlock(&op->lock);
+        return;
+    }
+    DIR *dp = opendir(path);
+    if (!dp) return;
+    struct dirent *de;
+    while ((de = readdir(dp))) {
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) continue;
+        gchar *child = g_build_filename(path, de->d_name, NULL);
+        _fileop_count(op, child);
+        g_free(child);
+    }
+    closedir(dp);
+}
+
+/* ── Data Copy ──────────────────────────────────────────── */
+/* Copies @in to @out from their current offsets to EOF; FALSE with
+ * errno set */
+static gboolean _fileop_copy_data(FileOp *op, int in, int out, guint64 size) {
+#ifdef FICLONE
+    if (size > 0 && ioctl(out, FICLONE, in) == 0) {
+        _fileop_add(op, size, 0);
+        return TRUE;
+    }
+#endif
+    enum { KERNEL_COPY, SENDFILE, READ_WRITE } method = KERNEL_COPY;
+    char *buf = NULL;
+    gboolean ok = TRUE;
+
+    while (TRUE) {
+        if (_fileop_cancelled(op)) {
+            errno = ECANCELED;
+            ok = FALSE;
+            break;
+        }
+
+        ssize_t n;
+        if (method == KERNEL_COPY) {
+            n = copy_file_range(in, NULL, out, NULL, FILEOPS_CHUNK, 0);
+            if (n < 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL ||
+                          errno == EOPNOTSUPP || errno == EBADF)) {
+                method = SENDFILE;
+                continue;
+            }
+        } else if (method == SENDFILE) {
+            n = sendfile(out, in, NULL, FILEOPS_CHUNK);
+            if (n < 0 && (errno == EINVAL || errno == ENOSYS)) {
+                method = READ_WRITE;
+                continue;
+            }
+        } else {
+            if (!buf) buf = g_malloc(FILEOPS_BUFFER);
+            n = read(in, buf, FILEOPS_BUFFER);
+            for (ssize_t off = 0; n > 0 && off < n;) {
+                ssize_t w = write(out, buf + off, (size_t)(n - off));
+                if (w < 0 && errno == EINTR) continue;
+                if (w < 0) n = -1;
+                else off += w;
+            }
+        }
+
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            ok = FALSE;
+            break;
+        }
+        if (n == 0) {
+            /* Some filesystems (procfs, sysfs) report EOF to the kernel
+             * copy paths early; read the rest the plain way */
+            if (method != READ_WRITE && lseek(in, 0, SEEK_CUR) < (off_t)size) {
+                method = READ_WRITE;
+                continue;
+            }
+            break;
+        }
+        _fileop_add(op, (guint64)n, 0);
+    }
+
+    g_free(buf);
+    return ok;
+}
+
+/* Copies the regular file @src to the new file @dest, keeping mode and
+ * timestamps; a partial copy is removed */
+static gboolean _fileop_copy_file(FileOp *op, const char *src, const char *dest,
+                                  const struct stat *st) {
+    int in = open(src, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (in < 0) return FALSE;
+    int out = open(dest, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (out < 0) {
+        close(in);
+        return FALSE;
+    }
+    posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    gboolean ok = _fileop_copy_data(op, in, out, (guint64)st->st_size);
+    if (ok) {
+        struct timespec times[2] = { st->st_atim, st->st_mtim };
+        fchmod(out, st->st_mode & 07777);
+        futimens(out, times);
+    }
+    int err = errno;
+    if (close(out) != 0 && ok) {
+        ok = FALSE;
+        err = errno;
+    }
+    close(in);
+    if (!ok) {
+        unlink(dest);
+        errno = err;
+    }
+    return ok;
+}
+
+typedef struct {
+    FileOp *op;
+    gchar *src;
+    gchar *dest;
+    struct stat st;
+} FileCopyTask;
+
+static void _fileop_copier(gpointer data, gpointer user_data) {
+    (void)user_data;
+    FileCopyTask *task = data;
+    FileOp *op = task->op;
+
+    if (!_fileop_cancelled(op) && !_fileop_copy_file(op, task->src, task->dest, &task->st))
+        _fileop_fail(op, task->src);
+    _fileop_add(op, 0, 1);
+
+    g_mutex_lock(&op->lock);
+    op->pending--;
+    g_cond_broadcast(&op->cond);
+    g_mutex_unlock(&op->lock);
+
+    g_free(task->src);
+    g_free(task->dest);
+    g_free(task);
+    _fileop_unref(op);
+}
+
+static void _fileop_wait_copiers(FileOp *op) {
+    g_mutex_lock(&op->lock);
+    while (op->pending > 0)
+        g_cond_wait(&op->cond, &op->lock);
+    g_mutex_unlock(&op->lock);
+}
+
+/* Once the copiers are done: children were recorded before their
+ * parents, so a folder made read-only is already full */
+static void _fileop_apply_dir_modes(FileOp *op) {
+    for (guint i = 0; i < op->dir_modes->len; i++) {
+        FileOpDirMode *dm = &g_array_index(op->dir_modes, FileOpDirMode, i);
+        chmod(dm->path, dm->mode);
+        g_free(dm->path);
+    }
+    g_array_set_size(op->dir_modes, 0);
+}
+
+/* ── Conflicts ──────────────────────────────────────────── */
+typedef struct {
+    FileOp *op;
+    gchar *src;
+    gchar *dest;
+} FileOpQuestion;
+
+static gboolean _fileop_deliver_question(gpointer data) {
+    FileOpQuestion *q = data;
+    if (!_fileop_cancelled(q->op))
+        q->op->cb.conflict(q->op, q->src, q->dest, q->op->data);
+    _fileop_unref(q->op);
+    g_free(q->src);
+    g_free(q->dest);
+    g_free(q);
+    return G_SOURCE_REMOVE;
+}
+
+/* Blocks the job until the main thread answers */
+static FileOpChoice _fileop_ask(FileOp *op, const char *src, const char *dest) {
+    g_mutex_lock(&op->lock);
+    FileOpChoice choice = op->sticky;
+    if (choice == FILEOP_ASK && op->cb.conflict) {
+        op->answer = FILEOP_ASK;
+        FileOpQuestion *q = g_new(FileOpQuestion, 1);
+        q->op = _fileop_ref(op);
+        q->src = g_strdup(src);
+        q->dest = g_strdup(dest);
+        g_idle_add(_fileop_deliver_question, q);
+
+        while (op->answer == FILEOP_ASK && !_fileop_cancelled(op))
+            g_cond_wait(&op->cond, &op->lock);
+        choice = _fileop_cancelled(op) ? FILEOP_ABORT : op->answer;
+    } else if (choice == FILEOP_ASK) {
+        choice = FILEOP_SKIP;
+    }
+    g_mutex_unlock(&op->lock);
+
+    if (choice == FILEOP_ABORT) g_cancellable_cancel(op->cancellable);
+    return choice;
+}
+
+/* "name (2).ext", the first such name not taken */
+static gchar *_fileop_free_name(const char *path, gboolean is_dir) {
+    gchar *dir = g_path_get_dirname(path);
+    gchar *base = g_path_get_basename(path);
+    const char *ext = is_dir ? NULL : strrchr(base, '.');
+    if (ext == base) ext = NULL;
+    int stem = ext ? (int)(ext - base) : (int)strlen(base);
+
+    gchar *result = NULL;
+    for (int i = 2; !result; i++) {
+        gchar *name = g_strdup_printf("%.*s (%d)%s", stem, base, i, ext ? ext : "");
+        gchar *candidate = g_build_filename(dir, name, NULL);
+        g_free(name);
+        struct stat st;
+        if (lstat(candidate, &st) != 0) result = candidate;
+        else g_free(candidate);
+    }
+    g_free(dir);
+    g_free(base);
+    return result;
+}
+
+/* ── Delete ─────────────────────────────────────────────── */
+/* Deletes @path and everything below it, never following symlinks */
+static gboolean _fileop_remove_tree(FileOp *op, const char *path, gboolean count) {
+    if (unlink(path) == 0) {
+        if (count) _fileop_add(op, 0, 1);
+        return TRUE;
+    }
+    if (errno != EISDIR && errno != EPERM) {
+        _fileop_fail(op, path);
+        return FALSE;
+    }
+
+    int fd = open(path, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    DIR *dp = fd >= 0 ? fdopendir(fd) : NULL;
+    if (!dp) {
+        _fileop_fail(op, path);
+        if (fd >= 0) close(fd);
+        return FALSE;
+    }
+    gboolean ok = TRUE;
+    struct dirent *de;
+    while ((de = readdir(dp)) && !_fileop_cancelled(op)) {
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) continue;
+        gchar *child = g_build_filename(path, de->d_name, NULL);
+        ok = _fileop_remove_tree(op, child, count) && ok;
+        g_free(child);
+    }
+    closedir(dp);
+
+    if (_fileop_cancelled(op)) return FALSE;
+    if (ok && rmdir(path) != 0) {
+        _fileop_fail(op, path);
+        ok = FALSE;
+    }
+    return ok;
+}
+
+/* After a move by copy: deletes @path less the sources the copy kept,
+ * and the folders holding them. TRUE if @path is gone. */
+static gboolean _fileop_remove_moved(FileOp *op, const char *path) {
+    if (g_hash_table_size(op->kept) == 0) return _fileop_remove_tree(op, path, FALSE);
+    if (g_hash_table_contains(op->kept, path)) return FALSE;
+
+    struct stat st;
+    if (lstat(path, &st) != 0 || !S_ISDIR(st.st_mode)) return _fileop_remove_tree(op, path, FALSE);
+    DIR *dp = opendir(path);
+    if (!dp) {
+        _fileop_fail(op, path);
+        return FALSE;
+    }
+    gboolean all = TRUE;
+    struct dirent *de;
+    while ((de = readdir(dp)) && !_fileop_cancelled(op)) {
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) continue;
+        gchar *child = g_build_filename(path, de->d_name, NULL);
+        all = _fileop_remove_moved(op, child) && all;
+        g_free(child);
+    }
+    closedir(dp);
+
+    if (!all || _fileop_cancelled(op)) return FALSE;
+    if (rmdir(path) != 0) {
+        _fileop_fail(op, path);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* ── Copy ───────────────────────────────────────────────── */
+/* Where @src goes given that @dest may exist; NULL to skip it. Replacing
+ * deletes the old one first, so it is refused when @src lies inside
+ * @dest (~/foo/foo onto ~/foo): that would delete the source. */
+static gchar *_fileop_target(FileOp *op, const char *src, const char *dest,
+                             const struct stat *st, gboolean *merge) {
+    *merge = FALSE;
+    struct stat dst;
+    if (lstat(dest, &dst) != 0) return g_strdup(dest);
+
+    gboolean is_dir = S_ISDIR(st->st_mode);
+    if (st->st_dev == dst.st_dev && st->st_ino == dst.st_ino)
+        return op->kind == FILEOP_COPY ? _fileop_free_name(dest, is_dir) : NULL;
+    if (is_dir && S_ISDIR(dst.st_mode)) {
+        *merge = TRUE;
+        return g_strdup(dest);
+    }
+    gsize len = strlen(dest);
+    if (strncmp(src, dest, len) == 0 && src[len] == '/') {
+        _fileop_fail_with(op, src, "the source is inside the destination");
+        return NULL;
+    }
+
+    switch (_fileop_ask(op, src, dest)) {
+    case FILEOP_REPLACE:
+        return _fileop_remove_tree(op, dest, FALSE) ? g_strdup(dest) : NULL;
+    case FILEOP_KEEP_BOTH:
+        return _fileop_free_name(dest, is_dir);
+    default:
+        return NULL;
+    }
+}
+
+static void _fileop_copy_tree(FileOp *op, const char *src, const char *dest) {
+    if (_fileop_cancelled(op)) return;
+    struct stat st;
+    if (lstat(src, &st) != 0) {
+        _fileop_fail(op, src);
+        return;
+    }
+
+    gboolean merge;
+    gchar *target = _fileop_target(op, src, dest, &st, &merge);
+    if (!target) {
+        if (!S_ISDIR(st.st_mode)) _fileop_add(op, S_ISREG(st.st_mode) ? (guint64)st.st_size : 0, 1);
+        g_hash_table_add(op->kept, g_strdup(src));
+        return;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        if (!merge && mkdir(target, 0700) != 0) {
+            _fileop_fail(op, src);
+            g_free(target);
+            return;
+        }
+        DIR *dp = opendir(src);
+        if (!dp) {
+            _fileop_fail(op, src);
+        } else {
+            struct dirent *de;
+            while ((de = readdir(dp)) && !_fileop_cancelled(op)) {
+                if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) continue;
+                gchar *child_src = g_build_filename(src, de->d_name, NULL);
+                gchar *child_dest = g_build_filename(target, de->d_name, NULL);
+                _fileop_copy_tree(op, child_src, child_dest);
+                g_free(child_src);
+                g_free(child_dest);
+            }
+            closedir(dp);
+        }
+        if (!merge) {
+            /* After its contents: the copiers may still be filling it */
+            FileOpDirMode dm = { g_strdup(target), st.st_mode & 07777 };
+            g_array_append_val(op->dir_modes, dm);
+        }
+    } else if (S_ISLNK(st.st_mode)) {
+        char link[4096];
+        ssize_t n = readlink(src, link, sizeof(link) - 1);
+        if (n >= 0) link[n] = '\0';
+        if (n < 0 || symlink(link, target) != 0) _fileop_fail(op, src);
+        _fileop_add(op, 0, 1);
+    } else if (S_ISREG(st.st_mode) && st.st_size < FILEOPS_SMALL_FILE && fileops.copiers) {
+        FileCopyTask *task = g_new(FileCopyTask, 1);
+        task->op = _fileop_ref(op);
+        task->src = g_strdup(src);
+        task->dest = target;
+        task->st = st;
+        g_mutex_lock(&op->lock);
+        op->pending++;
+        g_mutex_unlock(&op->lock);
+        g_thread_pool_push(fileops.copiers, task, NULL);
+        return;
+    } else if (S_ISREG(st.st_mode)) {
+        if (!_fileop_copy_file(op, src, target, &st)) _fileop_fail(op, src);
+        _fileop_add(op, 0, 1);
+    } else {
+        errno = EOPNOTSUPP;     /* devices, sockets, FIFOs */
+        _fileop_fail(op, src);
+        _fileop_add(op, 0, 1);
+    }
+    g_free(target);
+}
+
+/* Refuses to copy or move a folder into itself */
+static gboolean _fileop_into_self(FileOp *op, const char *src, const char *dest) {
+    gsize len = strlen(src);
+    if (strncmp(dest, src, len) != 0 || (dest[len] != '/' && dest[len] != '\0')) return FALSE;
+    _fileop_fail_with(op, src, "the destination is inside it");
+    return TRUE;
+}
+
+static int _fileop_rename_noreplace(const char *from, const char *to) {
+    if (renameat2(AT_FDCWD, from, AT_FDCWD, to, RENAME_NOREPLACE) == 0) return 0;
+    if (errno != EINVAL && errno != ENOSYS) return -1;
+    /* Filesystem without RENAME_NOREPLACE */
+    struct stat st;
+    if (lstat(to, &st) == 0) {
+        errno = EEXIST;
+        return -1;
+    }
+    return rename(from, to);
+}
+
+/* ── Jobs ───────────────────────────────────────────────── */
+static void _fileop_run_copy(FileOp *op) {
+    for (gchar **s = op->sources; *s; s++) _fileop_count(op, *s);
+    g_mutex_lock(&op->lock);
+    op->progress.counting = FALSE;
+    g_mutex_unlock(&op->lock);
+
+    for (gchar **s = op->sources; *s && !_fileop_cancelled(op); s++) {
+        if (_fileop_into_self(op, *s, op->dest)) continue;
+        gchar *base = g_path_get_basename(*s);
+        gchar *dest = g_build_filename(op->dest, base, NULL);
+        _fileop_copy_tree(op, *s, dest);
+        g_free(dest);
+        g_free(base);
+    }
+}
+
+/* Renames what it can; the rest is copied, then deleted if all of it
+ * arrived, except what was skipped */
+static void _fileop_run_move(FileOp *op) {
+    for (gchar **s = op->sources; *s && !_fileop_cancelled(op); s++) {
+        if (_fileop_into_self(op, *s, op->dest)) continue;
+        gchar *base = g_path_get_basename(*s);
+        gchar *dest = g_build_filename(op->dest, base, NULL);
+        g_free(base);
+
+        struct stat st;
+        gboolean merge = FALSE;
+        gchar *target = NULL;
+        if (lstat(*s, &st) != 0) _fileop_fail(op, *s);
+        else target = _fileop_target(op, *s, dest, &st, &merge);
+        g_free(dest);
+        if (!target) continue;
+
+        if (!merge && _fileop_rename_noreplace(*s, target) == 0) {
+            g_mutex_lock(&op->lock);
+            op->progress.files_total++;
+            op->progress.files_done++;
+            g_mutex_unlock(&op->lock);
+        } else if (merge || errno == EXDEV) {
+            _fileop_count(op, *s);
+            guint errors = _fileop_errors(op);
+            _fileop_copy_tree(op, *s, target);
+            _fileop_wait_copiers(op);
+            if (_fileop_errors(op) == errors && !_fileop_cancelled(op))
+                _fileop_remove_moved(op, *s);
+        } else {
+            _fileop_fail(op, *s);
+        }
+        g_free(target);
+    }
+}
+
+static void _fileop_run_delete(FileOp *op) {
+    for (gchar **s = op->sources; *s; s++) _fileop_count(op, *s);
+    g_mutex_lock(&op->lock);
+    op->progress.counting = FALSE;
+    g_mutex_unlock(&op->lock);
+
+    for (gchar **s = op->sources; *s && !_fileop_cancelled(op); s++)
+        _fileop_remove_tree(op, *s, TRUE);
+}
+
+static void _fileop_run_rename(FileOp *op) {
+    if (_fileop_rename_noreplace(op->sources[0], op->dest) != 0)
+        _fileop_fail(op, op->sources[0]);
+}
+
+static gboolean _fileop_deliver_done(gpointer data) {
+    FileOp *op = data;
+    gchar *error = NULL;
+    if (op->n_errors > 1)
+        error = g_strdup_printf("%s\n(and %u more)", op->first_error, op->n_errors - 1);
+    else if (op->n_errors == 1)
+        error = g_strdup(op->first_error);
+    if (op->cb.done) op->cb.done(op, error, op->data);
+    g_free(error);
+    _fileop_unref(op);
+    return G_SOURCE_REMOVE;
+}
+
+static void _fileop_run(gpointer data, gpointer user_data) {
+    (void)user_data;
+    FileOp *op = data;
+    g_mutex_lock(&op->lock);
+    op->progress.running = TRUE;
+    g_mutex_unlock(&op->lock);
+
+    if (!_fileop_cancelled(op)) op->run(op);
+    _fileop_wait_copiers(op);
+    _fileop_apply_dir_modes(op);
+
+    g_mutex_lock(&op->lock);
+    op->progress.counting = FALSE;
+    op->progress.running = FALSE;
+    g_mutex_unlock(&op->lock);
+    g_idle_add(_fileop_deliver_done, op);
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+static void fileops_init(void) {
+    fileops.jobs = g_thread_pool_new(_fileop_run, NULL, 1, FALSE, NULL);
+    gint copiers = CLAMP((gint)g_get_num_processors(), 1, FILEOPS_MAX_COPIERS);
+    fileops.copiers = g_thread_pool_new(_fileop_copier, NULL, copiers, FALSE, NULL);
+}
+
+/* A job not queued yet, so its totals can be set up front */
+static FileOp *_fileop_new(FileOpKind kind, void (*run)(FileOp *op),
+                           const char *const *sources, const char *dest,
+                           const FileOpCallbacks *cb, gpointer data) {
+    FileOp *op = g_new0(FileOp, 1);
+    op->ref_count = 1;
+    op->kind = kind;
+    op->run = run;
+    op->sources = g_strdupv((gchar **)sources);
+    op->dest = g_strdup(dest);
+    op->cancellable = g_cancellable_new();
+    op->cb = *cb;
+    op->data = data;
+    g_mutex_init(&op->lock);
+    g_cond_init(&op->cond);
+    op->progress.kind = kind;
+    op->progress.counting = TRUE;
+    op->answer = op->sticky = FILEOP_ASK;
+    op->kept = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    op->dir_modes = g_array_new(FALSE, FALSE, sizeof(FileOpDirMode));
+    return op;
+}
+
+static FileOp *_fileop_push(FileOp *op) {
+    g_thread_pool_push(fileops.jobs, op, NULL);
+    return op;
+}
+
+static FileOp *_fileop_queue(FileOpKind kind, void (*run)(FileOp *op),
+                             const char *const *sources, const char *dest,
+                             const FileOpCallbacks *cb, gpointer data) {
+    return _fileop_push(_fileop_new(kind, run, sources, dest, cb, data));
+}
+
+/* The returned job stays valid until its done callback returns */
+static FileOp *fileop_copy(const char *const *sources, const char *dest_dir,
+                           const FileOpCallbacks *cb, gpointer data) {
+    return _fileop_queue(FILEOP_COPY, _fileop_run_copy, sources, dest_dir, cb, data);
+}
+
+static FileOp *fileop_move(const char *const *sources, const char *dest_dir,
+                           const FileOpCallbacks *cb, gpointer data) {
+    return _fileop_queue(FILEOP_MOVE, _fileop_run_move, sources, dest_dir, cb, data);
+}
+
+static FileOp *fileop_delete(const char *const *paths, const FileOpCallbacks *cb, gpointer data) {
+    return _fileop_queue(FILEOP_DELETE, _fileop_run_delete, paths, NULL, cb, data);
+}
+
+/* Fails rather than replace an existing @new_name */
+static FileOp *fileop_rename(const char *path, const char *new_name,
+                             const FileOpCallbacks *cb, gpointer data) {
+    const char *sources[] = { path, NULL };
+    gchar *dir = g_path_get_dirname(path);
+    gchar *dest = g_build_filename(dir, new_name, NULL);
+    FileOp *op = _fileop_queue(FILEOP_RENAME, _fileop_run_rename, sources, dest, cb, data);
+    g_free(dest);
+    g_free(dir);
+    return op;
+}
+
+static void fileop_progress(FileOp *op, FileOpProgress *out) {
+    g_mutex_lock(&op->lock);
+    *out = op->progress;
+    g_mutex_unlock(&op->lock);
+}
+
+/* Answers the pending conflict; @apply_all answers the later ones too */
+static void fileop_resolve(FileOp *op, FileOpChoice choice, gboolean apply_all) {
+    g_mutex_lock(&op->lock);
+    op->answer = choice;
+    if (apply_all) op->sticky = choice;
+    g_cond_broadcast(&op->cond);
+    g_mutex_unlock(&op->lock);
+}
+
+/* Stops after the current chunk; a partly copied file is removed. The
+ * done callback still runs. */
+static void fileop_cancel(FileOp *op) {
+    g_cancellable_cancel(op->cancellable);
+    g_mutex_lock(&op->lock);
+    g_cond_broadcast(&op->cond);
+    g_mutex_unlock(&op->lock);
+}
+
+#endif /* BLAZENEURO_FILES_FILEOPS_H */
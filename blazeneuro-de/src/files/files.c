@@ -3,6 +3,8 @@
  * Modern file manager with sidebar, icon view, and context menus.
  */
 
+#define _GNU_SOURCE
+
 #include <gtk/gtk.h>
 #include <gio/gio.h>
 #include <glib/gstdio.h>
@@ -10,169 +12,1390 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 
+#include "../common/applet.h"
+#include "../common/pathindex.h"
 #include "../common/theme.h"
 #include "../common/titlebar.h"
+#include "archivefs.h"
+#include "dirload.h"
+#include "dirwatch.h"
+#include "dupview.h"
+#include "findview.h"
+#include "duview.h"
+#include "fileops.h"
+#include "filesmodel.h"
+#include "listcache.h"
+#include "metaload.h"
+#include "prefetch.h"
+#include "walker.h"
+#include "thumbs.h"
+#include "trash.h"
+#include "volumes.h"
 
 /* ── Globals ────────────────────────────────────────────── */
 static GtkWidget *icon_view;
+static GtkWidget *list_view;            /* the details view */
+static GtkWidget *view_stack;
+static GtkWidget *view_button;
+static gboolean details_view = FALSE;   /* list_view is shown, and has the model */
+static GtkTreeViewColumn *sort_columns[FILES_N_SORTS];
 static GtkWidget *path_label;
 static GtkWidget *sidebar_list;
+static GtkWidget *volumes_anchor;       /* the sidebar row volumes follow */
+static GHashTable *volume_rows = NULL;  /* mount point -> its sidebar row */
+static Volumes *volumes = NULL;
 static GtkWidget *main_window;
-static GtkListStore *file_store;
+static GtkWidget *load_spinner;
+static GtkWidget *search_entry;
+static FilesModel *file_model;
+static guint visible_source = 0;
+static guint flush_source = 0;
+static gdouble saved_scroll = 0;
+static GArray *saved_selection = NULL;  /* record indices */
+static DirLoad *current_load = NULL;
+static DirLoad *update_load = NULL;     /* applying monitor changes */
+static MetaLoad *meta_load = NULL;      /* details of rows on screen */
+static DirWatch *dir_watch = NULL;
+static gboolean watch_after_open = FALSE;   /* network share: watch once read */
+static Walk *current_walk = NULL;
+static PathIndex *path_index = NULL;    /* kept by blazeneuro-indexer */
+static gboolean searching = FALSE;      /* the view shows search results */
+static gchar *archive_file = NULL;      /* the archive being browsed, if any */
+static ArchiveIndex *archive_index = NULL;
+static ArchiveLoad *archive_load = NULL;
+static ArchiveSearch *archive_search = NULL;
+static GtkWidget *back_btn;
+static GtkWidget *forward_btn;
+static GQueue back_history = G_QUEUE_INIT;      /* paths, most recent first */
+static GQueue forward_history = G_QUEUE_INIT;
+static GQueue file_ops = G_QUEUE_INIT;          /* FileOp*, oldest first */
+static GtkWidget *ops_bar;
+static GtkWidget *ops_label;
+static GtkWidget *ops_progress;
+static guint ops_timer = 0;
+static GtkWidget *conflict_dialog = NULL;
+static FileOp *conflict_op = NULL;
+static gchar **clip_uris = NULL;        /* what we put on the clipboard */
+static gchar *trash_dir = NULL;         /* the home trash's files/ */
+static GtkWidget *trash_size_label;
+static gboolean clip_cut = FALSE;
 static char current_path[4096];
 static gboolean show_hidden = FALSE;
-
-enum {
-    COL_ICON,
-    COL_NAME,
-    COL_PATH,
-    COL_IS_DIR,
-    NUM_COLS
-};
+static FilesSortKey sort_key = FILES_SORT_NAME;
+static gboolean sort_descending = FALSE;
+static gint64 bench_start = 0;          /* set when BLAZENEURO_FILES_BENCH is */
+static gint64 bench_first_paint = 0;
+static gboolean bench_loaded = FALSE;
 
 /* ── Forward declarations ───────────────────────────────── */
 static void populate_files(const char *path);
+static void start_search(const char *query);
+static void queue_visible_items(void);
+static void add_meta_item(GArray *items, GtkTreeIter *iter, guint rec);
+static void start_details(GArray *items);
+static void cancel_details(void);
+static void show_archive(void);
+static void open_archive_member(const char *path);
+static void offer_paths(gchar **paths, gboolean cut);
 
 /* ── Populate Files ─────────────────────────────────────── */
+/* The first screenful is announced at once, later batches at most every
+ * LOAD_FLUSH_MSEC: each large flush rebuilds the icon view's item list */
+#define LOAD_FLUSH_MSEC 250
+
+static gboolean flush_loaded(gpointer data) {
+    (void)data;
+    flush_source = 0;
+    files_model_flush(file_model);
+    queue_visible_items();
+    return G_SOURCE_REMOVE;
+}
+
+static void watch_current(void);
+
+static void on_load_batch(const DirEntry *entries, guint n, gpointer data) {
+    (void)data;
+    if (watch_after_open) watch_current();
+    gboolean first = gtk_tree_model_iter_n_children(GTK_TREE_MODEL(file_model), NULL) == 0;
+    files_model_append(file_model, entries, n);
+    if (first)
+        flush_loaded(NULL);
+    else if (!flush_source)
+        flush_source = g_timeout_add(LOAD_FLUSH_MSEC, flush_loaded, NULL);
+}
+
+static void on_load_done(gboolean ok, gpointer data) {
+    (void)data;
+    if (watch_after_open) watch_current();
+    /* The mtime the worker read from the open folder before listing it:
+     * what the listing cache compares against */
+    FilesListing *listing = files_model_get_listing(file_model);
+    listing->dir_mtime = current_load->dir_mtime;
+    listing->complete = ok;
+    if (flush_source) g_source_remove(flush_source);
+    flush_loaded(NULL);
+    gtk_spinner_stop(GTK_SPINNER(load_spinner));
+    dirload_unref(current_load);
+    current_load = NULL;
+    if (bench_start) {
+        bench_loaded = TRUE;
+        gtk_widget_queue_draw(icon_view);
+    }
+}
+
+/* ── Benchmark ──────────────────────────────────────────── */
+/* For bench/files-bench.sh: times the first folder from startup to the
+ * first frame showing any of it and to the first frame once all of it
+ * is in, prints the results as key=value lines and quits */
+static gboolean on_bench_draw(GtkWidget *widget, cairo_t *cr, gpointer data) {
+    (void)cr; (void)data;
+    gint rows = gtk_tree_model_iter_n_children(GTK_TREE_MODEL(file_model), NULL);
+    gint64 now = g_get_monotonic_time();
+    if (!bench_first_paint && (rows > 0 || bench_loaded)) bench_first_paint = now;
+    if (!bench_loaded) return FALSE;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("bench_entries=%d\n", rows);
+    printf("bench_first_paint_us=%" G_GINT64_FORMAT "\n", bench_first_paint - bench_start);
+    printf("bench_populated_us=%" G_GINT64_FORMAT "\n", now - bench_start);
+    printf("bench_peak_rss_kib=%ld\n", usage.ru_maxrss);
+    fflush(stdout);
+
+    bench_start = 0;
+    g_signal_handlers_disconnect_by_func(widget, on_bench_draw, NULL);
+    g_application_quit(g_application_get_default());
+    return FALSE;
+}
+
+/* ── Views ──────────────────────────────────────────────── */
+/* The icon view or the details view, whichever is shown. Only that one
+ * has the model, so the other costs nothing while the folder changes. */
+static GtkWidget *shown_view(void) {
+    return details_view ? list_view : icon_view;
+}
+
+/* GtkTreePaths; free with gtk_tree_path_free() */
+static GList *view_get_selected(void) {
+    if (details_view)
+        return gtk_tree_selection_get_selected_rows(
+            gtk_tree_view_get_selection(GTK_TREE_VIEW(list_view)), NULL);
+    return gtk_icon_view_get_selected_items(GTK_ICON_VIEW(icon_view));
+}
+
+static void view_select_path(GtkTreePath *path) {
+    if (details_view)
+        gtk_tree_selection_select_path(gtk_tree_view_get_selection(GTK_TREE_VIEW(list_view)),
+                                       path);
+    else
+        gtk_icon_view_select_path(GTK_ICON_VIEW(icon_view), path);
+}
+
+static void view_set_model(GtkTreeModel *model) {
+    if (details_view)
+        gtk_tree_view_set_model(GTK_TREE_VIEW(list_view), model);
+    else
+        gtk_icon_view_set_model(GTK_ICON_VIEW(icon_view), model);
+}
+
+/* Keeps scroll position and selection across a model resync */
+static gboolean restore_scroll(gpointer data) {
+    (void)data;
+    GtkAdjustment *vadj = gtk_scrollable_get_vadjustment(GTK_SCROLLABLE(shown_view()));
+    gtk_adjustment_set_value(vadj, saved_scroll);
+    return G_SOURCE_REMOVE;
+}
+
+static void on_model_resync(FilesModel *model, gboolean detach, gpointer data) {
+    (void)data;
+    if (!icon_view) return;
+
+    if (detach) {
+        saved_scroll = gtk_adjustment_get_value(
+            gtk_scrollable_get_vadjustment(GTK_SCROLLABLE(shown_view())));
+        g_array_set_size(saved_selection, 0);
+        GList *selected = view_get_selected();
+        for (GList *l = selected; l; l = l->next) {
+            GtkTreeIter iter;
+            if (gtk_tree_model_get_iter(GTK_TREE_MODEL(model), &iter, l->data)) {
+                guint rec = files_model_iter_record(model, &iter);
+                g_array_append_val(saved_selection, rec);
+            }
+        }
+        g_list_free_full(selected, (GDestroyNotify)gtk_tree_path_free);
+        view_set_model(NULL);
+        return;
+    }
+
+    view_set_model(GTK_TREE_MODEL(model));
+    for (guint i = 0; i < saved_selection->len; i++) {
+        GtkTreeIter iter;
+        if (!files_model_record_iter(model, g_array_index(saved_selection, guint, i), &iter))
+            continue;
+        GtkTreePath *path = gtk_tree_model_get_path(GTK_TREE_MODEL(model), &iter);
+        view_select_path(path);
+        gtk_tree_path_free(path);
+    }
+    /* After the view's own relayout, which runs at a higher priority */
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, restore_scroll, NULL, NULL);
+}
+
+/* ── Live Updates ───────────────────────────────────────── */
+static void on_update_batch(const DirEntry *entries, guint n, gpointer data) {
+    (void)data;
+    /* Rewritten in place: the old previews are stale */
+    for (guint i = 0; i < n; i++) {
+        if (entries[i].gone) continue;
+        gchar *full = g_build_filename(current_path, entries[i].name, NULL);
+        thumbs_invalidate(full);
+        g_free(full);
+    }
+    files_model_update(file_model, entries, n);
+    queue_visible_items();
+}
+
+static void on_update_done(gboolean ok, gpointer data) {
+    (void)ok; (void)data;
+
+    /* Everything seen so far is applied: the listing matches the folder
+     * as of the mtime read before the update looked at it, not as of
+     * now, since a change made meanwhile may still be on its way from
+     * the monitor. The listing cache compares against this. */
+    if (!dirwatch_pending(dir_watch))
+        files_model_get_listing(file_model)->dir_mtime = update_load->dir_mtime;
+    dirload_unref(update_load);
+    update_load = NULL;
+}
+
+/* One update at a time, and never during the initial listing, so
+ * results are applied in the order the changes happened */
+static gboolean on_dir_changed(const char *const *names, gpointer data) {
+    (void)data;
+    if (current_load || update_load) return FALSE;
+    update_load = dirload_start_names(current_path, names, TRUE,
+                                      on_update_batch, on_update_done, NULL);
+    return TRUE;
+}
+
+static gboolean show_existing_parent(gpointer data) {
+    (void)data;
+    gchar *path = g_strdup(current_path);
+    while (!g_file_test(path, G_FILE_TEST_IS_DIR) && strcmp(path, "/") != 0) {
+        gchar *parent = g_path_get_dirname(path);
+        g_free(path);
+        path = parent;
+    }
+    populate_files(path);
+    g_free(path);
+    return G_SOURCE_REMOVE;
+}
+
+/* The open folder was deleted or moved away */
+static void on_dir_vanished(gpointer data) {
+    (void)data;
+    g_idle_add(show_existing_parent, NULL);
+}
+
+/* Setting up the monitor resolves the path on this thread, which a hung
+ * network mount never answers; there it waits until the listing worker
+ * has opened the folder */
+static void watch_current(void) {
+    watch_after_open = FALSE;
+    dir_watch = dirwatch_new(current_path, on_dir_changed, on_dir_vanished, NULL);
+}
+
+/* Listings of network shares are not kept: checking one is still
+ * current takes a stat() of the share on the main thread */
+static gboolean cacheable(const char *path) {
+    return !volumes_on_network(volumes, path);
+}
+
+/* After our own file operations: the monitor picks them up, unless
+ * this folder could not be watched; search results are searched again */
+static void refresh_after_change(void) {
+    if (archive_file) return;   /* nothing we do changes one */
+    if (searching)
+        start_search(gtk_entry_get_text(GTK_ENTRY(search_entry)));
+    else if (!dir_watch)
+        populate_files(current_path);
+}
+
+/* Where @path is inside the archive being browsed, "" for its top */
+static const char *archive_member(const char *path) {
+    const char *rest = path + strlen(archive_file);
+    return rest[0] == '/' ? rest + 1 : rest;
+}
+
+/* Shows @path: from the listing cache when it is still current, else by
+ * listing it in the background. A listing still in progress for the
+ * previous folder is cancelled first; a settled one is cached. */
+static void end_search(void);
+
 static void populate_files(const char *path) {
-    gtk_list_store_clear(file_store);
+    prefetch_stop();
+    gboolean was_searching = searching;
+    if (searching) end_search();
+
+    FilesListing *old = files_model_get_listing(file_model);
+    gboolean reload = !was_searching && strcmp(old->parent, path) == 0;
+    if (!was_searching && !reload && !archive_file && !current_load && !update_load &&
+        !dirwatch_pending(dir_watch) && cacheable(old->parent))
+        listcache_store(old);
+
+    dirload_cancel(current_load);
+    dirload_cancel(update_load);
+    current_load = update_load = NULL;
+    archivefs_load_cancel(archive_load);
+    archive_load = NULL;
+    archivefs_search_cancel(archive_search);
+    archive_search = NULL;
+    dirwatch_free(dir_watch);
+    dir_watch = NULL;
+    watch_after_open = FALSE;
+    thumbs_begin_pass();
+    thumbs_end_pass();
+    if (flush_source) g_source_remove(flush_source);
+    flush_source = 0;
+
+    /* Nothing here may touch a network share on this thread: a hung one
+     * would freeze the window. No archive there, no cached listing, and
+     * the monitor waits for the worker (watch_current()). */
+    gboolean remote = volumes_on_network(volumes, path);
     g_strlcpy(current_path, path, sizeof(current_path));
+    g_free(archive_file);
+    archive_file = remote ? NULL : archivefs_split(current_path, NULL);
+    if (archive_file) {
+        show_archive();
+        return;
+    }
+
+    FilesListing *listing = reload || remote ? NULL : listcache_take(current_path);
+    gboolean cached = listing != NULL;
+    if (!cached) listing = files_listing_new(current_path);
+    cancel_details();
+    files_model_set_listing(file_model, listing);
+    files_listing_unref(listing);
+    saved_scroll = 0;   /* a new folder opens at the top */
     gtk_label_set_text(GTK_LABEL(path_label), current_path);
 
-    GDir *dir = g_dir_open(path, 0, NULL);
-    if (!dir) return;
-
-    const gchar *name;
-    while ((name = g_dir_read_name(dir)) != NULL) {
-        if (!show_hidden && name[0] == '.') continue;
-
-        gchar *full = g_build_filename(path, name, NULL);
-        gboolean is_dir = g_file_test(full, G_FILE_TEST_IS_DIR);
-
-        const char *icon_name = is_dir ? "folder" : "text-x-generic";
-
-        if (!is_dir) {
-            gchar *name_lower = g_utf8_strdown(name, -1);
-            if (g_str_has_suffix(name_lower, ".png") || g_str_has_suffix(name_lower, ".jpg") ||
-                g_str_has_suffix(name_lower, ".jpeg") || g_str_has_suffix(name_lower, ".svg"))
-                icon_name = "image-x-generic";
-            else if (g_str_has_suffix(name_lower, ".mp3") || g_str_has_suffix(name_lower, ".wav") ||
-                     g_str_has_suffix(name_lower, ".flac"))
-                icon_name = "audio-x-generic";
-            else if (g_str_has_suffix(name_lower, ".mp4") || g_str_has_suffix(name_lower, ".mkv"))
-                icon_name = "video-x-generic";
-            else if (g_str_has_suffix(name_lower, ".pdf"))
-                icon_name = "application-pdf";
-            else if (g_str_has_suffix(name_lower, ".c") || g_str_has_suffix(name_lower, ".py") ||
-                     g_str_has_suffix(name_lower, ".js") || g_str_has_suffix(name_lower, ".h"))
-                icon_name = "text-x-script";
-            else if (g_str_has_suffix(name_lower, ".zip") || g_str_has_suffix(name_lower, ".tar") ||
-                     g_str_has_suffix(name_lower, ".gz"))
-                icon_name = "package-x-generic";
-            else if (g_str_has_suffix(name_lower, ".deb"))
-                icon_name = "application-x-deb";
-            else if (g_str_has_suffix(name_lower, ".sh"))
-                icon_name = "text-x-script";
-            g_free(name_lower);
+    /* Watch before listing, so nothing created meanwhile is missed; on a
+     * share, as soon as the worker is in */
+    if (remote) watch_after_open = TRUE;
+    else watch_current();
+    if (cached) {
+        queue_visible_items();
+        return;
+    }
+
+    /* Hidden entries are always listed; the model filters them */
+    gtk_spinner_start(GTK_SPINNER(load_spinner));
+    current_load = dirload_start(current_path, TRUE,
+                                 on_load_batch, on_load_done, NULL);
+}
+
+/* ── Search ─────────────────────────────────────────────── */
+static void on_search_changed(GtkSearchEntry *entry, gpointer data);
+
+static void on_walk_done(gboolean ok, gpointer data) {
+    (void)ok; (void)data;
+    if (flush_source) g_source_remove(flush_source);
+    flush_loaded(NULL);
+    gtk_spinner_stop(GTK_SPINNER(load_spinner));
+    walk_unref(current_walk);
+    current_walk = NULL;
+}
+
+/* Leaves search mode; the caller shows a folder next */
+static void end_search(void) {
+    walk_cancel(current_walk);
+    current_walk = NULL;
+    archivefs_search_cancel(archive_search);
+    archive_search = NULL;
+    searching = FALSE;
+    gtk_spinner_stop(GTK_SPINNER(load_spinner));
+
+    g_signal_handlers_block_by_func(search_entry, on_search_changed, NULL);
+    gtk_entry_set_text(GTK_ENTRY(search_entry), "");
+    g_signal_handlers_unblock_by_func(search_entry, on_search_changed, NULL);
+}
+
+typedef struct {
+    GArray *entries;        /* DirEntry */
+    gsize skip;             /* length of the folder's own relative path */
+} IndexMatches;
+
+static gboolean on_index_match(const char *path, guint base, gboolean is_dir, gpointer data) {
+    IndexMatches *m = data;
+    DirEntry e = { 0 };
+    e.name = g_strdup(path + m->skip);
+    e.base = base - (guint)m->skip;
+    e.is_dir = is_dir;
+    e.type_known = TRUE;
+    if (is_dir) {
+        e.kind = FT_KIND_FOLDER;
+    } else {
+        e.kind = filetype_lookup(path + base);
+        if (e.kind == FT_KIND_UNKNOWN) e.kind = FT_KIND_FILE;
+    }
+    e.icon = filetype_icons[e.kind];
+    g_array_append_val(m->entries, e);
+    return TRUE;
+}
+
+/* Answers from the path index when it covers the folder: it holds no
+ * hidden files, nothing below a dot folder and no other mounts */
+static gboolean search_index(const char *query) {
+    if (show_hidden || !pathindex_refresh(path_index)) return FALSE;
+    const char *rel = pathindex_relative(path_index, current_path);
+    if (!rel || rel[0] == '.' || strstr(rel, "/.")) return FALSE;
+    struct stat here, home_st;
+    if (stat(current_path, &here) != 0 || stat(path_index->home, &home_st) != 0 ||
+        here.st_dev != home_st.st_dev)
+        return FALSE;
+
+    IndexMatches m = { g_array_new(FALSE, FALSE, sizeof(DirEntry)), rel[0] ? strlen(rel) + 1 : 0 };
+    pathindex_query(path_index, query, rel, WALK_MAX_RESULTS, on_index_match, &m);
+    if (m.entries->len > 0)
+        on_load_batch((const DirEntry *)m.entries->data, m.entries->len, NULL);
+    flush_loaded(NULL);
+    for (guint i = 0; i < m.entries->len; i++)
+        g_free(g_array_index(m.entries, DirEntry, i).name);
+    g_array_free(m.entries, TRUE);
+    return TRUE;
+}
+
+static void on_archive_found(const DirEntry *entries, const FilesStat *stats, guint n,
+                             gpointer data) {
+    (void)data;
+    archivefs_fill(file_model, entries, stats, n);
+    gtk_spinner_stop(GTK_SPINNER(load_spinner));
+    archivefs_search_unref(archive_search);
+    archive_search = NULL;
+}
+
+/* Searches the subtree of the current folder, replacing the previous
+ * search; matches come from the path index at once when it covers the
+ * folder, else stream in from a walk like a folder listing */
+static void start_search(const char *query) {
+    if (!searching) {
+        /* Park the folder so clearing the search brings it back at once */
+        FilesListing *listing = files_model_get_listing(file_model);
+        if (!archive_file && !current_load && !update_load && !dirwatch_pending(dir_watch) &&
+            cacheable(listing->parent))
+            listcache_store(listing);
+        dirload_cancel(current_load);
+        dirload_cancel(update_load);
+        current_load = update_load = NULL;
+        dirwatch_free(dir_watch);
+        dir_watch = NULL;
+        watch_after_open = FALSE;
+        searching = TRUE;
+    }
+
+    walk_cancel(current_walk);
+    thumbs_begin_pass();
+    thumbs_end_pass();
+    if (flush_source) g_source_remove(flush_source);
+    flush_source = 0;
+
+    FilesListing *results = files_listing_new(current_path);
+    cancel_details();
+    files_model_set_listing(file_model, results);
+    files_listing_unref(results);
+    saved_scroll = 0;
+    if (archive_file) {
+        /* The index has every name: no walk needed */
+        archivefs_search_cancel(archive_search);
+        archive_search = NULL;
+        if (archive_index) {
+            gtk_spinner_start(GTK_SPINNER(load_spinner));
+            archive_search = archivefs_search(archive_index, archive_member(current_path),
+                                              query, on_archive_found, NULL);
         }
+        return;
+    }
+    if (search_index(query)) return;
 
-        GtkTreeIter iter;
-        gtk_list_store_append(file_store, &iter);
-        gtk_list_store_set(file_store, &iter,
-                           COL_ICON, icon_name,
-                           COL_NAME, name,
-                           COL_PATH, full,
-                           COL_IS_DIR, is_dir,
-                           -1);
-        g_free(full);
+    gtk_spinner_start(GTK_SPINNER(load_spinner));
+    current_walk = walk_start(current_path, query, show_hidden,
+                              on_load_batch, on_walk_done, NULL);
+}
+
+/* GtkSearchEntry already waits for a pause in typing */
+static void on_search_changed(GtkSearchEntry *entry, gpointer data) {
+    (void)data;
+    const char *query = gtk_entry_get_text(GTK_ENTRY(entry));
+    if (query[0])
+        start_search(query);
+    else if (searching)
+        populate_files(current_path);
+}
+
+static void on_search_stop(GtkSearchEntry *entry, gpointer data) {
+    (void)entry; (void)data;
+    if (searching) populate_files(current_path);
+    gtk_widget_grab_focus(shown_view());
+}
+
+/* ── Thumbnails ─────────────────────────────────────────── */
+static void on_thumb_ready(const char *path, GtkTreeRowReference *row,
+                           GdkPixbuf *pixbuf, gpointer data) {
+    (void)data;
+    GtkTreeModel *model = GTK_TREE_MODEL(file_model);
+    GtkTreePath *tree_path = gtk_tree_row_reference_get_path(row);
+    GtkTreeIter iter;
+    if (gtk_tree_model_get_iter(model, &iter, tree_path)) {
+        gchar *row_path;
+        gtk_tree_model_get(model, &iter, FILES_COL_PATH, &row_path, -1);
+        if (g_strcmp0(row_path, path) == 0)
+            files_model_set_thumb(file_model, &iter, pixbuf);
+        g_free(row_path);
     }
-    g_dir_close(dir);
+    gtk_tree_path_free(tree_path);
 }
 
-/* ── Navigation ─────────────────────────────────────────── */
-static void on_item_activated(GtkIconView *view, GtkTreePath *tree_path, gpointer data) {
+/* Asks for previews of what is on screen, top to bottom; queued work
+ * for items that scrolled away is dropped. Files the listing could not
+ * type by name are sniffed first (metaload.h), then come back here. */
+static void request_visible_thumbs(void) {
+    GtkTreePath *start, *end;
+    if (!gtk_icon_view_get_visible_range(GTK_ICON_VIEW(icon_view), &start, &end))
+        return;
+
+    GtkTreeModel *model = GTK_TREE_MODEL(file_model);
+    GtkTreeIter iter;
+    gboolean valid = gtk_tree_model_get_iter(model, &iter, start);
+    GArray *untyped = g_array_new(FALSE, TRUE, sizeof(MetaItem));
+    thumbs_begin_pass();
+    while (valid) {
+        gchar *path;
+        gint kind;
+        GdkPixbuf *thumb;
+        gtk_tree_model_get(model, &iter, FILES_COL_PATH, &path, FILES_COL_KIND, &kind,
+                           FILES_COL_THUMB, &thumb, -1);
+        if (thumb) {
+            g_object_unref(thumb);
+        } else if (thumbs_supported(kind)) {
+            GdkPixbuf *cached = thumbs_lookup(path);
+            if (cached) {
+                files_model_set_thumb(file_model, &iter, cached);
+            } else {
+                GtkTreePath *tree_path = gtk_tree_model_get_path(model, &iter);
+                thumbs_request(path, kind, gtk_tree_row_reference_new(model, tree_path));
+                gtk_tree_path_free(tree_path);
+            }
+        } else if (kind == FT_KIND_UNKNOWN) {
+            add_meta_item(untyped, &iter, files_model_iter_record(file_model, &iter));
+        }
+        g_free(path);
+
+        GtkTreePath *at = gtk_tree_model_get_path(model, &iter);
+        gboolean last = gtk_tree_path_compare(at, end) >= 0;
+        gtk_tree_path_free(at);
+        valid = !last && gtk_tree_model_iter_next(model, &iter);
+    }
+    thumbs_end_pass();
+    if (untyped->len > 0) start_details(untyped);
+    else g_array_free(untyped, TRUE);
+
+    gtk_tree_path_free(start);
+    gtk_tree_path_free(end);
+}
+
+/* ── Details ────────────────────────────────────────────── */
+static void on_details_batch(const MetaItem *items, guint n, gpointer data) {
+    (void)data;
+    for (guint i = 0; i < n; i++)
+        files_model_set_details(file_model, items[i].rec, items[i].size, items[i].mtime,
+                                items[i].mode, items[i].type, items[i].kind);
+}
+
+static void on_details_done(gpointer data) {
     (void)data;
-    GtkTreeModel *model = gtk_icon_view_get_model(view);
+    metaload_cancel(meta_load);
+    meta_load = NULL;
+    /* Files typed just now may have previews */
+    if (!details_view) queue_visible_items();
+}
+
+/* Before the listing is replaced: its records mean nothing in the next */
+static void cancel_details(void) {
+    metaload_cancel(meta_load);
+    meta_load = NULL;
+}
+
+static void add_meta_item(GArray *items, GtkTreeIter *iter, guint rec) {
+    MetaItem it = { 0 };
+    gint kind;
+    it.name = g_strdup(files_model_record_name(file_model, rec));
+    it.rec = rec;
+    gtk_tree_model_get(GTK_TREE_MODEL(file_model), iter, FILES_COL_IS_DIR, &it.is_dir,
+                       FILES_COL_KIND, &kind, -1);
+    it.kind = kind;
+    g_array_append_val(items, it);
+}
+
+/* Starts reading @items (taken), replacing a read still going */
+static void start_details(GArray *items) {
+    cancel_details();
+    if (items->len == 0) {
+        g_array_free(items, TRUE);
+        return;
+    }
+    /* Archive members are typed by name alone */
+    meta_load = metaload_start(current_path, items, !archive_file,
+                               on_details_batch, on_details_done, NULL);
+}
+
+/* Reads the details of the rows on screen, then of a screenful below
+ * and above. A read still going is replaced, its undelivered rows asked
+ * for again if they are still near. */
+static void request_visible_details(void) {
+    GtkTreePath *start, *end;
+    if (!gtk_tree_view_get_visible_range(GTK_TREE_VIEW(list_view), &start, &end)) return;
+    gint first = gtk_tree_path_get_indices(start)[0];
+    gint last = gtk_tree_path_get_indices(end)[0];
+    gtk_tree_path_free(start);
+    gtk_tree_path_free(end);
+
+    GtkTreeModel *model = GTK_TREE_MODEL(file_model);
+    gint n = gtk_tree_model_iter_n_children(model, NULL);
+    gint span = last - first + 1;
+    const gint ranges[3][2] = {
+        { first, last },
+        { last + 1, MIN(n - 1, last + span) },
+        { MAX(0, first - span), first - 1 },
+    };
+    GArray *items = g_array_new(FALSE, TRUE, sizeof(MetaItem));
+    for (guint r = 0; r < G_N_ELEMENTS(ranges); r++) {
+        for (gint row = ranges[r][0]; row <= ranges[r][1]; row++) {
+            GtkTreeIter iter;
+            if (!gtk_tree_model_iter_nth_child(model, &iter, NULL, row)) break;
+            guint rec = files_model_iter_record(file_model, &iter);
+            if (!files_model_has_details(file_model, rec)) add_meta_item(items, &iter, rec);
+        }
+    }
+    start_details(items);
+}
+
+/* Folders show no size; unread rows stay blank until their details come */
+static void size_cell_data(GtkTreeViewColumn *column, GtkCellRenderer *cell,
+                           GtkTreeModel *model, GtkTreeIter *iter, gpointer data) {
+    (void)column; (void)data;
+    gboolean is_dir;
+    gint64 size;
+    gtk_tree_model_get(model, iter, FILES_COL_IS_DIR, &is_dir, FILES_COL_SIZE, &size, -1);
+    gchar *text = is_dir || size == FILES_SORT_UNKNOWN ? NULL : g_format_size((guint64)size);
+    g_object_set(cell, "text", text, NULL);
+    g_free(text);
+}
+
+static void date_cell_data(GtkTreeViewColumn *column, GtkCellRenderer *cell,
+                           GtkTreeModel *model, GtkTreeIter *iter, gpointer data) {
+    (void)column; (void)data;
+    gint64 size, mtime;
+    gtk_tree_model_get(model, iter, FILES_COL_SIZE, &size, FILES_COL_MTIME, &mtime, -1);
+    gchar *text = NULL;
+    if (size != FILES_SORT_UNKNOWN) {
+        GDateTime *dt = g_date_time_new_from_unix_local(mtime / G_GINT64_CONSTANT(1000000000));
+        if (dt) text = g_date_time_format(dt, "%Y-%m-%d %H:%M");
+        if (dt) g_date_time_unref(dt);
+    }
+    g_object_set(cell, "text", text, NULL);
+    g_free(text);
+}
+
+/* As ls shows them: rwxr-xr-x, with s and t for the special bits */
+static void mode_cell_data(GtkTreeViewColumn *column, GtkCellRenderer *cell,
+                           GtkTreeModel *model, GtkTreeIter *iter, gpointer data) {
+    (void)column; (void)data;
+    guint mode;
+    gtk_tree_model_get(model, iter, FILES_COL_MODE, &mode, -1);
+    if (!mode) {
+        g_object_set(cell, "text", NULL, NULL);
+        return;
+    }
+    char text[10];
+    for (int i = 0; i < 9; i++) text[i] = mode & (0400u >> i) ? "rwxrwxrwx"[i] : '-';
+    if (mode & S_ISUID) text[2] = text[2] == 'x' ? 's' : 'S';
+    if (mode & S_ISGID) text[5] = text[5] == 'x' ? 's' : 'S';
+    if (mode & S_ISVTX) text[8] = text[8] == 'x' ? 't' : 'T';
+    text[9] = '\0';
+    g_object_set(cell, "text", text, NULL);
+}
+
+/* Coalesces scroll and resize bursts into one pass: previews for the
+ * icon view, details for the details view. Archive members have no file
+ * to preview until unpacked. */
+static gboolean request_visible_items(gpointer data) {
+    (void)data;
+    visible_source = 0;
+    if (details_view)
+        request_visible_details();
+    else if (!archive_file)
+        request_visible_thumbs();
+    return G_SOURCE_REMOVE;
+}
+
+static void queue_visible_items(void) {
+    if (!visible_source)
+        visible_source = g_timeout_add(50, request_visible_items, NULL);
+}
+
+static void on_view_scrolled(GtkAdjustment *adj, gpointer data) {
+    (void)adj; (void)data;
+    queue_visible_items();
+}
+
+static void on_view_size_allocate(GtkWidget *widget, GdkRectangle *alloc, gpointer data) {
+    (void)widget; (void)alloc; (void)data;
+    queue_visible_items();
+}
+
+/* A preview when there is one, the type icon otherwise */
+static void icon_cell_data(GtkCellLayout *layout, GtkCellRenderer *cell,
+                           GtkTreeModel *model, GtkTreeIter *iter, gpointer data) {
+    (void)layout; (void)data;
+    gchar *icon;
+    GdkPixbuf *thumb;
+    gtk_tree_model_get(model, iter, FILES_COL_ICON, &icon, FILES_COL_THUMB, &thumb, -1);
+    if (thumb)
+        g_object_set(cell, "pixbuf", thumb, NULL);
+    else
+        g_object_set(cell, "icon-name", icon, NULL);
+    if (thumb) g_object_unref(thumb);
+    g_free(icon);
+}
+
+/* ── History ────────────────────────────────────────────── */
+#define HISTORY_MAX 64
+
+static void update_history_buttons(void) {
+    gtk_widget_set_sensitive(back_btn, !g_queue_is_empty(&back_history));
+    gtk_widget_set_sensitive(forward_btn, !g_queue_is_empty(&forward_history));
+}
+
+static void push_history(GQueue *history, const char *path) {
+    g_queue_push_head(history, g_strdup(path));
+    if (history->length > HISTORY_MAX) g_free(g_queue_pop_tail(history));
+}
+
+/* User navigation: the folder being left is remembered for Back */
+static void navigate_to(const char *path) {
+    if (current_path[0] && strcmp(path, current_path) != 0) {
+        push_history(&back_history, current_path);
+        g_queue_clear_full(&forward_history, g_free);
+    }
+    populate_files(path);
+    update_history_buttons();
+}
+
+static void go_back(GtkWidget *widget, gpointer data) {
+    (void)widget; (void)data;
+    gchar *path = g_queue_pop_head(&back_history);
+    if (!path) return;
+    push_history(&forward_history, current_path);
+    populate_files(path);
+    update_history_buttons();
+    g_free(path);
+}
+
+static void go_forward(GtkWidget *widget, gpointer data) {
+    (void)widget; (void)data;
+    gchar *path = g_queue_pop_head(&forward_history);
+    if (!path) return;
+    push_history(&back_history, current_path);
+    populate_files(path);
+    update_history_buttons();
+    g_free(path);
+}
+
+/* ── Navigation ─────────────────────────────────────────── */
+static gboolean launch_path(const char *path) {
+    gchar *uri = g_filename_to_uri(path, NULL, NULL);
+    gboolean ok = uri && g_app_info_launch_default_for_uri(uri, NULL, NULL);
+    g_free(uri);
+    return ok;
+}
+
+/* Archives open as folders; their members are unpacked to be opened */
+static void open_file(const char *path) {
+    if (archive_file && archive_index)
+        open_archive_member(path);
+    else if (!archive_file && archivefs_supported(path))
+        navigate_to(path);
+    else
+        launch_path(path);
+}
+
+static void activate_row(GtkTreePath *tree_path) {
+    GtkTreeModel *model = GTK_TREE_MODEL(file_model);
     GtkTreeIter iter;
 
     if (gtk_tree_model_get_iter(model, &iter, tree_path)) {
         gboolean is_dir;
         gchar *path;
-        gtk_tree_model_get(model, &iter, COL_PATH, &path, COL_IS_DIR, &is_dir, -1);
+        gtk_tree_model_get(model, &iter, FILES_COL_PATH, &path, FILES_COL_IS_DIR, &is_dir, -1);
 
-        if (is_dir) {
-            populate_files(path);
-        } else {
-            gchar *uri = g_filename_to_uri(path, NULL, NULL);
-            if (uri) {
-                g_app_info_launch_default_for_uri(uri, NULL, NULL);
-                g_free(uri);
-            }
-        }
+        if (is_dir)
+            navigate_to(path);
+        else
+            open_file(path);
         g_free(path);
     }
 }
 
+static void on_item_activated(GtkIconView *view, GtkTreePath *tree_path, gpointer data) {
+    (void)view; (void)data;
+    activate_row(tree_path);
+}
+
+static void on_row_activated(GtkTreeView *view, GtkTreePath *tree_path,
+                             GtkTreeViewColumn *column, gpointer data) {
+    (void)view; (void)column; (void)data;
+    activate_row(tree_path);
+}
+
 static void go_up(GtkWidget *widget, gpointer data) {
     (void)widget; (void)data;
     char *parent = g_path_get_dirname(current_path);
-    populate_files(parent);
+    navigate_to(parent);
     g_free(parent);
 }
 
 static void go_home(GtkWidget *widget, gpointer data) {
     (void)widget; (void)data;
-    populate_files(g_get_home_dir());
+    navigate_to(g_get_home_dir());
+}
+
+/* ── Prefetch ───────────────────────────────────────────── */
+/* Only real folders other than this one, and not while this one is
+ * still being read; never on a network share, where a hung server
+ * would leave a stuck read behind for every folder hovered */
+static void hover_folder(const char *path) {
+    if (path && (archive_file || current_load || strcmp(path, current_path) == 0 ||
+                 volumes_on_network(volumes, path)))
+        path = NULL;
+    prefetch_hover(path);
+}
+
+static gboolean on_view_motion(GtkWidget *widget, GdkEventMotion *event, gpointer data) {
+    (void)data;
+    GtkTreePath *tree_path = NULL;
+    if (widget == icon_view)
+        tree_path = gtk_icon_view_get_path_at_pos(GTK_ICON_VIEW(icon_view),
+                                                  (gint)event->x, (gint)event->y);
+    else if (event->window == gtk_tree_view_get_bin_window(GTK_TREE_VIEW(list_view)))
+        gtk_tree_view_get_path_at_pos(GTK_TREE_VIEW(list_view), (gint)event->x,
+                                      (gint)event->y, &tree_path, NULL, NULL, NULL);
+
+    GtkTreeModel *model = GTK_TREE_MODEL(file_model);
+    GtkTreeIter iter;
+    gchar *path = NULL;
+    if (tree_path && gtk_tree_model_get_iter(model, &iter, tree_path)) {
+        gboolean is_dir;
+        gtk_tree_model_get(model, &iter, FILES_COL_PATH, &path, FILES_COL_IS_DIR, &is_dir, -1);
+        if (!is_dir) g_clear_pointer(&path, g_free);
+    }
+    gtk_tree_path_free(tree_path);
+    hover_folder(path);
+    g_free(path);
+    return FALSE;
+}
+
+static gboolean on_sidebar_motion(GtkWidget *widget, GdkEventMotion *event, gpointer data) {
+    (void)data;
+    GtkListBoxRow *row = gtk_list_box_get_row_at_y(GTK_LIST_BOX(widget), (gint)event->y);
+    hover_folder(row ? g_object_get_data(G_OBJECT(row), "path") : NULL);
+    return FALSE;
+}
+
+static gboolean on_hover_leave(GtkWidget *widget, GdkEventCrossing *event, gpointer data) {
+    (void)widget; (void)event; (void)data;
+    prefetch_hover(NULL);
+    return FALSE;
 }
 
 /* ── Context Menu Helpers ───────────────────────────────── */
 static gchar *get_selected_path(void) {
-    GList *selected = gtk_icon_view_get_selected_items(GTK_ICON_VIEW(icon_view));
+    GList *selected = view_get_selected();
     if (!selected) return NULL;
 
     GtkTreePath *tree_path = (GtkTreePath *)selected->data;
-    GtkTreeModel *model = gtk_icon_view_get_model(GTK_ICON_VIEW(icon_view));
+    GtkTreeModel *model = GTK_TREE_MODEL(file_model);
     GtkTreeIter iter;
     gchar *path = NULL;
 
     if (gtk_tree_model_get_iter(model, &iter, tree_path)) {
-        gtk_tree_model_get(model, &iter, COL_PATH, &path, -1);
+        gtk_tree_model_get(model, &iter, FILES_COL_PATH, &path, -1);
     }
 
     g_list_free_full(selected, (GDestroyNotify)gtk_tree_path_free);
     return path;
 }
 
+/* NULL-terminated; free with g_strfreev() */
+static gchar **get_selected_paths(void) {
+    GList *selected = view_get_selected();
+    GtkTreeModel *model = GTK_TREE_MODEL(file_model);
+    GPtrArray *paths = g_ptr_array_new();
+
+    for (GList *l = selected; l; l = l->next) {
+        GtkTreeIter iter;
+        gchar *path = NULL;
+        if (gtk_tree_model_get_iter(model, &iter, l->data))
+            gtk_tree_model_get(model, &iter, FILES_COL_PATH, &path, -1);
+        if (path) g_ptr_array_add(paths, path);
+    }
+
+    g_list_free_full(selected, (GDestroyNotify)gtk_tree_path_free);
+    g_ptr_array_add(paths, NULL);
+    return (gchar **)g_ptr_array_free(paths, FALSE);
+}
+
 static gboolean get_selected_is_dir(void) {
-    GList *selected = gtk_icon_view_get_selected_items(GTK_ICON_VIEW(icon_view));
+    GList *selected = view_get_selected();
     if (!selected) return FALSE;
 
     GtkTreePath *tree_path = (GtkTreePath *)selected->data;
-    GtkTreeModel *model = gtk_icon_view_get_model(GTK_ICON_VIEW(icon_view));
+    GtkTreeModel *model = GTK_TREE_MODEL(file_model);
     GtkTreeIter iter;
     gboolean is_dir = FALSE;
 
     if (gtk_tree_model_get_iter(model, &iter, tree_path)) {
-        gtk_tree_model_get(model, &iter, COL_IS_DIR, &is_dir, -1);
+        gtk_tree_model_get(model, &iter, FILES_COL_IS_DIR, &is_dir, -1);
     }
 
     g_list_free_full(selected, (GDestroyNotify)gtk_tree_path_free);
     return is_dir;
 }
 
+/* ── File Operations ────────────────────────────────────── */
+/* Progress of the oldest job, refreshed every OPS_TICK_MSEC; throughput
+ * is smoothed over a few ticks */
+#define OPS_TICK_MSEC 250
+
+static guint64 ops_last_bytes = 0;
+static gint64 ops_last_time = 0;
+static gdouble ops_rate = 0;
+
+static gboolean update_ops_bar(gpointer data) {
+    (void)data;
+    FileOp *op = g_queue_peek_head(&file_ops);
+    if (!op || !main_window) {
+        ops_timer = 0;
+        return G_SOURCE_REMOVE;
+    }
+
+    FileOpProgress p;
+    fileop_progress(op, &p);
+    gint64 now = g_get_monotonic_time();
+    if (ops_last_time > 0 && p.bytes_done >= ops_last_bytes) {
+        gdouble rate = (p.bytes_done - ops_last_bytes) * (gdouble)G_USEC_PER_SEC /
+                       MAX(now - ops_last_time, 1);
+        ops_rate = ops_rate > 0 ? 0.7 * ops_rate + 0.3 * rate : rate;
+    }
+    ops_last_bytes = p.bytes_done;
+    ops_last_time = now;
+
+    static const char *const verbs[] = { "Copying", "Moving", "Deleting", "Renaming",
+                                         "Moving to Trash", "Emptying Trash", "Extracting",
+                                         "Linking" };
+    GString *text = g_string_new(verbs[p.kind]);
+    if (p.counting && p.files_total > 0)
+        g_string_append_printf(text, " — %u files so far", p.files_total);
+    else if (p.files_total > 0)
+        g_string_append_printf(text, " %u of %u files", MIN(p.files_done + 1, p.files_total),
+                               p.files_total);
+    if (p.bytes_done > 0 && ops_rate > 0) {
+        gchar *rate = g_format_size((guint64)ops_rate);
+        g_string_append_printf(text, " · %s/s", rate);
+        g_free(rate);
+    }
+    guint queued = g_queue_get_length(&file_ops) - 1;
+    if (queued > 0) g_string_append_printf(text, " · %u more queued", queued);
+    gtk_label_set_text(GTK_LABEL(ops_label), text->str);
+    g_string_free(text, TRUE);
+
+    if (p.counting || (p.bytes_total == 0 && p.files_total == 0))
+        gtk_progress_bar_pulse(GTK_PROGRESS_BAR(ops_progress));
+    else if (p.bytes_total > 0)
+        gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(ops_progress),
+                                      MIN(1.0, (gdouble)p.bytes_done / p.bytes_total));
+    else
+        gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(ops_progress),
+                                      (gdouble)p.files_done / p.files_total);
+
+    /* First tick: quick jobs finish without the bar flashing up */
+    gtk_widget_show(ops_bar);
+    return G_SOURCE_CONTINUE;
+}
+
+static void on_ops_cancel(GtkWidget *widget, gpointer data) {
+    (void)widget; (void)data;
+    FileOp *op = g_queue_peek_head(&file_ops);
+    if (op) fileop_cancel(op);
+}
+
+static void on_conflict_response(GtkDialog *dialog, gint response, gpointer data) {
+    GtkWidget *apply_all = data;
+    FileOpChoice choice = response > 0 ? (FileOpChoice)response : FILEOP_ABORT;
+    fileop_resolve(conflict_op, choice,
+                   gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(apply_all)));
+    conflict_op = NULL;
+    conflict_dialog = NULL;
+    gtk_widget_destroy(GTK_WIDGET(dialog));
+}
+
+static void on_op_conflict(FileOp *op, const char *src, const char *dest, gpointer data) {
+    (void)src; (void)data;
+    /* Window closed: let the job finish in the background */
+    if (!main_window) {
+        fileop_resolve(op, FILEOP_SKIP, TRUE);
+        return;
+    }
+
+    gchar *name = g_filename_display_basename(dest);
+    GtkWidget *dialog = gtk_message_dialog_new(
+        GTK_WINDOW(main_window), GTK_DIALOG_DESTROY_WITH_PARENT,
+        GTK_MESSAGE_QUESTION, GTK_BUTTONS_NONE, "“%s” already exists", name);
+    gtk_message_dialog_format_secondary_text(GTK_MESSAGE_DIALOG(dialog),
+        "Replace it with the one being %s?",
+        op->kind == FILEOP_MOVE ? "moved" : op->kind == FILEOP_EXTRACT ? "extracted" : "copied");
+    gtk_dialog_add_buttons(GTK_DIALOG(dialog),
+                           "Cancel", FILEOP_ABORT,
+                           "Skip", FILEOP_SKIP,
+                           "Keep Both", FILEOP_KEEP_BOTH,
+                           "Replace", FILEOP_REPLACE, NULL);
+    gtk_dialog_set_default_response(GTK_DIALOG(dialog), FILEOP_KEEP_BOTH);
+
+    GtkWidget *apply_all = gtk_check_button_new_with_label("Apply to all conflicts");
+    gtk_box_pack_start(GTK_BOX(gtk_message_dialog_get_message_area(GTK_MESSAGE_DIALOG(dialog))),
+                       apply_all, FALSE, FALSE, 0);
+    g_signal_connect(dialog, "response", G_CALLBACK(on_conflict_response), apply_all);
+
+    conflict_op = op;
+    conflict_dialog = dialog;
+    gtk_widget_show_all(dialog);
+    g_free(name);
+}
+
+/* ── Trash ──────────────────────────────────────────────── */
+static void on_trash_size(guint64 bytes, guint items, gpointer data) {
+    (void)data;
+    if (!main_window) return;
+    gchar *size = items > 0 ? g_format_size(bytes) : NULL;
+    gtk_label_set_text(GTK_LABEL(trash_size_label), size ? size : "");
+    g_free(size);
+}
+
+/* Sized in the background, mostly from the trash's directorysizes */
+static void update_trash_size(void) {
+    trash_size(on_trash_size, NULL);
+}
+
+/* The open folder is the trash: deleting there is for good */
+static gboolean viewing_trash(void) {
+    return !searching && strcmp(current_path, trash_dir) == 0;
+}
+
+static void on_error_response(GtkDialog *dialog, gint response, gpointer data) {
+    (void)response; (void)data;
+    gtk_widget_destroy(GTK_WIDGET(dialog));
+}
+
+static void on_op_done(FileOp *op, const char *error, gpointer data) {
+    (void)data;
+    g_queue_remove(&file_ops, op);
+    g_application_release(g_application_get_default());
+    ops_last_time = 0;
+    ops_rate = 0;
+    if (op == conflict_op) {
+        gtk_widget_destroy(conflict_dialog);
+        conflict_op = NULL;
+        conflict_dialog = NULL;
+    }
+    if (!main_window) return;
+
+    if (g_queue_is_empty(&file_ops)) gtk_widget_hide(ops_bar);
+    if (error) {
+        GtkWidget *dialog = gtk_message_dialog_new(
+            GTK_WINDOW(main_window), GTK_DIALOG_DESTROY_WITH_PARENT,
+            GTK_MESSAGE_ERROR, GTK_BUTTONS_CLOSE, "%s", error);
+        g_signal_connect(dialog, "response", G_CALLBACK(on_error_response), NULL);
+        gtk_widget_show(dialog);
+    }
+    if (op->kind == FILEOP_TRASH || op->kind == FILEOP_EMPTY_TRASH) update_trash_size();
+    volumes_refresh(volumes);
+    refresh_after_change();
+}
+
+static const FileOpCallbacks op_callbacks = { on_op_conflict, on_op_done };
+
+/* Keeps the process alive until @op is done, even with the window closed */
+static void track_op(FileOp *op) {
+    g_queue_push_tail(&file_ops, op);
+    g_application_hold(g_application_get_default());
+    if (!ops_timer) ops_timer = g_timeout_add(OPS_TICK_MSEC, update_ops_bar, NULL);
+}
+
+/* ── Archives ───────────────────────────────────────────── */
+/* Browsed from the index, which is kept until another archive is opened
+ * and read again only when the file changes */
+static void show_archive_folder(void) {
+    if (archivefs_populate(archive_index, archive_member(current_path), file_model))
+        return;
+    /* Gone from a rewritten archive: its top instead */
+    gchar *top = g_strdup(archive_file);
+    populate_files(top);
+    g_free(top);
+}
+
+static void on_archive_index(ArchiveIndex *index, const char *error, gpointer data) {
+    (void)data;
+    gtk_spinner_stop(GTK_SPINNER(load_spinner));
+    archivefs_load_unref(archive_load);
+    archive_load = NULL;
+    if (index) {
+        archive_index = archivefs_index_ref(index);
+        show_archive_folder();
+        return;
+    }
+
+    /* Not one we can read after all: back out as if it had never been
+     * entered, and hand it to its app as before */
+    gchar *file = g_strdup(archive_file);
+    gchar *parent = g_path_get_dirname(file);
+    const char *last = g_queue_peek_head(&back_history);
+    if (last && strcmp(last, parent) == 0) g_free(g_queue_pop_head(&back_history));
+    populate_files(parent);
+    update_history_buttons();
+    if (!launch_path(file)) {
+        gchar *name = g_filename_display_basename(file);
+        GtkWidget *dialog = gtk_message_dialog_new(
+            GTK_WINDOW(main_window), GTK_DIALOG_DESTROY_WITH_PARENT,
+            GTK_MESSAGE_ERROR, GTK_BUTTONS_CLOSE, "Could not open “%s”", name);
+        gtk_message_dialog_format_secondary_text(GTK_MESSAGE_DIALOG(dialog), "%s", error);
+        g_signal_connect(dialog, "response", G_CALLBACK(on_error_response), NULL);
+        gtk_widget_show(dialog);
+        g_free(name);
+    }
+    g_free(parent);
+    g_free(file);
+}
+
+/* populate_files() for a path inside an archive */
+static void show_archive(void) {
+    FilesListing *listing = files_listing_new(current_path);
+    cancel_details();
+    files_model_set_listing(file_model, listing);
+    files_listing_unref(listing);
+    saved_scroll = 0;
+    gtk_label_set_text(GTK_LABEL(path_label), current_path);
+
+    if (archive_index && strcmp(archive_index->file, archive_file) == 0 &&
+        archive_index->file_mtime == archivefs_file_mtime(archive_file)) {
+        show_archive_folder();
+        return;
+    }
+    archivefs_index_unref(archive_index);
+    archive_index = NULL;
+    gtk_spinner_start(GTK_SPINNER(load_spinner));
+    archive_load = archivefs_load(archive_file, on_archive_index, NULL);
+}
+
+/* What is unpacked to the cache stays the same for as long as the
+ * archive does, so what is there already is kept without asking */
+static void on_cache_conflict(FileOp *op, const char *src, const char *dest, gpointer data) {
+    (void)src; (void)dest; (void)data;
+    fileop_resolve(op, FILEOP_SKIP, TRUE);
+}
+
+static void on_open_extracted(FileOp *op, const char *error, gpointer data) {
+    gchar *target = data;
+    on_op_done(op, error, NULL);
+    if (g_file_test(target, G_FILE_TEST_EXISTS)) launch_path(target);
+    g_free(target);
+}
+
+static const FileOpCallbacks open_callbacks = { on_cache_conflict, on_open_extracted };
+
+/* Unpacks just @path to the cache and opens it from there */
+static void open_archive_member(const char *path) {
+    const char *members[] = { archive_member(path), NULL };
+    gchar *cache = archivefs_cache_dir(archive_index);
+    gchar *target = g_build_filename(cache, members[0], NULL);
+    g_free(cache);
+    /* Not below a link unpacked before: the job refuses those */
+    if (archivefs_extractable(archive_index, members[0]) &&
+        g_file_test(target, G_FILE_TEST_EXISTS)) {
+        launch_path(target);
+        g_free(target);
+        return;
+    }
+    track_op(fileop_extract_cached(archive_index, members, &open_callbacks, target));
+}
+
+static void on_copy_extracted(FileOp *op, const char *error, gpointer data) {
+    gchar **targets = data;
+    on_op_done(op, error, NULL);
+    if (!error && main_window) offer_paths(targets, FALSE);
+    else g_strfreev(targets);
+}
+
+static const FileOpCallbacks copy_callbacks = { on_cache_conflict, on_copy_extracted };
+
+/* Copying out of an archive: the selection is unpacked to the cache
+ * first, and the unpacked files go on the clipboard */
+static void copy_archive_members(gchar **paths) {
+    gchar *cache = archivefs_cache_dir(archive_index);
+    guint n = g_strv_length(paths);
+    const char **members = g_new0(const char *, n + 1);
+    gchar **targets = g_new0(gchar *, n + 1);
+    for (guint i = 0; i < n; i++) {
+        members[i] = archive_member(paths[i]);
+        targets[i] = g_build_filename(cache, members[i], NULL);
+    }
+    track_op(fileop_extract_cached(archive_index, members, &copy_callbacks, targets));
+    g_free(members);
+    g_free(cache);
+}
+
+/* Asks where to unpack @members, the folder holding the archive first */
+static void extract_members(const char *const *members) {
+    GtkWidget *dialog = gtk_file_chooser_dialog_new(
+        "Extract To", GTK_WINDOW(main_window), GTK_FILE_CHOOSER_ACTION_SELECT_FOLDER,
+        "Cancel", GTK_RESPONSE_CANCEL, "Extract", GTK_RESPONSE_ACCEPT, NULL);
+    gchar *parent = g_path_get_dirname(archive_file);
+    gtk_file_chooser_set_current_folder(GTK_FILE_CHOOSER(dialog), parent);
+    g_free(parent);
+
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
+        gchar *dest = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+        if (dest) track_op(fileop_extract(archive_index, members, dest, &op_callbacks, NULL));
+        g_free(dest);
+    }
+    gtk_widget_destroy(dialog);
+}
+
+/* ── Clipboard ──────────────────────────────────────────── */
+/* Offered in Nautilus' format too, so files paste across file managers */
+enum { CLIP_GNOME_FILES, CLIP_URI_LIST, CLIP_TEXT };
+
+static void clip_get(GtkClipboard *clip, GtkSelectionData *sel, guint info, gpointer data) {
+    (void)clip; (void)data;
+    GString *out = g_string_new(info == CLIP_GNOME_FILES ? (clip_cut ? "cut" : "copy") : NULL);
+    for (gchar **u = clip_uris; u && *u; u++) {
+        if (info == CLIP_GNOME_FILES) {
+            g_string_append_printf(out, "\n%s", *u);
+        } else if (info == CLIP_URI_LIST) {
+            g_string_append_printf(out, "%s\r\n", *u);
+        } else {
+            gchar *path = g_filename_from_uri(*u, NULL, NULL);
+            if (path) g_string_append_printf(out, "%s%s", out->len ? "\n" : "", path);
+            g_free(path);
+        }
+    }
+    gtk_selection_data_set(sel, gtk_selection_data_get_target(sel), 8,
+                           (const guchar *)out->str, (gint)out->len);
+    g_string_free(out, TRUE);
+}
+
+static void clip_clear(GtkClipboard *clip, gpointer data) {
+    (void)clip; (void)data;
+    g_strfreev(clip_uris);
+    clip_uris = NULL;
+}
+
+/* Puts @paths (taken) on the clipboard */
+static void offer_paths(gchar **paths, gboolean cut) {
+    guint n = g_strv_length(paths);
+    gchar **uris = g_new0(gchar *, n + 1);
+    for (guint i = 0; i < n; i++) uris[i] = g_filename_to_uri(paths[i], NULL, NULL);
+    g_strfreev(paths);
+
+    static const GtkTargetEntry targets[] = {
+        { "x-special/gnome-copied-files", 0, CLIP_GNOME_FILES },
+        { "text/uri-list", 0, CLIP_URI_LIST },
+        { "UTF8_STRING", 0, CLIP_TEXT },
+    };
+    GtkClipboard *clip = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
+    if (gtk_clipboard_set_with_data(clip, targets, G_N_ELEMENTS(targets),
+                                    clip_get, clip_clear, NULL)) {
+        clip_uris = uris;
+        clip_cut = cut;
+    } else {
+        g_strfreev(uris);
+    }
+}
+
+/* Archives are read-only: nothing is cut from them */
+static void set_clipboard(gboolean cut) {
+    gchar **paths = get_selected_paths();
+    if (!paths[0] || (archive_file && cut)) {
+        g_strfreev(paths);
+        return;
+    }
+    if (archive_file) {
+        copy_archive_members(paths);
+        g_strfreev(paths);
+        return;
+    }
+    offer_paths(paths, cut);
+}
+
+static void on_paste_received(GtkClipboard *clip, GtkSelectionData *sel, gpointer data) {
+    gchar *dest = data;
+    const guchar *raw = gtk_selection_data_get_data(sel);
+    gint len = gtk_selection_data_get_length(sel);
+    if (!raw || len <= 0) {
+        g_free(dest);
+        return;
+    }
+
+    gchar *text = g_strndup((const gchar *)raw, len);
+    gchar **lines = g_strsplit(text, "\n", -1);
+    gboolean cut = strcmp(g_strstrip(lines[0]), "cut") == 0;
+    GPtrArray *paths = g_ptr_array_new_with_free_func(g_free);
+    for (guint i = 1; lines[i]; i++) {
+        gchar *path = g_filename_from_uri(g_strstrip(lines[i]), NULL, NULL);
+        if (path) g_ptr_array_add(paths, path);
+    }
+    g_ptr_array_add(paths, NULL);
+
+    if (paths->len > 1) {
+        const char *const *sources = (const char *const *)paths->pdata;
+        track_op(cut ? fileop_move(sources, dest, &op_callbacks, NULL)
+                     : fileop_copy(sources, dest, &op_callbacks, NULL));
+        /* Cut files move once */
+        if (cut) gtk_clipboard_clear(clip);
+    }
+
+    g_ptr_array_free(paths, TRUE);
+    g_strfreev(lines);
+    g_free(text);
+    g_free(dest);
+}
+
+static void paste_into(const char *dir) {
+    if (archive_file) return;
+    gtk_clipboard_request_contents(gtk_clipboard_get(GDK_SELECTION_CLIPBOARD),
+                                   gdk_atom_intern_static_string("x-special/gnome-copied-files"),
+                                   on_paste_received, g_strdup(dir));
+}
+
 /* ── Context Menu Actions ───────────────────────────────── */
 static void ctx_open(GtkWidget *w, gpointer d) {
     (void)w; (void)d;
     gchar *path = get_selected_path();
     if (!path) return;
-    if (get_selected_is_dir()) {
-        populate_files(path);
-    } else {
-        gchar *uri = g_filename_to_uri(path, NULL, NULL);
-        if (uri) { g_app_info_launch_default_for_uri(uri, NULL, NULL); g_free(uri); }
-    }
+    if (get_selected_is_dir())
+        navigate_to(path);
+    else
+        open_file(path);
     g_free(path);
 }
 
@@ -187,6 +1410,21 @@ static void ctx_open_in_terminal(GtkWidget *w, gpointer d) {
     if (path) g_free(path);
 }
 
+static void ctx_cut(GtkWidget *w, gpointer d) {
+    (void)w; (void)d;
+    set_clipboard(TRUE);
+}
+
+static void ctx_copy(GtkWidget *w, gpointer d) {
+    (void)w; (void)d;
+    set_clipboard(FALSE);
+}
+
+static void ctx_paste(GtkWidget *w, gpointer d) {
+    (void)w; (void)d;
+    paste_into(current_path);
+}
+
 static void ctx_copy_path(GtkWidget *w, gpointer d) {
     (void)w; (void)d;
     gchar *path = get_selected_path();
@@ -203,7 +1441,6 @@ static void ctx_rename(GtkWidget *w, gpointer d) {
     if (!path) return;
 
     gchar *basename = g_path_get_basename(path);
-    gchar *dirname = g_path_get_dirname(path);
 
     GtkWidget *dialog = gtk_dialog_new_with_buttons(
         "Rename", GTK_WINDOW(main_window), GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
@@ -220,44 +1457,70 @@ static void ctx_rename(GtkWidget *w, gpointer d) {
 
     if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
         const char *new_name = gtk_entry_get_text(GTK_ENTRY(entry));
-        if (new_name && new_name[0]) {
-            gchar *new_path = g_build_filename(dirname, new_name, NULL);
-            g_rename(path, new_path);
-            g_free(new_path);
-            populate_files(current_path);
-        }
+        if (new_name && new_name[0] && !strchr(new_name, '/') && strcmp(new_name, basename) != 0)
+            track_op(fileop_rename(path, new_name, &op_callbacks, NULL));
     }
     gtk_widget_destroy(dialog);
-    g_free(basename); g_free(dirname); g_free(path);
+    g_free(basename); g_free(path);
 }
 
+/* Asks first: nothing can bring these back */
 static void ctx_delete(GtkWidget *w, gpointer d) {
     (void)w; (void)d;
-    gchar *path = get_selected_path();
-    if (!path) return;
+    gchar **paths = get_selected_paths();
+    if (!paths[0]) {
+        g_strfreev(paths);
+        return;
+    }
 
-    gchar *basename = g_path_get_basename(path);
-    gchar *msg = g_strdup_printf("Delete \"%s\"?", basename);
+    guint n = g_strv_length(paths);
+    gchar *basename = g_path_get_basename(paths[0]);
+    gchar *msg = n == 1 ? g_strdup_printf("Permanently delete \"%s\"?", basename)
+                        : g_strdup_printf("Permanently delete %u items?", n);
 
     GtkWidget *dialog = gtk_message_dialog_new(
         GTK_WINDOW(main_window), GTK_DIALOG_MODAL,
         GTK_MESSAGE_WARNING, GTK_BUTTONS_NONE, "%s", msg);
+    gtk_message_dialog_format_secondary_text(GTK_MESSAGE_DIALOG(dialog),
+                                             "They will not go to the Trash.");
     gtk_dialog_add_buttons(GTK_DIALOG(dialog),
                            "Cancel", GTK_RESPONSE_CANCEL,
                            "Delete", GTK_RESPONSE_ACCEPT, NULL);
 
     if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
-        if (get_selected_is_dir()) {
-            gchar *cmd = g_strdup_printf("rm -rf '%s'", path);
-            g_spawn_command_line_async(cmd, NULL);
-            g_free(cmd);
-        } else {
-            g_unlink(path);
-        }
-        populate_files(current_path);
+        /* In the trash their .trashinfo and size entries go too */
+        if (viewing_trash())
+            track_op(fileop_empty_trash((const char *const *)paths, &op_callbacks, NULL));
+        else
+            track_op(fileop_delete((const char *const *)paths, &op_callbacks, NULL));
     }
     gtk_widget_destroy(dialog);
-    g_free(msg); g_free(basename); g_free(path);
+    g_free(msg); g_free(basename); g_strfreev(paths);
+}
+
+static void ctx_trash(GtkWidget *w, gpointer d) {
+    if (viewing_trash()) {
+        ctx_delete(w, d);
+        return;
+    }
+    gchar **paths = get_selected_paths();
+    if (paths[0]) track_op(fileop_trash((const char *const *)paths, &op_callbacks, NULL));
+    g_strfreev(paths);
+}
+
+static void ctx_empty_trash(GtkWidget *w, gpointer d) {
+    (void)w; (void)d;
+    GtkWidget *dialog = gtk_message_dialog_new(
+        GTK_WINDOW(main_window), GTK_DIALOG_MODAL,
+        GTK_MESSAGE_WARNING, GTK_BUTTONS_NONE, "Empty the Trash?");
+    gtk_message_dialog_format_secondary_text(GTK_MESSAGE_DIALOG(dialog),
+                                             "Everything in it will be deleted permanently.");
+    gtk_dialog_add_buttons(GTK_DIALOG(dialog),
+                           "Cancel", GTK_RESPONSE_CANCEL,
+                           "Empty Trash", GTK_RESPONSE_ACCEPT, NULL);
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT)
+        track_op(fileop_empty_trash(NULL, &op_callbacks, NULL));
+    gtk_widget_destroy(dialog);
 }
 
 static void ctx_new_folder(GtkWidget *w, gpointer d) {
@@ -283,7 +1546,7 @@ static void ctx_new_folder(GtkWidget *w, gpointer d) {
             gchar *new_dir = g_build_filename(current_path, name, NULL);
             g_mkdir_with_parents(new_dir, 0755);
             g_free(new_dir);
-            populate_files(current_path);
+            refresh_after_change();
         }
     }
     gtk_widget_destroy(dialog);
@@ -313,7 +1576,7 @@ static void ctx_new_file(GtkWidget *w, gpointer d) {
             FILE *f = fopen(new_file, "w");
             if (f) fclose(f);
             g_free(new_file);
-            populate_files(current_path);
+            refresh_after_change();
         }
     }
     gtk_widget_destroy(dialog);
@@ -322,7 +1585,85 @@ static void ctx_new_file(GtkWidget *w, gpointer d) {
 static void ctx_toggle_hidden(GtkWidget *w, gpointer d) {
     (void)w; (void)d;
     show_hidden = !show_hidden;
-    populate_files(current_path);
+    files_model_set_show_hidden(file_model, show_hidden);
+    if (searching) start_search(gtk_entry_get_text(GTK_ENTRY(search_entry)));
+}
+
+/* The model sorts itself; the details view's headers only show it */
+static void apply_sort(void) {
+    files_model_set_sort(file_model, sort_key, sort_descending);
+    for (gint key = 0; key < FILES_N_SORTS; key++) {
+        gtk_tree_view_column_set_sort_indicator(sort_columns[key], key == (gint)sort_key);
+        gtk_tree_view_column_set_sort_order(sort_columns[key], sort_descending ?
+                                            GTK_SORT_DESCENDING : GTK_SORT_ASCENDING);
+    }
+}
+
+static void ctx_sort_by(GtkWidget *w, gpointer d) {
+    (void)d;
+    if (!gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(w))) return;
+    sort_key = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(w), "sort-key"));
+    apply_sort();
+}
+
+static void ctx_sort_reverse(GtkWidget *w, gpointer d) {
+    (void)d;
+    sort_descending = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(w));
+    apply_sort();
+}
+
+/* A header sorts by its column; clicked again, the other way round */
+static void on_column_clicked(GtkTreeViewColumn *column, gpointer data) {
+    (void)column;
+    FilesSortKey key = GPOINTER_TO_INT(data);
+    sort_descending = key == sort_key && !sort_descending;
+    sort_key = key;
+    apply_sort();
+}
+
+/* Swaps the icon and details views; the model moves with the selection */
+static void set_details_view(gboolean on) {
+    if (on == details_view) return;
+    on_model_resync(file_model, TRUE, NULL);
+    details_view = on;
+    saved_scroll = 0;   /* rows and icons do not line up */
+    gtk_stack_set_visible_child_name(GTK_STACK(view_stack), on ? "details" : "icons");
+    gtk_button_set_image(GTK_BUTTON(view_button), gtk_image_new_from_icon_name(
+        on ? "view-grid-symbolic" : "view-list-symbolic", GTK_ICON_SIZE_BUTTON));
+    gtk_widget_set_tooltip_text(view_button, on ? "Icons (Ctrl+1)" : "Details (Ctrl+2)");
+    on_model_resync(file_model, FALSE, NULL);
+    gtk_widget_grab_focus(shown_view());
+    queue_visible_items();
+}
+
+static void on_view_button(GtkWidget *w, gpointer d) {
+    (void)w; (void)d;
+    set_details_view(!details_view);
+}
+
+static GtkWidget *make_sort_menu(void) {
+    static const char *const labels[FILES_N_SORTS] = {
+        [FILES_SORT_NAME] = "Name",
+        [FILES_SORT_SIZE] = "Size",
+        [FILES_SORT_TYPE] = "Type",
+        [FILES_SORT_DATE] = "Modified",
+    };
+    GtkWidget *menu = gtk_menu_new();
+    GSList *group = NULL;
+    for (gint key = 0; key < FILES_N_SORTS; key++) {
+        GtkWidget *item = gtk_radio_menu_item_new_with_label(group, labels[key]);
+        group = gtk_radio_menu_item_get_group(GTK_RADIO_MENU_ITEM(item));
+        gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(item), key == (gint)sort_key);
+        g_object_set_data(G_OBJECT(item), "sort-key", GINT_TO_POINTER(key));
+        g_signal_connect(item, "toggled", G_CALLBACK(ctx_sort_by), NULL);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), item);
+    }
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+    GtkWidget *reverse = gtk_check_menu_item_new_with_label("Reverse Order");
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(reverse), sort_descending);
+    g_signal_connect(reverse, "toggled", G_CALLBACK(ctx_sort_reverse), NULL);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), reverse);
+    return menu;
 }
 
 static void ctx_refresh(GtkWidget *w, gpointer d) {
@@ -363,6 +1704,62 @@ static void ctx_properties(GtkWidget *w, gpointer d) {
     g_free(info); g_free(size_str); g_free(basename); g_free(path);
 }
 
+static void ctx_extract_to(GtkWidget *w, gpointer d) {
+    (void)w; (void)d;
+    gchar **paths = get_selected_paths();
+    guint n = g_strv_length(paths);
+    const char **members = g_new0(const char *, n + 1);
+    for (guint i = 0; i < n; i++) members[i] = archive_member(paths[i]);
+    if (n > 0) extract_members(members);
+    g_free(members);
+    g_strfreev(paths);
+}
+
+/* Everything in the open folder of the archive */
+static void ctx_extract_all(GtkWidget *w, gpointer d) {
+    (void)w; (void)d;
+    const char **members = archivefs_children(archive_index, archive_member(current_path));
+    if (members[0]) extract_members(members);
+    g_free(members);
+}
+
+/* The selected folder, else the open one */
+static void ctx_disk_usage(GtkWidget *w, gpointer d) {
+    (void)w; (void)d;
+    gchar *path = get_selected_path();
+    if (!path || !g_file_test(path, G_FILE_TEST_IS_DIR)) {
+        g_free(path);
+        path = g_strdup(current_path);
+    }
+    duview_open(GTK_WINDOW(main_window), path, navigate_to);
+    g_free(path);
+}
+
+/* Same folder choice as Disk Usage */
+static void ctx_find_duplicates(GtkWidget *w, gpointer d) {
+    (void)w; (void)d;
+    gchar *path = get_selected_path();
+    if (!path || !g_file_test(path, G_FILE_TEST_IS_DIR)) {
+        g_free(path);
+        path = g_strdup(current_path);
+    }
+    dupview_open(GTK_WINDOW(main_window), path, show_hidden, navigate_to, &op_callbacks, track_op);
+    g_free(path);
+}
+
+/* Same folder choice again; starts with the name filter's text */
+static void ctx_find_in_files(GtkWidget *w, gpointer d) {
+    (void)w; (void)d;
+    gchar *path = get_selected_path();
+    if (!path || !g_file_test(path, G_FILE_TEST_IS_DIR)) {
+        g_free(path);
+        path = g_strdup(current_path);
+    }
+    findview_open(GTK_WINDOW(main_window), path, gtk_entry_get_text(GTK_ENTRY(search_entry)),
+                  show_hidden, open_file);
+    g_free(path);
+}
+
 /* ── Build Context Menu ─────────────────────────────────── */
 static GtkWidget *make_ctx_item(const char *icon_name, const char *label, GCallback cb) {
     GtkWidget *item = gtk_menu_item_new();
@@ -390,13 +1787,45 @@ static gboolean on_button_press(GtkWidget *widget, GdkEventButton *ev, gpointer
     GtkWidget *menu = gtk_menu_new();
     gchar *sel_path = get_selected_path();
 
-    if (sel_path) {
+    if (sel_path && archive_file) {
+        /* Inside an archive: read-only */
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+            make_ctx_item("document-open", "Open", G_CALLBACK(ctx_open)));
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+            make_ctx_item("archive-extract", "Extract To…", G_CALLBACK(ctx_extract_to)));
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+            make_ctx_item("edit-copy", "Copy", G_CALLBACK(ctx_copy)));
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+            make_ctx_item("edit-copy", "Copy Path", G_CALLBACK(ctx_copy_path)));
+
+        g_free(sel_path);
+    } else if (archive_file) {
+        if (archive_index) {
+            gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+                make_ctx_item("archive-extract", "Extract All To…", G_CALLBACK(ctx_extract_all)));
+            gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+        }
+        GtkWidget *sort_item = make_ctx_item("view-sort-ascending", "Sort By", NULL);
+        gtk_menu_item_set_submenu(GTK_MENU_ITEM(sort_item), make_sort_menu());
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), sort_item);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+            make_ctx_item("view-refresh", "Refresh", G_CALLBACK(ctx_refresh)));
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+            make_ctx_item(show_hidden ? "view-visible" : "view-hidden",
+                          show_hidden ? "Hide Hidden Files" : "Show Hidden Files",
+                          G_CALLBACK(ctx_toggle_hidden)));
+    } else if (sel_path) {
         /* Item-specific context menu */
         gtk_menu_shell_append(GTK_MENU_SHELL(menu),
             make_ctx_item("document-open", "Open", G_CALLBACK(ctx_open)));
         gtk_menu_shell_append(GTK_MENU_SHELL(menu),
             make_ctx_item("utilities-terminal", "Open in Terminal", G_CALLBACK(ctx_open_in_terminal)));
         gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+            make_ctx_item("edit-cut", "Cut", G_CALLBACK(ctx_cut)));
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+            make_ctx_item("edit-copy", "Copy", G_CALLBACK(ctx_copy)));
         gtk_menu_shell_append(GTK_MENU_SHELL(menu),
             make_ctx_item("edit-copy", "Copy Path", G_CALLBACK(ctx_copy_path)));
         gtk_menu_shell_append(GTK_MENU_SHELL(menu),
@@ -404,9 +1833,21 @@ static gboolean on_button_press(GtkWidget *widget, GdkEventButton *ev, gpointer
         gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
         gtk_menu_shell_append(GTK_MENU_SHELL(menu),
             make_ctx_item("dialog-information", "Properties", G_CALLBACK(ctx_properties)));
+        if (g_file_test(sel_path, G_FILE_TEST_IS_DIR)) {
+            gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+                make_ctx_item("drive-harddisk", "Disk Usage…", G_CALLBACK(ctx_disk_usage)));
+            if (!viewing_trash())
+                gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+                    make_ctx_item("edit-find", "Find Duplicates…", G_CALLBACK(ctx_find_duplicates)));
+            gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+                make_ctx_item("system-search", "Find in Files…", G_CALLBACK(ctx_find_in_files)));
+        }
         gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+        if (!viewing_trash())
+            gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+                make_ctx_item("user-trash", "Move to Trash", G_CALLBACK(ctx_trash)));
         gtk_menu_shell_append(GTK_MENU_SHELL(menu),
-            make_ctx_item("edit-delete", "Delete", G_CALLBACK(ctx_delete)));
+            make_ctx_item("edit-delete", "Delete Permanently…", G_CALLBACK(ctx_delete)));
 
         g_free(sel_path);
     } else {
@@ -415,17 +1856,34 @@ static gboolean on_button_press(GtkWidget *widget, GdkEventButton *ev, gpointer
             make_ctx_item("folder-new", "New Folder…", G_CALLBACK(ctx_new_folder)));
         gtk_menu_shell_append(GTK_MENU_SHELL(menu),
             make_ctx_item("document-new", "New File…", G_CALLBACK(ctx_new_file)));
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+            make_ctx_item("edit-paste", "Paste", G_CALLBACK(ctx_paste)));
         gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
         gtk_menu_shell_append(GTK_MENU_SHELL(menu),
             make_ctx_item("utilities-terminal", "Open Terminal Here",
                           G_CALLBACK(ctx_open_in_terminal)));
         gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+        GtkWidget *sort_item = make_ctx_item("view-sort-ascending", "Sort By", NULL);
+        gtk_menu_item_set_submenu(GTK_MENU_ITEM(sort_item), make_sort_menu());
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), sort_item);
         gtk_menu_shell_append(GTK_MENU_SHELL(menu),
             make_ctx_item("view-refresh", "Refresh", G_CALLBACK(ctx_refresh)));
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+            make_ctx_item("drive-harddisk", "Disk Usage…", G_CALLBACK(ctx_disk_usage)));
+        if (!viewing_trash())
+            gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+                make_ctx_item("edit-find", "Find Duplicates…", G_CALLBACK(ctx_find_duplicates)));
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+            make_ctx_item("system-search", "Find in Files…", G_CALLBACK(ctx_find_in_files)));
         gtk_menu_shell_append(GTK_MENU_SHELL(menu),
             make_ctx_item(show_hidden ? "view-visible" : "view-hidden",
                           show_hidden ? "Hide Hidden Files" : "Show Hidden Files",
                           G_CALLBACK(ctx_toggle_hidden)));
+        if (viewing_trash()) {
+            gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+            gtk_menu_shell_append(GTK_MENU_SHELL(menu),
+                make_ctx_item("user-trash-full", "Empty Trash…", G_CALLBACK(ctx_empty_trash)));
+        }
     }
 
     gtk_widget_show_all(menu);
@@ -438,7 +1896,7 @@ static void on_sidebar_select(GtkListBox *box, GtkListBoxRow *row, gpointer data
     (void)box; (void)data;
     if (!row) return;
     const char *path = g_object_get_data(G_OBJECT(row), "path");
-    if (path) populate_files(path);
+    if (path) navigate_to(path);
 }
 
 static GtkWidget *create_sidebar_row(const char *label, const char *icon_name, const char *path) {
@@ -458,12 +1916,237 @@ static GtkWidget *create_sidebar_row(const char *label, const char *icon_name, c
     return row;
 }
 
-/* ── Main ───────────────────────────────────────────────── */
-int main(int argc, char *argv[]) {
-    gtk_init(&argc, &argv);
-    blazeneuro_load_theme();
+static void set_volume_figures(GtkWidget *row, const Volume *v) {
+    GtkLabel *label = g_object_get_data(G_OBJECT(row), "free-label");
+    if (!v->stats_known) {
+        gtk_label_set_text(label, "");
+        gtk_widget_set_tooltip_text(row, v->mount_point);
+        return;
+    }
+    gchar *avail = g_format_size(v->avail);
+    gchar *size = g_format_size(v->size);
+    gchar *tip = g_strdup_printf("%s (%s)\n%s free of %s", v->mount_point, v->fs_type,
+                                 avail, size);
+    gtk_label_set_text(label, avail);
+    gtk_widget_set_tooltip_text(row, tip);
+    g_free(tip);
+    g_free(size);
+    g_free(avail);
+}
 
+/* Rows follow the mount table: those of mounts gone are dropped, new
+ * ones put in place, and the rest only get their figures updated, so
+ * the selected row stays selected */
+static void on_volumes_changed(gpointer data) {
+    (void)data;
+    if (!main_window) return;
+    GPtrArray *list = volumes_list(volumes);
+    GHashTable *listed = g_hash_table_new(g_str_hash, g_str_equal);
+    for (guint i = 0; i < list->len; i++)
+        g_hash_table_add(listed, ((Volume *)g_ptr_array_index(list, i))->mount_point);
+
+    GHashTableIter iter;
+    gpointer key, row;
+    g_hash_table_iter_init(&iter, volume_rows);
+    while (g_hash_table_iter_next(&iter, &key, &row)) {
+        if (g_hash_table_contains(listed, key)) continue;
+        gtk_widget_destroy(row);
+        g_hash_table_iter_remove(&iter);
+    }
+
+    gint pos = gtk_list_box_row_get_index(GTK_LIST_BOX_ROW(volumes_anchor)) + 1;
+    for (guint i = 0; i < list->len; i++, pos++) {
+        const Volume *v = g_ptr_array_index(list, i);
+        GtkWidget *row = g_hash_table_lookup(volume_rows, v->mount_point);
+        if (!row) {
+            row = create_sidebar_row(v->label, v->icon, v->mount_point);
+            GtkWidget *free_label = gtk_label_new(NULL);
+            gtk_style_context_add_class(gtk_widget_get_style_context(free_label), "dim-label");
+            gtk_box_pack_end(GTK_BOX(gtk_bin_get_child(GTK_BIN(row))), free_label,
+                             FALSE, FALSE, 0);
+            g_object_set_data(G_OBJECT(row), "free-label", free_label);
+            gtk_widget_show_all(row);
+            gtk_list_box_insert(GTK_LIST_BOX(sidebar_list), row, pos);
+            g_hash_table_insert(volume_rows, g_strdup(v->mount_point), row);
+        } else if (gtk_list_box_row_get_index(GTK_LIST_BOX_ROW(row)) != pos) {
+            /* Out of place after mounts came and went: moved, keeping
+             * its selection without opening the folder again */
+            gboolean selected = gtk_list_box_row_is_selected(GTK_LIST_BOX_ROW(row));
+            g_object_ref(row);
+            g_signal_handlers_block_by_func(sidebar_list, on_sidebar_select, NULL);
+            gtk_container_remove(GTK_CONTAINER(sidebar_list), row);
+            gtk_list_box_insert(GTK_LIST_BOX(sidebar_list), row, pos);
+            if (selected)
+                gtk_list_box_select_row(GTK_LIST_BOX(sidebar_list), GTK_LIST_BOX_ROW(row));
+            g_signal_handlers_unblock_by_func(sidebar_list, on_sidebar_select, NULL);
+            g_object_unref(row);
+        }
+        set_volume_figures(row, v);
+    }
+    g_hash_table_destroy(listed);
+    g_ptr_array_free(list, TRUE);
+}
+
+/* ── Window ─────────────────────────────────────────────── */
+/* One column of the details view. Every column has a fixed width, so
+ * the view never measures rows it does not show. */
+static GtkTreeViewColumn *add_details_column(const char *title, gint width, gint sort,
+                                             GtkCellRenderer *cell, GtkTreeCellDataFunc func,
+                                             gint text_column) {
+    GtkTreeViewColumn *column = gtk_tree_view_column_new();
+    gtk_tree_view_column_set_title(column, title);
+    gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+    gtk_tree_view_column_set_fixed_width(column, width);
+    gtk_tree_view_column_set_resizable(column, TRUE);
+    gtk_tree_view_column_pack_start(column, cell, TRUE);
+    if (func)
+        gtk_tree_view_column_set_cell_data_func(column, cell, func, NULL, NULL);
+    else
+        gtk_tree_view_column_add_attribute(column, cell, "text", text_column);
+    if (sort >= 0) {
+        sort_columns[sort] = column;
+        gtk_tree_view_column_set_clickable(column, TRUE);
+        g_signal_connect(column, "clicked", G_CALLBACK(on_column_clicked), GINT_TO_POINTER(sort));
+    }
+    gtk_tree_view_append_column(GTK_TREE_VIEW(list_view), column);
+    return column;
+}
+
+/* Name, size, modified, type and permissions; all but the name are read
+ * for the rows on screen only (see request_visible_details()) */
+static GtkWidget *create_details_view(void) {
+    list_view = gtk_tree_view_new();
+    gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(list_view), TRUE);
+    gtk_tree_view_set_enable_search(GTK_TREE_VIEW(list_view), FALSE);
+    gtk_tree_view_set_rubber_banding(GTK_TREE_VIEW(list_view), TRUE);
+    gtk_tree_selection_set_mode(gtk_tree_view_get_selection(GTK_TREE_VIEW(list_view)),
+                                GTK_SELECTION_MULTIPLE);
+
+    GtkCellRenderer *name = gtk_cell_renderer_text_new();
+    g_object_set(name, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+    GtkTreeViewColumn *column = add_details_column("Name", 280, FILES_SORT_NAME, name, NULL,
+                                                   FILES_COL_NAME);
+    gtk_tree_view_column_set_expand(column, TRUE);
+    GtkCellRenderer *icon = gtk_cell_renderer_pixbuf_new();
+    gtk_tree_view_column_pack_start(column, icon, FALSE);
+    gtk_tree_view_column_reorder(column, icon, 0);
+    gtk_tree_view_column_add_attribute(column, icon, "icon-name", FILES_COL_ICON);
+
+    GtkCellRenderer *size = gtk_cell_renderer_text_new();
+    g_object_set(size, "xalign", 1.0, NULL);
+    add_details_column("Size", 90, FILES_SORT_SIZE, size, size_cell_data, -1);
+    add_details_column("Modified", 140, FILES_SORT_DATE, gtk_cell_renderer_text_new(),
+                       date_cell_data, -1);
+    GtkCellRenderer *type = gtk_cell_renderer_text_new();
+    g_object_set(type, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+    add_details_column("Type", 160, FILES_SORT_TYPE, type, NULL, FILES_COL_TYPE);
+    add_details_column("Permissions", 100, -1, gtk_cell_renderer_text_new(),
+                       mode_cell_data, -1);
+    apply_sort();
+
+    g_signal_connect(list_view, "row-activated", G_CALLBACK(on_row_activated), NULL);
+    gtk_widget_add_events(list_view, GDK_BUTTON_PRESS_MASK);
+    g_signal_connect(list_view, "button-press-event", G_CALLBACK(on_button_press), NULL);
+    g_signal_connect(list_view, "size-allocate", G_CALLBACK(on_view_size_allocate), NULL);
+    gtk_widget_add_events(list_view, GDK_POINTER_MOTION_MASK | GDK_LEAVE_NOTIFY_MASK);
+    g_signal_connect(list_view, "motion-notify-event", G_CALLBACK(on_view_motion), NULL);
+    g_signal_connect(list_view, "leave-notify-event", G_CALLBACK(on_hover_leave), NULL);
+    gtk_style_context_add_class(gtk_widget_get_style_context(list_view), "content-area");
+
+    GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
+    gtk_container_add(GTK_CONTAINER(scroll), list_view);
+    g_signal_connect(gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(scroll)),
+                     "value-changed", G_CALLBACK(on_view_scrolled), NULL);
+    return scroll;
+}
+
+static gboolean on_window_key(GtkWidget *widget, GdkEventKey *ev, gpointer data) {
+    (void)widget; (void)data;
+    if ((ev->state & GDK_CONTROL_MASK) && ev->keyval == GDK_KEY_f) {
+        gtk_widget_grab_focus(search_entry);
+        return TRUE;
+    }
+    if ((ev->state & GDK_CONTROL_MASK) && ev->keyval == GDK_KEY_F && !archive_file) {
+        findview_open(GTK_WINDOW(main_window), current_path,
+                      gtk_entry_get_text(GTK_ENTRY(search_entry)), show_hidden, open_file);
+        return TRUE;
+    }
+    /* Clipboard keys act on files unless a text field has focus */
+    GtkWidget *focus = gtk_window_get_focus(GTK_WINDOW(main_window));
+    if ((ev->state & GDK_CONTROL_MASK) && !(focus && GTK_IS_EDITABLE(focus))) {
+        switch (ev->keyval) {
+        case GDK_KEY_c: set_clipboard(FALSE); return TRUE;
+        case GDK_KEY_x: set_clipboard(TRUE); return TRUE;
+        case GDK_KEY_v: paste_into(current_path); return TRUE;
+        case GDK_KEY_1: set_details_view(FALSE); return TRUE;
+        case GDK_KEY_2: set_details_view(TRUE); return TRUE;
+        }
+    }
+    /* Delete trashes, Shift+Delete deletes for good */
+    if (ev->keyval == GDK_KEY_Delete && !archive_file && !(focus && GTK_IS_EDITABLE(focus))) {
+        if (ev->state & GDK_SHIFT_MASK) ctx_delete(NULL, NULL);
+        else ctx_trash(NULL, NULL);
+        return TRUE;
+    }
+    if (!(ev->state & GDK_MOD1_MASK)) return FALSE;
+    switch (ev->keyval) {
+    case GDK_KEY_Left:  go_back(NULL, NULL); return TRUE;
+    case GDK_KEY_Right: go_forward(NULL, NULL); return TRUE;
+    case GDK_KEY_Up:    go_up(NULL, NULL); return TRUE;
+    case GDK_KEY_Home:  go_home(NULL, NULL); return TRUE;
+    }
+    return FALSE;
+}
+
+/* Mouse back/forward side buttons */
+static gboolean on_window_button(GtkWidget *widget, GdkEventButton *ev, gpointer data) {
+    (void)widget; (void)data;
+    if (ev->type != GDK_BUTTON_PRESS) return FALSE;
+    if (ev->button == 8) { go_back(NULL, NULL); return TRUE; }
+    if (ev->button == 9) { go_forward(NULL, NULL); return TRUE; }
+    return FALSE;
+}
+
+static void on_window_destroy(GtkWidget *win, gpointer data) {
+    (void)win; (void)data;
+    prefetch_stop();
+    dirload_cancel(current_load);
+    dirload_cancel(update_load);
+    current_load = update_load = NULL;
+    dirwatch_free(dir_watch);
+    dir_watch = NULL;
+    walk_cancel(current_walk);
+    current_walk = NULL;
+    archivefs_load_cancel(archive_load);
+    archive_load = NULL;
+    archivefs_search_cancel(archive_search);
+    archive_search = NULL;
+    searching = FALSE;
+    if (flush_source) g_source_remove(flush_source);
+    flush_source = 0;
+    thumbs_begin_pass();
+    thumbs_end_pass();
+    if (visible_source) g_source_remove(visible_source);
+    visible_source = 0;
+    cancel_details();
+    volumes_free(volumes);
+    volumes = NULL;
+    g_clear_pointer(&volume_rows, g_hash_table_destroy);
+    if (ops_timer) g_source_remove(ops_timer);
+    ops_timer = 0;
+    /* Running jobs finish in the background; their conflicts are skipped */
+    if (conflict_op) fileop_resolve(conflict_op, FILEOP_SKIP, TRUE);
+    conflict_op = NULL;
+    conflict_dialog = NULL;
+    g_clear_object(&file_model);
+    icon_view = NULL;
+    list_view = NULL;
+    main_window = NULL;
+}
+
+static void build_window(GtkApplication *app, const char *initial_path) {
     main_window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    gtk_window_set_application(GTK_WINDOW(main_window), app);
     gtk_window_set_title(GTK_WINDOW(main_window), "Files");
     gtk_window_set_default_size(GTK_WINDOW(main_window), 900, 600);
     gtk_widget_set_app_paintable(main_window, TRUE);
@@ -472,7 +2155,10 @@ int main(int argc, char *argv[]) {
     GdkVisual *vis = gdk_screen_get_rgba_visual(scr);
     if (vis) gtk_widget_set_visual(main_window, vis);
 
-    g_signal_connect(main_window, "destroy", G_CALLBACK(gtk_main_quit), NULL);
+    g_signal_connect(main_window, "destroy", G_CALLBACK(on_window_destroy), NULL);
+    g_signal_connect(main_window, "key-press-event", G_CALLBACK(on_window_key), NULL);
+    gtk_widget_add_events(main_window, GDK_BUTTON_PRESS_MASK);
+    g_signal_connect(main_window, "button-press-event", G_CALLBACK(on_window_button), NULL);
 
     /* Main layout */
     GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
@@ -487,6 +2173,9 @@ int main(int argc, char *argv[]) {
     sidebar_list = gtk_list_box_new();
     gtk_list_box_set_selection_mode(GTK_LIST_BOX(sidebar_list), GTK_SELECTION_SINGLE);
     g_signal_connect(sidebar_list, "row-selected", G_CALLBACK(on_sidebar_select), NULL);
+    gtk_widget_add_events(sidebar_list, GDK_POINTER_MOTION_MASK | GDK_LEAVE_NOTIFY_MASK);
+    g_signal_connect(sidebar_list, "motion-notify-event", G_CALLBACK(on_sidebar_motion), NULL);
+    g_signal_connect(sidebar_list, "leave-notify-event", G_CALLBACK(on_hover_leave), NULL);
 
     const char *home = g_get_home_dir();
     gchar *docs = g_build_filename(home, "Documents", NULL);
@@ -500,8 +2189,21 @@ int main(int argc, char *argv[]) {
     gtk_container_add(GTK_CONTAINER(sidebar_list), create_sidebar_row("Downloads", "folder-download", down));
     gtk_container_add(GTK_CONTAINER(sidebar_list), create_sidebar_row("Pictures", "folder-pictures", pics));
     gtk_container_add(GTK_CONTAINER(sidebar_list), create_sidebar_row("Music", "folder-music", music));
-    gtk_container_add(GTK_CONTAINER(sidebar_list), create_sidebar_row("Videos", "folder-videos", videos));
-    gtk_container_add(GTK_CONTAINER(sidebar_list), create_sidebar_row("Root", "drive-harddisk", "/"));
+    volumes_anchor = create_sidebar_row("Videos", "folder-videos", videos);
+    gtk_container_add(GTK_CONTAINER(sidebar_list), volumes_anchor);
+
+    GtkWidget *trash_row = create_sidebar_row("Trash", "user-trash", trash_dir);
+    trash_size_label = gtk_label_new(NULL);
+    gtk_style_context_add_class(gtk_widget_get_style_context(trash_size_label), "dim-label");
+    gtk_box_pack_end(GTK_BOX(gtk_bin_get_child(GTK_BIN(trash_row))), trash_size_label,
+                     FALSE, FALSE, 0);
+    gtk_container_add(GTK_CONTAINER(sidebar_list), trash_row);
+    update_trash_size();
+
+    /* Root, removable media and other mounts, kept up to date */
+    volume_rows = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    volumes = volumes_watch(on_volumes_changed, NULL);
+    on_volumes_changed(NULL);
 
     g_free(docs); g_free(down); g_free(pics); g_free(music); g_free(videos);
 
@@ -516,6 +2218,16 @@ int main(int argc, char *argv[]) {
     GtkWidget *pathbar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
     gtk_style_context_add_class(gtk_widget_get_style_context(pathbar), "pathbar");
 
+    back_btn = gtk_button_new_with_label("←");
+    gtk_widget_set_tooltip_text(back_btn, "Back (Alt+Left)");
+    g_signal_connect(back_btn, "clicked", G_CALLBACK(go_back), NULL);
+    gtk_box_pack_start(GTK_BOX(pathbar), back_btn, FALSE, FALSE, 0);
+
+    forward_btn = gtk_button_new_with_label("→");
+    gtk_widget_set_tooltip_text(forward_btn, "Forward (Alt+Right)");
+    g_signal_connect(forward_btn, "clicked", G_CALLBACK(go_forward), NULL);
+    gtk_box_pack_start(GTK_BOX(pathbar), forward_btn, FALSE, FALSE, 0);
+
     GtkWidget *up_btn = gtk_button_new_with_label("↑");
     g_signal_connect(up_btn, "clicked", G_CALLBACK(go_up), NULL);
     gtk_box_pack_start(GTK_BOX(pathbar), up_btn, FALSE, FALSE, 0);
@@ -524,6 +2236,20 @@ int main(int argc, char *argv[]) {
     g_signal_connect(home_btn, "clicked", G_CALLBACK(go_home), NULL);
     gtk_box_pack_start(GTK_BOX(pathbar), home_btn, FALSE, FALSE, 0);
 
+    view_button = gtk_button_new_from_icon_name("view-list-symbolic", GTK_ICON_SIZE_BUTTON);
+    gtk_widget_set_tooltip_text(view_button, "Details (Ctrl+2)");
+    g_signal_connect(view_button, "clicked", G_CALLBACK(on_view_button), NULL);
+    gtk_box_pack_end(GTK_BOX(pathbar), view_button, FALSE, FALSE, 0);
+
+    load_spinner = gtk_spinner_new();
+    gtk_box_pack_end(GTK_BOX(pathbar), load_spinner, FALSE, FALSE, 4);
+
+    search_entry = gtk_search_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(search_entry), "Search this folder (Ctrl+F)");
+    g_signal_connect(search_entry, "search-changed", G_CALLBACK(on_search_changed), NULL);
+    g_signal_connect(search_entry, "stop-search", G_CALLBACK(on_search_stop), NULL);
+    gtk_box_pack_end(GTK_BOX(pathbar), search_entry, FALSE, FALSE, 0);
+
     path_label = gtk_label_new("");
     gtk_style_context_add_class(gtk_widget_get_style_context(path_label), "muted");
     gtk_label_set_xalign(GTK_LABEL(path_label), 0);
@@ -533,43 +2259,132 @@ int main(int argc, char *argv[]) {
     gtk_box_pack_start(GTK_BOX(right_box), pathbar, FALSE, FALSE, 0);
 
     /* Icon view */
-    file_store = gtk_list_store_new(NUM_COLS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_BOOLEAN);
+    file_model = files_model_new(on_model_resync, NULL);
+    files_model_set_show_hidden(file_model, show_hidden);
+    if (!saved_selection) saved_selection = g_array_new(FALSE, FALSE, sizeof(guint));
 
-    icon_view = gtk_icon_view_new_with_model(GTK_TREE_MODEL(file_store));
-    gtk_icon_view_set_text_column(GTK_ICON_VIEW(icon_view), COL_NAME);
+    icon_view = gtk_icon_view_new_with_model(GTK_TREE_MODEL(file_model));
+    gtk_icon_view_set_text_column(GTK_ICON_VIEW(icon_view), FILES_COL_NAME);
     gtk_icon_view_set_pixbuf_column(GTK_ICON_VIEW(icon_view), -1);
     gtk_icon_view_set_item_width(GTK_ICON_VIEW(icon_view), 90);
     gtk_icon_view_set_columns(GTK_ICON_VIEW(icon_view), -1);
     gtk_icon_view_set_spacing(GTK_ICON_VIEW(icon_view), 4);
     gtk_icon_view_set_margin(GTK_ICON_VIEW(icon_view), 12);
-    gtk_icon_view_set_selection_mode(GTK_ICON_VIEW(icon_view), GTK_SELECTION_SINGLE);
+    gtk_icon_view_set_selection_mode(GTK_ICON_VIEW(icon_view), GTK_SELECTION_MULTIPLE);
 
     /* Cell renderer for icons */
     GtkCellRenderer *pix_renderer = gtk_cell_renderer_pixbuf_new();
     g_object_set(pix_renderer, "stock-size", GTK_ICON_SIZE_DIALOG, NULL);
     gtk_cell_layout_pack_start(GTK_CELL_LAYOUT(icon_view), pix_renderer, FALSE);
-    gtk_cell_layout_set_attributes(GTK_CELL_LAYOUT(icon_view), pix_renderer,
-                                   "icon-name", COL_ICON, NULL);
+    gtk_cell_layout_set_cell_data_func(GTK_CELL_LAYOUT(icon_view), pix_renderer,
+                                       icon_cell_data, NULL, NULL);
 
     g_signal_connect(icon_view, "item-activated", G_CALLBACK(on_item_activated), NULL);
+    if (bench_start)
+        g_signal_connect_after(icon_view, "draw", G_CALLBACK(on_bench_draw), NULL);
     gtk_style_context_add_class(gtk_widget_get_style_context(icon_view), "content-area");
 
     /* Right-click context menu */
     gtk_widget_add_events(icon_view, GDK_BUTTON_PRESS_MASK);
     g_signal_connect(icon_view, "button-press-event", G_CALLBACK(on_button_press), NULL);
 
+    /* Resting on a folder reads it ahead */
+    gtk_widget_add_events(icon_view, GDK_POINTER_MOTION_MASK | GDK_LEAVE_NOTIFY_MASK);
+    g_signal_connect(icon_view, "motion-notify-event", G_CALLBACK(on_view_motion), NULL);
+    g_signal_connect(icon_view, "leave-notify-event", G_CALLBACK(on_hover_leave), NULL);
+
     GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
     gtk_container_add(GTK_CONTAINER(scroll), icon_view);
-    gtk_box_pack_start(GTK_BOX(right_box), scroll, TRUE, TRUE, 0);
+    g_signal_connect(gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(scroll)),
+                     "value-changed", G_CALLBACK(on_view_scrolled), NULL);
+    g_signal_connect(icon_view, "size-allocate", G_CALLBACK(on_view_size_allocate), NULL);
+
+    view_stack = gtk_stack_new();
+    gtk_stack_add_named(GTK_STACK(view_stack), scroll, "icons");
+    gtk_stack_add_named(GTK_STACK(view_stack), create_details_view(), "details");
+    gtk_box_pack_start(GTK_BOX(right_box), view_stack, TRUE, TRUE, 0);
+
+    /* Copy/move/delete progress, shown while jobs run */
+    ops_bar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    gtk_container_set_border_width(GTK_CONTAINER(ops_bar), 6);
+    ops_label = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(ops_label), 0);
+    gtk_label_set_ellipsize(GTK_LABEL(ops_label), PANGO_ELLIPSIZE_END);
+    gtk_box_pack_start(GTK_BOX(ops_bar), ops_label, TRUE, TRUE, 0);
+    ops_progress = gtk_progress_bar_new();
+    gtk_widget_set_size_request(ops_progress, 160, -1);
+    gtk_widget_set_valign(ops_progress, GTK_ALIGN_CENTER);
+    gtk_box_pack_start(GTK_BOX(ops_bar), ops_progress, FALSE, FALSE, 0);
+    GtkWidget *ops_cancel = gtk_button_new_from_icon_name("process-stop-symbolic", GTK_ICON_SIZE_BUTTON);
+    gtk_widget_set_tooltip_text(ops_cancel, "Cancel");
+    g_signal_connect(ops_cancel, "clicked", G_CALLBACK(on_ops_cancel), NULL);
+    gtk_box_pack_start(GTK_BOX(ops_bar), ops_cancel, FALSE, FALSE, 0);
+    gtk_widget_show(ops_label);
+    gtk_widget_show(ops_progress);
+    gtk_widget_show(ops_cancel);
+    gtk_widget_set_no_show_all(ops_bar, TRUE);
+    gtk_box_pack_start(GTK_BOX(right_box), ops_bar, FALSE, FALSE, 0);
 
     /* Initial path */
-    populate_files(home);
+    navigate_to(initial_path ? initial_path : home);
 
     /* Add titlebar + content */
     blazeneuro_add_titlebar(main_window, "Files", main_box);
 
     gtk_widget_show_all(main_window);
-    gtk_main();
+}
 
-    return 0;
+/* ── Single Instance ────────────────────────────────────── */
+static void on_startup(GApplication *app, gpointer data) {
+    (void)app; (void)data;
+    blazeneuro_load_theme();
+    thumbs_init(on_thumb_ready, NULL);
+    listcache_init();
+    fileops_init();
+    trash_dir = trash_files_dir();
+    g_mkdir_with_parents(trash_dir, 0700);
+    path_index = pathindex_open();
+}
+
+static void on_activate(GApplication *app, gpointer data) {
+    (void)data;
+    if (!main_window) build_window(GTK_APPLICATION(app), NULL);
+    gtk_window_present(GTK_WINDOW(main_window));
+}
+
+/* A second launch with a folder or archive argument navigates the
+ * existing window */
+static void on_open(GApplication *app, GFile **files, gint n_files,
+                    const gchar *hint, gpointer data) {
+    (void)hint; (void)data;
+    gchar *path = n_files > 0 ? g_file_get_path(files[0]) : NULL;
+    if (path && !g_file_test(path, G_FILE_TEST_IS_DIR) && !archivefs_supported(path)) {
+        g_free(path);
+        path = NULL;
+    }
+
+    if (!main_window)
+        build_window(GTK_APPLICATION(app), path);
+    else if (path)
+        navigate_to(path);
+    gtk_window_present(GTK_WINDOW(main_window));
+    g_free(path);
+}
+
+/* ── Main ───────────────────────────────────────────────── */
+int BLAZENEURO_MAIN(files)(int argc, char *argv[]) {
+    GApplicationFlags flags = G_APPLICATION_HANDLES_OPEN;
+    /* A timed run must not hand its folder to a running window */
+    if (g_getenv("BLAZENEURO_FILES_BENCH")) {
+        bench_start = g_get_monotonic_time();
+        flags |= G_APPLICATION_NON_UNIQUE;
+    }
+    GtkApplication *app = gtk_application_new("org.blazeneuro.Files", flags);
+    g_signal_connect(app, "startup", G_CALLBACK(on_startup), NULL);
+    g_signal_connect(app, "activate", G_CALLBACK(on_activate), NULL);
+    g_signal_connect(app, "open", G_CALLBACK(on_open), NULL);
+
+    int status = g_application_run(G_APPLICATION(app), argc, argv);
+    g_object_unref(app);
+    return status;
 }
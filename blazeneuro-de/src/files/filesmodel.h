@@ -0,0 +1,843 @@
+/*
+ * BlazeNeuro Files — Folder Model
+ * A GtkTreeModel over a packed listing instead of a GtkListStore, so a
+ * folder with a million entries costs a predictable ~32 bytes per entry
+ * plus its name and collation key:
+ *
+ *   FilesRecord   24 bytes  name and key pointers, kind, flags, basename offset
+ *   order          4 bytes  row -> record (sort and filter index)
+ *   row_of         4 bytes  record -> row
+ *
+ * Names and keys live back to back in one GStringChunk and the folder
+ * path is stored once; COL_PATH is built when asked for. Sizes and dates
+ * (16 bytes) are only kept once a sort by them, or the details view,
+ * has read them. Previews, and the permissions and type descriptions
+ * the details view reads (see metaload.h), are kept in sparse tables, as
+ * only rows that were on screen have them. The name index used by live
+ * updates is built the first time a folder changes.
+ *
+ * GtkIconView handles one row-inserted in O(rows), so appends are held
+ * back until files_model_flush(): a few rows are announced one by one,
+ * a large batch through the resync callback, which detaches the model
+ * from its views around the change.
+ *
+ * Rows are kept in the chosen order (see filesort.h): flushed rows are
+ * merged into place, and choosing another order sorts every row again,
+ * on a worker thread when there are many or sizes and dates are still
+ * missing. Reordering goes through the resync callback too.
+ */
+
+#ifndef BLAZENEURO_FILES_MODEL_H
+#define BLAZENEURO_FILES_MODEL_H
+
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include "dirload.h"
+#include "filesort.h"
+#include "filetype.h"
+
+#define FILES_MODEL_SIGNAL_MAX  256     /* larger changes resync the views */
+#define FILES_NO_ROW            G_MAXUINT32
+
+enum {
+    FILES_COL_ICON,         /* gchararray, static icon name */
+    FILES_COL_NAME,         /* gchararray */
+    FILES_COL_PATH,         /* gchararray, built on demand */
+    FILES_COL_IS_DIR,       /* gboolean */
+    FILES_COL_KIND,         /* gint, FileKind */
+    FILES_COL_THUMB,        /* GdkPixbuf */
+    FILES_COL_SIZE,         /* gint64, FILES_SORT_UNKNOWN until read */
+    FILES_COL_MTIME,        /* gint64, ns; 0 until read */
+    FILES_COL_MODE,         /* guint, st_mode; 0 until read */
+    FILES_COL_TYPE,         /* gchararray, type description; NULL until read */
+    FILES_N_COLUMNS
+};
+
+/* ── Listing ────────────────────────────────────────────── */
+enum {
+    FILES_REC_DIR    = 1 << 0,
+    FILES_REC_HIDDEN = 1 << 1,
+    FILES_REC_DEAD   = 1 << 2,  /* removed; the slot stays until relisting */
+};
+
+typedef struct {
+    const char *name;       /* in FilesListing.names; relative for search results */
+    const char *key;        /* collation key of the basename, also in names */
+    guint8 kind;            /* FileKind */
+    guint8 flags;
+    guint16 base;           /* offset of the basename in name */
+} FilesRecord;
+
+typedef struct {
+    gint64 size;            /* FILES_SORT_UNKNOWN: not read, or stale */
+    gint64 mtime;           /* ns */
+} FilesStat;
+
+typedef struct {
+    guint32 mode;           /* st_mode, 0 if not known */
+    const char *type;       /* interned description */
+} FilesDetails;
+
+typedef struct {
+    gint ref_count;
+    gchar *parent;
+    GStringChunk *names;
+    gsize name_bytes;       /* names and keys */
+    GArray *records;        /* FilesRecord */
+    GArray *stats;          /* FilesStat per record, as far as read */
+    GHashTable *by_name;    /* name -> record + 1; NULL until needed */
+    gboolean complete;      /* the whole folder has been read */
+    gint64 dir_mtime;       /* folder mtime (ns) the listing matches */
+} FilesListing;
+
+static FilesListing *files_listing_new(const char *parent) {
+    FilesListing *l = g_new0(FilesListing, 1);
+    l->ref_count = 1;
+    l->parent = g_strdup(parent);
+    l->names = g_string_chunk_new(16 * 1024);
+    l->records = g_array_new(FALSE, FALSE, sizeof(FilesRecord));
+    l->stats = g_array_new(FALSE, FALSE, sizeof(FilesStat));
+    return l;
+}
+
+static FilesListing *files_listing_ref(FilesListing *l) {
+    l->ref_count++;
+    return l;
+}
+
+static void files_listing_unref(FilesListing *l) {
+    if (!l || --l->ref_count > 0) return;
+    if (l->by_name) g_hash_table_destroy(l->by_name);
+    g_array_free(l->records, TRUE);
+    g_array_free(l->stats, TRUE);
+    g_string_chunk_free(l->names);
+    g_free(l->parent);
+    g_free(l);
+}
+
+/* Approximate heap footprint, for cache accounting */
+static gsize files_listing_bytes(const FilesListing *l) {
+    gsize bytes = sizeof(*l) + l->name_bytes + l->records->len * sizeof(FilesRecord) +
+                  l->stats->len * sizeof(FilesStat);
+    if (l->by_name) bytes += g_hash_table_size(l->by_name) * 3 * sizeof(gpointer);
+    return bytes;
+}
+
+static FilesRecord *_files_listing_record(FilesListing *l, guint rec) {
+    return &g_array_index(l->records, FilesRecord, rec);
+}
+
+static void _files_listing_index(FilesListing *l) {
+    if (l->by_name) return;
+    l->by_name = g_hash_table_new(g_str_hash, g_str_equal);
+    for (guint i = 0; i < l->records->len; i++) {
+        FilesRecord *r = _files_listing_record(l, i);
+        if (!(r->flags & FILES_REC_DEAD))
+            g_hash_table_insert(l->by_name, (gpointer)r->name, GUINT_TO_POINTER(i + 1));
+    }
+}
+
+/* Record index of @name, or FILES_NO_ROW */
+static guint files_listing_find(FilesListing *l, const char *name) {
+    _files_listing_index(l);
+    gpointer v = g_hash_table_lookup(l->by_name, name);
+    return v ? GPOINTER_TO_UINT(v) - 1 : FILES_NO_ROW;
+}
+
+static guint _files_listing_add(FilesListing *l, const DirEntry *e) {
+    FilesRecord r;
+    r.name = g_string_chunk_insert(l->names, e->name);
+    l->name_bytes += strlen(e->name) + 1;
+    /* Loaders make the key on their thread; index matches come without */
+    gchar *key = e->key ? NULL : files_collate_key(e->name + e->base);
+    r.key = g_string_chunk_insert(l->names, e->key ? e->key : key);
+    l->name_bytes += strlen(r.key) + 1;
+    g_free(key);
+    r.kind = (guint8)e->kind;
+    r.base = (guint16)MIN(e->base, G_MAXUINT16);
+    r.flags = (e->is_dir ? FILES_REC_DIR : 0) | (e->name[r.base] == '.' ? FILES_REC_HIDDEN : 0);
+    g_array_append_val(l->records, r);
+
+    guint rec = l->records->len - 1;
+    if (l->by_name)
+        g_hash_table_insert(l->by_name, (gpointer)r.name, GUINT_TO_POINTER(rec + 1));
+    return rec;
+}
+
+/* Appends listed entries to a listing no model shows yet (see prefetch.h) */
+static void files_listing_append(FilesListing *l, const DirEntry *entries, guint n) {
+    for (guint i = 0; i < n; i++) _files_listing_add(l, &entries[i]);
+}
+
+/* Sizes the stats to every record, the new ones not read */
+static void _files_listing_grow_stats(FilesListing *l) {
+    guint old = l->stats->len;
+    g_array_set_size(l->stats, l->records->len);
+    for (guint i = old; i < l->stats->len; i++)
+        g_array_index(l->stats, FilesStat, i).size = FILES_SORT_UNKNOWN;
+}
+
+/* ── Model ──────────────────────────────────────────────── */
+#define FILES_TYPE_MODEL (files_model_get_type())
+G_DECLARE_FINAL_TYPE(FilesModel, files_model, FILES, MODEL, GObject)
+
+/* @detach TRUE: take the model off its views; FALSE: put it back */
+typedef void (*FilesModelResyncFunc)(FilesModel *model, gboolean detach, gpointer data);
+
+struct _FilesModel {
+    GObject parent_instance;
+    gint stamp;
+    FilesListing *listing;
+    GArray *order;          /* guint32 record per row; [0, n_shown) announced */
+    guint n_shown;
+    GArray *row_of;         /* guint32 row per record, FILES_NO_ROW if filtered */
+    GHashTable *thumbs;     /* record -> GdkPixbuf */
+    GHashTable *details;    /* record -> FilesDetails, rows the details view read */
+    gboolean show_hidden;
+    FilesSortKey sort_key;
+    gboolean sort_descending;
+    FilesSort *sorting;     /* background sort in progress, or NULL */
+    guint serial;           /* bumped whenever rows come or go */
+    guint sorting_serial;   /* serial the background sort started from */
+    FilesModelResyncFunc resync;
+    gpointer resync_data;
+};
+
+static void files_model_tree_model_init(GtkTreeModelIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE(FilesModel, files_model, G_TYPE_OBJECT,
+                        G_IMPLEMENT_INTERFACE(GTK_TYPE_TREE_MODEL, files_model_tree_model_init))
+
+static guint _files_row_record(FilesModel *m, guint row) {
+    return g_array_index(m->order, guint32, row);
+}
+
+static guint _files_record_row(FilesModel *m, guint rec) {
+    return g_array_index(m->row_of, guint32, rec);
+}
+
+static void _files_set_iter(FilesModel *m, GtkTreeIter *iter, guint rec) {
+    iter->stamp = m->stamp;
+    iter->user_data = GUINT_TO_POINTER(rec);
+    iter->user_data2 = NULL;
+    iter->user_data3 = NULL;
+}
+
+static guint _files_iter_record(GtkTreeIter *iter) {
+    return GPOINTER_TO_UINT(iter->user_data);
+}
+
+static gboolean _files_visible(FilesModel *m, const FilesRecord *r) {
+    if (r->flags & FILES_REC_DEAD) return FALSE;
+    return m->show_hidden || !(r->flags & FILES_REC_HIDDEN);
+}
+
+/* Rebuilds order/row_of from the listing; views must be detached */
+static void _files_refilter(FilesModel *m) {
+    FilesListing *l = m->listing;
+    g_array_set_size(m->order, 0);
+    g_array_set_size(m->row_of, l->records->len);
+    for (guint i = 0; i < l->records->len; i++) {
+        guint32 row = FILES_NO_ROW;
+        if (_files_visible(m, _files_listing_record(l, i))) {
+            row = m->order->len;
+            g_array_append_val(m->order, i);
+        }
+        g_array_index(m->row_of, guint32, i) = row;
+    }
+    m->n_shown = m->order->len;
+    m->serial++;
+}
+
+static void _files_resync(FilesModel *m, gboolean detach) {
+    if (m->resync) m->resync(m, detach, m->resync_data);
+}
+
+/* ── Sorting ────────────────────────────────────────────── */
+static void _files_sort_item(FilesModel *m, guint rec, FilesSortItem *it) {
+    FilesListing *l = m->listing;
+    const FilesRecord *r = _files_listing_record(l, rec);
+    it->name = r->name;
+    it->key = r->key;
+    it->rec = rec;
+    it->base = r->base;
+    it->kind = r->kind;
+    it->is_dir = (r->flags & FILES_REC_DIR) != 0;
+    if (rec < l->stats->len) {
+        const FilesStat *st = &g_array_index(l->stats, FilesStat, rec);
+        it->size = st->size;
+        it->mtime = st->mtime;
+    } else {
+        it->size = FILES_SORT_UNKNOWN;
+        it->mtime = 0;
+    }
+}
+
+/* Can rows [from, to) be placed without reading anything? */
+static gboolean _files_sort_known(FilesModel *m, guint from, guint to) {
+    if (!filesort_needs_stat(m->sort_key)) return TRUE;
+    FilesListing *l = m->listing;
+    for (guint row = from; row < to; row++) {
+        guint rec = _files_row_record(m, row);
+        if (rec >= l->stats->len ||
+            g_array_index(l->stats, FilesStat, rec).size == FILES_SORT_UNKNOWN)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static gint _files_compare(FilesModel *m, guint a, guint b) {
+    FilesSortItem ia, ib;
+    _files_sort_item(m, a, &ia);
+    _files_sort_item(m, b, &ib);
+    return filesort_compare(&ia, &ib, m->sort_key, m->sort_descending);
+}
+
+static void _files_renumber(FilesModel *m, guint from) {
+    for (guint row = from; row < m->order->len; row++)
+        g_array_index(m->row_of, guint32, _files_row_record(m, row)) = row;
+}
+
+/* Sorts rows [from, to) in place; row_of is left to the caller */
+static void _files_sort_range(FilesModel *m, guint from, guint to) {
+    guint n = to - from;
+    FilesSortItem *items = g_new(FilesSortItem, n);
+    for (guint i = 0; i < n; i++)
+        _files_sort_item(m, _files_row_record(m, from + i), &items[i]);
+    filesort_items(items, n, m->sort_key, m->sort_descending);
+    for (guint i = 0; i < n; i++)
+        g_array_index(m->order, guint32, from + i) = items[i].rec;
+    g_free(items);
+}
+
+/* Merges the sorted held-back rows into the sorted shown ones and
+ * announces them all; views must be detached */
+static void _files_merge(FilesModel *m) {
+    guint n = m->order->len, mid = m->n_shown;
+    guint32 *rows = (guint32 *)m->order->data;
+    guint32 *out = g_new(guint32, n);
+    guint a = 0, b = mid, k = 0;
+    while (a < mid && b < n)
+        out[k++] = _files_compare(m, rows[b], rows[a]) < 0 ? rows[b++] : rows[a++];
+    while (a < mid) out[k++] = rows[a++];
+    while (b < n) out[k++] = rows[b++];
+    memcpy(rows, out, n * sizeof(guint32));
+    g_free(out);
+    _files_renumber(m, 0);
+    m->n_shown = n;
+}
+
+static void _files_sort(FilesModel *m);
+
+/* Keeps what the worker read, then applies its order unless rows came
+ * or went meanwhile; then it sorts again, mostly from what is known */
+static void _files_sorted(const FilesSortItem *items, guint n, gpointer data) {
+    FilesModel *m = data;
+    FilesListing *l = m->listing;
+    filesort_cancel(m->sorting);
+    m->sorting = NULL;
+
+    if (filesort_needs_stat(m->sort_key)) {
+        _files_listing_grow_stats(l);
+        for (guint i = 0; i < n; i++) {
+            FilesStat *st = &g_array_index(l->stats, FilesStat, items[i].rec);
+            st->size = items[i].size;
+            st->mtime = items[i].mtime;
+        }
+    }
+
+    if (m->serial != m->sorting_serial) {
+        _files_sort(m);
+        return;
+    }
+    _files_resync(m, TRUE);
+    for (guint i = 0; i < n; i++)
+        g_array_index(m->order, guint32, i) = items[i].rec;
+    _files_renumber(m, 0);
+    m->n_shown = m->order->len;
+    _files_resync(m, FALSE);
+}
+
+/* Puts every row in order: at once when that is cheap, else on a worker
+ * thread, the rows keeping their current order until it is done */
+static void _files_sort(FilesModel *m) {
+    filesort_cancel(m->sorting);
+    m->sorting = NULL;
+    guint n = m->order->len;
+    if (n < 2) return;
+
+    if (n <= FILES_SORT_SYNC_MAX && _files_sort_known(m, 0, n)) {
+        _files_resync(m, TRUE);
+        _files_sort_range(m, 0, n);
+        _files_renumber(m, 0);
+        m->n_shown = n;
+        _files_resync(m, FALSE);
+        return;
+    }
+
+    GArray *items = g_array_sized_new(FALSE, FALSE, sizeof(FilesSortItem), n);
+    g_array_set_size(items, n);
+    for (guint row = 0; row < n; row++)
+        _files_sort_item(m, _files_row_record(m, row), &g_array_index(items, FilesSortItem, row));
+    m->sorting_serial = m->serial;
+    m->sorting = filesort_start(m->listing->parent, items, m->sort_key, m->sort_descending,
+                                _files_sorted, m, files_listing_ref(m->listing),
+                                (GDestroyNotify)files_listing_unref);
+}
+
+/* ── GtkTreeModel ───────────────────────────────────────── */
+static GtkTreeModelFlags files_model_get_flags(GtkTreeModel *model) {
+    (void)model;
+    return GTK_TREE_MODEL_LIST_ONLY | GTK_TREE_MODEL_ITERS_PERSIST;
+}
+
+static gint files_model_get_n_columns(GtkTreeModel *model) {
+    (void)model;
+    return FILES_N_COLUMNS;
+}
+
+static GType files_model_get_column_type(GtkTreeModel *model, gint column) {
+    (void)model;
+    switch (column) {
+    case FILES_COL_IS_DIR: return G_TYPE_BOOLEAN;
+    case FILES_COL_KIND:   return G_TYPE_INT;
+    case FILES_COL_THUMB:  return GDK_TYPE_PIXBUF;
+    case FILES_COL_SIZE:
+    case FILES_COL_MTIME:  return G_TYPE_INT64;
+    case FILES_COL_MODE:   return G_TYPE_UINT;
+    default:               return G_TYPE_STRING;
+    }
+}
+
+static gboolean files_model_get_iter(GtkTreeModel *model, GtkTreeIter *iter, GtkTreePath *path) {
+    FilesModel *m = FILES_MODEL(model);
+    if (gtk_tree_path_get_depth(path) != 1) return FALSE;
+    gint row = gtk_tree_path_get_indices(path)[0];
+    if (row < 0 || (guint)row >= m->n_shown) return FALSE;
+    _files_set_iter(m, iter, _files_row_record(m, (guint)row));
+    return TRUE;
+}
+
+static GtkTreePath *files_model_get_path(GtkTreeModel *model, GtkTreeIter *iter) {
+    FilesModel *m = FILES_MODEL(model);
+    g_return_val_if_fail(iter->stamp == m->stamp, NULL);
+    return gtk_tree_path_new_from_indices((gint)_files_record_row(m, _files_iter_record(iter)), -1);
+}
+
+static void files_model_get_value(GtkTreeModel *model, GtkTreeIter *iter,
+                                  gint column, GValue *value) {
+    FilesModel *m = FILES_MODEL(model);
+    g_return_if_fail(iter->stamp == m->stamp);
+    guint rec = _files_iter_record(iter);
+    const FilesRecord *r = _files_listing_record(m->listing, rec);
+    const FilesStat *st = rec < m->listing->stats->len ?
+                          &g_array_index(m->listing->stats, FilesStat, rec) : NULL;
+    const FilesDetails *d = g_hash_table_lookup(m->details, GUINT_TO_POINTER(rec));
+
+    g_value_init(value, files_model_get_column_type(model, column));
+    switch (column) {
+    case FILES_COL_ICON:
+        g_value_set_static_string(value, filetype_icons[r->kind]);
+        break;
+    case FILES_COL_NAME:
+        g_value_set_static_string(value, r->name + r->base);
+        break;
+    case FILES_COL_PATH:
+        g_value_take_string(value, g_build_filename(m->listing->parent, r->name, NULL));
+        break;
+    case FILES_COL_IS_DIR:
+        g_value_set_boolean(value, (r->flags & FILES_REC_DIR) != 0);
+        break;
+    case FILES_COL_KIND:
+        g_value_set_int(value, r->kind);
+        break;
+    case FILES_COL_THUMB:
+        g_value_set_object(value, g_hash_table_lookup(m->thumbs, GUINT_TO_POINTER(rec)));
+        break;
+    case FILES_COL_SIZE:
+        g_value_set_int64(value, st ? st->size : FILES_SORT_UNKNOWN);
+        break;
+    case FILES_COL_MTIME:
+        g_value_set_int64(value, st && st->size != FILES_SORT_UNKNOWN ? st->mtime : 0);
+        break;
+    case FILES_COL_MODE:
+        g_value_set_uint(value, d ? d->mode : 0);
+        break;
+    case FILES_COL_TYPE:
+        g_value_set_static_string(value, d ? d->type : NULL);
+        break;
+    }
+}
+
+static gboolean files_model_iter_nth_child(GtkTreeModel *model, GtkTreeIter *iter,
+                                           GtkTreeIter *parent, gint n) {
+    FilesModel *m = FILES_MODEL(model);
+    if (parent || n < 0 || (guint)n >= m->n_shown) return FALSE;
+    _files_set_iter(m, iter, _files_row_record(m, (guint)n));
+    return TRUE;
+}
+
+/* A record filtered out since @iter was made has no neighbours */
+static gboolean files_model_iter_next(GtkTreeModel *model, GtkTreeIter *iter) {
+    FilesModel *m = FILES_MODEL(model);
+    guint row = _files_record_row(m, _files_iter_record(iter));
+    if (row == FILES_NO_ROW || ++row >= m->n_shown) {
+        iter->stamp = 0;
+        return FALSE;
+    }
+    _files_set_iter(m, iter, _files_row_record(m, row));
+    return TRUE;
+}
+
+static gboolean files_model_iter_previous(GtkTreeModel *model, GtkTreeIter *iter) {
+    FilesModel *m = FILES_MODEL(model);
+    guint row = _files_record_row(m, _files_iter_record(iter));
+    if (row == 0 || row == FILES_NO_ROW) {
+        iter->stamp = 0;
+        return FALSE;
+    }
+    _files_set_iter(m, iter, _files_row_record(m, row - 1));
+    return TRUE;
+}
+
+static gboolean files_model_iter_children(GtkTreeModel *model, GtkTreeIter *iter,
+                                          GtkTreeIter *parent) {
+    return files_model_iter_nth_child(model, iter, parent, 0);
+}
+
+static gboolean files_model_iter_has_child(GtkTreeModel *model, GtkTreeIter *iter) {
+    (void)model; (void)iter;
+    return FALSE;
+}
+
+static gint files_model_iter_n_children(GtkTreeModel *model, GtkTreeIter *iter) {
+    return iter ? 0 : (gint)FILES_MODEL(model)->n_shown;
+}
+
+static gboolean files_model_iter_parent(GtkTreeModel *model, GtkTreeIter *iter,
+                                        GtkTreeIter *child) {
+    (void)model; (void)iter; (void)child;
+    return FALSE;
+}
+
+static void files_model_tree_model_init(GtkTreeModelIface *iface) {
+    iface->get_flags = files_model_get_flags;
+    iface->get_n_columns = files_model_get_n_columns;
+    iface->get_column_type = files_model_get_column_type;
+    iface->get_iter = files_model_get_iter;
+    iface->get_path = files_model_get_path;
+    iface->get_value = files_model_get_value;
+    iface->iter_next = files_model_iter_next;
+    iface->iter_previous = files_model_iter_previous;
+    iface->iter_children = files_model_iter_children;
+    iface->iter_has_child = files_model_iter_has_child;
+    iface->iter_n_children = files_model_iter_n_children;
+    iface->iter_nth_child = files_model_iter_nth_child;
+    iface->iter_parent = files_model_iter_parent;
+}
+
+/* ── GObject ────────────────────────────────────────────── */
+static void files_model_finalize(GObject *object) {
+    FilesModel *m = FILES_MODEL(object);
+    filesort_cancel(m->sorting);
+    files_listing_unref(m->listing);
+    g_array_free(m->order, TRUE);
+    g_array_free(m->row_of, TRUE);
+    g_hash_table_destroy(m->thumbs);
+    g_hash_table_destroy(m->details);
+    G_OBJECT_CLASS(files_model_parent_class)->finalize(object);
+}
+
+static void files_model_class_init(FilesModelClass *klass) {
+    G_OBJECT_CLASS(klass)->finalize = files_model_finalize;
+}
+
+static void files_model_init(FilesModel *m) {
+    m->stamp = g_random_int();
+    m->listing = files_listing_new("/");
+    m->order = g_array_new(FALSE, FALSE, sizeof(guint32));
+    m->row_of = g_array_new(FALSE, FALSE, sizeof(guint32));
+    m->thumbs = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_object_unref);
+    m->details = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+static FilesModel *files_model_new(FilesModelResyncFunc resync, gpointer data) {
+    FilesModel *m = g_object_new(FILES_TYPE_MODEL, NULL);
+    m->resync = resync;
+    m->resync_data = data;
+    return m;
+}
+
+static FilesListing *files_model_get_listing(FilesModel *m) {
+    return m->listing;
+}
+
+/* Shows @listing (the model takes a reference); iters are invalidated */
+static void files_model_set_listing(FilesModel *m, FilesListing *listing) {
+    filesort_cancel(m->sorting);
+    m->sorting = NULL;
+    _files_resync(m, TRUE);
+    files_listing_unref(m->listing);
+    m->listing = files_listing_ref(listing);
+    m->stamp++;
+    g_hash_table_remove_all(m->thumbs);
+    g_hash_table_remove_all(m->details);
+    _files_refilter(m);
+    _files_resync(m, FALSE);
+    _files_sort(m);
+}
+
+static void files_model_set_show_hidden(FilesModel *m, gboolean show_hidden) {
+    if (m->show_hidden == show_hidden) return;
+    _files_resync(m, TRUE);
+    m->show_hidden = show_hidden;
+    _files_refilter(m);
+    _files_resync(m, FALSE);
+    _files_sort(m);
+}
+
+static void files_model_set_sort(FilesModel *m, FilesSortKey key, gboolean descending) {
+    if (m->sort_key == key && m->sort_descending == descending) return;
+    m->sort_key = key;
+    m->sort_descending = descending;
+    _files_sort(m);
+}
+
+/* Appends freshly listed entries (names not yet in the listing). They
+ * stay invisible to views until files_model_flush(). */
+static void files_model_append(FilesModel *m, const DirEntry *entries, guint n) {
+    for (guint i = 0; i < n; i++) {
+        guint rec = _files_listing_add(m->listing, &entries[i]);
+        guint32 row = FILES_NO_ROW;
+        if (_files_visible(m, _files_listing_record(m->listing, rec))) {
+            row = m->order->len;
+            g_array_append_val(m->order, rec);
+        }
+        g_array_append_val(m->row_of, row);
+    }
+    m->serial++;
+}
+
+/* Announces rows held back by files_model_append(), in sort order.
+ * Rows without a size or date yet go last until a background sort,
+ * started here, moves them. */
+static void files_model_flush(FilesModel *m) {
+    guint pending = m->order->len - m->n_shown;
+    if (pending == 0) return;
+
+    gboolean placed = !m->sorting && _files_sort_known(m, m->n_shown, m->order->len);
+    if (placed) _files_sort_range(m, m->n_shown, m->order->len);
+
+    if (pending > FILES_MODEL_SIGNAL_MAX && m->resync) {
+        _files_resync(m, TRUE);
+        if (placed)
+            _files_merge(m);
+        else
+            m->n_shown = m->order->len;
+        _files_resync(m, FALSE);
+    } else if (!placed) {
+        while (m->n_shown < m->order->len) {
+            GtkTreeIter iter;
+            guint row = m->n_shown++;
+            _files_set_iter(m, &iter, _files_row_record(m, row));
+            GtkTreePath *path = gtk_tree_path_new_from_indices((gint)row, -1);
+            gtk_tree_model_row_inserted(GTK_TREE_MODEL(m), path, &iter);
+            gtk_tree_path_free(path);
+        }
+    } else {
+        /* Each lands after the one before, so the search narrows */
+        guint32 *held = g_new(guint32, pending);
+        memcpy(held, &g_array_index(m->order, guint32, m->n_shown), pending * sizeof(guint32));
+        g_array_set_size(m->order, m->n_shown);
+        for (guint i = 0; i < pending; i++)
+            g_array_index(m->row_of, guint32, held[i]) = FILES_NO_ROW;
+
+        guint lo = 0;
+        for (guint i = 0; i < pending; i++) {
+            guint hi = m->n_shown;
+            while (lo < hi) {
+                guint mid = lo + (hi - lo) / 2;
+                if (_files_compare(m, _files_row_record(m, mid), held[i]) < 0)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            g_array_insert_val(m->order, lo, held[i]);
+            m->n_shown++;
+            _files_renumber(m, lo);
+
+            GtkTreeIter iter;
+            _files_set_iter(m, &iter, held[i]);
+            GtkTreePath *path = gtk_tree_path_new_from_indices((gint)lo, -1);
+            gtk_tree_model_row_inserted(GTK_TREE_MODEL(m), path, &iter);
+            gtk_tree_path_free(path);
+            lo++;
+        }
+        g_free(held);
+    }
+
+    if (!placed && !m->sorting) _files_sort(m);
+}
+
+/* Drops the rows of @recs (already marked dead) from the order index */
+static void _files_remove_rows(FilesModel *m, GArray *recs) {
+    m->serial++;
+    gboolean bulk = recs->len > FILES_MODEL_SIGNAL_MAX && m->resync;
+    if (bulk) {
+        _files_resync(m, TRUE);
+        guint shown = m->n_shown, out = 0;
+        for (guint row = 0; row < m->order->len; row++) {
+            guint rec = _files_row_record(m, row);
+            if (_files_listing_record(m->listing, rec)->flags & FILES_REC_DEAD) {
+                g_array_index(m->row_of, guint32, rec) = FILES_NO_ROW;
+                if (row < m->n_shown) shown--;
+                continue;
+            }
+            g_array_index(m->order, guint32, out) = rec;
+            g_array_index(m->row_of, guint32, rec) = out++;
+        }
+        g_array_set_size(m->order, out);
+        m->n_shown = shown;
+        _files_resync(m, FALSE);
+        return;
+    }
+
+    for (guint i = 0; i < recs->len; i++) {
+        guint rec = g_array_index(recs, guint32, i);
+        guint row = _files_record_row(m, rec);
+        if (row == FILES_NO_ROW) continue;
+
+        g_array_remove_index(m->order, row);
+        g_array_index(m->row_of, guint32, rec) = FILES_NO_ROW;
+        for (guint r = row; r < m->order->len; r++)
+            g_array_index(m->row_of, guint32, _files_row_record(m, r)) = r;
+
+        if (row < m->n_shown) {
+            m->n_shown--;
+            GtkTreePath *path = gtk_tree_path_new_from_indices((gint)row, -1);
+            gtk_tree_model_row_deleted(GTK_TREE_MODEL(m), path);
+            gtk_tree_path_free(path);
+        }
+    }
+}
+
+/* Applies re-examined names (see dirload_start_names()): existing ones
+ * are updated in place, new ones appended, gone ones removed */
+static void files_model_update(FilesModel *m, const DirEntry *entries, guint n) {
+    FilesListing *l = m->listing;
+    GArray *removed = g_array_new(FALSE, FALSE, sizeof(guint32));
+    gboolean resort = FALSE;
+
+    for (guint i = 0; i < n; i++) {
+        const DirEntry *e = &entries[i];
+        guint rec = files_listing_find(l, e->name);
+
+        if (rec == FILES_NO_ROW) {
+            if (!e->gone) files_model_append(m, e, 1);
+            continue;
+        }
+
+        FilesRecord *r = _files_listing_record(l, rec);
+        if (e->gone) {
+            r->flags |= FILES_REC_DEAD;
+            g_hash_table_remove(l->by_name, r->name);
+            g_hash_table_remove(m->thumbs, GUINT_TO_POINTER(rec));
+            g_hash_table_remove(m->details, GUINT_TO_POINTER(rec));
+            g_array_append_val(removed, rec);
+            continue;
+        }
+
+        /* Rewritten: its size and date are stale, its place may be */
+        gboolean was_dir = (r->flags & FILES_REC_DIR) != 0;
+        resort |= m->sort_key != FILES_SORT_NAME || was_dir != e->is_dir;
+        if (rec < l->stats->len)
+            g_array_index(l->stats, FilesStat, rec).size = FILES_SORT_UNKNOWN;
+        r->kind = (guint8)e->kind;
+        r->flags = (r->flags & ~FILES_REC_DIR) | (e->is_dir ? FILES_REC_DIR : 0);
+        g_hash_table_remove(m->thumbs, GUINT_TO_POINTER(rec));
+        g_hash_table_remove(m->details, GUINT_TO_POINTER(rec));
+
+        guint row = _files_record_row(m, rec);
+        if (row != FILES_NO_ROW && row < m->n_shown) {
+            GtkTreeIter iter;
+            _files_set_iter(m, &iter, rec);
+            GtkTreePath *path = gtk_tree_path_new_from_indices((gint)row, -1);
+            gtk_tree_model_row_changed(GTK_TREE_MODEL(m), path, &iter);
+            gtk_tree_path_free(path);
+        }
+    }
+
+    if (removed->len > 0) _files_remove_rows(m, removed);
+    g_array_free(removed, TRUE);
+    files_model_flush(m);
+    if (resort) {
+        m->serial++;
+        _files_sort(m);
+    }
+}
+
+/* Record behind @iter, stable until the folder is relisted */
+static guint files_model_iter_record(FilesModel *m, GtkTreeIter *iter) {
+    g_return_val_if_fail(iter->stamp == m->stamp, FILES_NO_ROW);
+    return _files_iter_record(iter);
+}
+
+/* FALSE if @rec is gone or filtered out */
+static gboolean files_model_record_iter(FilesModel *m, guint rec, GtkTreeIter *iter) {
+    if (rec >= m->row_of->len) return FALSE;
+    guint row = _files_record_row(m, rec);
+    if (row == FILES_NO_ROW || row >= m->n_shown) return FALSE;
+    _files_set_iter(m, iter, rec);
+    return TRUE;
+}
+
+/* Relative name of @rec, owned by the listing */
+static const char *files_model_record_name(FilesModel *m, guint rec) {
+    return _files_listing_record(m->listing, rec)->name;
+}
+
+/* Has the details view read @rec yet? */
+static gboolean files_model_has_details(FilesModel *m, guint rec) {
+    return g_hash_table_contains(m->details, GUINT_TO_POINTER(rec));
+}
+
+/* Stores what the details view read for @rec; @size FILES_SORT_UNKNOWN
+ * keeps the size and date already known, @kind FT_KIND_UNKNOWN the kind.
+ * Neither moves the row: a sort by size read them all, and updates sort
+ * again; a sort by type keeps files typed later where they were. */
+static void files_model_set_details(FilesModel *m, guint rec, gint64 size, gint64 mtime,
+                                    guint32 mode, const char *type, FileKind kind) {
+    FilesListing *l = m->listing;
+    if (rec >= l->records->len) return;
+    if (kind != FT_KIND_UNKNOWN) _files_listing_record(l, rec)->kind = (guint8)kind;
+    if (size != FILES_SORT_UNKNOWN) {
+        _files_listing_grow_stats(l);
+        FilesStat *st = &g_array_index(l->stats, FilesStat, rec);
+        st->size = size;
+        st->mtime = mtime;
+    }
+    FilesDetails *d = g_new(FilesDetails, 1);
+    d->mode = mode;
+    d->type = type;
+    g_hash_table_replace(m->details, GUINT_TO_POINTER(rec), d);
+
+    GtkTreeIter iter;
+    if (!files_model_record_iter(m, rec, &iter)) return;
+    GtkTreePath *path = files_model_get_path(GTK_TREE_MODEL(m), &iter);
+    gtk_tree_model_row_changed(GTK_TREE_MODEL(m), path, &iter);
+    gtk_tree_path_free(path);
+}
+
+static void files_model_set_thumb(FilesModel *m, GtkTreeIter *iter, GdkPixbuf *pixbuf) {
+    guint rec = files_model_iter_record(m, iter);
+    if (rec == FILES_NO_ROW) return;
+    g_hash_table_replace(m->thumbs, GUINT_TO_POINTER(rec), g_object_ref(pixbuf));
+
+    GtkTreePath *path = files_model_get_path(GTK_TREE_MODEL(m), iter);
+    gtk_tree_model_row_changed(GTK_TREE_MODEL(m), path, iter);
+    gtk_tree_path_free(path);
+}
+
+#endif /* BLAZENEURO_FILES_MODEL_H */
@@ -0,0 +1,224 @@
+/*
+ * BlazeNeuro Files — Sorting
+ * Orders a folder by name, size, type or date, folders first. Names
+ * compare by their g_utf8_collate_key_for_filename() key, so "file10"
+ * follows "file9" and case and accents sort the way people expect; the
+ * loaders make the key once per entry on their worker threads and the
+ * model keeps it, so a sort is plain strcmp()s.
+ *
+ * Size and date need a stat per entry, which a listing does not make
+ * (see dirload.h); they are filled in by the first sort that needs
+ * them. A large folder, or one still missing sizes or dates, is sorted
+ * by filesort_start() on a worker thread, which works on a snapshot of
+ * the rows, so changing the order of 100k entries never stalls the
+ * window.
+ *
+ * Usage:
+ *   FilesSort *sort = filesort_start(parent, items, key, descending,
+ *                                    on_sorted, data, listing, unref);
+ *   ...
+ *   filesort_cancel(sort);   // the rows changed: no callback
+ */
+
+#ifndef BLAZENEURO_FILES_FILESORT_H
+#define BLAZENEURO_FILES_FILESORT_H
+
+#include <gio/gio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define FILES_SORT_SYNC_MAX     4096    /* rows sorted on the main thread */
+#define FILES_SORT_UNKNOWN      (-1)    /* size/mtime not read yet */
+#define FILES_SORT_CHECK_EVERY  256     /* stats between cancellation checks */
+
+typedef enum {
+    FILES_SORT_NAME,
+    FILES_SORT_SIZE,
+    FILES_SORT_TYPE,
+    FILES_SORT_DATE,
+    FILES_N_SORTS
+} FilesSortKey;
+
+/* One row, as the sort sees it; the strings belong to the listing */
+typedef struct {
+    const char *name;       /* relative to the folder */
+    const char *key;        /* collation key of the basename */
+    gint64 size;            /* bytes, or FILES_SORT_UNKNOWN */
+    gint64 mtime;           /* ns */
+    guint32 rec;
+    guint16 base;           /* offset of the basename in name */
+    guint8 kind;            /* FileKind */
+    guint8 is_dir;
+} FilesSortItem;
+
+/* Collation key for @name, which need not be valid UTF-8. Any thread. */
+static gchar *files_collate_key(const char *name) {
+    if (g_utf8_validate(name, -1, NULL))
+        return g_utf8_collate_key_for_filename(name, -1);
+    gchar *valid = g_utf8_make_valid(name, -1);
+    gchar *key = g_utf8_collate_key_for_filename(valid, -1);
+    g_free(valid);
+    return key;
+}
+
+static gboolean filesort_needs_stat(FilesSortKey key) {
+    return key == FILES_SORT_SIZE || key == FILES_SORT_DATE;
+}
+
+/* Extension of the basename, "" for none or a dot file */
+static const char *_filesort_ext(const FilesSortItem *it) {
+    const char *base = it->name + it->base;
+    const char *dot = strrchr(base, '.');
+    return dot && dot != base ? dot + 1 : "";
+}
+
+static gint _filesort_cmp64(gint64 a, gint64 b) {
+    return a < b ? -1 : a > b;
+}
+
+/* Folders come first whichever the direction; ties fall back to the
+ * name, then to listing order, so equal rows never swap places */
+static gint filesort_compare(const FilesSortItem *a, const FilesSortItem *b,
+                             FilesSortKey key, gboolean descending) {
+    if (a->is_dir != b->is_dir) return a->is_dir ? -1 : 1;
+
+    gint res = 0;
+    switch (key) {
+    case FILES_SORT_SIZE:
+        /* A folder's st_size says nothing about its contents */
+        if (!a->is_dir) res = _filesort_cmp64(a->size, b->size);
+        break;
+    case FILES_SORT_TYPE:
+        res = (gint)a->kind - (gint)b->kind;
+        if (res == 0) res = g_ascii_strcasecmp(_filesort_ext(a), _filesort_ext(b));
+        break;
+    case FILES_SORT_DATE:
+        res = _filesort_cmp64(a->mtime, b->mtime);
+        break;
+    default:
+        break;
+    }
+    if (res == 0) res = strcmp(a->key, b->key);
+    if (res == 0) res = a->rec < b->rec ? -1 : a->rec > b->rec;
+    return descending ? -res : res;
+}
+
+typedef struct {
+    FilesSortKey key;
+    gboolean descending;
+} FilesSortOrder;
+
+static gint _filesort_qsort_cmp(gconstpointer a, gconstpointer b, gpointer data) {
+    const FilesSortOrder *o = data;
+    return filesort_compare(a, b, o->key, o->descending);
+}
+
+/* Sorts @items in place on the calling thread; sizes and dates must
+ * already be known for a size or date sort */
+static void filesort_items(FilesSortItem *items, guint n, FilesSortKey key, gboolean descending) {
+    FilesSortOrder o = { key, descending };
+    g_qsort_with_data(items, (gint)n, sizeof(FilesSortItem), _filesort_qsort_cmp, &o);
+}
+
+/* ── Background sort ────────────────────────────────────── */
+/* Runs on the main thread with the sorted items, sizes and dates filled
+ * in; never after filesort_cancel() */
+typedef void (*FilesSortDoneFunc)(const FilesSortItem *items, guint n, gpointer data);
+
+typedef struct {
+    gint ref_count;
+    gchar *parent;
+    GArray *items;          /* FilesSortItem */
+    FilesSortOrder order;
+    GCancellable *cancellable;
+    FilesSortDoneFunc done_func;
+    gpointer data;
+    gpointer keep;
+    GDestroyNotify keep_free;
+} FilesSort;
+
+static void _filesort_unref(FilesSort *sort) {
+    if (!g_atomic_int_dec_and_test(&sort->ref_count)) return;
+    if (sort->keep_free) sort->keep_free(sort->keep);
+    g_array_free(sort->items, TRUE);
+    g_object_unref(sort->cancellable);
+    g_free(sort->parent);
+    g_free(sort);
+}
+
+static gboolean _filesort_deliver(gpointer data) {
+    FilesSort *sort = data;
+    if (!g_cancellable_is_cancelled(sort->cancellable))
+        sort->done_func((const FilesSortItem *)sort->items->data, sort->items->len, sort->data);
+    return G_SOURCE_REMOVE;
+}
+
+/* Reads what the listing left out, relative to the folder's fd; links
+ * report their target, as that is what opening them gives */
+static gboolean _filesort_stat(FilesSort *sort) {
+    int dfd = open(sort->parent, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    for (guint i = 0; i < sort->items->len; i++) {
+        if (i % FILES_SORT_CHECK_EVERY == 0 && g_cancellable_is_cancelled(sort->cancellable))
+            break;
+        FilesSortItem *it = &g_array_index(sort->items, FilesSortItem, i);
+        if (it->size != FILES_SORT_UNKNOWN) continue;
+
+        struct stat st;
+        if (dfd >= 0 && fstatat(dfd, it->name, &st, AT_NO_AUTOMOUNT) == 0) {
+            it->size = st.st_size;
+            it->mtime = (gint64)st.st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) +
+                        st.st_mtim.tv_nsec;
+        } else {
+            it->size = 0;       /* vanished or unreadable: known, and small */
+            it->mtime = 0;
+        }
+    }
+    if (dfd >= 0) close(dfd);
+    return !g_cancellable_is_cancelled(sort->cancellable);
+}
+
+static gpointer _filesort_worker(gpointer data) {
+    FilesSort *sort = data;
+    if (!g_cancellable_is_cancelled(sort->cancellable) &&
+        (!filesort_needs_stat(sort->order.key) || _filesort_stat(sort)))
+        filesort_items((FilesSortItem *)sort->items->data, sort->items->len,
+                       sort->order.key, sort->order.descending);
+    /* Even when cancelled: the worker's reference goes with the idle, so
+     * the last unref, and @keep with it, happens on the main thread */
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, _filesort_deliver, sort,
+                    (GDestroyNotify)_filesort_unref);
+    return NULL;
+}
+
+/* Sorts @items (taken) on a worker thread, reading missing sizes and
+ * dates relative to @parent first. @keep owns the items' strings and is
+ * released with @keep_free once the worker is done with them. */
+static FilesSort *filesort_start(const char *parent, GArray *items,
+                                 FilesSortKey key, gboolean descending,
+                                 FilesSortDoneFunc done, gpointer data,
+                                 gpointer keep, GDestroyNotify keep_free) {
+    FilesSort *sort = g_new0(FilesSort, 1);
+    sort->ref_count = 2;    /* caller + worker */
+    sort->parent = g_strdup(parent);
+    sort->items = items;
+    sort->order.key = key;
+    sort->order.descending = descending;
+    sort->cancellable = g_cancellable_new();
+    sort->done_func = done;
+    sort->data = data;
+    sort->keep = keep;
+    sort->keep_free = keep_free;
+    g_thread_unref(g_thread_new("files-sort", _filesort_worker, sort));
+    return sort;
+}
+
+/* Drops @sort: no callback follows. NULL is ignored. */
+static void filesort_cancel(FilesSort *sort) {
+    if (!sort) return;
+    g_cancellable_cancel(sort->cancellable);
+    _filesort_unref(sort);
+}
+
+#endif /* BLAZENEURO_FILES_FILESORT_H */
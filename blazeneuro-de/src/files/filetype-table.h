@@ -0,0 +1,162 @@
+/* Generated by tools/gen-filetype.py — do not edit. */
+
+#define FILETYPE_BUCKET_SEED 2166136261u
+#define FILETYPE_BUCKETS     64
+#define FILETYPE_TABLE_SIZE  256
+#define FILETYPE_MAX_EXT     8
+
+static const guint32 filetype_disp[FILETYPE_BUCKETS] = {
+    1, 2, 1, 2, 2, 11, 2, 3,
+    2, 1, 2, 6, 2, 2, 3, 1,
+    2, 2, 2, 1, 1, 1, 1, 2,
+    5, 1, 2, 1, 2, 8, 4, 2,
+    2, 1, 1, 2, 5, 2, 2, 5,
+    1, 1, 4, 0, 1, 4, 1, 2,
+    1, 4, 1, 2, 2, 2, 5, 2,
+    1, 4, 2, 1, 8, 0, 3, 3,
+};
+
+static const struct { const char *ext; FileKind kind; } filetype_table[FILETYPE_TABLE_SIZE] = {
+    [0] = { "xcf", FT_KIND_IMAGE },
+    [2] = { "csv", FT_KIND_SPREADSHEET },
+    [4] = { "hh", FT_KIND_CODE },
+    [5] = { "cfg", FT_KIND_TEXT },
+    [6] = { "tsv", FT_KIND_SPREADSHEET },
+    [7] = { "sh", FT_KIND_CODE },
+    [8] = { "mid", FT_KIND_AUDIO },
+    [9] = { "img", FT_KIND_DISK_IMAGE },
+    [12] = { "gif", FT_KIND_IMAGE },
+    [18] = { "m4v", FT_KIND_VIDEO },
+    [19] = { "tiff", FT_KIND_IMAGE },
+    [20] = { "css", FT_KIND_CODE },
+    [24] = { "swift", FT_KIND_CODE },
+    [25] = { "rs", FT_KIND_CODE },
+    [28] = { "jpg", FT_KIND_IMAGE },
+    [29] = { "txz", FT_KIND_ARCHIVE },
+    [32] = { "md", FT_KIND_TEXT },
+    [36] = { "7z", FT_KIND_ARCHIVE },
+    [37] = { "svg", FT_KIND_IMAGE },
+    [38] = { "exe", FT_KIND_EXECUTABLE },
+    [39] = { "flv", FT_KIND_VIDEO },
+    [40] = { "iso", FT_KIND_DISK_IMAGE },
+    [41] = { "doc", FT_KIND_DOCUMENT },
+    [45] = { "kt", FT_KIND_CODE },
+    [46] = { "mov", FT_KIND_VIDEO },
+    [47] = { "zst", FT_KIND_ARCHIVE },
+    [49] = { "epub", FT_KIND_DOCUMENT },
+    [52] = { "flac", FT_KIND_AUDIO },
+    [53] = { "xlsx", FT_KIND_SPREADSHEET },
+    [55] = { "heic", FT_KIND_IMAGE },
+    [56] = { "ico", FT_KIND_IMAGE },
+    [57] = { "mp4", FT_KIND_VIDEO },
+    [58] = { "cpio", FT_KIND_ARCHIVE },
+    [60] = { "odt", FT_KIND_DOCUMENT },
+    [64] = { "cs", FT_KIND_CODE },
+    [66] = { "jpe", FT_KIND_IMAGE },
+    [67] = { "hpp", FT_KIND_CODE },
+    [68] = { "bmp", FT_KIND_IMAGE },
+    [69] = { "patch", FT_KIND_CODE },
+    [71] = { "toml", FT_KIND_CODE },
+    [73] = { "yml", FT_KIND_CODE },
+    [74] = { "wav", FT_KIND_AUDIO },
+    [75] = { "pcf", FT_KIND_FONT },
+    [77] = { "sql", FT_KIND_CODE },
+    [81] = { "wmv", FT_KIND_VIDEO },
+    [82] = { "ogv", FT_KIND_VIDEO },
+    [83] = { "yaml", FT_KIND_CODE },
+    [84] = { "go", FT_KIND_CODE },
+    [87] = { "woff2", FT_KIND_FONT },
+    [88] = { "heif", FT_KIND_IMAGE },
+    [89] = { "pdf", FT_KIND_PDF },
+    [91] = { "pyw", FT_KIND_CODE },
+    [92] = { "json", FT_KIND_CODE },
+    [93] = { "djvu", FT_KIND_DOCUMENT },
+    [95] = { "gz", FT_KIND_ARCHIVE },
+    [97] = { "psd", FT_KIND_IMAGE },
+    [98] = { "oga", FT_KIND_AUDIO },
+    [99] = { "mpeg", FT_KIND_VIDEO },
+    [101] = { "ttf", FT_KIND_FONT },
+    [103] = { "aiff", FT_KIND_AUDIO },
+    [104] = { "log", FT_KIND_TEXT },
+    [108] = { "webp", FT_KIND_IMAGE },
+    [110] = { "py", FT_KIND_CODE },
+    [111] = { "xls", FT_KIND_SPREADSHEET },
+    [112] = { "cc", FT_KIND_CODE },
+    [113] = { "rb", FT_KIND_CODE },
+    [115] = { "rtf", FT_KIND_DOCUMENT },
+    [118] = { "cpp", FT_KIND_CODE },
+    [120] = { "pptx", FT_KIND_PRESENTATION },
+    [123] = { "webm", FT_KIND_VIDEO },
+    [125] = { "png", FT_KIND_IMAGE },
+    [126] = { "php", FT_KIND_CODE },
+    [127] = { "html", FT_KIND_CODE },
+    [129] = { "pm", FT_KIND_CODE },
+    [131] = { "run", FT_KIND_EXECUTABLE },
+    [133] = { "wma", FT_KIND_AUDIO },
+    [134] = { "tgz", FT_KIND_ARCHIVE },
+    [135] = { "tar", FT_KIND_ARCHIVE },
+    [137] = { "htm", FT_KIND_CODE },
+    [138] = { "qcow2", FT_KIND_DISK_IMAGE },
+    [140] = { "lz4", FT_KIND_ARCHIVE },
+    [144] = { "lzma", FT_KIND_ARCHIVE },
+    [145] = { "js", FT_KIND_CODE },
+    [147] = { "vdi", FT_KIND_DISK_IMAGE },
+    [148] = { "otf", FT_KIND_FONT },
+    [149] = { "avif", FT_KIND_IMAGE },
+    [150] = { "mp3", FT_KIND_AUDIO },
+    [151] = { "rst", FT_KIND_TEXT },
+    [152] = { "bash", FT_KIND_CODE },
+    [153] = { "diff", FT_KIND_CODE },
+    [157] = { "appimage", FT_KIND_EXECUTABLE },
+    [160] = { "jpeg", FT_KIND_IMAGE },
+    [162] = { "rpm", FT_KIND_PACKAGE },
+    [164] = { "midi", FT_KIND_AUDIO },
+    [166] = { "3gp", FT_KIND_VIDEO },
+    [167] = { "ppt", FT_KIND_PRESENTATION },
+    [169] = { "ods", FT_KIND_SPREADSHEET },
+    [179] = { "c", FT_KIND_CODE },
+    [182] = { "jsx", FT_KIND_CODE },
+    [183] = { "markdown", FT_KIND_TEXT },
+    [185] = { "opus", FT_KIND_AUDIO },
+    [188] = { "docx", FT_KIND_DOCUMENT },
+    [189] = { "mk", FT_KIND_CODE },
+    [190] = { "bz2", FT_KIND_ARCHIVE },
+    [192] = { "bin", FT_KIND_EXECUTABLE },
+    [193] = { "xz", FT_KIND_ARCHIVE },
+    [194] = { "java", FT_KIND_CODE },
+    [195] = { "avi", FT_KIND_VIDEO },
+    [196] = { "fish", FT_KIND_CODE },
+    [197] = { "scss", FT_KIND_CODE },
+    [199] = { "aac", FT_KIND_AUDIO },
+    [200] = { "key", FT_KIND_PRESENTATION },
+    [201] = { "mjs", FT_KIND_CODE },
+    [203] = { "cxx", FT_KIND_CODE },
+    [204] = { "snap", FT_KIND_PACKAGE },
+    [206] = { "txt", FT_KIND_TEXT },
+    [208] = { "pl", FT_KIND_CODE },
+    [209] = { "ini", FT_KIND_TEXT },
+    [212] = { "ts", FT_KIND_CODE },
+    [216] = { "tsx", FT_KIND_CODE },
+    [217] = { "zip", FT_KIND_ARCHIVE },
+    [218] = { "zsh", FT_KIND_CODE },
+    [220] = { "woff", FT_KIND_FONT },
+    [221] = { "vmdk", FT_KIND_DISK_IMAGE },
+    [222] = { "h", FT_KIND_CODE },
+    [223] = { "tbz2", FT_KIND_ARCHIVE },
+    [228] = { "deb", FT_KIND_PACKAGE },
+    [229] = { "lua", FT_KIND_CODE },
+    [230] = { "svgz", FT_KIND_IMAGE },
+    [231] = { "vala", FT_KIND_CODE },
+    [234] = { "nfo", FT_KIND_TEXT },
+    [236] = { "cmake", FT_KIND_CODE },
+    [238] = { "flatpak", FT_KIND_PACKAGE },
+    [240] = { "ogg", FT_KIND_AUDIO },
+    [241] = { "rar", FT_KIND_ARCHIVE },
+    [242] = { "mpg", FT_KIND_VIDEO },
+    [245] = { "tif", FT_KIND_IMAGE },
+    [246] = { "xml", FT_KIND_CODE },
+    [248] = { "conf", FT_KIND_TEXT },
+    [251] = { "odp", FT_KIND_PRESENTATION },
+    [252] = { "mkv", FT_KIND_VIDEO },
+    [254] = { "m4a", FT_KIND_AUDIO },
+};
@@ -0,0 +1,196 @@
+/*
+ * BlazeNeuro Files — File Type Classifier
+ * Maps a file name to a FileKind and icon without allocating: the
+ * extension is lowercased into a stack buffer and looked up in a perfect
+ * hash table generated ahead of time (tools/gen-filetype.py writes
+ * filetype-table.h).
+ *
+ * Files without a known extension are sniffed: their first bytes are
+ * matched against shared-mime-info magic with g_content_type_guess().
+ * Sniff results are cached by (device, inode, mtime), so revisiting a
+ * folder never reads file headers again. Listing never sniffs
+ * (filetype_classify_name()); only the rows on screen are, later (see
+ * metaload.h). Safe to call from any thread.
+ */
+
+#ifndef BLAZENEURO_FILES_FILETYPE_H
+#define BLAZENEURO_FILES_FILETYPE_H
+
+#include <gio/gio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+typedef enum {
+    FT_KIND_UNKNOWN,        /* not classified yet */
+    FT_KIND_FOLDER,
+    FT_KIND_FILE,           /* binary or unreadable */
+    FT_KIND_TEXT,
+    FT_KIND_CODE,
+    FT_KIND_IMAGE,
+    FT_KIND_AUDIO,
+    FT_KIND_VIDEO,
+    FT_KIND_PDF,
+    FT_KIND_DOCUMENT,
+    FT_KIND_SPREADSHEET,
+    FT_KIND_PRESENTATION,
+    FT_KIND_ARCHIVE,
+    FT_KIND_PACKAGE,
+    FT_KIND_DISK_IMAGE,
+    FT_KIND_EXECUTABLE,
+    FT_KIND_FONT,
+    FT_N_KINDS
+} FileKind;
+
+static const char *const filetype_icons[FT_N_KINDS] = {
+    [FT_KIND_UNKNOWN]      = "text-x-generic",
+    [FT_KIND_FOLDER]       = "folder",
+    [FT_KIND_FILE]         = "application-octet-stream",
+    [FT_KIND_TEXT]         = "text-x-generic",
+    [FT_KIND_CODE]         = "text-x-script",
+    [FT_KIND_IMAGE]        = "image-x-generic",
+    [FT_KIND_AUDIO]        = "audio-x-generic",
+    [FT_KIND_VIDEO]        = "video-x-generic",
+    [FT_KIND_PDF]          = "application-pdf",
+    [FT_KIND_DOCUMENT]     = "x-office-document",
+    [FT_KIND_SPREADSHEET]  = "x-office-spreadsheet",
+    [FT_KIND_PRESENTATION] = "x-office-presentation",
+    [FT_KIND_ARCHIVE]      = "package-x-generic",
+    [FT_KIND_PACKAGE]      = "application-x-deb",
+    [FT_KIND_DISK_IMAGE]   = "application-x-cd-image",
+    [FT_KIND_EXECUTABLE]   = "application-x-executable",
+    [FT_KIND_FONT]         = "font-x-generic",
+};
+
+#include "filetype-table.h"
+
+/* ── Extension lookup ───────────────────────────────────── */
+static inline guint32 _filetype_fnv1a(const char *s, guint32 h) {
+    for (; *s; s++) h = (h ^ (guchar)*s) * 16777619u;
+    return h;
+}
+
+/* FT_KIND_UNKNOWN when @name has no extension in the table */
+static FileKind filetype_lookup(const char *name) {
+    const char *dot = strrchr(name, '.');
+    if (!dot || dot == name || !dot[1]) return FT_KIND_UNKNOWN;
+
+    char ext[FILETYPE_MAX_EXT + 1];
+    size_t len = 0;
+    for (const char *p = dot + 1; *p; p++) {
+        if (len == FILETYPE_MAX_EXT) return FT_KIND_UNKNOWN;
+        ext[len++] = g_ascii_tolower(*p);
+    }
+    ext[len] = '\0';
+
+    guint32 disp = filetype_disp[_filetype_fnv1a(ext, FILETYPE_BUCKET_SEED) % FILETYPE_BUCKETS];
+    guint32 slot = _filetype_fnv1a(ext, disp) & (FILETYPE_TABLE_SIZE - 1);
+    const char *key = filetype_table[slot].ext;
+    return key && strcmp(key, ext) == 0 ? filetype_table[slot].kind : FT_KIND_UNKNOWN;
+}
+
+/* ── Content sniffing ───────────────────────────────────── */
+#define FILETYPE_SNIFF_BYTES   512
+#define FILETYPE_SNIFF_CACHE   65536   /* entries before the cache is reset */
+
+typedef struct {
+    dev_t dev;
+    ino_t ino;
+    gint64 mtime_ns;
+    FileKind kind;
+} SniffEntry;
+
+static GHashTable *_sniff_cache = NULL;     /* SniffEntry* -> itself */
+static GMutex _sniff_lock;
+
+static guint _sniff_hash(gconstpointer p) {
+    const SniffEntry *e = p;
+    return (guint)(e->ino ^ (e->ino >> 32) ^ ((guint64)e->dev << 7));
+}
+
+static gboolean _sniff_equal(gconstpointer a, gconstpointer b) {
+    const SniffEntry *x = a, *y = b;
+    return x->ino == y->ino && x->dev == y->dev;
+}
+
+static FileKind _filetype_kind_for_mime(const char *type) {
+    static const char *const archives[] = {
+        "application/zip", "application/gzip", "application/x-tar",
+        "application/x-xz", "application/zstd", "application/x-bzip2",
+        "application/x-7z-compressed", "application/vnd.rar", NULL
+    };
+
+    if (g_str_has_prefix(type, "image/")) return FT_KIND_IMAGE;
+    if (g_str_has_prefix(type, "audio/")) return FT_KIND_AUDIO;
+    if (g_str_has_prefix(type, "video/")) return FT_KIND_VIDEO;
+    if (g_content_type_is_a(type, "application/pdf")) return FT_KIND_PDF;
+    if (g_content_type_is_a(type, "application/x-executable") ||
+        g_content_type_is_a(type, "application/x-sharedlib"))
+        return FT_KIND_EXECUTABLE;
+    for (int i = 0; archives[i]; i++)
+        if (g_content_type_is_a(type, archives[i])) return FT_KIND_ARCHIVE;
+    if (g_content_type_is_a(type, "text/plain"))
+        return (strstr(type, "script") || g_str_has_prefix(type, "text/x-"))
+               ? FT_KIND_CODE : FT_KIND_TEXT;
+    return FT_KIND_FILE;
+}
+
+/* Classify a regular file by its first bytes; FT_KIND_UNKNOWN if it is
+ * not a regular file. @name is relative to the directory fd @dfd. */
+static FileKind filetype_sniff(int dfd, const char *name) {
+    struct stat st;
+    if (fstatat(dfd, name, &st, 0) != 0 || !S_ISREG(st.st_mode))
+        return FT_KIND_UNKNOWN;
+    if (st.st_size == 0) return FT_KIND_TEXT;
+
+    SniffEntry key = { st.st_dev, st.st_ino,
+                       (gint64)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec,
+                       FT_KIND_UNKNOWN };
+
+    g_mutex_lock(&_sniff_lock);
+    if (!_sniff_cache)
+        _sniff_cache = g_hash_table_new_full(_sniff_hash, _sniff_equal, g_free, NULL);
+    SniffEntry *hit = g_hash_table_lookup(_sniff_cache, &key);
+    FileKind cached = (hit && hit->mtime_ns == key.mtime_ns) ? hit->kind : FT_KIND_UNKNOWN;
+    g_mutex_unlock(&_sniff_lock);
+    if (cached != FT_KIND_UNKNOWN) return cached;
+
+    /* O_NOATIME is refused for files we do not own */
+    int fd = openat(dfd, name, O_RDONLY | O_CLOEXEC | O_NOATIME);
+    if (fd < 0 && errno == EPERM) fd = openat(dfd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return FT_KIND_FILE;
+
+    guchar buf[FILETYPE_SNIFF_BYTES];
+    ssize_t n = read(fd, buf, sizeof(buf));
+    close(fd);
+    if (n <= 0) return FT_KIND_FILE;
+
+    gchar *type = g_content_type_guess(NULL, buf, (gsize)n, NULL);
+    key.kind = _filetype_kind_for_mime(type);
+    g_free(type);
+
+    g_mutex_lock(&_sniff_lock);
+    if (g_hash_table_size(_sniff_cache) >= FILETYPE_SNIFF_CACHE)
+        g_hash_table_remove_all(_sniff_cache);
+    SniffEntry *entry = g_memdup2(&key, sizeof(key));
+    g_hash_table_replace(_sniff_cache, entry, entry);
+    g_mutex_unlock(&_sniff_lock);
+    return key.kind;
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+/* From the name alone; FT_KIND_UNKNOWN when only the contents can tell */
+static FileKind filetype_classify_name(const char *name, gboolean is_dir) {
+    return is_dir ? FT_KIND_FOLDER : filetype_lookup(name);
+}
+
+static FileKind filetype_classify(int dfd, const char *name, gboolean is_dir) {
+    if (is_dir) return FT_KIND_FOLDER;
+    FileKind kind = filetype_lookup(name);
+    if (kind == FT_KIND_UNKNOWN) kind = filetype_sniff(dfd, name);
+    return kind == FT_KIND_UNKNOWN ? FT_KIND_FILE : kind;
+}
+
+#endif /* BLAZENEURO_FILES_FILETYPE_H */
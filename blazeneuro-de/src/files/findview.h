@@ -0,0 +1,285 @@
+/*
+ * BlazeNeuro Files — Find in Files
+ * A window searching the files below a folder for some text (see
+ * textfind.h) as it is typed. Matches arrive while the search runs,
+ * grouped by file, each line shown with the match in bold. Activating
+ * a line opens its file.
+ *
+ * Usage:
+ *   findview_open(GTK_WINDOW(main_window), path, initial_text, show_hidden, open_file);
+ */
+
+#ifndef BLAZENEURO_FILES_FINDVIEW_H
+#define BLAZENEURO_FILES_FINDVIEW_H
+
+#include <gtk/gtk.h>
+
+#include "textfind.h"
+
+#define FINDVIEW_TICK_MSEC  200
+#define FINDVIEW_EXPAND     50      /* files shown open */
+
+enum { FIND_COL_MARKUP, FIND_COL_PATH, FIND_COL_COUNT, FIND_N_COLS };
+
+typedef void (*FindViewOpenFunc)(const char *path);
+
+typedef struct {
+    GtkWidget *window;
+    GtkWidget *entry;
+    GtkWidget *match_case;
+    GtkWidget *regex;
+    GtkWidget *tree;
+    GtkWidget *status;
+    GtkWidget *spinner;
+    GtkTreeStore *store;
+    GHashTable *rows;           /* relative path -> GtkTreeIter* of its file row */
+    gchar *path;
+    gboolean show_hidden;
+    FindViewOpenFunc open_func;
+    TextFind *find;
+    guint timer;
+    guint n_files;              /* with a match */
+} FindView;
+
+/* ── Results ────────────────────────────────────────────── */
+static void _findview_set_title(FindView *v, GtkTreeIter *file, const char *rel, guint count) {
+    gchar *display = g_filename_display_name(rel);
+    gchar *markup = g_markup_printf_escaped("<b>%s</b>  <small>%u %s</small>", display, count,
+                                            count == 1 ? "line" : "lines");
+    gtk_tree_store_set(v->store, file, FIND_COL_MARKUP, markup, FIND_COL_COUNT, count, -1);
+    g_free(markup);
+    g_free(display);
+}
+
+static GtkTreeIter *_findview_file_row(FindView *v, const char *rel) {
+    GtkTreeIter *file = g_hash_table_lookup(v->rows, rel);
+    if (file) return file;
+    file = g_new(GtkTreeIter, 1);
+    gchar *path = g_build_filename(v->path, rel, NULL);
+    gtk_tree_store_insert_with_values(v->store, file, NULL, -1, FIND_COL_PATH, path, -1);
+    g_free(path);
+    g_hash_table_insert(v->rows, g_strdup(rel), file);
+    v->n_files++;
+    return file;
+}
+
+static gchar *_findview_line_markup(const TextHit *hit) {
+    gchar *before = g_markup_escape_text(hit->preview, hit->match_start);
+    gchar *match = g_markup_escape_text(hit->preview + hit->match_start, hit->match_len);
+    gchar *after = g_markup_escape_text(hit->preview + hit->match_start + hit->match_len, -1);
+    gchar *markup = g_strdup_printf("<span alpha=\"60%%\">%u</span>  %s<b>%s</b>%s",
+                                    hit->line, before, match, after);
+    g_free(after);
+    g_free(match);
+    g_free(before);
+    return markup;
+}
+
+static void _findview_on_batch(const TextHit *hits, guint n, gpointer data) {
+    FindView *v = data;
+    for (guint i = 0; i < n; i++) {
+        const TextHit *hit = &hits[i];
+        guint before = v->n_files;
+        GtkTreeIter *file = _findview_file_row(v, hit->path);
+        gboolean is_new = v->n_files != before;
+
+        gchar *markup = _findview_line_markup(hit);
+        gchar *path = NULL;
+        gtk_tree_model_get(GTK_TREE_MODEL(v->store), file, FIND_COL_PATH, &path, -1);
+        gtk_tree_store_insert_with_values(v->store, NULL, file, -1, FIND_COL_MARKUP, markup,
+                                          FIND_COL_PATH, path, -1);
+        g_free(path);
+        g_free(markup);
+
+        guint count = 0;
+        gtk_tree_model_get(GTK_TREE_MODEL(v->store), file, FIND_COL_COUNT, &count, -1);
+        _findview_set_title(v, file, hit->path, count + 1);
+        if (is_new && v->n_files <= FINDVIEW_EXPAND) {
+            GtkTreePath *tree_path = gtk_tree_model_get_path(GTK_TREE_MODEL(v->store), file);
+            gtk_tree_view_expand_row(GTK_TREE_VIEW(v->tree), tree_path, FALSE);
+            gtk_tree_path_free(tree_path);
+        }
+    }
+}
+
+static void on_findview_activated(GtkTreeView *tree, GtkTreePath *path, GtkTreeViewColumn *col,
+                                  gpointer data) {
+    (void)col;
+    FindView *v = data;
+    if (gtk_tree_path_get_depth(path) == 1) {
+        if (gtk_tree_view_row_expanded(tree, path)) gtk_tree_view_collapse_row(tree, path);
+        else gtk_tree_view_expand_row(tree, path, FALSE);
+        return;
+    }
+    GtkTreeIter iter;
+    gchar *file = NULL;
+    if (gtk_tree_model_get_iter(GTK_TREE_MODEL(v->store), &iter, path))
+        gtk_tree_model_get(GTK_TREE_MODEL(v->store), &iter, FIND_COL_PATH, &file, -1);
+    if (file && v->open_func) v->open_func(file);
+    g_free(file);
+}
+
+/* ── Searching ──────────────────────────────────────────── */
+static void _findview_stop(FindView *v) {
+    textfind_cancel(v->find);
+    v->find = NULL;
+    if (v->timer) g_source_remove(v->timer);
+    v->timer = 0;
+    gtk_spinner_stop(GTK_SPINNER(v->spinner));
+    gtk_widget_hide(v->spinner);
+}
+
+static gboolean _findview_tick(gpointer data) {
+    FindView *v = data;
+    TextFindProgress p;
+    textfind_progress(v->find, &p);
+    gchar *size = g_format_size(p.bytes);
+    gchar *text = g_strdup_printf("%u lines in %u files — searched %u files, %s",
+                                  p.hits, v->n_files, p.files, size);
+    gtk_label_set_text(GTK_LABEL(v->status), text);
+    g_free(text);
+    g_free(size);
+    return G_SOURCE_CONTINUE;
+}
+
+static void _findview_on_done(gboolean truncated, gpointer data) {
+    FindView *v = data;
+    TextFindProgress p;
+    textfind_progress(v->find, &p);
+    _findview_stop(v);
+
+    gchar *text;
+    if (truncated)
+        text = g_strdup_printf("Stopped at the first %u lines, in %u files — try more precise text",
+                               p.hits, v->n_files);
+    else if (p.hits == 0)
+        text = g_strdup_printf("No matches in %u files", p.files);
+    else
+        text = g_strdup_printf("%u lines in %u files — searched %u files", p.hits, v->n_files,
+                               p.files);
+    gtk_label_set_text(GTK_LABEL(v->status), text);
+    g_free(text);
+    if (p.skipped > 0) {
+        gchar *tip = g_strdup_printf("%u files were left out: binary, larger than %d MB, "
+                                     "or unreadable", p.skipped, TEXTFIND_MAX_FILE >> 20);
+        gtk_widget_set_tooltip_text(v->status, tip);
+        g_free(tip);
+    }
+}
+
+static void _findview_search(FindView *v) {
+    _findview_stop(v);
+    gtk_tree_store_clear(v->store);
+    g_hash_table_remove_all(v->rows);
+    v->n_files = 0;
+    gtk_widget_set_tooltip_text(v->status, NULL);
+
+    const char *text = gtk_entry_get_text(GTK_ENTRY(v->entry));
+    if (!text[0]) {
+        gtk_label_set_text(GTK_LABEL(v->status), "Type the text to look for");
+        return;
+    }
+    TextFindFlags flags = 0;
+    if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(v->match_case))) flags |= TEXTFIND_MATCH_CASE;
+    if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(v->regex))) flags |= TEXTFIND_REGEX;
+
+    GError *error = NULL;
+    v->find = textfind_start(v->path, text, flags, v->show_hidden, _findview_on_batch,
+                             _findview_on_done, v, &error);
+    if (!v->find) {
+        gtk_label_set_text(GTK_LABEL(v->status), error->message);
+        g_error_free(error);
+        return;
+    }
+    gtk_widget_show(v->spinner);
+    gtk_spinner_start(GTK_SPINNER(v->spinner));
+    gtk_label_set_text(GTK_LABEL(v->status), "Searching…");
+    v->timer = g_timeout_add(FINDVIEW_TICK_MSEC, _findview_tick, v);
+}
+
+static void on_findview_changed(GtkWidget *widget, gpointer data) {
+    (void)widget;
+    _findview_search(data);
+}
+
+static void on_findview_destroy(GtkWidget *widget, gpointer data) {
+    (void)widget;
+    FindView *v = data;
+    _findview_stop(v);
+    g_signal_handlers_disconnect_by_data(v->tree, v);
+    g_hash_table_destroy(v->rows);
+    g_object_unref(v->store);
+    g_free(v->path);
+    g_free(v);
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+/* Searches @path for @text (may be NULL) straight away */
+static void findview_open(GtkWindow *parent, const char *path, const char *text,
+                          gboolean show_hidden, FindViewOpenFunc open_func) {
+    FindView *v = g_new0(FindView, 1);
+    v->path = g_strdup(path);
+    v->show_hidden = show_hidden;
+    v->open_func = open_func;
+    v->store = gtk_tree_store_new(FIND_N_COLS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_UINT);
+    v->rows = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+
+    v->window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    gtk_window_set_transient_for(GTK_WINDOW(v->window), parent);
+    gtk_window_set_application(GTK_WINDOW(v->window), gtk_window_get_application(parent));
+    gtk_window_set_default_size(GTK_WINDOW(v->window), 820, 600);
+    gchar *name = g_path_get_basename(path);
+    gchar *title = g_strdup_printf("Find in Files — %s", name);
+    gtk_window_set_title(GTK_WINDOW(v->window), title);
+    g_free(title);
+    g_free(name);
+    g_signal_connect(v->window, "destroy", G_CALLBACK(on_findview_destroy), v);
+
+    GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+    GtkWidget *header = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    gtk_container_set_border_width(GTK_CONTAINER(header), 6);
+    v->entry = gtk_search_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(v->entry), "Text in files");
+    if (text) gtk_entry_set_text(GTK_ENTRY(v->entry), text);
+    v->match_case = gtk_check_button_new_with_label("Match case");
+    v->regex = gtk_check_button_new_with_label("Regular expression");
+    g_signal_connect(v->entry, "search-changed", G_CALLBACK(on_findview_changed), v);
+    g_signal_connect(v->match_case, "toggled", G_CALLBACK(on_findview_changed), v);
+    g_signal_connect(v->regex, "toggled", G_CALLBACK(on_findview_changed), v);
+    gtk_box_pack_start(GTK_BOX(header), v->entry, TRUE, TRUE, 0);
+    gtk_box_pack_start(GTK_BOX(header), v->match_case, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(header), v->regex, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(vbox), header, FALSE, FALSE, 0);
+
+    GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll),
+                                   GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+    v->tree = gtk_tree_view_new_with_model(GTK_TREE_MODEL(v->store));
+    gtk_tree_view_set_headers_visible(GTK_TREE_VIEW(v->tree), FALSE);
+    GtkCellRenderer *cell = gtk_cell_renderer_text_new();
+    g_object_set(cell, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+    GtkTreeViewColumn *col = gtk_tree_view_column_new_with_attributes("Match", cell, "markup",
+                                                                       FIND_COL_MARKUP, NULL);
+    gtk_tree_view_column_set_expand(col, TRUE);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(v->tree), col);
+    g_signal_connect(v->tree, "row-activated", G_CALLBACK(on_findview_activated), v);
+    gtk_container_add(GTK_CONTAINER(scroll), v->tree);
+    gtk_box_pack_start(GTK_BOX(vbox), scroll, TRUE, TRUE, 0);
+
+    GtkWidget *footer = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    gtk_container_set_border_width(GTK_CONTAINER(footer), 6);
+    v->spinner = gtk_spinner_new();
+    v->status = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(v->status), 0);
+    gtk_label_set_ellipsize(GTK_LABEL(v->status), PANGO_ELLIPSIZE_END);
+    gtk_box_pack_start(GTK_BOX(footer), v->spinner, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(footer), v->status, TRUE, TRUE, 0);
+    gtk_box_pack_start(GTK_BOX(vbox), footer, FALSE, FALSE, 0);
+
+    gtk_container_add(GTK_CONTAINER(v->window), vbox);
+    gtk_widget_show_all(v->window);
+    gtk_widget_grab_focus(v->entry);
+    _findview_search(v);
+}
+
+#endif /* BLAZENEURO_FILES_FINDVIEW_H */
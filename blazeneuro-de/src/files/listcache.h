@@ -0,0 +1,100 @@
+/*
+ * BlazeNeuro Files — Listing Cache
+ * Keeps the listings of recently left folders, so Back, Forward or a
+ * second visit shows the folder without reading it again. An entry is
+ * only reused while the folder's mtime still matches the listing; any
+ * entry added, removed or renamed since bumps it.
+ *
+ * Entries are evicted least recently used first once their total size
+ * passes the ceiling: 64 MB, or BLAZENEURO_FILES_CACHE_MB=<n> (0 turns
+ * the cache off).
+ */
+
+#ifndef BLAZENEURO_FILES_LISTCACHE_H
+#define BLAZENEURO_FILES_LISTCACHE_H
+
+#include <glib.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include "filesmodel.h"
+
+#define LISTCACHE_DEFAULT_MB  64
+
+typedef struct {
+    FilesListing *listing;
+    gsize bytes;
+} ListCacheEntry;
+
+static struct {
+    GQueue lru;             /* ListCacheEntry*, most recent first */
+    GHashTable *index;      /* parent path -> GList* link in lru */
+    gsize bytes;
+    gsize ceiling;
+} listcache;
+
+/* Folder mtime in ns, or -1 if it cannot be read */
+static gint64 listcache_dir_mtime(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) return -1;
+    return (gint64)st.st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) + st.st_mtim.tv_nsec;
+}
+
+static void listcache_init(void) {
+    const char *env = g_getenv("BLAZENEURO_FILES_CACHE_MB");
+    gsize mb = env ? (gsize)strtoul(env, NULL, 10) : LISTCACHE_DEFAULT_MB;
+    listcache.ceiling = mb << 20;
+    listcache.index = g_hash_table_new(g_str_hash, g_str_equal);
+    g_queue_init(&listcache.lru);
+}
+
+static void _listcache_drop(GList *link) {
+    ListCacheEntry *ce = link->data;
+    listcache.bytes -= ce->bytes;
+    g_hash_table_remove(listcache.index, ce->listing->parent);
+    g_queue_delete_link(&listcache.lru, link);
+    files_listing_unref(ce->listing);
+    g_free(ce);
+}
+
+/* Removes and returns the cached listing of @path if the folder has not
+ * changed since; NULL otherwise. The caller owns the result. */
+static FilesListing *listcache_take(const char *path) {
+    GList *link = g_hash_table_lookup(listcache.index, path);
+    if (!link) return NULL;
+
+    ListCacheEntry *ce = link->data;
+    FilesListing *listing = files_listing_ref(ce->listing);
+    _listcache_drop(link);
+    if (listing->dir_mtime == listcache_dir_mtime(path)) return listing;
+    files_listing_unref(listing);
+    return NULL;
+}
+
+/* Is a listing of @path kept? It may still turn out stale when taken;
+ * answered without touching the disk */
+static gboolean listcache_has(const char *path) {
+    return g_hash_table_contains(listcache.index, path);
+}
+
+/* Keeps a reference to a complete @listing */
+static void listcache_store(FilesListing *listing) {
+    if (!listing->complete || listing->dir_mtime < 0) return;
+    GList *old = g_hash_table_lookup(listcache.index, listing->parent);
+    if (old) _listcache_drop(old);
+
+    gsize bytes = files_listing_bytes(listing);
+    if (bytes > listcache.ceiling) return;
+
+    ListCacheEntry *ce = g_new(ListCacheEntry, 1);
+    ce->listing = files_listing_ref(listing);
+    ce->bytes = bytes;
+    g_queue_push_head(&listcache.lru, ce);
+    g_hash_table_insert(listcache.index, listing->parent, listcache.lru.head);
+    listcache.bytes += bytes;
+
+    while (listcache.bytes > listcache.ceiling)
+        _listcache_drop(listcache.lru.tail);
+}
+
+#endif /* BLAZENEURO_FILES_LISTCACHE_H */
@@ -0,0 +1,233 @@
+/*
+ * BlazeNeuro Files — Details Loader
+ * Reads what the details view shows beyond a name (size, date,
+ * permissions and type) for the rows on screen, on a worker thread. A
+ * folder still opens at listing speed whatever its size (see dirload.h),
+ * and the columns fill in as rows scroll into view.
+ *
+ * A request is a screenful or so of names, read relative to the
+ * folder's fd and delivered in small batches, first rows first. The type
+ * comes from the name, or from the first bytes when the name says
+ * nothing; its description is looked up once per type and request.
+ * Rows the listing could not give a kind (FT_KIND_UNKNOWN) are sniffed
+ * here too, so the icon view asks for them as well.
+ * Archive members have nothing on disk to read (@read_disk FALSE): only
+ * their names are used.
+ *
+ * Usage:
+ *   MetaLoad *load = metaload_start(parent, items, TRUE, on_batch, on_done, data);
+ *   ...
+ *   metaload_cancel(load);   // scrolled away: no further callbacks
+ */
+
+#ifndef BLAZENEURO_FILES_METALOAD_H
+#define BLAZENEURO_FILES_METALOAD_H
+
+#include <gio/gio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "filesort.h"
+#include "filetype.h"
+
+#define METALOAD_BATCH  48      /* rows per delivery */
+#define METALOAD_SNIFF  4096    /* bytes read when the name gives no type */
+
+typedef struct {
+    gchar *name;            /* relative to the folder */
+    guint32 rec;
+    gboolean is_dir;        /* as listed */
+    FileKind kind;          /* as listed; out: sniffed if that was FT_KIND_UNKNOWN */
+    gint64 size;            /* out: FILES_SORT_UNKNOWN if it could not be read */
+    gint64 mtime;           /* out: ns */
+    guint32 mode;           /* out: st_mode, 0 if not known */
+    const char *type;       /* out: interned description */
+} MetaItem;
+
+/* Both run on the main thread and never after metaload_cancel() */
+typedef void (*MetaLoadBatchFunc)(const MetaItem *items, guint n, gpointer data);
+typedef void (*MetaLoadDoneFunc)(gpointer data);
+
+typedef struct {
+    gint ref_count;
+    gchar *parent;
+    GArray *items;          /* MetaItem; ranges are handed over as they are read */
+    gboolean read_disk;
+    GCancellable *cancellable;
+    MetaLoadBatchFunc batch_func;
+    MetaLoadDoneFunc done_func;
+    gpointer data;
+} MetaLoad;
+
+typedef struct {
+    MetaLoad *load;
+    guint from, to;         /* items read */
+    gboolean last;
+} MetaLoadBatch;
+
+static MetaLoad *_metaload_ref(MetaLoad *load) {
+    g_atomic_int_inc(&load->ref_count);
+    return load;
+}
+
+static void _metaload_unref(MetaLoad *load) {
+    if (!g_atomic_int_dec_and_test(&load->ref_count)) return;
+    for (guint i = 0; i < load->items->len; i++)
+        g_free(g_array_index(load->items, MetaItem, i).name);
+    g_array_free(load->items, TRUE);
+    g_object_unref(load->cancellable);
+    g_free(load->parent);
+    g_free(load);
+}
+
+/* ── Main-thread delivery ──────────────────────────────── */
+static void _metaload_batch_free(gpointer data) {
+    MetaLoadBatch *batch = data;
+    _metaload_unref(batch->load);
+    g_free(batch);
+}
+
+static gboolean _metaload_deliver(gpointer data) {
+    MetaLoadBatch *batch = data;
+    MetaLoad *load = batch->load;
+    if (g_cancellable_is_cancelled(load->cancellable)) return G_SOURCE_REMOVE;
+
+    if (batch->to > batch->from)
+        load->batch_func(&g_array_index(load->items, MetaItem, batch->from),
+                         batch->to - batch->from, load->data);
+    if (batch->last && load->done_func) load->done_func(load->data);
+    return G_SOURCE_REMOVE;
+}
+
+static void _metaload_post(MetaLoad *load, guint from, guint to, gboolean last) {
+    MetaLoadBatch *batch = g_new(MetaLoadBatch, 1);
+    batch->load = _metaload_ref(load);
+    batch->from = from;
+    batch->to = to;
+    batch->last = last;
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, _metaload_deliver, batch, _metaload_batch_free);
+}
+
+/* ── Worker ─────────────────────────────────────────────── */
+static const char *_metaload_special_type(mode_t mode) {
+    if (S_ISDIR(mode)) return "inode/directory";
+    if (S_ISLNK(mode)) return "inode/symlink";     /* dangling: lstat only */
+    if (S_ISCHR(mode)) return "inode/chardevice";
+    if (S_ISBLK(mode)) return "inode/blockdevice";
+    if (S_ISFIFO(mode)) return "inode/fifo";
+    if (S_ISSOCK(mode)) return "inode/socket";
+    return NULL;
+}
+
+/* Content type of a regular file: by name, then by its first bytes */
+static gchar *_metaload_guess(int dfd, const MetaItem *it) {
+    const char *slash = strrchr(it->name, '/');
+    const char *base = slash ? slash + 1 : it->name;
+    gboolean uncertain = FALSE;
+    gchar *type = g_content_type_guess(base, NULL, 0, &uncertain);
+    if (!uncertain || dfd < 0 || it->size <= 0) return type;
+
+    int fd = openat(dfd, it->name, O_RDONLY | O_NOATIME | O_CLOEXEC);
+    if (fd < 0 && errno == EPERM) fd = openat(dfd, it->name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return type;
+    guchar buf[METALOAD_SNIFF];
+    ssize_t n = read(fd, buf, sizeof(buf));
+    close(fd);
+    if (n <= 0) return type;
+    g_free(type);
+    return g_content_type_guess(base, buf, (gsize)n, NULL);
+}
+
+/* Description of @type, through @seen (type -> interned description) */
+static const char *_metaload_describe(GHashTable *seen, gchar *type) {
+    const char *desc = g_hash_table_lookup(seen, type);
+    if (desc) {
+        g_free(type);
+        return desc;
+    }
+    gchar *text = g_content_type_get_description(type);
+    desc = g_intern_string(text);
+    g_free(text);
+    g_hash_table_insert(seen, type, (gpointer)desc);
+    return desc;
+}
+
+/* Links report their target, as the sort does; a dangling one itself */
+static void _metaload_read(int dfd, MetaItem *it, GHashTable *seen) {
+    struct stat st;
+    gboolean ok = dfd >= 0 && (fstatat(dfd, it->name, &st, AT_NO_AUTOMOUNT) == 0 ||
+                               fstatat(dfd, it->name, &st, AT_SYMLINK_NOFOLLOW) == 0);
+    if (ok) {
+        it->size = st.st_size;
+        it->mtime = (gint64)st.st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) +
+                    st.st_mtim.tv_nsec;
+        it->mode = st.st_mode;
+    }
+
+    if (it->kind == FT_KIND_UNKNOWN)
+        it->kind = ok && S_ISREG(st.st_mode) ? filetype_classify(dfd, it->name, FALSE)
+                                              : FT_KIND_FILE;
+
+    const char *special = _metaload_special_type(ok ? st.st_mode : (it->is_dir ? S_IFDIR : 0));
+    gchar *type = special ? g_strdup(special) : _metaload_guess(ok ? dfd : -1, it);
+    it->type = _metaload_describe(seen, type);
+}
+
+static gpointer _metaload_worker(gpointer data) {
+    MetaLoad *load = data;
+    int dfd = load->read_disk ? open(load->parent, O_RDONLY | O_DIRECTORY | O_CLOEXEC) : -1;
+    GHashTable *seen = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    guint from = 0, n = load->items->len;
+    for (guint i = 0; i < n && !g_cancellable_is_cancelled(load->cancellable); i++) {
+        _metaload_read(dfd, &g_array_index(load->items, MetaItem, i), seen);
+        if (i + 1 - from == METALOAD_BATCH && i + 1 < n) {
+            _metaload_post(load, from, i + 1, FALSE);
+            from = i + 1;
+        }
+    }
+    if (!g_cancellable_is_cancelled(load->cancellable)) _metaload_post(load, from, n, TRUE);
+
+    g_hash_table_destroy(seen);
+    if (dfd >= 0) close(dfd);
+    _metaload_unref(load);
+    return NULL;
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+/* Reads @items (MetaItem with name, rec, is_dir and kind set; taken), in
+ * order, relative to @parent */
+static MetaLoad *metaload_start(const char *parent, GArray *items, gboolean read_disk,
+                                MetaLoadBatchFunc batch_func, MetaLoadDoneFunc done_func,
+                                gpointer data) {
+    MetaLoad *load = g_new0(MetaLoad, 1);
+    load->ref_count = 2;    /* caller + worker */
+    load->parent = g_strdup(parent);
+    load->items = items;
+    load->read_disk = read_disk;
+    load->cancellable = g_cancellable_new();
+    load->batch_func = batch_func;
+    load->done_func = done_func;
+    load->data = data;
+    for (guint i = 0; i < items->len; i++) {
+        MetaItem *it = &g_array_index(items, MetaItem, i);
+        it->size = FILES_SORT_UNKNOWN;
+        it->mtime = 0;
+        it->mode = 0;
+        it->type = NULL;
+    }
+    g_thread_unref(g_thread_new("files-details", _metaload_worker, load));
+    return load;
+}
+
+/* Drops @load: no callback follows. NULL is ignored. */
+static void metaload_cancel(MetaLoad *load) {
+    if (!load) return;
+    g_cancellable_cancel(load->cancellable);
+    _metaload_unref(load);
+}
+
+#endif /* BLAZENEURO_FILES_METALOAD_H */
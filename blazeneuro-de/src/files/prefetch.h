@@ -0,0 +1,151 @@
+/*
+ * BlazeNeuro Files — Hover Prefetch
+ * When the pointer rests on a folder, or on a sidebar place, for
+ * PREFETCH_DWELL_MSEC, the folder is read in the background into the
+ * listing cache (listcache.h), so clicking it shows the whole folder at
+ * once instead of starting a cold read. The first few previews it will
+ * show are queued too, behind everything asked for on screen.
+ *
+ * The work is kept on a budget: one folder at a time, and a new dwell
+ * replaces it; folders over PREFETCH_MAX_ENTRIES or taking longer than
+ * PREFETCH_MAX_MSEC are dropped and not tried again. A dropped read
+ * that is stuck in the kernel stays stuck on its thread, so Files does
+ * not hover-read network shares at all (volumes_on_network()); any
+ * other folder costs one stuck read at most. Nothing is done when the
+ * listing cache is off, or for a folder it still holds.
+ *
+ * Usage:
+ *   prefetch_hover(path);   // pointer now on @path; NULL: on no folder
+ *   prefetch_stop();        // navigating or closing: drop the read
+ */
+
+#ifndef BLAZENEURO_FILES_PREFETCH_H
+#define BLAZENEURO_FILES_PREFETCH_H
+
+#include <glib.h>
+#include <string.h>
+
+#include "dirload.h"
+#include "filesmodel.h"
+#include "listcache.h"
+#include "thumbs.h"
+
+#define PREFETCH_DWELL_MSEC   300
+#define PREFETCH_MAX_MSEC     2000
+#define PREFETCH_MAX_ENTRIES  50000
+#define PREFETCH_THUMBS       16
+
+static struct {
+    gchar *hovered;         /* waiting out the dwell */
+    guint dwell_source;
+    DirLoad *load;          /* NULL when idle */
+    FilesListing *listing;  /* being read by load */
+    guint budget_source;
+    GHashTable *refused;    /* paths that went over budget */
+} prefetch;
+
+static void _prefetch_drop(void) {
+    if (prefetch.budget_source) g_source_remove(prefetch.budget_source);
+    prefetch.budget_source = 0;
+    dirload_cancel(prefetch.load);
+    prefetch.load = NULL;
+    files_listing_unref(prefetch.listing);
+    prefetch.listing = NULL;
+}
+
+static void _prefetch_refuse(void) {
+    g_hash_table_add(prefetch.refused, g_strdup(prefetch.listing->parent));
+    _prefetch_drop();
+}
+
+static gint _prefetch_by_key(gconstpointer a, gconstpointer b) {
+    const FilesRecord *ra = *(FilesRecord *const *)a, *rb = *(FilesRecord *const *)b;
+    return strcmp(ra->key, rb->key);
+}
+
+/* Queues the previews that come first in name order: the ones on the
+ * first screen of a folder sorted by name */
+static void _prefetch_thumbs(FilesListing *l) {
+    GPtrArray *recs = g_ptr_array_new();
+    for (guint i = 0; i < l->records->len; i++) {
+        FilesRecord *r = &g_array_index(l->records, FilesRecord, i);
+        if (thumbs_supported(r->kind) && !(r->flags & FILES_REC_HIDDEN))
+            g_ptr_array_add(recs, r);
+    }
+    g_ptr_array_sort(recs, _prefetch_by_key);
+    for (guint i = 0; i < recs->len && i < PREFETCH_THUMBS; i++) {
+        FilesRecord *r = recs->pdata[i];
+        gchar *full = g_build_filename(l->parent, r->name, NULL);
+        thumbs_prefetch(full, r->kind);
+        g_free(full);
+    }
+    g_ptr_array_free(recs, TRUE);
+}
+
+static void _prefetch_batch(const DirEntry *entries, guint n, gpointer data) {
+    (void)data;
+    if (prefetch.listing->records->len + n > PREFETCH_MAX_ENTRIES) {
+        _prefetch_refuse();
+        return;
+    }
+    files_listing_append(prefetch.listing, entries, n);
+}
+
+static void _prefetch_done(gboolean ok, gpointer data) {
+    (void)data;
+    FilesListing *l = files_listing_ref(prefetch.listing);
+    l->dir_mtime = prefetch.load->dir_mtime;
+    l->complete = ok;
+    _prefetch_drop();
+
+    if (ok && l->dir_mtime >= 0) {
+        listcache_store(l);
+        _prefetch_thumbs(l);
+    }
+    files_listing_unref(l);
+}
+
+static gboolean _prefetch_over_budget(gpointer data) {
+    (void)data;
+    prefetch.budget_source = 0;
+    _prefetch_refuse();
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean _prefetch_dwelt(gpointer data) {
+    (void)data;
+    prefetch.dwell_source = 0;
+    _prefetch_drop();
+    thumbs_cancel_prefetch();
+
+    /* Hidden entries are always listed, as for a visit */
+    prefetch.listing = files_listing_new(prefetch.hovered);
+    prefetch.load = dirload_start(prefetch.hovered, TRUE, _prefetch_batch, _prefetch_done, NULL);
+    prefetch.budget_source = g_timeout_add(PREFETCH_MAX_MSEC, _prefetch_over_budget, NULL);
+    return G_SOURCE_REMOVE;
+}
+
+/* The pointer now rests on the folder @path, or on none when NULL */
+static void prefetch_hover(const char *path) {
+    if (g_strcmp0(path, prefetch.hovered) == 0) return;
+    if (prefetch.dwell_source) g_source_remove(prefetch.dwell_source);
+    prefetch.dwell_source = 0;
+    g_free(prefetch.hovered);
+    prefetch.hovered = g_strdup(path);
+    if (!path || listcache.ceiling == 0) return;
+
+    if (!prefetch.refused)
+        prefetch.refused = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    if (g_hash_table_contains(prefetch.refused, path) || listcache_has(path)) return;
+    if (prefetch.listing && strcmp(prefetch.listing->parent, path) == 0) return;
+    prefetch.dwell_source = g_timeout_add(PREFETCH_DWELL_MSEC, _prefetch_dwelt, NULL);
+}
+
+/* Drops a pending dwell and a read in progress. Previews already queued
+ * are kept: they are likely for the folder being opened. */
+static void prefetch_stop(void) {
+    prefetch_hover(NULL);
+    _prefetch_drop();
+}
+
+#endif /* BLAZENEURO_FILES_PREFETCH_H */
@@ -0,0 +1,575 @@
+/*
+ * BlazeNeuro Files — Text Search
+ * Finds the lines holding some text in the files below a folder and
+ * streams them, with a preview of each line, back to the main loop.
+ *
+ * Folders are listed and files searched on the search walker's pool of
+ * threads (WalkPool, walker.h). A folder's files are queued after its
+ * subfolders, and each thread takes its newest work first, so files are
+ * searched before the walk goes deeper and the queues stay about one
+ * folder deep however large the tree. Work that cannot match is
+ * dropped as early as it is known:
+ *   - by name, for kinds that are never text (audio, video, archives,
+ *     fonts...) — these are not even opened;
+ *   - by size, over TEXTFIND_MAX_FILE;
+ *   - by content, when the first TEXTFIND_PROBE bytes hold a NUL, the
+ *     test grep and ripgrep use for binary data.
+ *
+ * Files are read in TEXTFIND_BLOCK blocks cut at the last newline, not
+ * mapped: a mapped file truncated while it is searched kills the
+ * process with SIGBUS, and over a tree of small files reads are as fast
+ * (ripgrep reads too when it searches folders). Literal text is found
+ * by scanning for its rarest byte with memchr(), vectorised in glibc,
+ * or, ignoring case, for both cases of it 16 bytes at a time, and only
+ * the candidates are compared. Regular expressions go to GRegex.
+ * Ignoring case folds ASCII letters only.
+ *
+ * Usage:
+ *   TextFind *find = textfind_start(root, text, TEXTFIND_REGEX, show_hidden,
+ *                                   on_batch, on_done, data, &error);
+ *   textfind_progress(find, &p);      // from a timer
+ *   textfind_cancel(find);            // no callback after this; also once done
+ */
+
+#ifndef BLAZENEURO_FILES_TEXTFIND_H
+#define BLAZENEURO_FILES_TEXTFIND_H
+
+#include <gio/gio.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "filetype.h"
+#include "walker.h"             /* WalkPool, struct walk_dirent64, _walk_read_hidden() */
+
+#define TEXTFIND_MAX_WORKERS  8
+#define TEXTFIND_BLOCK        (1 << 20)
+#define TEXTFIND_PROBE        (8 << 10)     /* bytes checked for a NUL */
+#define TEXTFIND_MAX_FILE     (64 << 20)    /* larger files are skipped */
+#define TEXTFIND_FILE_HITS    100           /* lines reported per file */
+#define TEXTFIND_MAX_HITS     20000         /* then the search stops */
+#define TEXTFIND_PREVIEW      160           /* bytes of a long line shown */
+#define TEXTFIND_BATCH        128
+#define TEXTFIND_FLUSH_USEC   (50 * 1000)
+
+typedef enum {
+    TEXTFIND_MATCH_CASE = 1 << 0,
+    TEXTFIND_REGEX      = 1 << 1,
+} TextFindFlags;
+
+typedef struct {
+    const char *path;           /* relative to the root */
+    guint line;                 /* from 1 */
+    const char *preview;        /* the line, or the part around the match; UTF-8 */
+    guint match_start;          /* bytes into preview */
+    guint match_len;
+} TextHit;
+
+typedef struct {
+    guint files;                /* searched */
+    guint skipped;              /* binary, too large or unreadable */
+    guint64 bytes;
+    guint hits;
+} TextFindProgress;
+
+/* Both run on the main thread and never after textfind_cancel() */
+typedef void (*TextFindBatchFunc)(const TextHit *hits, guint n, gpointer data);
+typedef void (*TextFindDoneFunc)(gboolean truncated, gpointer data);
+
+typedef struct {
+    gchar *text;
+    gsize len;
+    gboolean fold;              /* ASCII letters match either case */
+    gsize rare_at;              /* offset of the byte scanned for */
+    guchar rare, rare_other;    /* that byte, and its other case when folding */
+    GRegex *regex;              /* instead of text */
+} TextPattern;
+
+typedef struct {
+    GArray *hits;               /* TextHit */
+    GStringChunk *strings;
+    gint64 last_post;
+    char *dents;
+    guchar *buf;
+} TextFindWorker;
+
+/* A pool item: a file to search or a folder to list */
+typedef struct {
+    gboolean is_dir;
+    char rel[];                 /* relative to the root; "" for the root */
+} TextFindItem;
+
+typedef struct {
+    gint ref_count;
+    int root_fd;
+    dev_t root_dev;
+    gboolean show_hidden;
+    TextPattern pat;
+    GCancellable *cancellable;
+
+    WalkPool pool;              /* TextFindItem* */
+    TextFindWorker *workers;    /* one per pool thread */
+    GMutex lock;                /* bytes */
+    gint hits;                  /* TEXTFIND_MAX_HITS ends the search */
+    gint files_done;
+    gint skipped;
+    guint64 bytes;
+
+    TextFindBatchFunc batch_func;
+    TextFindDoneFunc done_func;
+    gpointer data;
+} TextFind;
+
+typedef struct {
+    TextFind *find;
+    GArray *hits;               /* NULL for the final notice */
+    GStringChunk *strings;
+} TextFindBatch;
+
+static TextFind *_textfind_ref(TextFind *find) {
+    g_atomic_int_inc(&find->ref_count);
+    return find;
+}
+
+static void _textfind_unref(TextFind *find) {
+    if (!g_atomic_int_dec_and_test(&find->ref_count)) return;
+    for (guint i = 0; i < find->pool.n_workers; i++) {
+        TextFindWorker *w = &find->workers[i];
+        g_array_free(w->hits, TRUE);
+        g_string_chunk_free(w->strings);
+        g_free(w->dents);
+        g_free(w->buf);
+    }
+    g_free(find->workers);
+    walk_pool_clear(&find->pool);
+    g_mutex_clear(&find->lock);
+    if (find->root_fd >= 0) close(find->root_fd);
+    if (find->pat.regex) g_regex_unref(find->pat.regex);
+    g_free(find->pat.text);
+    g_object_unref(find->cancellable);
+    g_free(find);
+}
+
+static gboolean _textfind_stopped(TextFind *find) {
+    return g_cancellable_is_cancelled(find->cancellable) ||
+           g_atomic_int_get(&find->hits) >= TEXTFIND_MAX_HITS;
+}
+
+/* ── Main-thread delivery ──────────────────────────────── */
+static void _textfind_batch_free(gpointer data) {
+    TextFindBatch *batch = data;
+    if (batch->hits) g_array_free(batch->hits, TRUE);
+    if (batch->strings) g_string_chunk_free(batch->strings);
+    _textfind_unref(batch->find);
+    g_free(batch);
+}
+
+static gboolean _textfind_deliver(gpointer data) {
+    TextFindBatch *batch = data;
+    TextFind *find = batch->find;
+    if (g_cancellable_is_cancelled(find->cancellable)) return G_SOURCE_REMOVE;
+
+    if (batch->hits)
+        find->batch_func((const TextHit *)batch->hits->data, batch->hits->len, find->data);
+    else if (find->done_func)
+        find->done_func(g_atomic_int_get(&find->hits) >= TEXTFIND_MAX_HITS, find->data);
+    return G_SOURCE_REMOVE;
+}
+
+/* Same priority for batches and the final notice, so it arrives last */
+static void _textfind_post(TextFind *find, GArray *hits, GStringChunk *strings) {
+    TextFindBatch *batch = g_new(TextFindBatch, 1);
+    batch->find = _textfind_ref(find);
+    batch->hits = hits;
+    batch->strings = strings;
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, _textfind_deliver, batch, _textfind_batch_free);
+}
+
+static void _textfind_flush(TextFind *find, TextFindWorker *w) {
+    if (w->hits->len == 0) return;
+    _textfind_post(find, w->hits, w->strings);
+    w->hits = g_array_new(FALSE, FALSE, sizeof(TextHit));
+    w->strings = g_string_chunk_new(4096);
+    w->last_post = g_get_monotonic_time();
+}
+
+/* ── Matching ───────────────────────────────────────────── */
+/* Bytes by how often they turn up in text and code, commonest first;
+ * any other byte is rarer than all of these */
+static const char textfind_common[] =
+    " etaoinsrhldcumfpgwybvk\n.,_-()=;/\"'0123456789:{}xjqz";
+
+static gint _textfind_commonness(guchar c) {
+    const char *at = c ? strchr(textfind_common, g_ascii_tolower(c)) : NULL;
+    return at ? (gint)(sizeof(textfind_common) - (gsize)(at - textfind_common)) : 0;
+}
+
+static gboolean _textfind_compile(TextPattern *p, const char *text, TextFindFlags flags,
+                                  GError **error) {
+    p->fold = !(flags & TEXTFIND_MATCH_CASE);
+    if (flags & TEXTFIND_REGEX) {
+        /* RAW: files are bytes, and need not be valid UTF-8 */
+        GRegexCompileFlags cflags = G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_OPTIMIZE;
+        if (p->fold) cflags |= G_REGEX_CASELESS;
+        p->regex = g_regex_new(text, cflags, 0, error);
+        return p->regex != NULL;
+    }
+
+    p->text = g_strdup(text);
+    p->len = strlen(text);
+    gint best = G_MAXINT;
+    for (gsize i = 0; i < p->len; i++) {
+        gint score = _textfind_commonness((guchar)text[i]);
+        if (score < best) {
+            best = score;
+            p->rare_at = i;
+        }
+    }
+    p->rare = p->rare_other = (guchar)text[p->rare_at];
+    if (p->fold && g_ascii_isalpha(p->rare)) {
+        p->rare = (guchar)g_ascii_tolower(p->rare);
+        p->rare_other = (guchar)g_ascii_toupper(p->rare);
+    }
+    return TRUE;
+}
+
+typedef guchar TextVec __attribute__((vector_size(16)));
+
+/* First of @a or @b in [s, end): memchr() for two bytes, one SSE2 or
+ * NEON compare per 16 */
+static const guchar *_textfind_memchr2(guchar a, guchar b, const guchar *s, const guchar *end) {
+    TextVec va = { 0 }, vb = { 0 };
+    va += a;
+    vb += b;
+    for (; end - s >= 16; s += 16) {
+        TextVec v;
+        memcpy(&v, s, sizeof(v));
+        TextVec m = (TextVec)((v == va) | (v == vb));
+        guint64 half[2];
+        memcpy(half, &m, sizeof(half));
+        if (half[0] | half[1]) break;
+    }
+    for (; s < end; s++)
+        if (*s == a || *s == b) return s;
+    return NULL;
+}
+
+/* The first match in [from, end) of a block starting at @base */
+static gboolean _textfind_next(const TextPattern *p, const guchar *base, const guchar *from,
+                               const guchar *end, const guchar **match, const guchar **match_end) {
+    if (p->regex) {
+        GMatchInfo *info = NULL;
+        gint start = 0, stop = 0;
+        gboolean found = g_regex_match_full(p->regex, (const gchar *)base, end - base,
+                                            from - base, 0, &info, NULL) &&
+                         g_match_info_fetch_pos(info, 0, &start, &stop);
+        g_match_info_free(info);
+        if (!found) return FALSE;
+        *match = base + start;
+        *match_end = base + stop;
+        return TRUE;
+    }
+
+    if (p->len == 0 || (gsize)(end - from) < p->len) return FALSE;
+    const guchar *last = end - p->len;       /* latest start that fits */
+    for (const guchar *s = from + p->rare_at; s <= last + p->rare_at;) {
+        const guchar *c = p->rare == p->rare_other
+            ? memchr(s, p->rare, (gsize)(last + p->rare_at + 1 - s))
+            : _textfind_memchr2(p->rare, p->rare_other, s, last + p->rare_at + 1);
+        if (!c) return FALSE;
+        const guchar *start = c - p->rare_at;
+        if (p->fold ? g_ascii_strncasecmp((const char *)start, p->text, p->len) == 0
+                    : memcmp(start, p->text, p->len) == 0) {
+            *match = start;
+            *match_end = start + p->len;
+            return TRUE;
+        }
+        s = c + 1;
+    }
+    return FALSE;
+}
+
+static guint _textfind_count_lines(const guchar *s, const guchar *end) {
+    guint n = 0;
+    while (s < end && (s = memchr(s, '\n', (gsize)(end - s)))) {
+        n++;
+        s++;
+    }
+    return n;
+}
+
+/* ── Hits ───────────────────────────────────────────────── */
+static void _textfind_add_hit(TextFind *find, TextFindWorker *w, const char *rel, guint line,
+                              const guchar *ls, const guchar *le,
+                              const guchar *ms, const guchar *me) {
+    while (ls < ms && (*ls == ' ' || *ls == '\t')) ls++;
+    if (le > me && le[-1] == '\r') le--;
+    /* A long line shows the part around the match */
+    if (le - ls > TEXTFIND_PREVIEW) {
+        if (ms - ls > TEXTFIND_PREVIEW / 3) ls = ms - TEXTFIND_PREVIEW / 3;
+        if (le - ls > TEXTFIND_PREVIEW) le = ls + TEXTFIND_PREVIEW;
+        if (me > le) me = le;
+    }
+
+    /* Made valid in pieces, so the match offsets hold */
+    gchar *before = g_utf8_make_valid((const gchar *)ls, ms - ls);
+    gchar *match = g_utf8_make_valid((const gchar *)ms, me - ms);
+    gchar *after = g_utf8_make_valid((const gchar *)me, le - me);
+    gchar *preview = g_strconcat(before, match, after, NULL);
+
+    TextHit hit;
+    hit.path = g_string_chunk_insert_const(w->strings, rel);
+    hit.line = line;
+    hit.preview = g_string_chunk_insert(w->strings, preview);
+    hit.match_start = (guint)strlen(before);
+    hit.match_len = (guint)strlen(match);
+    g_array_append_val(w->hits, hit);
+    g_atomic_int_inc(&find->hits);
+
+    g_free(preview);
+    g_free(after);
+    g_free(match);
+    g_free(before);
+    if (w->hits->len >= TEXTFIND_BATCH) _textfind_flush(find, w);
+}
+
+/* Reports the lines in [base, end) holding a match, up to the file's
+ * share; @line is base's line number, and end's is returned */
+static guint _textfind_block(TextFind *find, TextFindWorker *w, const char *rel,
+                             const guchar *base, const guchar *end, guint line,
+                             guint *file_hits) {
+    const guchar *counted = base, *from = base, *ms, *me;
+    while (from < end && *file_hits < TEXTFIND_FILE_HITS && !_textfind_stopped(find) &&
+           _textfind_next(&find->pat, base, from, end, &ms, &me)) {
+        line += _textfind_count_lines(counted, ms);
+        counted = ms;
+        const guchar *ls = ms;
+        while (ls > base && ls[-1] != '\n') ls--;
+        const guchar *le = memchr(ms, '\n', (gsize)(end - ms));
+        if (!le) le = end;
+        _textfind_add_hit(find, w, rel, line, ls, le, ms, MIN(me, le));
+        (*file_hits)++;
+        from = le + 1;      /* one hit per line */
+    }
+    return line + _textfind_count_lines(counted, end);
+}
+
+/* ── Worker ─────────────────────────────────────────────── */
+/* Kinds that are never searched: known binary, and not worth a read */
+static gboolean _textfind_binary_kind(FileKind kind) {
+    switch (kind) {
+    case FT_KIND_AUDIO:
+    case FT_KIND_VIDEO:
+    case FT_KIND_PDF:
+    case FT_KIND_ARCHIVE:
+    case FT_KIND_PACKAGE:
+    case FT_KIND_DISK_IMAGE:
+    case FT_KIND_EXECUTABLE:
+    case FT_KIND_FONT:
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+static void _textfind_file(TextFind *find, TextFindWorker *w, const char *rel) {
+    int fd = openat(find->root_fd, rel, O_RDONLY | O_NOFOLLOW | O_NOATIME | O_CLOEXEC);
+    if (fd < 0 && errno == EPERM)
+        fd = openat(find->root_fd, rel, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size > TEXTFIND_MAX_FILE) {
+        g_atomic_int_inc(&find->skipped);
+        if (fd >= 0) close(fd);
+        return;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    gsize have = 0, total = 0;      /* have: a partial line kept from the last block */
+    guint line = 1, file_hits = 0;
+    gboolean binary = FALSE;
+    while (!_textfind_stopped(find) && file_hits < TEXTFIND_FILE_HITS) {
+        ssize_t n = read(fd, w->buf + have, TEXTFIND_BLOCK - have);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 || (n == 0 && have == 0)) break;
+        if (total == 0 && memchr(w->buf, 0, MIN((gsize)n, TEXTFIND_PROBE))) {
+            binary = TRUE;
+            break;
+        }
+        total += (gsize)n;
+
+        /* Search up to the last newline; a line longer than a block is
+         * searched in block-sized pieces */
+        gsize len = have + (gsize)n;
+        const guchar *end = w->buf + len;
+        if (n > 0) {
+            const guchar *nl = memrchr(w->buf, '\n', len);
+            if (nl) end = nl + 1;
+        }
+        line = _textfind_block(find, w, rel, w->buf, end, line, &file_hits);
+        have = (gsize)(w->buf + len - end);
+        memmove(w->buf, end, have);
+        if (n == 0) break;
+    }
+    close(fd);
+
+    if (binary) {
+        g_atomic_int_inc(&find->skipped);
+        return;
+    }
+    g_atomic_int_inc(&find->files_done);
+    g_mutex_lock(&find->lock);
+    find->bytes += total;
+    g_mutex_unlock(&find->lock);
+}
+
+static TextFindItem *_textfind_item(gboolean is_dir, const char *dir, const char *name) {
+    gsize dir_len = strlen(dir), name_len = strlen(name);
+    TextFindItem *item = g_malloc(sizeof(TextFindItem) + dir_len + 1 + name_len + 1);
+    item->is_dir = is_dir;
+    if (dir_len) {
+        memcpy(item->rel, dir, dir_len);
+        item->rel[dir_len++] = '/';
+    }
+    memcpy(item->rel + dir_len, name, name_len + 1);
+    return item;
+}
+
+static void _textfind_dir(TextFind *find, TextFindWorker *w, guint worker, const char *rel) {
+    int fd = openat(find->root_fd, rel[0] ? rel : ".",
+                    O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_dev != find->root_dev) {
+        close(fd);
+        return;
+    }
+    GHashTable *hidden = find->show_hidden ? NULL : _walk_read_hidden(fd);
+
+    long n;
+    while (!_textfind_stopped(find) &&
+           (n = syscall(SYS_getdents64, fd, w->dents, WALK_DENTS_BUF)) > 0) {
+        GPtrArray *files = g_ptr_array_new();
+        for (long off = 0; off < n;) {
+            struct walk_dirent64 *de = (struct walk_dirent64 *)(w->dents + off);
+            off += de->d_reclen;
+            const char *name = de->d_name;
+            if (name[0] == '.' &&
+                (!find->show_hidden || name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                continue;
+            if (hidden && g_hash_table_contains(hidden, name)) continue;
+
+            unsigned char type = de->d_type;
+            if (type == DT_UNKNOWN) {
+                if (fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) continue;
+                type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN;
+            }
+            if (type == DT_DIR) {
+                walk_pool_push(&find->pool, worker, _textfind_item(TRUE, rel, name));
+            } else if (type == DT_REG) {
+                if (_textfind_binary_kind(filetype_lookup(name))) {
+                    g_atomic_int_inc(&find->skipped);
+                    continue;
+                }
+                g_ptr_array_add(files, _textfind_item(FALSE, rel, name));
+            }
+        }
+        /* Pushed last, so they are taken first */
+        for (guint i = 0; i < files->len; i++)
+            walk_pool_push(&find->pool, worker, files->pdata[i]);
+        g_ptr_array_free(files, TRUE);
+    }
+    if (hidden) g_hash_table_destroy(hidden);
+    close(fd);
+}
+
+static void _textfind_work(guint worker, gpointer item, gpointer data) {
+    TextFind *find = data;
+    TextFindWorker *w = &find->workers[worker];
+    TextFindItem *it = item;
+    if (it->is_dir) _textfind_dir(find, w, worker, it->rel);
+    else _textfind_file(find, w, it->rel);
+    if (w->hits->len > 0 && g_get_monotonic_time() - w->last_post > TEXTFIND_FLUSH_USEC)
+        _textfind_flush(find, w);
+    if (_textfind_stopped(find)) walk_pool_stop(&find->pool);
+}
+
+/* Out of work for now: what was found goes out before sleeping */
+static void _textfind_idle(guint worker, gpointer data) {
+    TextFind *find = data;
+    _textfind_flush(find, &find->workers[worker]);
+}
+
+static gpointer _textfind_run(gpointer data) {
+    TextFind *find = data;
+    walk_pool_run(&find->pool, _textfind_item(TRUE, "", ""));
+    for (guint i = 0; i < find->pool.n_workers; i++) _textfind_flush(find, &find->workers[i]);
+    _textfind_post(find, NULL, NULL);
+    _textfind_unref(find);
+    return NULL;
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+/* NULL, with @error set, for a regular expression that does not compile */
+static TextFind *textfind_start(const char *root, const char *text, TextFindFlags flags,
+                                gboolean show_hidden, TextFindBatchFunc batch_func,
+                                TextFindDoneFunc done_func, gpointer data, GError **error) {
+    TextFind *find = g_new0(TextFind, 1);
+    find->ref_count = 1;
+    find->root_fd = -1;
+    find->cancellable = g_cancellable_new();
+    g_mutex_init(&find->lock);
+    walk_pool_init(&find->pool, TEXTFIND_MAX_WORKERS, "files-grep", find->cancellable,
+                   _textfind_work, _textfind_idle, g_free, find);
+    find->workers = g_new0(TextFindWorker, find->pool.n_workers);
+    for (guint i = 0; i < find->pool.n_workers; i++) {
+        find->workers[i].hits = g_array_new(FALSE, FALSE, sizeof(TextHit));
+        find->workers[i].strings = g_string_chunk_new(4096);
+        find->workers[i].last_post = g_get_monotonic_time();
+    }
+    if (!_textfind_compile(&find->pat, text, flags, error)) {
+        _textfind_unref(find);
+        return NULL;
+    }
+    find->show_hidden = show_hidden;
+    find->batch_func = batch_func;
+    find->done_func = done_func;
+    find->data = data;
+
+    struct stat st;
+    find->root_fd = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (find->root_fd < 0 || fstat(find->root_fd, &st) != 0) {
+        _textfind_post(find, NULL, NULL);
+        return find;
+    }
+    find->root_dev = st.st_dev;
+
+    for (guint i = 0; i < find->pool.n_workers; i++) {
+        find->workers[i].dents = g_malloc(WALK_DENTS_BUF);
+        find->workers[i].buf = g_malloc(TEXTFIND_BLOCK);
+    }
+    g_thread_unref(g_thread_new("files-grep-run", _textfind_run, _textfind_ref(find)));
+    return find;
+}
+
+static void textfind_progress(TextFind *find, TextFindProgress *p) {
+    p->files = (guint)g_atomic_int_get(&find->files_done);
+    p->skipped = (guint)g_atomic_int_get(&find->skipped);
+    p->hits = (guint)MIN(g_atomic_int_get(&find->hits), TEXTFIND_MAX_HITS);
+    g_mutex_lock(&find->lock);
+    p->bytes = find->bytes;
+    g_mutex_unlock(&find->lock);
+}
+
+/* Stops every worker at its next file and drops batches still queued.
+ * NULL is ignored. */
+static void textfind_cancel(TextFind *find) {
+    if (!find) return;
+    g_cancellable_cancel(find->cancellable);
+    _textfind_unref(find);
+}
+
+#endif /* BLAZENEURO_FILES_TEXTFIND_H */
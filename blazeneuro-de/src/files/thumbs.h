@@ -0,0 +1,475 @@
+/*
+ * BlazeNeuro Files — Thumbnails
+ * Generates previews for images, videos and PDFs on a small worker pool
+ * and shares them through the freedesktop thumbnail cache
+ * (~/.cache/thumbnails/normal/<md5 of URI>.png, validated against the
+ * file's Thumb::MTime). Images are decoded at thumbnail size by
+ * gdk-pixbuf; other types go through the installed .thumbnailer helpers,
+ * which get THUMB_HELPER_MSEC before they are killed.
+ *
+ * Everything but the workers runs on the main thread. Finished previews
+ * are kept in a byte-capped in-memory LRU, so a revisited folder fills in
+ * without touching the disk.
+ *
+ * Usage:
+ *   thumbs_init(on_ready, data);
+ *   thumbs_begin_pass();
+ *   for each visible item without a preview:
+ *       thumbs_request(path, kind, row_reference);
+ *   thumbs_end_pass();      // cancels queued work that scrolled away and
+ *                           // puts what is still wanted in screen order
+ */
+
+#ifndef BLAZENEURO_FILES_THUMBS_H
+#define BLAZENEURO_FILES_THUMBS_H
+
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+#include "filetype.h"
+
+#define THUMB_CACHE_SIZE     128                 /* "normal" cache bucket */
+#define THUMB_DISPLAY_SIZE   64
+#define THUMB_MAX_WORKERS    4
+#define THUMB_MAX_FILE_SIZE  (64 << 20)          /* skip huge images */
+#define THUMB_LRU_BYTES      (32 << 20)
+#define THUMB_HELPER_MSEC    10000               /* then a thumbnailer is killed */
+#define THUMB_FAIL_DIR       "blazeneuro-files"
+
+/* Called on the main thread for every preview produced. @row may have
+ * gone stale if the model changed without signals; check @path. */
+typedef void (*ThumbReadyFunc)(const char *path, GtkTreeRowReference *row,
+                               GdkPixbuf *pixbuf, gpointer data);
+
+typedef struct {
+    gchar *path;
+    FileKind kind;
+    GtkTreeRowReference *row;   /* main thread only */
+    guint pass;                 /* last pass that asked for it */
+    guint seq;                  /* request order within the pass */
+    gint cancelled;
+    gboolean prefetch;          /* nobody waits for it yet: see thumbs_prefetch() */
+    GdkPixbuf *result;
+} ThumbJob;
+
+static struct {
+    GThreadPool *pool;
+    GHashTable *pending;        /* path -> ThumbJob* */
+    guint pass;
+    guint seq;
+    gboolean reordered;         /* queued jobs changed pass or seq */
+    ThumbReadyFunc ready_func;
+    gpointer ready_data;
+    gchar *normal_dir;
+    gchar *fail_dir;
+
+    GQueue lru;                 /* ThumbCacheEntry*, most recent first */
+    GHashTable *lru_index;      /* path -> GList* link in lru */
+    gsize lru_bytes;
+} thumbs;
+
+typedef struct {
+    gchar *path;
+    GdkPixbuf *pixbuf;
+} ThumbCacheEntry;
+
+/* ── Memory LRU (main thread) ───────────────────────────── */
+static void _thumbs_lru_drop(GList *link) {
+    ThumbCacheEntry *ce = link->data;
+    thumbs.lru_bytes -= gdk_pixbuf_get_byte_length(ce->pixbuf);
+    g_hash_table_remove(thumbs.lru_index, ce->path);
+    g_queue_delete_link(&thumbs.lru, link);
+    g_object_unref(ce->pixbuf);
+    g_free(ce->path);
+    g_free(ce);
+}
+
+static void _thumbs_lru_put(const char *path, GdkPixbuf *pixbuf) {
+    GList *old = g_hash_table_lookup(thumbs.lru_index, path);
+    if (old) _thumbs_lru_drop(old);
+
+    ThumbCacheEntry *ce = g_new(ThumbCacheEntry, 1);
+    ce->path = g_strdup(path);
+    ce->pixbuf = g_object_ref(pixbuf);
+    g_queue_push_head(&thumbs.lru, ce);
+    g_hash_table_insert(thumbs.lru_index, ce->path, thumbs.lru.head);
+    thumbs.lru_bytes += gdk_pixbuf_get_byte_length(pixbuf);
+
+    while (thumbs.lru_bytes > THUMB_LRU_BYTES && thumbs.lru.length > 1)
+        _thumbs_lru_drop(thumbs.lru.tail);
+}
+
+/* Borrowed reference, or NULL when not in memory */
+static GdkPixbuf *thumbs_lookup(const char *path) {
+    GList *link = g_hash_table_lookup(thumbs.lru_index, path);
+    if (!link) return NULL;
+    g_queue_unlink(&thumbs.lru, link);
+    g_queue_push_head_link(&thumbs.lru, link);
+    return ((ThumbCacheEntry *)link->data)->pixbuf;
+}
+
+/* The file changed: forget the in-memory preview */
+static void thumbs_invalidate(const char *path) {
+    GList *link = g_hash_table_lookup(thumbs.lru_index, path);
+    if (link) _thumbs_lru_drop(link);
+}
+
+static gboolean thumbs_supported(FileKind kind) {
+    return kind == FT_KIND_IMAGE || kind == FT_KIND_VIDEO || kind == FT_KIND_PDF;
+}
+
+/* ── External thumbnailers ──────────────────────────────── */
+typedef struct {
+    gchar **mime_types;
+    gchar *exec;
+} Thumbnailer;
+
+static GPtrArray *_thumbs_helpers;      /* Thumbnailer*, built once */
+
+static gpointer _thumbs_load_helpers(gpointer unused) {
+    (void)unused;
+    GPtrArray *helpers = g_ptr_array_new();
+    const gchar *const *sys = g_get_system_data_dirs();
+    gchar **dirs = g_new0(gchar *, g_strv_length((gchar **)sys) + 2);
+    dirs[0] = g_build_filename(g_get_user_data_dir(), "thumbnailers", NULL);
+    for (guint i = 0; sys[i]; i++)
+        dirs[i + 1] = g_build_filename(sys[i], "thumbnailers", NULL);
+
+    for (guint i = 0; dirs[i]; i++) {
+        GDir *dir = g_dir_open(dirs[i], 0, NULL);
+        if (!dir) continue;
+        const char *name;
+        while ((name = g_dir_read_name(dir)) != NULL) {
+            if (!g_str_has_suffix(name, ".thumbnailer")) continue;
+            gchar *file = g_build_filename(dirs[i], name, NULL);
+            GKeyFile *kf = g_key_file_new();
+            if (g_key_file_load_from_file(kf, file, G_KEY_FILE_NONE, NULL)) {
+                gchar *try_exec = g_key_file_get_string(kf, "Thumbnailer Entry", "TryExec", NULL);
+                gchar *found = try_exec ? g_find_program_in_path(try_exec) : NULL;
+                if (!try_exec || found) {
+                    Thumbnailer *t = g_new0(Thumbnailer, 1);
+                    t->exec = g_key_file_get_string(kf, "Thumbnailer Entry", "Exec", NULL);
+                    t->mime_types = g_key_file_get_string_list(kf, "Thumbnailer Entry",
+                                                               "MimeType", NULL, NULL);
+                    if (t->exec && t->mime_types) {
+                        g_ptr_array_add(helpers, t);
+                    } else {
+                        g_free(t->exec);
+                        g_strfreev(t->mime_types);
+                        g_free(t);
+                    }
+                }
+                g_free(found);
+                g_free(try_exec);
+            }
+            g_key_file_free(kf);
+            g_free(file);
+        }
+        g_dir_close(dir);
+    }
+    g_strfreev(dirs);
+    _thumbs_helpers = helpers;
+    return NULL;
+}
+
+static const Thumbnailer *_thumbs_find_helper(const char *mime) {
+    static GOnce once = G_ONCE_INIT;
+    g_once(&once, _thumbs_load_helpers, NULL);
+    for (guint i = 0; i < _thumbs_helpers->len; i++) {
+        const Thumbnailer *t = g_ptr_array_index(_thumbs_helpers, i);
+        for (guint j = 0; t->mime_types[j]; j++)
+            if (g_content_type_is_a(mime, t->mime_types[j])) return t;
+    }
+    return NULL;
+}
+
+/* Expand %i %u %o %s %% in one Exec argument */
+static gchar *_thumbs_expand(const char *arg, const char *path, const char *uri,
+                             const char *out) {
+    GString *s = g_string_new(NULL);
+    for (const char *p = arg; *p; p++) {
+        if (*p != '%' || !p[1]) { g_string_append_c(s, *p); continue; }
+        switch (*++p) {
+        case 'i': g_string_append(s, path); break;
+        case 'u': g_string_append(s, uri); break;
+        case 'o': g_string_append(s, out); break;
+        case 's': g_string_append_printf(s, "%d", THUMB_CACHE_SIZE); break;
+        default:  g_string_append_c(s, *p); break;
+        }
+    }
+    return g_string_free(s, FALSE);
+}
+
+/* In the child: its own process group, so a helper's children go too */
+static void _thumbs_helper_setup(gpointer unused) {
+    (void)unused;
+    setpgid(0, 0);
+}
+
+/* Waits for @pid up to THUMB_HELPER_MSEC, then kills its group. Without
+ * pidfds (Linux < 5.3) it waits as long as the helper takes. */
+static gboolean _thumbs_wait_helper(GPid pid) {
+#ifdef SYS_pidfd_open
+    int pidfd = (int)syscall(SYS_pidfd_open, pid, 0);
+    if (pidfd >= 0) {
+        struct pollfd pfd = { pidfd, POLLIN, 0 };
+        int ready;
+        while ((ready = poll(&pfd, 1, THUMB_HELPER_MSEC)) < 0 && errno == EINTR) {}
+        if (ready == 0) kill(-pid, SIGKILL);
+        close(pidfd);
+    }
+#endif
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+    return g_spawn_check_wait_status(status, NULL);
+}
+
+static GdkPixbuf *_thumbs_run_helper(const char *path, const char *uri) {
+    gchar *mime = g_content_type_guess(path, NULL, 0, NULL);
+    const Thumbnailer *t = _thumbs_find_helper(mime);
+    g_free(mime);
+    if (!t) return NULL;
+
+    gchar **argv = NULL;
+    if (!g_shell_parse_argv(t->exec, NULL, &argv, NULL)) return NULL;
+
+    gchar *out = NULL;
+    int fd = g_file_open_tmp("blazeneuro-thumb-XXXXXX.png", &out, NULL);
+    if (fd < 0) { g_strfreev(argv); return NULL; }
+    close(fd);
+
+    for (guint i = 0; argv[i]; i++) {
+        gchar *expanded = _thumbs_expand(argv[i], path, uri, out);
+        g_free(argv[i]);
+        argv[i] = expanded;
+    }
+
+    GdkPixbuf *pixbuf = NULL;
+    GPid pid;
+    if (g_spawn_async(NULL, argv, NULL,
+                      G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD |
+                      G_SPAWN_STDOUT_TO_DEV_NULL | G_SPAWN_STDERR_TO_DEV_NULL,
+                      _thumbs_helper_setup, NULL, &pid, NULL) &&
+        _thumbs_wait_helper(pid))
+        pixbuf = gdk_pixbuf_new_from_file_at_scale(out, THUMB_CACHE_SIZE, THUMB_CACHE_SIZE,
+                                                   TRUE, NULL);
+    g_unlink(out);
+    g_free(out);
+    g_strfreev(argv);
+    return pixbuf;
+}
+
+/* ── Disk cache ─────────────────────────────────────────── */
+static GdkPixbuf *_thumbs_read_cached(const char *file, const char *mtime) {
+    GdkPixbuf *pixbuf = gdk_pixbuf_new_from_file(file, NULL);
+    if (!pixbuf) return NULL;
+    const gchar *stored = gdk_pixbuf_get_option(pixbuf, "tEXt::Thumb::MTime");
+    if (stored && strcmp(stored, mtime) == 0) return pixbuf;
+    g_object_unref(pixbuf);
+    return NULL;
+}
+
+/* Written to a temporary name first so readers never see half a PNG */
+static void _thumbs_write_cached(GdkPixbuf *pixbuf, const char *file,
+                                 const char *uri, const char *mtime) {
+    gchar *tmp = g_strdup_printf("%s.%d.tmp", file, (int)getpid());
+    if (gdk_pixbuf_save(pixbuf, tmp, "png", NULL,
+                        "tEXt::Thumb::URI", uri,
+                        "tEXt::Thumb::MTime", mtime, NULL)) {
+        g_chmod(tmp, 0600);
+        if (g_rename(tmp, file) != 0) g_unlink(tmp);
+    }
+    g_free(tmp);
+}
+
+/* ── Worker ─────────────────────────────────────────────── */
+static GdkPixbuf *_thumbs_generate(ThumbJob *job) {
+    struct stat st;
+    if (stat(job->path, &st) != 0 || !S_ISREG(st.st_mode)) return NULL;
+
+    gchar *uri = g_filename_to_uri(job->path, NULL, NULL);
+    if (!uri) return NULL;
+    gchar *md5 = g_compute_checksum_for_string(G_CHECKSUM_MD5, uri, -1);
+    gchar *leaf = g_strconcat(md5, ".png", NULL);
+    gchar *cached = g_build_filename(thumbs.normal_dir, leaf, NULL);
+    gchar *failed = g_build_filename(thumbs.fail_dir, leaf, NULL);
+    gchar *mtime = g_strdup_printf("%lld", (long long)st.st_mtime);
+
+    GdkPixbuf *pixbuf = _thumbs_read_cached(cached, mtime);
+    GdkPixbuf *marker = pixbuf ? NULL : _thumbs_read_cached(failed, mtime);
+
+    if (!pixbuf && !marker && !g_str_has_prefix(job->path, thumbs.normal_dir)) {
+        if (job->kind == FT_KIND_IMAGE && st.st_size <= THUMB_MAX_FILE_SIZE) {
+            /* The loader's size-prepared hook lets JPEG decode at 1/2..1/8 */
+            GdkPixbuf *raw = gdk_pixbuf_new_from_file_at_scale(job->path, THUMB_CACHE_SIZE,
+                                                               THUMB_CACHE_SIZE, TRUE, NULL);
+            if (raw) {
+                pixbuf = gdk_pixbuf_apply_embedded_orientation(raw);
+                g_object_unref(raw);
+            }
+        }
+        if (!pixbuf) pixbuf = _thumbs_run_helper(job->path, uri);
+
+        if (pixbuf) {
+            _thumbs_write_cached(pixbuf, cached, uri, mtime);
+        } else {
+            GdkPixbuf *blank = gdk_pixbuf_new(GDK_COLORSPACE_RGB, TRUE, 8, 1, 1);
+            gdk_pixbuf_fill(blank, 0);
+            _thumbs_write_cached(blank, failed, uri, mtime);
+            g_object_unref(blank);
+        }
+    }
+    if (marker) g_object_unref(marker);
+
+    g_free(mtime); g_free(failed); g_free(cached); g_free(leaf); g_free(md5); g_free(uri);
+    if (!pixbuf) return NULL;
+
+    int w = gdk_pixbuf_get_width(pixbuf), h = gdk_pixbuf_get_height(pixbuf);
+    if (w <= THUMB_DISPLAY_SIZE && h <= THUMB_DISPLAY_SIZE) return pixbuf;
+    double scale = (double)THUMB_DISPLAY_SIZE / MAX(w, h);
+    GdkPixbuf *small = gdk_pixbuf_scale_simple(pixbuf, MAX(1, (int)(w * scale)),
+                                               MAX(1, (int)(h * scale)), GDK_INTERP_BILINEAR);
+    g_object_unref(pixbuf);
+    return small;
+}
+
+static gboolean _thumbs_deliver(gpointer data) {
+    ThumbJob *job = data;
+    if (g_hash_table_lookup(thumbs.pending, job->path) == job)
+        g_hash_table_remove(thumbs.pending, job->path);
+
+    if (job->result) {
+        _thumbs_lru_put(job->path, job->result);
+        if (gtk_tree_row_reference_valid(job->row))
+            thumbs.ready_func(job->path, job->row, job->result, thumbs.ready_data);
+        g_object_unref(job->result);
+    }
+    gtk_tree_row_reference_free(job->row);
+    g_free(job->path);
+    g_free(job);
+    return G_SOURCE_REMOVE;
+}
+
+static void _thumbs_work(gpointer data, gpointer unused) {
+    (void)unused;
+    ThumbJob *job = data;
+    if (!g_atomic_int_get(&job->cancelled))
+        job->result = _thumbs_generate(job);
+    g_idle_add(_thumbs_deliver, job);
+}
+
+/* Newest pass first, then the order items were asked for (top to bottom) */
+static gint _thumbs_job_cmp(gconstpointer a, gconstpointer b, gpointer unused) {
+    (void)unused;
+    const ThumbJob *x = a, *y = b;
+    if (x->pass != y->pass) return x->pass > y->pass ? -1 : 1;
+    return x->seq < y->seq ? -1 : x->seq > y->seq;
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+static void thumbs_init(ThumbReadyFunc ready_func, gpointer data) {
+    thumbs.ready_func = ready_func;
+    thumbs.ready_data = data;
+    thumbs.pending = g_hash_table_new(g_str_hash, g_str_equal);
+    thumbs.lru_index = g_hash_table_new(g_str_hash, g_str_equal);
+    g_queue_init(&thumbs.lru);
+
+    thumbs.normal_dir = g_build_filename(g_get_user_cache_dir(), "thumbnails", "normal", NULL);
+    thumbs.fail_dir = g_build_filename(g_get_user_cache_dir(), "thumbnails", "fail",
+                                       THUMB_FAIL_DIR, NULL);
+    g_mkdir_with_parents(thumbs.normal_dir, 0700);
+    g_mkdir_with_parents(thumbs.fail_dir, 0700);
+
+    gint workers = CLAMP((gint)g_get_num_processors() - 1, 1, THUMB_MAX_WORKERS);
+    thumbs.pool = g_thread_pool_new(_thumbs_work, NULL, workers, FALSE, NULL);
+    g_thread_pool_set_sort_function(thumbs.pool, _thumbs_job_cmp, NULL);
+}
+
+/* Starts a round of requests, e.g. after a scroll */
+static void thumbs_begin_pass(void) {
+    thumbs.pass++;
+    thumbs.seq = 0;
+}
+
+/* Queues a preview for @path unless one is already on its way.
+ * Takes ownership of @row. */
+static void thumbs_request(const char *path, FileKind kind, GtkTreeRowReference *row) {
+    ThumbJob *job = g_hash_table_lookup(thumbs.pending, path);
+    if (job && !g_atomic_int_get(&job->cancelled)) {
+        /* Its place in the pool's queue is fixed in thumbs_end_pass() */
+        job->pass = thumbs.pass;
+        job->seq = thumbs.seq++;
+        job->prefetch = FALSE;
+        thumbs.reordered = TRUE;
+        if (job->row) gtk_tree_row_reference_free(row);
+        else job->row = row;
+        return;
+    }
+
+    job = g_new0(ThumbJob, 1);
+    job->path = g_strdup(path);
+    job->kind = kind;
+    job->row = row;
+    job->pass = thumbs.pass;
+    job->seq = thumbs.seq++;
+    g_hash_table_replace(thumbs.pending, job->path, job);
+    g_thread_pool_push(thumbs.pool, job, NULL);
+}
+
+/* Cancels queued jobs that were not asked for again in this pass, and
+ * re-sorts the pool's queue if any that were moved up */
+static void thumbs_end_pass(void) {
+    GHashTableIter it;
+    gpointer value;
+    g_hash_table_iter_init(&it, thumbs.pending);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        ThumbJob *job = value;
+        if (job->pass != thumbs.pass && !job->prefetch) {
+            g_atomic_int_set(&job->cancelled, 1);
+            g_hash_table_iter_remove(&it);
+        }
+    }
+    /* Pass and seq are only written on the main thread, which is also
+     * where every push compares them */
+    if (thumbs.reordered) g_thread_pool_set_sort_function(thumbs.pool, _thumbs_job_cmp, NULL);
+    thumbs.reordered = FALSE;
+}
+
+/* Queues a preview for a folder not shown yet, behind everything asked
+ * for on screen. It survives passes until thumbs_cancel_prefetch(), or
+ * becomes an ordinary job when thumbs_request() asks for it. */
+static void thumbs_prefetch(const char *path, FileKind kind) {
+    if (g_hash_table_contains(thumbs.pending, path) || thumbs_lookup(path)) return;
+    ThumbJob *job = g_new0(ThumbJob, 1);
+    job->path = g_strdup(path);
+    job->kind = kind;
+    job->pass = 0;              /* older than any pass: sorts last */
+    job->seq = thumbs.seq++;
+    job->prefetch = TRUE;
+    g_hash_table_replace(thumbs.pending, job->path, job);
+    g_thread_pool_push(thumbs.pool, job, NULL);
+}
+
+/* Cancels queued previews of thumbs_prefetch() still nobody asked for */
+static void thumbs_cancel_prefetch(void) {
+    GHashTableIter it;
+    gpointer value;
+    g_hash_table_iter_init(&it, thumbs.pending);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        ThumbJob *job = value;
+        if (job->prefetch) {
+            g_atomic_int_set(&job->cancelled, 1);
+            g_hash_table_iter_remove(&it);
+        }
+    }
+}
+
+#endif /* BLAZENEURO_FILES_THUMBS_H */
@@ -0,0 +1,574 @@
+/*
+ * BlazeNeuro Files — Trash
+ * Trashing as the freedesktop.org Trash spec describes it, run as jobs on
+ * the file-operation queue (fileops.h).
+ *
+ * Files on the home filesystem go to $XDG_DATA_HOME/Trash by renameat2(),
+ * never a copy. Files on other filesystems go to that filesystem's
+ * $topdir/.Trash/$uid or $topdir/.Trash-$uid; only when neither can be
+ * used are they copied to the home trash and then deleted. Each item's
+ * info/<name>.trashinfo is created (O_EXCL) before the move, which also
+ * claims the name.
+ *
+ * Trashed folders are sized once, on the job thread, and recorded in the
+ * trash's directorysizes file, so trash_size() costs one stat per item.
+ * Emptying renames everything into Trash/expunged first, so the trash is
+ * empty at once, then deletes it in the background.
+ *
+ * Usage:
+ *   FileOp *op = fileop_trash(paths, &callbacks, data);
+ *   fileop_empty_trash(NULL, &callbacks, data);     // everything
+ *   trash_size(on_size, data);
+ */
+
+#ifndef BLAZENEURO_FILES_TRASH_H
+#define BLAZENEURO_FILES_TRASH_H
+
+#include "fileops.h"
+
+/* Serialises rewrites of directorysizes between jobs and trash_size() */
+static GMutex trash_sizes_lock;
+
+typedef void (*TrashSizeFunc)(guint64 bytes, guint items, gpointer data);
+
+/* $XDG_DATA_HOME/Trash */
+static gchar *trash_home(void) {
+    return g_build_filename(g_get_user_data_dir(), "Trash", NULL);
+}
+
+/* Where the home trash keeps its items; what Files shows as the Trash */
+static gchar *trash_files_dir(void) {
+    return g_build_filename(g_get_user_data_dir(), "Trash", "files", NULL);
+}
+
+static gchar *_trash_info_path(const char *trash, const char *name) {
+    return g_strdup_printf("%s/info/%s.trashinfo", trash, name);
+}
+
+/* Creates files/ and info/ in @trash when missing */
+static gboolean _trash_prepare(const char *trash) {
+    gchar *files = g_build_filename(trash, "files", NULL);
+    gchar *info = g_build_filename(trash, "info", NULL);
+    gboolean ok = g_mkdir_with_parents(files, 0700) == 0 && g_mkdir_with_parents(info, 0700) == 0;
+    g_free(files);
+    g_free(info);
+    return ok;
+}
+
+/* Allocated bytes below @path, not following symlinks: st_blocks, as the
+ * disk usage view counts them, and a file with several hard links once
+ * (a trashed tree sits on one filesystem, so its inode is enough). The
+ * walk keeps its own stack, so a deep tree cannot exhaust the thread's. */
+static guint64 _trash_tree_size(const char *path) {
+    struct stat st;
+    if (lstat(path, &st) != 0) return 0;
+    guint64 size = (guint64)st.st_blocks * 512;
+    if (!S_ISDIR(st.st_mode)) return size;
+
+    GHashTable *linked = g_hash_table_new_full(g_int64_hash, g_int64_equal, g_free, NULL);
+    GPtrArray *stack = g_ptr_array_new();
+    g_ptr_array_add(stack, g_strdup(path));
+    while (stack->len > 0) {
+        gchar *dir = g_ptr_array_remove_index(stack, stack->len - 1);
+        DIR *dp = opendir(dir);
+        struct dirent *de;
+        while (dp && (de = readdir(dp))) {
+            if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) continue;
+            struct stat cst;
+            if (fstatat(dirfd(dp), de->d_name, &cst, AT_SYMLINK_NOFOLLOW) != 0) continue;
+            if (!S_ISDIR(cst.st_mode) && cst.st_nlink > 1) {
+                gint64 ino = (gint64)cst.st_ino;
+                if (g_hash_table_contains(linked, &ino)) continue;
+                g_hash_table_add(linked, g_memdup2(&ino, sizeof(ino)));
+            }
+            size += (guint64)cst.st_blocks * 512;
+            if (S_ISDIR(cst.st_mode))
+                g_ptr_array_add(stack, g_build_filename(dir, de->d_name, NULL));
+        }
+        if (dp) closedir(dp);
+        g_free(dir);
+    }
+    g_ptr_array_free(stack, TRUE);
+    g_hash_table_destroy(linked);
+    return size;
+}
+
+/* ── directorysizes ─────────────────────────────────────── */
+/* One line per trashed folder: "<bytes> <trashinfo mtime> <name>", the
+ * name percent-encoded. An entry whose .trashinfo has another mtime is
+ * stale. */
+typedef struct {
+    guint64 size;
+    gint64 mtime;
+} TrashDirSize;
+
+static void _trash_set_size(GHashTable *sizes, const char *name, guint64 size, gint64 mtime) {
+    TrashDirSize *ds = g_new(TrashDirSize, 1);
+    ds->size = size;
+    ds->mtime = mtime;
+    g_hash_table_replace(sizes, g_strdup(name), ds);
+}
+
+/* name → TrashDirSize */
+static GHashTable *_trash_read_sizes(const char *trash) {
+    GHashTable *sizes = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    gchar *file = g_build_filename(trash, "directorysizes", NULL);
+    gchar *contents = NULL;
+    if (g_file_get_contents(file, &contents, NULL, NULL)) {
+        char *next;
+        for (char *line = contents; line && *line; line = next) {
+            next = strchr(line, '\n');
+            if (next) *next++ = '\0';
+            char *end;
+            guint64 size = g_ascii_strtoull(line, &end, 10);
+            if (end == line || *end != ' ') continue;
+            gint64 mtime = g_ascii_strtoll(end + 1, &end, 10);
+            if (*end != ' ') continue;
+            gchar *name = g_uri_unescape_string(end + 1, NULL);
+            if (!name || !name[0] || strchr(name, '/')) {
+                g_free(name);
+                continue;
+            }
+            _trash_set_size(sizes, name, size, mtime);
+            g_free(name);
+        }
+    }
+    g_free(contents);
+    g_free(file);
+    return sizes;
+}
+
+/* Written to a temporary file and renamed over, as the spec asks */
+static void _trash_write_sizes(const char *trash, GHashTable *sizes) {
+    GString *out = g_string_new(NULL);
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, sizes);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        TrashDirSize *ds = value;
+        gchar *escaped = g_uri_escape_string(key, NULL, FALSE);
+        g_string_append_printf(out, "%" G_GUINT64_FORMAT " %" G_GINT64_FORMAT " %s\n",
+                               ds->size, ds->mtime, escaped);
+        g_free(escaped);
+    }
+    gchar *file = g_build_filename(trash, "directorysizes", NULL);
+    g_file_set_contents(file, out->str, (gssize)out->len, NULL);
+    g_free(file);
+    g_string_free(out, TRUE);
+}
+
+/* Sizes the newly trashed folder @name and records it */
+static void _trash_record_dir(const char *trash, const char *name) {
+    gchar *info = _trash_info_path(trash, name);
+    gchar *dir = g_build_filename(trash, "files", name, NULL);
+    struct stat st;
+    if (stat(info, &st) == 0) {
+        guint64 size = _trash_tree_size(dir);
+        g_mutex_lock(&trash_sizes_lock);
+        GHashTable *sizes = _trash_read_sizes(trash);
+        _trash_set_size(sizes, name, size, (gint64)st.st_mtime);
+        _trash_write_sizes(trash, sizes);
+        g_hash_table_unref(sizes);
+        g_mutex_unlock(&trash_sizes_lock);
+    }
+    g_free(dir);
+    g_free(info);
+}
+
+/* ── Trash Directories ──────────────────────────────────── */
+/* The mount point holding @path: its last parent on device @dev */
+static gchar *_trash_topdir(const char *path, dev_t dev) {
+    gchar *top = g_strdup(path);
+    while (strcmp(top, "/") != 0) {
+        gchar *parent = g_path_get_dirname(top);
+        struct stat st;
+        if (lstat(parent, &st) != 0 || st.st_dev != dev) {
+            g_free(parent);
+            break;
+        }
+        g_free(top);
+        top = parent;
+    }
+    return top;
+}
+
+/* Creates @dir when missing; it must be a real folder owned by us */
+static gboolean _trash_usable(const char *dir) {
+    struct stat st;
+    if (mkdir(dir, 0700) != 0 && errno != EEXIST) return FALSE;
+    if (lstat(dir, &st) != 0 || !S_ISDIR(st.st_mode) || st.st_uid != getuid()) return FALSE;
+    return _trash_prepare(dir);
+}
+
+/* $topdir/.Trash/$uid when the administrator made $topdir/.Trash (a
+ * sticky folder, not a symlink), else $topdir/.Trash-$uid; NULL when
+ * neither can be used */
+static gchar *_trash_topdir_trash(const char *topdir) {
+    guint uid = (guint)getuid();
+    gchar *shared = g_build_filename(topdir, ".Trash", NULL);
+    struct stat st;
+    if (lstat(shared, &st) == 0 && S_ISDIR(st.st_mode) && (st.st_mode & S_ISVTX)) {
+        gchar *dir = g_strdup_printf("%s/%u", shared, uid);
+        if (_trash_usable(dir)) {
+            g_free(shared);
+            return dir;
+        }
+        g_free(dir);
+    }
+    g_free(shared);
+
+    gchar *dir = g_strdup_printf("%s/.Trash-%u", strcmp(topdir, "/") == 0 ? "" : topdir, uid);
+    if (_trash_usable(dir)) return dir;
+    g_free(dir);
+    return NULL;
+}
+
+/* Claims a name in @trash for @path by creating its .trashinfo; NULL
+ * with errno set on failure. A topdir trash records @path relative to
+ * @topdir, the home trash records it absolute. */
+static gchar *_trash_write_info(const char *trash, const char *path, const char *topdir) {
+    const char *original = path;
+    if (topdir) {
+        original = path + strlen(topdir);
+        while (*original == '/') original++;
+    }
+    gchar *escaped = g_uri_escape_string(original, "/", FALSE);
+    GDateTime *now = g_date_time_new_now_local();
+    gchar *date = g_date_time_format(now, "%Y-%m-%dT%H:%M:%S");
+    g_date_time_unref(now);
+    gchar *contents = g_strdup_printf("[Trash Info]\nPath=%s\nDeletionDate=%s\n", escaped, date);
+    gsize len = strlen(contents);
+    g_free(escaped);
+    g_free(date);
+
+    gchar *base = g_path_get_basename(path);
+    const char *ext = strrchr(base, '.');
+    if (ext == base) ext = NULL;
+    int stem = ext ? (int)(ext - base) : (int)strlen(base);
+
+    gchar *name = NULL;
+    int err = 0;
+    for (int i = 1; !name && !err; i++) {
+        gchar *candidate = i == 1 ? g_strdup(base)
+                                  : g_strdup_printf("%.*s (%d)%s", stem, base, i, ext ? ext : "");
+        gchar *info = _trash_info_path(trash, candidate);
+        gchar *file = g_build_filename(trash, "files", candidate, NULL);
+        struct stat st;
+
+        int fd = open(info, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            if (errno != EEXIST) err = errno;
+        } else if (lstat(file, &st) == 0) {
+            /* An item without its .trashinfo; leave it be */
+            close(fd);
+            unlink(info);
+        } else {
+            gboolean ok = write(fd, contents, len) == (ssize_t)len;
+            if (!ok) err = errno ? errno : ENOSPC;
+            if (close(fd) != 0 && ok) {
+                ok = FALSE;
+                err = errno;
+            }
+            if (ok) name = g_strdup(candidate);
+            else unlink(info);
+        }
+        g_free(file);
+        g_free(info);
+        g_free(candidate);
+    }
+    g_free(base);
+    g_free(contents);
+    if (!name) errno = err;
+    return name;
+}
+
+/* ── Jobs ───────────────────────────────────────────────── */
+/* Moves @path into @trash under a name of its own; a copy only when
+ * @trash is on another filesystem */
+static void _trash_move(FileOp *op, const char *path, const struct stat *st,
+                        const char *trash, const char *topdir) {
+    gchar *name = _trash_write_info(trash, path, topdir);
+    if (!name) {
+        _fileop_fail(op, path);
+        return;
+    }
+    gchar *dest = g_build_filename(trash, "files", name, NULL);
+
+    gboolean trashed = FALSE;
+    if (_fileop_rename_noreplace(path, dest) == 0) {
+        trashed = TRUE;
+        g_mutex_lock(&op->lock);
+        op->progress.files_total++;
+        op->progress.files_done++;
+        g_mutex_unlock(&op->lock);
+    } else if (errno == EXDEV) {
+        _fileop_count(op, path);
+        guint errors = _fileop_errors(op);
+        _fileop_copy_tree(op, path, dest);
+        _fileop_wait_copiers(op);
+        /* A partial copy keeps its .trashinfo, so it shows in the trash
+         * rather than lingering there unseen */
+        trashed = TRUE;
+        if (_fileop_errors(op) == errors && !_fileop_cancelled(op))
+            _fileop_remove_moved(op, path);
+    } else {
+        _fileop_fail(op, path);
+        gchar *info = _trash_info_path(trash, name);
+        unlink(info);
+        g_free(info);
+    }
+
+    if (trashed && S_ISDIR(st->st_mode)) _trash_record_dir(trash, name);
+    g_free(dest);
+    g_free(name);
+}
+
+static void _trash_run(FileOp *op) {
+    gchar *home = trash_home();
+    gsize home_len = strlen(home);
+    struct stat home_st;
+    gboolean have_home = _trash_prepare(home) && stat(home, &home_st) == 0;
+
+    for (gchar **s = op->sources; *s && !_fileop_cancelled(op); s++) {
+        if (strncmp(*s, home, home_len) == 0 && ((*s)[home_len] == '/' || (*s)[home_len] == '\0')) {
+            _fileop_fail_with(op, *s, "it is in the trash already");
+            continue;
+        }
+        struct stat st;
+        if (lstat(*s, &st) != 0) {
+            _fileop_fail(op, *s);
+            continue;
+        }
+
+        gchar *topdir = NULL;
+        gchar *trash = NULL;
+        if (have_home && st.st_dev == home_st.st_dev) {
+            trash = g_strdup(home);
+        } else {
+            topdir = _trash_topdir(*s, st.st_dev);
+            trash = _trash_topdir_trash(topdir);
+            if (!trash) {
+                g_free(topdir);
+                topdir = NULL;
+                if (have_home) trash = g_strdup(home);
+            }
+        }
+
+        if (trash) _trash_move(op, *s, &st, trash, topdir);
+        else _fileop_fail_with(op, *s, "there is no trash to put it in");
+        g_free(trash);
+        g_free(topdir);
+    }
+    g_free(home);
+}
+
+/* Takes the items out of files/ and info/ into expunged/, so the trash
+ * is empty before anything is deleted; deletes expunged/ after. Leftovers
+ * from an interrupted earlier run go too. */
+static void _trash_run_empty(FileOp *op) {
+    gchar *trash = trash_home();
+    gchar *files = g_build_filename(trash, "files", NULL);
+    gchar *expunged = g_build_filename(trash, "expunged", NULL);
+    gboolean everything = op->sources[0] == NULL;
+
+    if (g_mkdir_with_parents(expunged, 0700) != 0) {
+        _fileop_fail(op, expunged);
+        goto out;
+    }
+
+    GPtrArray *names = g_ptr_array_new_with_free_func(g_free);
+    if (everything) {
+        DIR *dp = opendir(files);
+        struct dirent *de;
+        while (dp && (de = readdir(dp))) {
+            if (strcmp(de->d_name, ".") != 0 && strcmp(de->d_name, "..") != 0)
+                g_ptr_array_add(names, g_strdup(de->d_name));
+        }
+        if (dp) closedir(dp);
+    } else {
+        for (gchar **s = op->sources; *s; s++) g_ptr_array_add(names, g_path_get_basename(*s));
+    }
+
+    g_mutex_lock(&trash_sizes_lock);
+    GHashTable *sizes = _trash_read_sizes(trash);
+    guint serial = 0;
+    for (guint i = 0; i < names->len; i++) {
+        const char *name = names->pdata[i];
+        gchar *item = g_build_filename(files, name, NULL);
+        gchar *target = NULL;
+        int rc;
+        do {
+            g_free(target);
+            target = g_strdup_printf("%s/%u", expunged, serial++);
+            rc = _fileop_rename_noreplace(item, target);
+        } while (rc != 0 && errno == EEXIST);
+
+        if (rc == 0 || errno == ENOENT) {
+            gchar *info = _trash_info_path(trash, name);
+            unlink(info);
+            g_free(info);
+            g_hash_table_remove(sizes, name);
+        } else {
+            _fileop_fail(op, item);
+        }
+        g_free(target);
+        g_free(item);
+    }
+    if (everything) g_hash_table_remove_all(sizes);
+    _trash_write_sizes(trash, sizes);
+    g_hash_table_unref(sizes);
+    g_mutex_unlock(&trash_sizes_lock);
+    g_ptr_array_unref(names);
+
+    /* .trashinfo files whose item is gone */
+    if (everything) {
+        gchar *info_dir = g_build_filename(trash, "info", NULL);
+        DIR *dp = opendir(info_dir);
+        struct dirent *de;
+        while (dp && (de = readdir(dp))) {
+            if (g_str_has_suffix(de->d_name, ".trashinfo")) unlinkat(dirfd(dp), de->d_name, 0);
+        }
+        if (dp) closedir(dp);
+        g_free(info_dir);
+    }
+
+    DIR *dp = opendir(expunged);
+    if (!dp) {
+        _fileop_fail(op, expunged);
+        goto out;
+    }
+    GPtrArray *doomed = g_ptr_array_new_with_free_func(g_free);
+    struct dirent *de;
+    while ((de = readdir(dp))) {
+        if (strcmp(de->d_name, ".") != 0 && strcmp(de->d_name, "..") != 0)
+            g_ptr_array_add(doomed, g_build_filename(expunged, de->d_name, NULL));
+    }
+    closedir(dp);
+
+    g_mutex_lock(&op->lock);
+    op->progress.files_total = doomed->len;
+    op->progress.counting = FALSE;
+    g_mutex_unlock(&op->lock);
+    for (guint i = 0; i < doomed->len && !_fileop_cancelled(op); i++) {
+        _fileop_remove_tree(op, doomed->pdata[i], FALSE);
+        _fileop_add(op, 0, 1);
+    }
+    g_ptr_array_unref(doomed);
+
+out:
+    g_free(expunged);
+    g_free(files);
+    g_free(trash);
+}
+
+/* ── Trash Size ─────────────────────────────────────────── */
+typedef struct {
+    TrashSizeFunc func;
+    gpointer data;
+    guint64 bytes;
+    guint items;
+} TrashSizeTask;
+
+static gboolean _trash_deliver_size(gpointer data) {
+    TrashSizeTask *task = data;
+    task->func(task->bytes, task->items, task->data);
+    g_free(task);
+    return G_SOURCE_REMOVE;
+}
+
+/* Folders come from directorysizes while their entry is current; others
+ * are walked once and added, and entries for items gone are dropped */
+static gpointer _trash_size_worker(gpointer data) {
+    TrashSizeTask *task = data;
+    gchar *trash = trash_home();
+    gchar *files = g_build_filename(trash, "files", NULL);
+    GHashTable *sizes = _trash_read_sizes(trash);
+    GHashTable *found = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+
+    DIR *dp = opendir(files);
+    struct dirent *de;
+    while (dp && (de = readdir(dp))) {
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) continue;
+        struct stat st;
+        if (fstatat(dirfd(dp), de->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) continue;
+        task->items++;
+        if (!S_ISDIR(st.st_mode)) {
+            task->bytes += (guint64)st.st_blocks * 512;
+            continue;
+        }
+
+        gchar *info = _trash_info_path(trash, de->d_name);
+        struct stat info_st;
+        gint64 mtime = stat(info, &info_st) == 0 ? (gint64)info_st.st_mtime : 0;
+        g_free(info);
+        TrashDirSize *ds = g_hash_table_lookup(sizes, de->d_name);
+        if (ds && ds->mtime == mtime) {
+            task->bytes += ds->size;
+        } else {
+            gchar *path = g_build_filename(files, de->d_name, NULL);
+            guint64 size = _trash_tree_size(path);
+            g_free(path);
+            task->bytes += size;
+            _trash_set_size(found, de->d_name, size, mtime);
+        }
+        g_hash_table_remove(sizes, de->d_name);
+    }
+    if (dp) closedir(dp);
+    /* What is left in @sizes names items no longer in the trash */
+    gboolean stale = g_hash_table_size(sizes) > 0;
+
+    if (g_hash_table_size(found) > 0 || stale) {
+        g_mutex_lock(&trash_sizes_lock);
+        GHashTable *current = _trash_read_sizes(trash);
+        GHashTableIter iter;
+        gpointer key, value;
+        g_hash_table_iter_init(&iter, sizes);
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            gchar *path = g_build_filename(files, key, NULL);
+            struct stat st;
+            if (lstat(path, &st) != 0) g_hash_table_remove(current, key);
+            g_free(path);
+        }
+        g_hash_table_iter_init(&iter, found);
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            TrashDirSize *ds = value;
+            _trash_set_size(current, key, ds->size, ds->mtime);
+        }
+        _trash_write_sizes(trash, current);
+        g_hash_table_unref(current);
+        g_mutex_unlock(&trash_sizes_lock);
+    }
+
+    g_hash_table_unref(found);
+    g_hash_table_unref(sizes);
+    g_free(files);
+    g_free(trash);
+    g_idle_add(_trash_deliver_size, task);
+    return NULL;
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+/* Same contract as fileop_copy() */
+static FileOp *fileop_trash(const char *const *paths, const FileOpCallbacks *cb, gpointer data) {
+    return _fileop_queue(FILEOP_TRASH, _trash_run, paths, NULL, cb, data);
+}
+
+/* Deletes @paths, items directly in trash_files_dir(), with their
+ * .trashinfo; NULL empties the whole home trash */
+static FileOp *fileop_empty_trash(const char *const *paths, const FileOpCallbacks *cb,
+                                  gpointer data) {
+    static const char *const everything[] = { NULL };
+    return _fileop_queue(FILEOP_EMPTY_TRASH, _trash_run_empty, paths ? paths : everything,
+                         NULL, cb, data);
+}
+
+/* Calls @func on the main thread with the home trash's size in bytes and
+ * its number of items */
+static void trash_size(TrashSizeFunc func, gpointer data) {
+    TrashSizeTask *task = g_new0(TrashSizeTask, 1);
+    task->func = func;
+    task->data = data;
+    g_thread_unref(g_thread_new("trash-size", _trash_size_worker, task));
+}
+
+#endif /* BLAZENEURO_FILES_TRASH_H */
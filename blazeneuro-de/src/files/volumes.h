@@ -0,0 +1,378 @@
+/*
+ * BlazeNeuro Files — Volumes
+ * Lists the mounted filesystems worth a place in the sidebar: the root,
+ * removable media under /media and /run/media, mounts on or under /mnt
+ * or under the home folder, and network shares, each with its free
+ * space.
+ *
+ * The list follows the mount table without polling on a timer: the
+ * kernel flags /proc/self/mountinfo with POLLPRI whenever a filesystem
+ * is mounted or unmounted, and a burst of such events (a disk with
+ * three partitions) is read once, after VOLUMES_COALESCE_MSEC.
+ *
+ * Free space comes from statvfs(), cached per mount and asked again when
+ * the mount table changes or volumes_refresh() is called (after a file
+ * operation). statvfs() on a hung network mount does not return, so
+ * each call runs on a thread of its own and the main loop only ever
+ * reads the cache; a mount whose call is still out is not asked again,
+ * and shows no figure until it answers.
+ *
+ * Usage:
+ *   Volumes *vols = volumes_watch(on_changed, data);
+ *   GPtrArray *list = volumes_list(vols);     // Volume*, root first
+ *   ...
+ *   volumes_free(vols);
+ */
+
+#ifndef BLAZENEURO_FILES_VOLUMES_H
+#define BLAZENEURO_FILES_VOLUMES_H
+
+#include <gio/gio.h>
+#include <glib-unix.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/statvfs.h>
+
+#define VOLUMES_MOUNTINFO      "/proc/self/mountinfo"
+#define VOLUMES_COALESCE_MSEC  100
+#define VOLUMES_STAT_MIN_USEC  (2 * G_USEC_PER_SEC)     /* younger figures are kept */
+
+typedef struct {
+    gchar *mount_point;
+    gchar *label;
+    const char *icon;
+    gchar *fs_type;
+    gboolean network;
+    gboolean stats_known;       /* statvfs() has answered */
+    guint64 size;
+    guint64 avail;              /* to unprivileged users */
+} Volume;
+
+/* The list or a free-space figure changed; runs on the main thread */
+typedef void (*VolumesChangedFunc)(gpointer data);
+
+typedef struct {
+    gint64 stamp;               /* of the last answer */
+    gboolean busy;              /* a call is out */
+    gboolean known;
+    guint64 size;
+    guint64 avail;
+} VolumeStat;
+
+typedef struct {
+    gint ref_count;
+    gboolean closed;            /* volumes_free() was called */
+    int fd;
+    guint watch_source;
+    guint reread_source;
+    GPtrArray *volumes;         /* Volume*, as last read */
+    GHashTable *stats;          /* mount point -> VolumeStat* */
+    VolumesChangedFunc func;
+    gpointer data;
+} Volumes;
+
+typedef struct {
+    Volumes *vols;
+    gchar *mount_point;
+    gboolean ok;
+    guint64 size;
+    guint64 avail;
+} VolumeStatCall;
+
+static void _volume_free(gpointer data) {
+    Volume *v = data;
+    g_free(v->mount_point);
+    g_free(v->label);
+    g_free(v->fs_type);
+    g_free(v);
+}
+
+static Volumes *_volumes_ref(Volumes *vols) {
+    g_atomic_int_inc(&vols->ref_count);
+    return vols;
+}
+
+static void _volumes_unref(Volumes *vols) {
+    if (!g_atomic_int_dec_and_test(&vols->ref_count)) return;
+    g_ptr_array_free(vols->volumes, TRUE);
+    g_hash_table_destroy(vols->stats);
+    g_free(vols);
+}
+
+/* ── Mount table ────────────────────────────────────────── */
+static const char *const volumes_network_types[] = {
+    "nfs", "nfs4", "cifs", "smb3", "smbfs", "ncpfs", "afs", "9p", "ceph", "glusterfs",
+    "fuse.sshfs", "fuse.rclone", "fuse.s3fs", "davfs", "fuse.davfs2", NULL
+};
+
+/* Kernel and helper filesystems, never shown whatever their mount point */
+static const char *const volumes_hidden_types[] = {
+    "proc", "sysfs", "tmpfs", "devtmpfs", "devpts", "cgroup", "cgroup2", "securityfs",
+    "pstore", "debugfs", "tracefs", "configfs", "fusectl", "mqueue", "hugetlbfs", "bpf",
+    "autofs", "binfmt_misc", "efivarfs", "nsfs", "rpc_pipefs", "ramfs", "selinuxfs",
+    "squashfs", "overlay", "fuse.gvfsd-fuse", "fuse.portal", "fuse.xdg-document-portal", NULL
+};
+
+static gboolean _volumes_in(const char *const *list, const char *s) {
+    for (guint i = 0; list[i]; i++)
+        if (strcmp(list[i], s) == 0) return TRUE;
+    return FALSE;
+}
+
+/* mountinfo writes space, tab, newline and backslash as \ooo */
+static gchar *_volumes_unescape(const char *s) {
+    GString *out = g_string_sized_new(strlen(s));
+    for (; *s; s++) {
+        if (s[0] == '\\' && s[1] >= '0' && s[1] <= '3' && s[2] >= '0' && s[2] <= '7' &&
+            s[3] >= '0' && s[3] <= '7') {
+            g_string_append_c(out, (char)((s[1] - '0') << 6 | (s[2] - '0') << 3 | (s[3] - '0')));
+            s += 3;
+        } else {
+            g_string_append_c(out, *s);
+        }
+    }
+    return g_string_free(out, FALSE);
+}
+
+/* Under @dir, and no part of the rest hidden */
+static gboolean _volumes_below(const char *path, const char *dir) {
+    gsize len = strlen(dir);
+    if (strncmp(path, dir, len) != 0 || path[len] != '/' || !path[len + 1]) return FALSE;
+    return strstr(path + len, "/.") == NULL;
+}
+
+static Volume *_volumes_parse_line(const char *line, const char *user_media) {
+    /* id parent major:minor root mount-point options [optional...] - type source super */
+    gchar **f = g_strsplit(line, " ", -1);
+    guint n = g_strv_length(f), sep = 6;
+    while (sep < n && strcmp(f[sep], "-") != 0) sep++;
+    if (n < 5 || sep + 2 >= n) {
+        g_strfreev(f);
+        return NULL;
+    }
+    const char *type = f[sep + 1];
+    gchar *mount_point = _volumes_unescape(f[4]);
+    gboolean network = _volumes_in(volumes_network_types, type);
+    gboolean removable = g_str_has_prefix(mount_point, "/media/") ||
+                         _volumes_below(mount_point, user_media);
+    gboolean root = strcmp(mount_point, "/") == 0;
+    gboolean shown = root ||
+                     (!_volumes_in(volumes_hidden_types, type) &&
+                      (removable || network || strcmp(mount_point, "/mnt") == 0 ||
+                       _volumes_below(mount_point, "/mnt") ||
+                       _volumes_below(mount_point, g_get_home_dir())));
+    if (!shown) {
+        g_free(mount_point);
+        g_strfreev(f);
+        return NULL;
+    }
+
+    Volume *v = g_new0(Volume, 1);
+    v->mount_point = mount_point;
+    v->label = root ? g_strdup("Root") : g_filename_display_basename(mount_point);
+    v->icon = root ? "drive-harddisk" : network ? "folder-remote"
+                   : removable ? "drive-removable-media" : "drive-harddisk";
+    v->fs_type = g_strdup(type);
+    v->network = network;
+    g_strfreev(f);
+    return v;
+}
+
+static gint _volumes_compare(gconstpointer a, gconstpointer b) {
+    const Volume *va = *(Volume *const *)a, *vb = *(Volume *const *)b;
+    gboolean ra = strcmp(va->mount_point, "/") == 0, rb = strcmp(vb->mount_point, "/") == 0;
+    if (ra != rb) return ra ? -1 : 1;
+    return g_utf8_collate(va->label, vb->label);
+}
+
+/* Reads the table through the watched fd; a mount point listed twice
+ * (mounted over) counts once, as the mount on top */
+static GPtrArray *_volumes_read(int fd) {
+    GString *text = g_string_new(NULL);
+    char buf[16 * 1024];
+    if (lseek(fd, 0, SEEK_SET) == 0) {
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0 || (n < 0 && errno == EINTR))
+            if (n > 0) g_string_append_len(text, buf, n);
+    }
+
+    gchar *user_media = g_build_filename("/run/media", g_get_user_name(), NULL);
+    GHashTable *seen = g_hash_table_new(g_str_hash, g_str_equal);     /* mount point -> Volume* */
+    GPtrArray *list = g_ptr_array_new_with_free_func(_volume_free);
+    gchar **lines = g_strsplit(text->str, "\n", -1);
+    for (guint i = 0; lines[i]; i++) {
+        Volume *v = lines[i][0] ? _volumes_parse_line(lines[i], user_media) : NULL;
+        if (!v) continue;
+        Volume *old = g_hash_table_lookup(seen, v->mount_point);
+        if (old) g_ptr_array_remove(list, old);
+        g_hash_table_insert(seen, v->mount_point, v);
+        g_ptr_array_add(list, v);
+    }
+    g_strfreev(lines);
+    g_hash_table_destroy(seen);
+    g_free(user_media);
+    g_string_free(text, TRUE);
+    g_ptr_array_sort(list, _volumes_compare);
+    return list;
+}
+
+/* ── Free space ─────────────────────────────────────────── */
+static gboolean _volumes_stat_done(gpointer data) {
+    VolumeStatCall *call = data;
+    Volumes *vols = call->vols;
+    VolumeStat *st = g_hash_table_lookup(vols->stats, call->mount_point);
+    if (st) {
+        st->busy = FALSE;
+        st->stamp = g_get_monotonic_time();
+        st->known = call->ok;
+        st->size = call->size;
+        st->avail = call->avail;
+    }
+    if (!vols->closed && st) vols->func(vols->data);
+    return G_SOURCE_REMOVE;
+}
+
+static void _volumes_stat_call_free(gpointer data) {
+    VolumeStatCall *call = data;
+    _volumes_unref(call->vols);
+    g_free(call->mount_point);
+    g_free(call);
+}
+
+static gpointer _volumes_stat_thread(gpointer data) {
+    VolumeStatCall *call = data;
+    struct statvfs sv;
+    call->ok = statvfs(call->mount_point, &sv) == 0;
+    if (call->ok) {
+        call->size = (guint64)sv.f_blocks * sv.f_frsize;
+        call->avail = (guint64)sv.f_bavail * sv.f_frsize;
+    }
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, _volumes_stat_done, call, _volumes_stat_call_free);
+    return NULL;
+}
+
+/* Asks every listed mount whose figures are older than
+ * VOLUMES_STAT_MIN_USEC, or all of them with @force */
+static void _volumes_stat_all(Volumes *vols, gboolean force) {
+    gint64 now = g_get_monotonic_time();
+    for (guint i = 0; i < vols->volumes->len; i++) {
+        Volume *v = g_ptr_array_index(vols->volumes, i);
+        VolumeStat *st = g_hash_table_lookup(vols->stats, v->mount_point);
+        if (!st) {
+            st = g_new0(VolumeStat, 1);
+            g_hash_table_insert(vols->stats, g_strdup(v->mount_point), st);
+        }
+        if (st->busy || (!force && st->stamp && now - st->stamp < VOLUMES_STAT_MIN_USEC))
+            continue;
+        st->busy = TRUE;
+        VolumeStatCall *call = g_new0(VolumeStatCall, 1);
+        call->vols = _volumes_ref(vols);
+        call->mount_point = g_strdup(v->mount_point);
+        g_thread_unref(g_thread_new("files-statvfs", _volumes_stat_thread, call));
+    }
+}
+
+/* ── Watch ──────────────────────────────────────────────── */
+static gboolean _volumes_reread(gpointer data) {
+    Volumes *vols = data;
+    vols->reread_source = 0;
+    g_ptr_array_free(vols->volumes, TRUE);
+    vols->volumes = _volumes_read(vols->fd);
+
+    /* Figures of mounts gone are dropped, unless a call is still out */
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, vols->stats);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        gboolean listed = FALSE;
+        for (guint i = 0; i < vols->volumes->len && !listed; i++)
+            listed = strcmp(((Volume *)g_ptr_array_index(vols->volumes, i))->mount_point, key) == 0;
+        if (!listed && !((VolumeStat *)value)->busy) g_hash_table_iter_remove(&iter);
+    }
+    _volumes_stat_all(vols, TRUE);
+    vols->func(vols->data);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean _volumes_on_event(gint fd, GIOCondition condition, gpointer data) {
+    (void)fd; (void)condition;
+    Volumes *vols = data;
+    if (!vols->reread_source)
+        vols->reread_source = g_timeout_add(VOLUMES_COALESCE_MSEC, _volumes_reread, vols);
+    return G_SOURCE_CONTINUE;
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+/* @func runs whenever volumes_list() would answer differently */
+static Volumes *volumes_watch(VolumesChangedFunc func, gpointer data) {
+    Volumes *vols = g_new0(Volumes, 1);
+    vols->ref_count = 1;
+    vols->func = func;
+    vols->data = data;
+    vols->stats = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    vols->fd = open(VOLUMES_MOUNTINFO, O_RDONLY | O_CLOEXEC);
+    vols->volumes = vols->fd >= 0 ? _volumes_read(vols->fd)
+                                  : g_ptr_array_new_with_free_func(_volume_free);
+    if (vols->fd >= 0)
+        vols->watch_source = g_unix_fd_add(vols->fd, G_IO_PRI | G_IO_ERR, _volumes_on_event, vols);
+    _volumes_stat_all(vols, TRUE);
+    return vols;
+}
+
+/* The volumes, root first, then by name; free with g_ptr_array_free() */
+static GPtrArray *volumes_list(Volumes *vols) {
+    GPtrArray *list = g_ptr_array_new_with_free_func(_volume_free);
+    for (guint i = 0; i < vols->volumes->len; i++) {
+        const Volume *src = g_ptr_array_index(vols->volumes, i);
+        Volume *v = g_new(Volume, 1);
+        *v = *src;
+        v->mount_point = g_strdup(src->mount_point);
+        v->label = g_strdup(src->label);
+        v->fs_type = g_strdup(src->fs_type);
+        VolumeStat *st = g_hash_table_lookup(vols->stats, v->mount_point);
+        v->stats_known = st && st->known;
+        v->size = v->stats_known ? st->size : 0;
+        v->avail = v->stats_known ? st->avail : 0;
+        g_ptr_array_add(list, v);
+    }
+    return list;
+}
+
+/* TRUE if @path lies on a network share: the listed volume with the
+ * longest mount point at or above it is one. Reads only the last mount
+ * table, never the path itself. */
+static gboolean volumes_on_network(Volumes *vols, const char *path) {
+    const Volume *best = NULL;
+    gsize best_len = 0;
+    for (guint i = 0; vols && i < vols->volumes->len; i++) {
+        const Volume *v = g_ptr_array_index(vols->volumes, i);
+        gsize len = strlen(v->mount_point);
+        gboolean above = strcmp(v->mount_point, "/") == 0 ||
+                         (strncmp(path, v->mount_point, len) == 0 &&
+                          (path[len] == '/' || path[len] == '\0'));
+        if (above && (!best || len > best_len)) {
+            best = v;
+            best_len = len;
+        }
+    }
+    return best && best->network;
+}
+
+/* Free space may have changed (files were written or deleted) */
+static void volumes_refresh(Volumes *vols) {
+    if (vols) _volumes_stat_all(vols, FALSE);
+}
+
+/* Stops watching; calls still out finish on their own. NULL is ignored. */
+static void volumes_free(Volumes *vols) {
+    if (!vols) return;
+    vols->closed = TRUE;
+    if (vols->watch_source) g_source_remove(vols->watch_source);
+    if (vols->reread_source) g_source_remove(vols->reread_source);
+    if (vols->fd >= 0) close(vols->fd);
+    _volumes_unref(vols);
+}
+
+#endif /* BLAZENEURO_FILES_VOLUMES_H */
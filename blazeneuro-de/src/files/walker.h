@@ -0,0 +1,500 @@
+/*
+ * BlazeNeuro Files — Recursive Search Walker
+ * Walks a subtree on a pool of threads and streams the entries whose
+ * name contains the query back to the main loop, using the same batch
+ * callbacks as the directory loader.
+ *
+ * The pool (WalkPool) is shared with the disk usage, duplicate and text
+ * scanners. Each thread owns a deque of work: it takes its newest (depth
+ * first, so the directory it just read is still hot) and, when it runs
+ * dry, steals the oldest work of another thread, which tends to be the
+ * largest unexplored subtree. A thread with nothing to take sleeps until
+ * work is pushed, the walk ends or its cancellable fires.
+ *
+ * Directories are read with getdents64 relative to one root fd; only
+ * DT_UNKNOWN entries cost a stat. The walk stays on the root's
+ * filesystem, does not follow symlinks, and skips dotfiles and names
+ * listed in a folder's .hidden unless hidden files are shown.
+ *
+ * Usage:
+ *   Walk *walk = walk_start(root, query, show_hidden, on_batch, on_done, data);
+ *   ...
+ *   walk_cancel(walk);      // next keystroke: no further callbacks
+ *
+ *   walk_pool_init(&pool, max_threads, "name", cancellable, work, idle, g_free, data);
+ *   walk_pool_run(&pool, first);        // blocks; work() may walk_pool_push()
+ *   walk_pool_clear(&pool);
+ */
+
+#ifndef BLAZENEURO_FILES_WALKER_H
+#define BLAZENEURO_FILES_WALKER_H
+
+#include <gio/gio.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "dirload.h"
+#include "filetype.h"
+
+#define WALK_MAX_WORKERS   8
+#define WALK_BATCH         256
+#define WALK_FLUSH_USEC    (50 * 1000)
+#define WALK_MAX_RESULTS   200000
+#define WALK_DENTS_BUF     (64 * 1024)
+
+struct walk_dirent64 {
+    guint64 d_ino;
+    gint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+typedef struct {
+    GMutex lock;
+    GQueue items;           /* head = newest */
+} WalkDeque;
+
+/* ── Work pool ──────────────────────────────────────────── */
+/* Runs on pool thread @worker (0 to n_workers - 1) for each item */
+typedef void (*WalkPoolFunc)(guint worker, gpointer item, gpointer data);
+/* Runs on pool thread @worker before it sleeps for want of work */
+typedef void (*WalkPoolIdleFunc)(guint worker, gpointer data);
+
+typedef struct {
+    const char *name;       /* of the threads */
+    guint n_workers;
+    WalkDeque *deques;
+    gint outstanding;       /* items queued or being worked on */
+    gint stopped;
+    GMutex idle_lock;       /* pushes; sleepers wait on idle_cond */
+    GCond idle_cond;
+    guint pushes;
+    GCancellable *cancellable;  /* the owner's; stops the pool when it fires */
+    WalkPoolFunc func;
+    WalkPoolIdleFunc idle;  /* may be NULL */
+    GDestroyNotify item_free;   /* after func, and for items left when stopped */
+    gpointer data;
+} WalkPool;
+
+typedef struct {
+    WalkPool *pool;
+    guint index;
+} WalkPoolThread;
+
+static void walk_pool_init(WalkPool *pool, guint max_workers, const char *name,
+                           GCancellable *cancellable, WalkPoolFunc func,
+                           WalkPoolIdleFunc idle, GDestroyNotify item_free, gpointer data) {
+    memset(pool, 0, sizeof(*pool));
+    pool->name = name;
+    pool->n_workers = CLAMP(g_get_num_processors(), 2, max_workers);
+    pool->deques = g_new0(WalkDeque, pool->n_workers);
+    for (guint i = 0; i < pool->n_workers; i++) {
+        g_mutex_init(&pool->deques[i].lock);
+        g_queue_init(&pool->deques[i].items);
+    }
+    g_mutex_init(&pool->idle_lock);
+    g_cond_init(&pool->idle_cond);
+    pool->cancellable = cancellable;
+    pool->func = func;
+    pool->idle = idle;
+    pool->item_free = item_free;
+    pool->data = data;
+}
+
+static void walk_pool_clear(WalkPool *pool) {
+    for (guint i = 0; i < pool->n_workers; i++) {
+        g_queue_clear_full(&pool->deques[i].items, pool->item_free);
+        g_mutex_clear(&pool->deques[i].lock);
+    }
+    g_free(pool->deques);
+    g_mutex_clear(&pool->idle_lock);
+    g_cond_clear(&pool->idle_cond);
+}
+
+static void _walk_pool_wake(WalkPool *pool, gboolean all) {
+    g_mutex_lock(&pool->idle_lock);
+    if (all) g_cond_broadcast(&pool->idle_cond);
+    else g_cond_signal(&pool->idle_cond);
+    g_mutex_unlock(&pool->idle_lock);
+}
+
+/* Queues @item on @worker's own deque; from pool threads only */
+static void walk_pool_push(WalkPool *pool, guint worker, gpointer item) {
+    WalkDeque *dq = &pool->deques[worker];
+    g_atomic_int_inc(&pool->outstanding);
+    g_mutex_lock(&dq->lock);
+    g_queue_push_head(&dq->items, item);
+    g_mutex_unlock(&dq->lock);
+
+    g_mutex_lock(&pool->idle_lock);
+    pool->pushes++;
+    g_cond_signal(&pool->idle_cond);
+    g_mutex_unlock(&pool->idle_lock);
+}
+
+/* Ends the walk: threads finish the item in hand and take no more */
+static void walk_pool_stop(WalkPool *pool) {
+    g_atomic_int_set(&pool->stopped, TRUE);
+    _walk_pool_wake(pool, TRUE);
+}
+
+static gboolean walk_pool_stopped(WalkPool *pool) {
+    return g_atomic_int_get(&pool->stopped);
+}
+
+static void _walk_pool_cancelled(GCancellable *cancellable, gpointer data) {
+    (void)cancellable;
+    walk_pool_stop(data);
+}
+
+static gpointer _walk_pool_take(WalkPool *pool, guint worker) {
+    WalkDeque *own = &pool->deques[worker];
+    g_mutex_lock(&own->lock);
+    gpointer item = g_queue_pop_head(&own->items);
+    g_mutex_unlock(&own->lock);
+
+    for (guint i = 1; i < pool->n_workers && !item; i++) {
+        WalkDeque *victim = &pool->deques[(worker + i) % pool->n_workers];
+        g_mutex_lock(&victim->lock);
+        item = g_queue_pop_tail(&victim->items);
+        g_mutex_unlock(&victim->lock);
+    }
+    return item;
+}
+
+/* The next item for @worker, sleeping while others may still push one;
+ * NULL once the walk is over or stopped */
+static gpointer _walk_pool_next(WalkPool *pool, guint worker) {
+    while (!walk_pool_stopped(pool)) {
+        gpointer item = _walk_pool_take(pool, worker);
+        if (item) return item;
+        if (pool->idle) pool->idle(worker, pool->data);
+
+        /* A push after this read is seen below; one before it is in a
+         * deque for the second take */
+        g_mutex_lock(&pool->idle_lock);
+        guint seen = pool->pushes;
+        g_mutex_unlock(&pool->idle_lock);
+        if ((item = _walk_pool_take(pool, worker))) return item;
+
+        g_mutex_lock(&pool->idle_lock);
+        while (pool->pushes == seen && !walk_pool_stopped(pool) &&
+               g_atomic_int_get(&pool->outstanding) > 0)
+            g_cond_wait(&pool->idle_cond, &pool->idle_lock);
+        gboolean over = g_atomic_int_get(&pool->outstanding) == 0;
+        g_mutex_unlock(&pool->idle_lock);
+        if (over) break;
+    }
+    return NULL;
+}
+
+static gpointer _walk_pool_thread(gpointer data) {
+    WalkPoolThread *t = data;
+    WalkPool *pool = t->pool;
+    gpointer item;
+    while ((item = _walk_pool_next(pool, t->index))) {
+        pool->func(t->index, item, pool->data);
+        if (pool->item_free) pool->item_free(item);
+        if (g_atomic_int_dec_and_test(&pool->outstanding)) _walk_pool_wake(pool, TRUE);
+    }
+    return NULL;
+}
+
+/* Works through @first and everything pushed after it; returns once the
+ * queue is empty and every thread idle, or the pool was stopped */
+static void walk_pool_run(WalkPool *pool, gpointer first) {
+    /* The first item goes to thread 0; the rest start by stealing */
+    pool->outstanding = 1;
+    g_queue_push_head(&pool->deques[0].items, first);
+    gulong cancel_id = pool->cancellable
+        ? g_cancellable_connect(pool->cancellable, G_CALLBACK(_walk_pool_cancelled), pool, NULL)
+        : 0;
+
+    WalkPoolThread *threads = g_new(WalkPoolThread, pool->n_workers);
+    GThread **handles = g_new(GThread *, pool->n_workers);
+    for (guint i = 0; i < pool->n_workers; i++) {
+        threads[i].pool = pool;
+        threads[i].index = i;
+        handles[i] = g_thread_new(pool->name, _walk_pool_thread, &threads[i]);
+    }
+    for (guint i = 0; i < pool->n_workers; i++) g_thread_join(handles[i]);
+    g_free(handles);
+    g_free(threads);
+    if (cancel_id) g_cancellable_disconnect(pool->cancellable, cancel_id);
+}
+
+/* ── Search walk ────────────────────────────────────────── */
+typedef struct {
+    GArray *results;        /* DirEntry */
+    gint64 last_post;
+    char *dents;
+} WalkWorker;
+
+typedef struct {
+    gint ref_count;
+    int root_fd;
+    dev_t root_dev;
+    gchar *query;           /* casefolded */
+    gboolean query_ascii;
+    gboolean show_hidden;
+    GCancellable *cancellable;
+
+    WalkPool pool;
+    WalkWorker *workers;    /* one per pool thread */
+    gint n_results;         /* WALK_MAX_RESULTS ends the walk, not the delivery */
+
+    DirLoadBatchFunc batch_func;
+    DirLoadDoneFunc done_func;
+    gpointer data;
+} Walk;
+
+typedef struct {
+    Walk *walk;
+    GArray *entries;        /* DirEntry; NULL for the final notice */
+} WalkBatch;
+
+static Walk *walk_ref(Walk *walk) {
+    g_atomic_int_inc(&walk->ref_count);
+    return walk;
+}
+
+static void walk_unref(Walk *walk) {
+    if (!g_atomic_int_dec_and_test(&walk->ref_count)) return;
+    for (guint i = 0; i < walk->pool.n_workers; i++) {
+        g_array_free(walk->workers[i].results, TRUE);
+        g_free(walk->workers[i].dents);
+    }
+    g_free(walk->workers);
+    walk_pool_clear(&walk->pool);
+    if (walk->root_fd >= 0) close(walk->root_fd);
+    g_object_unref(walk->cancellable);
+    g_free(walk->query);
+    g_free(walk);
+}
+
+/* ── Main-thread delivery ──────────────────────────────── */
+static void _walk_batch_free(gpointer data) {
+    WalkBatch *batch = data;
+    if (batch->entries) {
+        for (guint i = 0; i < batch->entries->len; i++) {
+            DirEntry *e = &g_array_index(batch->entries, DirEntry, i);
+            g_free(e->name);
+            g_free(e->key);
+        }
+        g_array_free(batch->entries, TRUE);
+    }
+    walk_unref(batch->walk);
+    g_free(batch);
+}
+
+static gboolean _walk_stopped(Walk *walk) {
+    return g_cancellable_is_cancelled(walk->cancellable) ||
+           g_atomic_int_get(&walk->n_results) >= WALK_MAX_RESULTS;
+}
+
+static gboolean _walk_deliver(gpointer data) {
+    WalkBatch *batch = data;
+    Walk *walk = batch->walk;
+    if (g_cancellable_is_cancelled(walk->cancellable)) return G_SOURCE_REMOVE;
+
+    if (batch->entries)
+        walk->batch_func((const DirEntry *)batch->entries->data, batch->entries->len, walk->data);
+    else if (walk->done_func)
+        walk->done_func(TRUE, walk->data);
+    return G_SOURCE_REMOVE;
+}
+
+/* Same priority for batches and the final notice, so it arrives last */
+static void _walk_post(Walk *walk, GArray *entries) {
+    WalkBatch *batch = g_new(WalkBatch, 1);
+    batch->walk = walk_ref(walk);
+    batch->entries = entries;
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, _walk_deliver, batch, _walk_batch_free);
+}
+
+static void _walk_flush(Walk *walk, WalkWorker *w) {
+    if (w->results->len == 0) return;
+    _walk_post(walk, w->results);
+    w->results = g_array_new(FALSE, FALSE, sizeof(DirEntry));
+    w->last_post = g_get_monotonic_time();
+}
+
+/* ── Matching ───────────────────────────────────────────── */
+static gboolean _walk_match(Walk *walk, const char *name) {
+    if (walk->query_ascii) return strcasestr(name, walk->query) != NULL;
+    gchar *folded = g_utf8_casefold(name, -1);
+    gboolean hit = strstr(folded, walk->query) != NULL;
+    g_free(folded);
+    return hit;
+}
+
+/* Names listed in the folder's .hidden file (Nautilus convention) */
+static GHashTable *_walk_read_hidden(int dfd) {
+    int fd = openat(dfd, ".hidden", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+    char buf[16 * 1024];
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0) return NULL;
+    buf[n] = '\0';
+
+    GHashTable *set = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    gchar **lines = g_strsplit(buf, "\n", -1);
+    for (guint i = 0; lines[i]; i++)
+        if (lines[i][0]) g_hash_table_add(set, g_strdup(lines[i]));
+    g_strfreev(lines);
+    return set;
+}
+
+/* ── Worker ─────────────────────────────────────────────── */
+static void _walk_dir(guint worker, gpointer item, gpointer data) {
+    Walk *walk = data;
+    WalkWorker *w = &walk->workers[worker];
+    const char *rel = item;
+    int fd = openat(walk->root_fd, rel[0] ? rel : ".",
+                    O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_dev != walk->root_dev) {
+        close(fd);
+        return;
+    }
+    GHashTable *hidden = walk->show_hidden ? NULL : _walk_read_hidden(fd);
+
+    size_t rel_len = strlen(rel);
+    char child[PATH_MAX];
+    if (rel_len + 2 >= sizeof(child)) {
+        close(fd);
+        return;
+    }
+    memcpy(child, rel, rel_len);
+    size_t base = rel_len ? rel_len + 1 : 0;
+    if (rel_len) child[rel_len] = '/';
+
+    long n;
+    while (!_walk_stopped(walk) &&
+           (n = syscall(SYS_getdents64, fd, w->dents, WALK_DENTS_BUF)) > 0) {
+        for (long off = 0; off < n;) {
+            struct walk_dirent64 *de = (struct walk_dirent64 *)(w->dents + off);
+            off += de->d_reclen;
+            const char *name = de->d_name;
+            if (name[0] == '.' &&
+                (!walk->show_hidden || name[1] == '\0' ||
+                 (name[1] == '.' && name[2] == '\0')))
+                continue;
+            if (hidden && g_hash_table_contains(hidden, name)) continue;
+
+            size_t len = strlen(name);
+            if (base + len >= sizeof(child)) continue;
+            memcpy(child + base, name, len + 1);
+
+            unsigned char type = de->d_type;
+            if (type == DT_UNKNOWN) {
+                struct stat cst;
+                if (fstatat(fd, name, &cst, AT_SYMLINK_NOFOLLOW) == 0)
+                    type = S_ISDIR(cst.st_mode) ? DT_DIR : DT_REG;
+            }
+            gboolean is_dir = type == DT_DIR;
+
+            if (_walk_match(walk, name)) {
+                DirEntry e = { 0 };
+                e.name = g_strdup(child);
+                e.base = (guint)base;
+                e.key = files_collate_key(name);
+                e.is_dir = is_dir;
+                e.type_known = TRUE;
+                if (is_dir) {
+                    e.kind = FT_KIND_FOLDER;
+                } else {
+                    e.kind = filetype_lookup(name);
+                    if (e.kind == FT_KIND_UNKNOWN) e.kind = FT_KIND_FILE;
+                }
+                e.icon = filetype_icons[e.kind];
+                g_array_append_val(w->results, e);
+
+                if (g_atomic_int_add(&walk->n_results, 1) + 1 >= WALK_MAX_RESULTS) {
+                    walk_pool_stop(&walk->pool);
+                    break;
+                }
+                if (w->results->len >= WALK_BATCH) _walk_flush(walk, w);
+            }
+            if (is_dir) walk_pool_push(&walk->pool, worker, g_strdup(child));
+        }
+        /* Checked per buffer, not per match, so rare matches in a big
+         * tree still go out while the walk goes on */
+        if (w->results->len > 0 &&
+            g_get_monotonic_time() - w->last_post > WALK_FLUSH_USEC)
+            _walk_flush(walk, w);
+    }
+
+    if (hidden) g_hash_table_destroy(hidden);
+    close(fd);
+}
+
+/* Out of work for now: what was found goes out before sleeping */
+static void _walk_idle(guint worker, gpointer data) {
+    Walk *walk = data;
+    _walk_flush(walk, &walk->workers[worker]);
+}
+
+static gpointer _walk_run(gpointer data) {
+    Walk *walk = data;
+    walk_pool_run(&walk->pool, g_strdup(""));
+    for (guint i = 0; i < walk->pool.n_workers; i++) _walk_flush(walk, &walk->workers[i]);
+    _walk_post(walk, NULL);
+    walk_unref(walk);
+    return NULL;
+}
+
+/* ── Public API ─────────────────────────────────────────── */
+static Walk *walk_start(const char *root, const char *query, gboolean show_hidden,
+                        DirLoadBatchFunc batch_func, DirLoadDoneFunc done_func,
+                        gpointer data) {
+    Walk *walk = g_new0(Walk, 1);
+    walk->ref_count = 1;
+    walk->cancellable = g_cancellable_new();
+    walk->query = g_utf8_casefold(query, -1);
+    walk->query_ascii = g_str_is_ascii(walk->query);
+    walk->show_hidden = show_hidden;
+    walk->batch_func = batch_func;
+    walk->done_func = done_func;
+    walk->data = data;
+
+    walk_pool_init(&walk->pool, WALK_MAX_WORKERS, "walk", walk->cancellable,
+                   _walk_dir, _walk_idle, g_free, walk);
+    walk->workers = g_new0(WalkWorker, walk->pool.n_workers);
+    for (guint i = 0; i < walk->pool.n_workers; i++) {
+        walk->workers[i].results = g_array_new(FALSE, FALSE, sizeof(DirEntry));
+        walk->workers[i].last_post = g_get_monotonic_time();
+    }
+
+    struct stat st;
+    walk->root_fd = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (walk->root_fd < 0 || fstat(walk->root_fd, &st) != 0) {
+        _walk_post(walk, NULL);
+        return walk;
+    }
+    walk->root_dev = st.st_dev;
+
+    for (guint i = 0; i < walk->pool.n_workers; i++)
+        walk->workers[i].dents = g_malloc(WALK_DENTS_BUF);
+    g_thread_unref(g_thread_new("walk-run", _walk_run, walk_ref(walk)));
+    return walk;
+}
+
+/* Stops every worker at its next entry and drops batches still queued */
+static void walk_cancel(Walk *walk) {
+    if (!walk) return;
+    g_cancellable_cancel(walk->cancellable);
+    walk_unref(walk);
+}
+
+#endif /* BLAZENEURO_FILES_WALKER_H */
@@ -0,0 +1,414 @@
+/*
+ * BlazeNeuro Indexer
+ * Background service keeping the path index of $HOME (see
+ * src/common/pathindex.h) current for Files and the Launcher.
+ *
+ * $HOME is read once at startup; after that inotify events mark the
+ * folder they happened in, and marked folders are read again after a
+ * short pause. The index file is rewritten once changes settle. Folders
+ * left unwatched (inotify watch limit) and events lost to a queue
+ * overflow are caught by a full pass every 30 minutes.
+ *
+ * Like Files, it leaves out dotfiles, names listed in a folder's .hidden
+ * file and other filesystems mounted below $HOME. It runs at idle CPU
+ * and I/O priority; a second instance exits at once.
+ */
+
+#define _GNU_SOURCE
+
+#include <glib.h>
+#include <glib-unix.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/inotify.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "../common/applet.h"
+#include "../common/pathindex.h"
+
+#define RESCAN_DELAY_MSEC   1000        /* after the last event in a folder */
+#define WRITE_DELAY_SEC     2           /* after the last change */
+#define RECONCILE_SEC       (30 * 60)
+#define WATCH_MASK          (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | \
+                             IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | \
+                             IN_DONT_FOLLOW | IN_EXCL_UNLINK)
+
+/* ── State ──────────────────────────────────────────────── */
+typedef struct {
+    gchar *path;            /* relative to $HOME, "" for $HOME itself */
+    int wd;                 /* -1 while not watched */
+    GHashTable *children;   /* name -> GINT_TO_POINTER(is_dir) */
+} IdxDir;
+
+static gchar *home;
+static int home_fd = -1;
+static dev_t home_dev;
+static int inotify_fd = -1;
+static gchar *index_file;
+
+static GHashTable *dirs;            /* path -> IdxDir* */
+static GHashTable *dirs_by_wd;      /* wd -> IdxDir* */
+static GHashTable *dirty;           /* paths of folders to read again */
+static guint rescan_source = 0;
+static guint write_source = 0;
+static guint overflow_source = 0;
+static gboolean watch_limit = FALSE;
+static gint64 last_walk = 0;
+static GMainLoop *loop;
+
+static void schedule_write(void);
+
+static gchar *child_path(const char *dir, const char *name) {
+    return dir[0] ? g_strconcat(dir, "/", name, NULL) : g_strdup(name);
+}
+
+static void free_dir(gpointer data) {
+    IdxDir *d = data;
+    g_hash_table_destroy(d->children);
+    g_free(d->path);
+    g_free(d);
+}
+
+/* ── Watches ────────────────────────────────────────────── */
+static void watch_dir(IdxDir *d) {
+    if (d->wd >= 0 || watch_limit) return;
+    gchar *abs = d->path[0] ? g_build_filename(home, d->path, NULL) : g_strdup(home);
+    int wd = inotify_add_watch(inotify_fd, abs, WATCH_MASK);
+    g_free(abs);
+    if (wd < 0) {
+        if (errno == ENOSPC) {
+            watch_limit = TRUE;
+            g_warning("indexer: out of inotify watches; relying on periodic passes");
+        }
+        return;
+    }
+
+    /* A folder moved within $HOME keeps its watch; take it over from
+     * the entry for its old path */
+    IdxDir *prev = g_hash_table_lookup(dirs_by_wd, GINT_TO_POINTER(wd));
+    if (prev) prev->wd = -1;
+    d->wd = wd;
+    g_hash_table_insert(dirs_by_wd, GINT_TO_POINTER(wd), d);
+}
+
+static void unwatch_dir(IdxDir *d) {
+    if (d->wd < 0) return;
+    if (g_hash_table_lookup(dirs_by_wd, GINT_TO_POINTER(d->wd)) == d) {
+        g_hash_table_remove(dirs_by_wd, GINT_TO_POINTER(d->wd));
+        inotify_rm_watch(inotify_fd, d->wd);
+    }
+    d->wd = -1;
+}
+
+/* ── Scanning ───────────────────────────────────────────── */
+/* Forgets @path and every folder below it */
+static void drop_dir(const char *path) {
+    IdxDir *d = g_hash_table_lookup(dirs, path);
+    if (!d) return;
+
+    GHashTableIter it;
+    gpointer name, is_dir;
+    g_hash_table_iter_init(&it, d->children);
+    while (g_hash_table_iter_next(&it, &name, &is_dir)) {
+        if (!GPOINTER_TO_INT(is_dir)) continue;
+        gchar *child = child_path(path, name);
+        drop_dir(child);
+        g_free(child);
+    }
+    unwatch_dir(d);
+    g_hash_table_remove(dirs, d->path);
+    schedule_write();
+}
+
+static GHashTable *read_hidden(int dfd) {
+    int fd = openat(dfd, ".hidden", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+    char buf[8192];
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0) return NULL;
+    buf[n] = '\0';
+
+    GHashTable *names = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    gchar **lines = g_strsplit(buf, "\n", -1);
+    for (gchar **l = lines; *l; l++)
+        if (**l) g_hash_table_add(names, g_strdup(*l));
+    g_strfreev(lines);
+    return names;
+}
+
+/* Reads the folder @path again and brings its entry up to date. New
+ * subfolders are read too; with @deep, so is every known one. */
+static void scan_dir(const char *path, gboolean deep) {
+    int fd = openat(home_fd, path[0] ? path : ".",
+                    O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    struct stat st;
+    if (fd >= 0 && (fstat(fd, &st) != 0 || st.st_dev != home_dev)) {
+        close(fd);
+        fd = -1;
+    }
+    if (fd < 0) {
+        drop_dir(path);
+        return;
+    }
+    DIR *dp = fdopendir(fd);
+    if (!dp) {
+        close(fd);
+        return;
+    }
+
+    IdxDir *d = g_hash_table_lookup(dirs, path);
+    if (!d) {
+        d = g_new0(IdxDir, 1);
+        d->path = g_strdup(path);
+        d->wd = -1;
+        d->children = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+        g_hash_table_insert(dirs, d->path, d);
+    }
+    /* Watch before reading, so nothing created in between is missed */
+    watch_dir(d);
+
+    GHashTable *hidden = read_hidden(dirfd(dp));
+    GHashTable *old = d->children;
+    d->children = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    gboolean changed = FALSE;
+
+    struct dirent *de;
+    while ((de = readdir(dp))) {
+        if (de->d_name[0] == '.') continue;
+        if (hidden && g_hash_table_contains(hidden, de->d_name)) continue;
+
+        gboolean is_dir = de->d_type == DT_DIR;
+        if (de->d_type == DT_UNKNOWN &&
+            fstatat(dirfd(dp), de->d_name, &st, AT_SYMLINK_NOFOLLOW) == 0)
+            is_dir = S_ISDIR(st.st_mode);
+        g_hash_table_insert(d->children, g_strdup(de->d_name), GINT_TO_POINTER(is_dir));
+
+        gpointer was;
+        gboolean known = g_hash_table_lookup_extended(old, de->d_name, NULL, &was);
+        if (!known || GPOINTER_TO_INT(was) != is_dir) changed = TRUE;
+        if (known && GPOINTER_TO_INT(was) && !is_dir) {
+            gchar *child = child_path(path, de->d_name);
+            drop_dir(child);
+            g_free(child);
+        }
+        if (known) g_hash_table_remove(old, de->d_name);
+    }
+    closedir(dp);
+    if (hidden) g_hash_table_destroy(hidden);
+
+    /* What is left in @old is gone */
+    GHashTableIter it;
+    gpointer name, is_dir;
+    g_hash_table_iter_init(&it, old);
+    while (g_hash_table_iter_next(&it, &name, &is_dir)) {
+        changed = TRUE;
+        if (!GPOINTER_TO_INT(is_dir)) continue;
+        gchar *child = child_path(path, name);
+        drop_dir(child);
+        g_free(child);
+    }
+    g_hash_table_destroy(old);
+    if (changed) schedule_write();
+
+    /* Subfolders to read: new ones, or all of them when @deep */
+    GPtrArray *sub = g_ptr_array_new_with_free_func(g_free);
+    g_hash_table_iter_init(&it, d->children);
+    while (g_hash_table_iter_next(&it, &name, &is_dir)) {
+        if (!GPOINTER_TO_INT(is_dir)) continue;
+        gchar *child = child_path(path, name);
+        if (deep || !g_hash_table_contains(dirs, child))
+            g_ptr_array_add(sub, child);
+        else
+            g_free(child);
+    }
+    for (guint i = 0; i < sub->len; i++)
+        scan_dir(g_ptr_array_index(sub, i), deep);
+    g_ptr_array_free(sub, TRUE);
+}
+
+/* Full pass: picks up whatever the watches missed */
+static gboolean reconcile(gpointer data) {
+    (void)data;
+    watch_limit = FALSE;
+    last_walk = g_get_real_time();
+    scan_dir("", TRUE);
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean reconcile_once(gpointer data) {
+    overflow_source = 0;
+    reconcile(data);
+    return G_SOURCE_REMOVE;
+}
+
+/* ── Writing ────────────────────────────────────────────── */
+static gboolean write_index(gpointer data) {
+    (void)data;
+    write_source = 0;
+
+    GArray *items = g_array_new(FALSE, FALSE, sizeof(PathIndexItem));
+    GHashTableIter dit;
+    gpointer key, value;
+    g_hash_table_iter_init(&dit, dirs);
+    while (g_hash_table_iter_next(&dit, &key, &value)) {
+        IdxDir *d = value;
+        GHashTableIter cit;
+        gpointer name, is_dir;
+        g_hash_table_iter_init(&cit, d->children);
+        while (g_hash_table_iter_next(&cit, &name, &is_dir)) {
+            PathIndexItem item = { child_path(d->path, name), GPOINTER_TO_INT(is_dir) };
+            g_array_append_val(items, item);
+        }
+    }
+
+    if (!pathindex_write(index_file, (PathIndexItem *)items->data, items->len, last_walk))
+        g_warning("indexer: cannot write %s: %s", index_file, g_strerror(errno));
+
+    for (guint i = 0; i < items->len; i++)
+        g_free((gchar *)g_array_index(items, PathIndexItem, i).path);
+    g_array_free(items, TRUE);
+    return G_SOURCE_REMOVE;
+}
+
+static void schedule_write(void) {
+    if (write_source) g_source_remove(write_source);
+    write_source = g_timeout_add_seconds(WRITE_DELAY_SEC, write_index, NULL);
+}
+
+/* ── Events ─────────────────────────────────────────────── */
+static int cmp_length(gconstpointer a, gconstpointer b) {
+    gsize x = strlen(*(const char *const *)a), y = strlen(*(const char *const *)b);
+    return (x > y) - (x < y);
+}
+
+/* Parents first, so a folder dropped with its parent is not read again */
+static gboolean rescan_dirty(gpointer data) {
+    (void)data;
+    rescan_source = 0;
+    guint n;
+    gchar **paths = (gchar **)g_hash_table_get_keys_as_array(dirty, &n);
+    qsort(paths, n, sizeof(gchar *), cmp_length);
+    for (guint i = 0; i < n; i++)
+        if (g_hash_table_contains(dirs, paths[i])) scan_dir(paths[i], FALSE);
+    g_free(paths);
+    g_hash_table_remove_all(dirty);
+    return G_SOURCE_REMOVE;
+}
+
+static void mark_dirty(const char *path) {
+    g_hash_table_add(dirty, g_strdup(path));
+    if (rescan_source) g_source_remove(rescan_source);
+    rescan_source = g_timeout_add(RESCAN_DELAY_MSEC, rescan_dirty, NULL);
+}
+
+static gboolean on_inotify(gint fd, GIOCondition cond, gpointer data) {
+    (void)cond; (void)data;
+    char buf[16384] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n <= 0) return G_SOURCE_CONTINUE;
+
+    for (char *p = buf; p < buf + n;) {
+        const struct inotify_event *ev = (const struct inotify_event *)p;
+        p += sizeof(struct inotify_event) + ev->len;
+
+        if (ev->mask & IN_Q_OVERFLOW) {
+            if (!overflow_source) overflow_source = g_idle_add(reconcile_once, NULL);
+            continue;
+        }
+        IdxDir *d = g_hash_table_lookup(dirs_by_wd, GINT_TO_POINTER(ev->wd));
+        if (!d) continue;
+
+        if (ev->mask & IN_IGNORED) {
+            g_hash_table_remove(dirs_by_wd, GINT_TO_POINTER(ev->wd));
+            d->wd = -1;
+        } else if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+            /* The parent's own event drops it; read the parent anyway in
+             * case that event was not for us (moved from outside) */
+            gchar *parent = g_path_get_dirname(d->path);
+            mark_dirty(strcmp(parent, ".") == 0 ? "" : parent);
+            g_free(parent);
+        } else {
+            mark_dirty(d->path);
+        }
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean on_quit_signal(gpointer data) {
+    (void)data;
+    g_main_loop_quit(loop);
+    return G_SOURCE_REMOVE;
+}
+
+/* ── Main ───────────────────────────────────────────────── */
+static gboolean start(gpointer data) {
+    (void)data;
+    reconcile(NULL);
+    /* First index as soon as the walk is done, not after the delay */
+    if (write_source) g_source_remove(write_source);
+    write_index(NULL);
+    return G_SOURCE_REMOVE;
+}
+
+int BLAZENEURO_MAIN(indexer)(int argc, char *argv[]) {
+    (void)argc; (void)argv;
+
+    /* One instance per user */
+    gchar *lock_path = g_build_filename(g_get_user_runtime_dir(), "blazeneuro-indexer.lock", NULL);
+    int lock_fd = open(lock_path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    g_free(lock_path);
+    if (lock_fd < 0 || flock(lock_fd, LOCK_EX | LOCK_NB) != 0) return 0;
+
+    /* Stay out of the way of interactive work */
+    setpriority(PRIO_PROCESS, 0, 19);
+    syscall(SYS_ioprio_set, 1 /* IOPRIO_WHO_PROCESS */, 0, 3 << 13 /* IOPRIO_CLASS_IDLE */);
+
+    home = g_strdup(g_get_home_dir());
+    struct stat st;
+    home_fd = open(home, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (home_fd < 0 || fstat(home_fd, &st) != 0 || inotify_fd < 0) {
+        fprintf(stderr, "blazeneuro-indexer: cannot watch %s: %s\n", home, g_strerror(errno));
+        return 1;
+    }
+    home_dev = st.st_dev;
+    index_file = pathindex_file();
+
+    dirs = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, free_dir);
+    dirs_by_wd = g_hash_table_new(g_direct_hash, g_direct_equal);
+    dirty = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    loop = g_main_loop_new(NULL, FALSE);
+    g_unix_fd_add(inotify_fd, G_IO_IN, on_inotify, NULL);
+    g_unix_signal_add(SIGTERM, on_quit_signal, NULL);
+    g_unix_signal_add(SIGINT, on_quit_signal, NULL);
+    g_idle_add(start, NULL);
+    g_timeout_add_seconds(RECONCILE_SEC, reconcile, NULL);
+    g_main_loop_run(loop);
+
+    /* Flush changes still waiting for their delay */
+    if (write_source) {
+        g_source_remove(write_source);
+        write_index(NULL);
+    }
+
+    g_main_loop_unref(loop);
+    g_hash_table_destroy(dirty);
+    g_hash_table_destroy(dirs_by_wd);
+    g_hash_table_destroy(dirs);
+    close(inotify_fd);
+    close(home_fd);
+    close(lock_fd);
+    g_free(index_file);
+    g_free(home);
+    return 0;
+}
@@ -2,6 +2,8 @@
  * BlazeNeuro Launcher
  * Spotlight-like application launcher overlay.
  * Press Alt+Space to open, type to search, Enter to launch.
+ * Files and folders under $HOME are found through the indexer's path
+ * index when it is running.
  */
 
 #include <gtk/gtk.h>
@@ -10,7 +12,11 @@
 #include <string.h>
 #include <stdlib.h>
 
+#include "../common/applet.h"
+#include "../common/launch.h"
+#include "../common/pathindex.h"
 #include "../common/theme.h"
+#include "../common/zygote.h"
 
 /* ── App Entry ──────────────────────────────────────────── */
 typedef struct {
@@ -24,6 +30,10 @@ static GList *all_apps = NULL;
 static GtkWidget *results_box;
 static GtkWidget *search_entry;
 static int selected_index = -1;
+static PathIndex *path_index;
+
+#define MAX_APP_RESULTS  8
+#define MAX_FILE_RESULTS 5
 
 static void free_app_entry(gpointer data) {
     AppEntry *entry = data;
@@ -91,14 +101,86 @@ static GtkWidget *create_result(AppEntry *entry) {
     return btn;
 }
 
+/* Folder or file found in the path index; @path relative to $HOME */
+static GtkWidget *create_file_result(const char *path, guint base, gboolean is_dir) {
+    GtkWidget *btn = gtk_button_new();
+    gtk_style_context_add_class(gtk_widget_get_style_context(btn), "result-btn");
+
+    GtkWidget *hbox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
+    gtk_container_set_border_width(GTK_CONTAINER(hbox), 4);
+
+    const char *name = path + base;
+    gchar *icon_name;
+    if (is_dir) {
+        icon_name = g_strdup("folder");
+    } else {
+        gchar *type = g_content_type_guess(name, NULL, 0, NULL);
+        icon_name = g_content_type_get_generic_icon_name(type);
+        g_free(type);
+    }
+    GtkWidget *icon = gtk_image_new_from_icon_name(icon_name, GTK_ICON_SIZE_LARGE_TOOLBAR);
+    gtk_image_set_pixel_size(GTK_IMAGE(icon), 32);
+    gtk_box_pack_start(GTK_BOX(hbox), icon, FALSE, FALSE, 0);
+    g_free(icon_name);
+
+    GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+    GtkWidget *label = gtk_label_new(name);
+    gtk_label_set_xalign(GTK_LABEL(label), 0);
+    gtk_box_pack_start(GTK_BOX(vbox), label, FALSE, FALSE, 0);
+
+    gchar *folder = g_strndup(path, base > 0 ? base - 1 : 0);
+    gchar *where = folder[0] ? g_strconcat("~/", folder, NULL) : g_strdup("~");
+    GtkWidget *sub = gtk_label_new(where);
+    gtk_label_set_xalign(GTK_LABEL(sub), 0);
+    gtk_label_set_ellipsize(GTK_LABEL(sub), PANGO_ELLIPSIZE_MIDDLE);
+    gtk_style_context_add_class(gtk_widget_get_style_context(sub), "dim-label");
+    gtk_box_pack_start(GTK_BOX(vbox), sub, FALSE, FALSE, 0);
+    g_free(where);
+    g_free(folder);
+
+    gtk_box_pack_start(GTK_BOX(hbox), vbox, TRUE, TRUE, 0);
+    gtk_container_add(GTK_CONTAINER(btn), hbox);
+
+    g_object_set_data_full(G_OBJECT(btn), "path",
+                           g_build_filename(path_index->home, path, NULL), g_free);
+    g_object_set_data(G_OBJECT(btn), "is-dir", GINT_TO_POINTER(is_dir));
+    return btn;
+}
+
+/* Folders open in Files, forked from the zygote when it is up */
+static void open_path(const char *path, gboolean is_dir) {
+    if (is_dir) {
+        gchar *quoted = g_shell_quote(path);
+        gchar *cmdline = g_strconcat("blazeneuro-files ", quoted, NULL);
+        blazeneuro_launch(cmdline);
+        g_free(cmdline);
+        g_free(quoted);
+        return;
+    }
+    gchar *uri = g_filename_to_uri(path, NULL, NULL);
+    if (uri) g_app_info_launch_default_for_uri(uri, NULL, NULL);
+    g_free(uri);
+}
+
 /* ── Launch Selected App ────────────────────────────────── */
 static void launch_result(GtkWidget *btn, gpointer data) {
     (void)data;
+    const char *path = g_object_get_data(G_OBJECT(btn), "path");
+    if (path) {
+        open_path(path, GPOINTER_TO_INT(g_object_get_data(G_OBJECT(btn), "is-dir")));
+        gtk_main_quit();
+        return;
+    }
+
     const char *app_id = g_object_get_data(G_OBJECT(btn), "app-id");
     if (app_id) {
         GDesktopAppInfo *info = g_desktop_app_info_new(app_id);
         if (info) {
-            g_app_info_launch(G_APP_INFO(info), NULL, NULL, NULL);
+            /* Our own apps fork from the zygote instead of a cold exec */
+            const char *exec = g_app_info_get_executable(G_APP_INFO(info));
+            const char *argv[] = { exec, NULL };
+            if (blazeneuro_zygote_launch(argv) <= 0)
+                g_app_info_launch(G_APP_INFO(info), NULL, NULL, NULL);
             g_object_unref(info);
         }
     }
@@ -119,6 +201,14 @@ static void update_selection(void) {
 }
 
 /* ── Search Filter ──────────────────────────────────────── */
+static gboolean add_file_result(const char *path, guint base, gboolean is_dir, gpointer data) {
+    (void)data;
+    GtkWidget *row = create_file_result(path, base, is_dir);
+    g_signal_connect(row, "clicked", G_CALLBACK(launch_result), NULL);
+    gtk_box_pack_start(GTK_BOX(results_box), row, FALSE, FALSE, 0);
+    return TRUE;
+}
+
 static void on_search_changed(GtkEditable *editable, gpointer data) {
     (void)data;
     const char *query = gtk_entry_get_text(GTK_ENTRY(editable));
@@ -136,7 +226,7 @@ static void on_search_changed(GtkEditable *editable, gpointer data) {
     char *query_lower = g_utf8_strdown(query, -1);
     int count = 0;
 
-    for (GList *l = all_apps; l && count < 8; l = l->next) {
+    for (GList *l = all_apps; l && count < MAX_APP_RESULTS; l = l->next) {
         AppEntry *entry = l->data;
 
         if (strstr(entry->name_lower, query_lower)) {
@@ -148,6 +238,9 @@ static void on_search_changed(GtkEditable *editable, gpointer data) {
     }
     g_free(query_lower);
 
+    if (pathindex_refresh(path_index))
+        count += pathindex_query(path_index, query, NULL, MAX_FILE_RESULTS, add_file_result, NULL);
+
     if (count > 0) selected_index = 0;
     gtk_widget_show_all(results_box);
 }
@@ -194,10 +287,11 @@ static gboolean on_key_press(GtkWidget *widget, GdkEventKey *ev, gpointer data)
 }
 
 /* ── Main ───────────────────────────────────────────────── */
-int main(int argc, char *argv[]) {
+int BLAZENEURO_MAIN(launcher)(int argc, char *argv[]) {
     gtk_init(&argc, &argv);
     blazeneuro_load_theme();
     load_apps();
+    path_index = pathindex_open();
 
     /* Overlay window */
     GtkWidget *win = gtk_window_new(GTK_WINDOW_TOPLEVEL);
@@ -219,7 +313,7 @@ int main(int argc, char *argv[]) {
 
     /* Search entry */
     search_entry = gtk_entry_new();
-    gtk_entry_set_placeholder_text(GTK_ENTRY(search_entry), "  Search applications…");
+    gtk_entry_set_placeholder_text(GTK_ENTRY(search_entry), "  Search applications and files…");
     gtk_style_context_add_class(gtk_widget_get_style_context(search_entry), "search-box");
     g_signal_connect(search_entry, "changed", G_CALLBACK(on_search_changed), NULL);
     gtk_box_pack_start(GTK_BOX(vbox), search_entry, FALSE, FALSE, 0);
@@ -233,6 +327,7 @@ int main(int argc, char *argv[]) {
     gtk_main();
 
     g_list_free_full(all_apps, free_app_entry);
+    pathindex_close(path_index);
 
     return 0;
 }
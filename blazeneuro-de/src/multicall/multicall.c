@@ -0,0 +1,67 @@
+/*
+ * BlazeNeuro Multi-call Binary
+ * Every GTK component of the shell linked into one executable, picking
+ * the component from argv[0] ("blazeneuro-dock" symlink) or from the
+ * first argument ("blazeneuro dock"). All shell processes then map the
+ * same text pages, and the zygote can fork any of them from one image.
+ *
+ * The window manager stays a separate Xlib-only executable: linking it
+ * here would make it load and relocate GTK for nothing.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../common/applet.h"
+
+/* ── Applet Table ───────────────────────────────────────── */
+static const BlazeneuroApplet applets[] = {
+    { "desktop",    blazeneuro_desktop_main },
+    { "dock",       blazeneuro_dock_main },
+    { "topbar",     blazeneuro_topbar_main },
+    { "terminal",   blazeneuro_terminal_main },
+    { "files",      blazeneuro_files_main },
+    { "launcher",   blazeneuro_launcher_main },
+    { "settings",   blazeneuro_settings_main },
+    { "notes",      blazeneuro_notes_main },
+    { "calculator", blazeneuro_calculator_main },
+    { "taskviewer", blazeneuro_taskviewer_main },
+    { "zygote",     blazeneuro_zygote_main },
+    { "indexer",    blazeneuro_indexer_main },
+    { NULL, NULL }
+};
+
+const BlazeneuroApplet *blazeneuro_find_applet(const char *exec) {
+    if (!exec) return NULL;
+    const char *name = strrchr(exec, '/');
+    name = name ? name + 1 : exec;
+    if (strncmp(name, "blazeneuro-", 11) == 0) name += 11;
+
+    for (int i = 0; applets[i].name; i++)
+        if (strcmp(applets[i].name, name) == 0) return &applets[i];
+    return NULL;
+}
+
+/* ── Main ───────────────────────────────────────────────── */
+int main(int argc, char *argv[]) {
+    const BlazeneuroApplet *applet = blazeneuro_find_applet(argv[0]);
+
+    /* "blazeneuro <applet> [args]": run it under its usual name so
+     * prgname and WM_CLASS match the symlinked form */
+    static char name[64];
+    if (!applet && argc > 1 && (applet = blazeneuro_find_applet(argv[1]))) {
+        snprintf(name, sizeof(name), "blazeneuro-%s", applet->name);
+        argv[1] = name;
+        argv++;
+        argc--;
+    }
+
+    if (!applet) {
+        fprintf(stderr, "Usage: blazeneuro <applet> [args...]\n\nApplets:");
+        for (int i = 0; applets[i].name; i++)
+            fprintf(stderr, " %s", applets[i].name);
+        fprintf(stderr, "\n");
+        return 1;
+    }
+    return applet->main(argc, argv);
+}
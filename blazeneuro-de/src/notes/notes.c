@@ -8,9 +8,11 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../common/applet.h"
 #include "../common/theme.h"
 #include "../common/titlebar.h"
 
+static GtkWidget *main_window;
 static GtkWidget *text_view;
 static GtkWidget *word_count_label;
 static char notes_path[512];
@@ -34,6 +36,7 @@ static void save_notes(void) {
 
 static gboolean autosave(gpointer data) {
     (void)data;
+    if (!main_window) return G_SOURCE_REMOVE;
     save_notes();
     return TRUE;
 }
@@ -41,7 +44,6 @@ static gboolean autosave(gpointer data) {
 static void on_destroy(GtkWidget *widget, gpointer data) {
     (void)widget; (void)data;
     save_notes();
-    gtk_main_quit();
 }
 
 static void load_notes(void) {
@@ -91,20 +93,20 @@ static void on_buffer_changed(GtkTextBuffer *buffer, gpointer data) {
     update_word_count(buffer);
 }
 
-/* ── Main ───────────────────────────────────────────────── */
-int main(int argc, char *argv[]) {
-    gtk_init(&argc, &argv);
-    blazeneuro_load_theme();
-
+/* ── Window ─────────────────────────────────────────────── */
+static void build_window(GtkApplication *app) {
     const char *home = g_get_home_dir();
     g_snprintf(notes_path, sizeof(notes_path), "%s/.blazeneuro-notes.txt", home);
 
     GtkWidget *win = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    main_window = win;
+    gtk_window_set_application(GTK_WINDOW(win), app);
     gtk_window_set_title(GTK_WINDOW(win), "Notes");
     gtk_window_set_default_size(GTK_WINDOW(win), 700, 500);
     blazeneuro_style_window(win, "app-notes");
 
     g_signal_connect(win, "destroy", G_CALLBACK(on_destroy), NULL);
+    g_signal_connect(win, "destroy", G_CALLBACK(gtk_widget_destroyed), &main_window);
 
     /* Main content */
     GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
@@ -151,7 +153,28 @@ int main(int argc, char *argv[]) {
     blazeneuro_add_titlebar(win, "Notes", vbox);
 
     gtk_widget_show_all(win);
-    gtk_main();
+}
 
-    return 0;
+/* ── Single Instance ────────────────────────────────────── */
+static void on_startup(GApplication *app, gpointer data) {
+    (void)app; (void)data;
+    blazeneuro_load_theme();
+}
+
+static void on_activate(GApplication *app, gpointer data) {
+    (void)data;
+    if (!main_window) build_window(GTK_APPLICATION(app));
+    gtk_window_present(GTK_WINDOW(main_window));
+}
+
+/* ── Main ───────────────────────────────────────────────── */
+int BLAZENEURO_MAIN(notes)(int argc, char *argv[]) {
+    GtkApplication *app = gtk_application_new("org.blazeneuro.Notes",
+                                              G_APPLICATION_FLAGS_NONE);
+    g_signal_connect(app, "startup", G_CALLBACK(on_startup), NULL);
+    g_signal_connect(app, "activate", G_CALLBACK(on_activate), NULL);
+
+    int status = g_application_run(G_APPLICATION(app), argc, argv);
+    g_object_unref(app);
+    return status;
 }
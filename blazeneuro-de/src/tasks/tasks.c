@@ -12,6 +12,7 @@
 #include <signal.h>
 #include <stdlib.h>
 
+#include "../common/applet.h"
 #include "../common/theme.h"
 #include "../common/titlebar.h"
 
@@ -22,6 +23,7 @@ enum {
     NUM_COLS
 };
 
+static GtkWidget *main_window;
 static GtkListStore *store;
 static GtkWidget *tree;
 static gboolean is_numeric_name(const char *name) {
@@ -73,6 +75,7 @@ static void refresh_processes(void) {
 
 static gboolean on_timer(gpointer data) {
     (void)data;
+    if (!main_window) return G_SOURCE_REMOVE;
     refresh_processes();
     return TRUE;
 }
@@ -99,16 +102,16 @@ static void on_kill(GtkWidget *widget, gpointer data) {
     }
 }
 
-int main(int argc, char *argv[]) {
-    gtk_init(&argc, &argv);
-    blazeneuro_load_theme();
-
+/* ── Window ─────────────────────────────────────────────── */
+static void build_window(GtkApplication *app) {
     GtkWidget *win = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    main_window = win;
+    gtk_window_set_application(GTK_WINDOW(win), app);
     gtk_window_set_title(GTK_WINDOW(win), "Task Viewer");
     gtk_window_set_default_size(GTK_WINDOW(win), 680, 480);
     blazeneuro_style_window(win, "app-tasks");
 
-    g_signal_connect(win, "destroy", G_CALLBACK(gtk_main_quit), NULL);
+    g_signal_connect(win, "destroy", G_CALLBACK(gtk_widget_destroyed), &main_window);
 
     /* Main content */
     GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
@@ -167,7 +170,28 @@ int main(int argc, char *argv[]) {
     blazeneuro_add_titlebar(win, "Task Viewer", vbox);
 
     gtk_widget_show_all(win);
-    gtk_main();
+}
+
+/* ── Single Instance ────────────────────────────────────── */
+static void on_startup(GApplication *app, gpointer data) {
+    (void)app; (void)data;
+    blazeneuro_load_theme();
+}
+
+static void on_activate(GApplication *app, gpointer data) {
+    (void)data;
+    if (!main_window) build_window(GTK_APPLICATION(app));
+    gtk_window_present(GTK_WINDOW(main_window));
+}
+
+/* ── Main ───────────────────────────────────────────────── */
+int BLAZENEURO_MAIN(taskviewer)(int argc, char *argv[]) {
+    GtkApplication *app = gtk_application_new("org.blazeneuro.TaskViewer",
+                                              G_APPLICATION_FLAGS_NONE);
+    g_signal_connect(app, "startup", G_CALLBACK(on_startup), NULL);
+    g_signal_connect(app, "activate", G_CALLBACK(on_activate), NULL);
 
-    return 0;
+    int status = g_application_run(G_APPLICATION(app), argc, argv);
+    g_object_unref(app);
+    return status;
 }
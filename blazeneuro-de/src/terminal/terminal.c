@@ -8,6 +8,7 @@
 #include <vte/vte.h>
 #include <stdlib.h>
 
+#include "../common/applet.h"
 #include "../common/theme.h"
 #include "../common/titlebar.h"
 
@@ -52,7 +53,7 @@ static gboolean on_key_press(GtkWidget *widget, GdkEventKey *ev, gpointer data)
     return FALSE;
 }
 
-int main(int argc, char *argv[]) {
+int BLAZENEURO_MAIN(terminal)(int argc, char *argv[]) {
     gtk_init(&argc, &argv);
     blazeneuro_load_theme();
 
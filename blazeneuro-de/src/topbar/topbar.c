@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "../common/applet.h"
 #include "../common/theme.h"
 
 #define BAR_HEIGHT 32
@@ -145,7 +146,7 @@ static void on_realize(GtkWidget *widget, gpointer data) {
 }
 
 /* ── Main ───────────────────────────────────────────────── */
-int main(int argc, char *argv[]) {
+int BLAZENEURO_MAIN(topbar)(int argc, char *argv[]) {
     gtk_init(&argc, &argv);
     blazeneuro_load_theme();
 
@@ -19,6 +19,8 @@
 #include <signal.h>
 #include <sys/wait.h>
 
+#include "../common/zygote.h"
+
 /* ── Globals ────────────────────────────────────────────── */
 static Display *dpy;
 static Window root;
@@ -32,6 +34,17 @@ static int drag_start_x, drag_start_y;
 static int drag_win_x, drag_win_y;
 static int drag_win_w, drag_win_h;
 static int drag_mode = 0; /* 0=none, 1=move, 2=resize */
+static int drag_edge = 4;  /* _NET_WM_MOVERESIZE_SIZE_* direction for resize */
+static int drag_grabbed = 0; /* pointer grabbed by us for a client request */
+
+/* _NET_WM_MOVERESIZE directions */
+#define MOVERESIZE_SIZE_TOPLEFT      0
+#define MOVERESIZE_SIZE_TOPRIGHT     2
+#define MOVERESIZE_SIZE_BOTTOMRIGHT  4
+#define MOVERESIZE_SIZE_BOTTOMLEFT   6
+#define MOVERESIZE_SIZE_LEFT         7
+#define MOVERESIZE_MOVE              8
+#define MOVERESIZE_CANCEL           11
 
 /* EWMH atoms */
 static Atom net_supported, net_wm_name, net_wm_state;
@@ -46,6 +59,7 @@ static Atom net_close_window, net_wm_state_demands_attention;
 static Atom net_current_desktop, net_number_of_desktops;
 static Atom wm_protocols, wm_delete_window, wm_state;
 static Atom wm_change_state;
+static Atom net_wm_moveresize;
 
 /* Client tracking */
 #define MAX_CLIENTS 256
@@ -84,6 +98,7 @@ static void setup_ewmh(void) {
     net_close_window        = XInternAtom(dpy, "_NET_CLOSE_WINDOW", False);
     net_current_desktop     = XInternAtom(dpy, "_NET_CURRENT_DESKTOP", False);
     net_number_of_desktops  = XInternAtom(dpy, "_NET_NUMBER_OF_DESKTOPS", False);
+    net_wm_moveresize       = XInternAtom(dpy, "_NET_WM_MOVERESIZE", False);
     wm_protocols            = XInternAtom(dpy, "WM_PROTOCOLS", False);
     wm_delete_window        = XInternAtom(dpy, "WM_DELETE_WINDOW", False);
     wm_state                = XInternAtom(dpy, "WM_STATE", False);
@@ -107,7 +122,7 @@ static void setup_ewmh(void) {
         net_wm_state_maximized_vert, net_wm_state_maximized_horz,
         net_wm_window_type, net_active_window, net_client_list,
         net_wm_strut, net_wm_strut_partial, net_close_window,
-        net_current_desktop, net_number_of_desktops
+        net_current_desktop, net_number_of_desktops, net_wm_moveresize
     };
     XChangeProperty(dpy, root, net_supported, XA_ATOM, 32,
                     PropModeReplace, (unsigned char *)supported,
@@ -156,7 +171,10 @@ static void add_client(Window w) {
     }
 }
 
+static void end_drag(void);
+
 static void remove_client(Window w) {
+    if (w == drag_win) end_drag();
     for (int i = 0; i < nclients; i++) {
         if (clients[i].win == w) {
             memmove(&clients[i], &clients[i + 1],
@@ -221,6 +239,16 @@ static int send_delete(Window w) {
     return found;
 }
 
+/* ── Launch: fork from the zygote, exec as a fallback ──── */
+static void spawn_app(const char *cmd) {
+    const char *argv[] = { cmd, NULL };
+    if (blazeneuro_zygote_launch(argv) > 0) return;
+    if (fork() == 0) {
+        execlp(cmd, cmd, NULL);
+        exit(0);
+    }
+}
+
 /* ── Focus ──────────────────────────────────────────────── */
 static void focus_window(Window w) {
     XSetInputFocus(dpy, w, RevertToPointerRoot, CurrentTime);
@@ -459,15 +487,86 @@ static void handle_button_press(XButtonEvent *ev) {
         drag_win_h = wa.height;
 
         drag_mode = (ev->button == 1) ? 1 : 2;
+        drag_edge = MOVERESIZE_SIZE_BOTTOMRIGHT;
     }
 }
 
-static void handle_button_release(XButtonEvent *ev) {
-    (void)ev;
+static void end_drag(void) {
+    if (drag_grabbed) XUngrabPointer(dpy, CurrentTime);
+    drag_grabbed = 0;
     drag_win = None;
     drag_mode = 0;
 }
 
+static void handle_button_release(XButtonEvent *ev) {
+    (void)ev;
+    end_drag();
+}
+
+/* ── _NET_WM_MOVERESIZE ─────────────────────────────────── */
+/* Client-side decorations ask us to run the drag: the WM already holds
+ * the geometry, so each motion is one XMoveResizeWindow with no client
+ * round trips. */
+static void start_moveresize(Window w, int x_root, int y_root, int direction) {
+    if (direction == MOVERESIZE_CANCEL) {
+        if (drag_win == w) end_drag();
+        return;
+    }
+    /* Keyboard-driven variants (9, 10) are not supported */
+    if (direction < 0 || direction > MOVERESIZE_MOVE) return;
+
+    Client *c = find_client(w);
+    if (!c || c->is_fullscreen || drag_win != None) return;
+
+    XWindowAttributes wa;
+    if (!XGetWindowAttributes(dpy, w, &wa)) return;
+
+    static const unsigned int shapes[] = {
+        XC_top_left_corner, XC_top_side, XC_top_right_corner, XC_right_side,
+        XC_bottom_right_corner, XC_bottom_side, XC_bottom_left_corner,
+        XC_left_side, XC_fleur
+    };
+    static Cursor cursors[9];
+    if (!cursors[direction])
+        cursors[direction] = XCreateFontCursor(dpy, shapes[direction]);
+
+    if (XGrabPointer(dpy, root, False, ButtonReleaseMask | PointerMotionMask,
+                     GrabModeAsync, GrabModeAsync, None, cursors[direction],
+                     CurrentTime) != GrabSuccess)
+        return;
+
+    /* The button may have been released before the grab took effect */
+    Window rr, cr;
+    int rx, ry, wx, wy;
+    unsigned int mask;
+    if (!XQueryPointer(dpy, root, &rr, &cr, &rx, &ry, &wx, &wy, &mask) ||
+        !(mask & (Button1Mask | Button2Mask | Button3Mask))) {
+        XUngrabPointer(dpy, CurrentTime);
+        return;
+    }
+
+    /* Dragging a maximized window off its slot un-maximizes it */
+    if (c->is_maximized && direction == MOVERESIZE_MOVE) {
+        c->is_maximized = 0;
+        wa.x = x_root - c->w / 2;
+        wa.width = c->w;
+        wa.height = c->h;
+        XResizeWindow(dpy, w, c->w, c->h);
+    }
+
+    focus_window(w);
+    drag_win = w;
+    drag_grabbed = 1;
+    drag_start_x = x_root;
+    drag_start_y = y_root;
+    drag_win_x = wa.x;
+    drag_win_y = wa.y;
+    drag_win_w = wa.width;
+    drag_win_h = wa.height;
+    drag_mode = (direction == MOVERESIZE_MOVE) ? 1 : 2;
+    drag_edge = direction;
+}
+
 static void handle_motion(XMotionEvent *ev) {
     if (drag_win == None) return;
 
@@ -481,12 +580,23 @@ static void handle_motion(XMotionEvent *ev) {
         /* Move */
         XMoveWindow(dpy, drag_win, drag_win_x + dx, drag_win_y + dy);
     } else if (drag_mode == 2) {
-        /* Resize */
-        int nw = drag_win_w + dx;
-        int nh = drag_win_h + dy;
+        /* Resize from drag_edge; left/top edges also move the origin */
+        int left = drag_edge == MOVERESIZE_SIZE_TOPLEFT ||
+                   drag_edge == MOVERESIZE_SIZE_BOTTOMLEFT ||
+                   drag_edge == MOVERESIZE_SIZE_LEFT;
+        int right = drag_edge >= MOVERESIZE_SIZE_TOPRIGHT &&
+                    drag_edge <= MOVERESIZE_SIZE_BOTTOMRIGHT;
+        int top = drag_edge <= MOVERESIZE_SIZE_TOPRIGHT;
+        int bottom = drag_edge >= MOVERESIZE_SIZE_BOTTOMRIGHT &&
+                     drag_edge <= MOVERESIZE_SIZE_BOTTOMLEFT;
+
+        int nw = drag_win_w + (right ? dx : left ? -dx : 0);
+        int nh = drag_win_h + (bottom ? dy : top ? -dy : 0);
         if (nw < 100) nw = 100;
         if (nh < 60) nh = 60;
-        XResizeWindow(dpy, drag_win, nw, nh);
+        int nx = left ? drag_win_x + drag_win_w - nw : drag_win_x;
+        int ny = top ? drag_win_y + drag_win_h - nh : drag_win_y;
+        XMoveResizeWindow(dpy, drag_win, nx, ny, nw, nh);
     }
 }
 
@@ -528,6 +638,13 @@ static void handle_client_message(XClientMessageEvent *ev) {
         return;
     }
 
+    /* _NET_WM_MOVERESIZE — l[0..1]: pointer root position, l[2]: direction */
+    if (ev->message_type == net_wm_moveresize) {
+        start_moveresize(ev->window, (int)ev->data.l[0], (int)ev->data.l[1],
+                         (int)ev->data.l[2]);
+        return;
+    }
+
     /* WM_CHANGE_STATE — minimize request (e.g., gtk_window_iconify) */
     if (ev->message_type == wm_change_state) {
         if (ev->data.l[0] == 3 /* IconicState */) {
@@ -570,16 +687,10 @@ static void handle_key_press(XKeyEvent *ev) {
             }
         } else if (sym == XK_space) {
             /* Alt+Space: launch app launcher */
-            if (fork() == 0) {
-                execlp("blazeneuro-launcher", "blazeneuro-launcher", NULL);
-                exit(0);
-            }
+            spawn_app("blazeneuro-launcher");
         } else if (sym == XK_Return) {
             /* Alt+Enter: launch terminal */
-            if (fork() == 0) {
-                execlp("blazeneuro-terminal", "blazeneuro-terminal", NULL);
-                exit(0);
-            }
+            spawn_app("blazeneuro-terminal");
         } else if (sym == XK_F11) {
             /* Alt+F11: toggle fullscreen */
             if (focused != None)
@@ -618,10 +729,7 @@ static void handle_key_press(XKeyEvent *ev) {
             toggle_show_desktop();
         } else if (sym == XK_e || sym == XK_E) {
             /* Super+E: open file manager */
-            if (fork() == 0) {
-                execlp("blazeneuro-files", "blazeneuro-files", NULL);
-                exit(0);
-            }
+            spawn_app("blazeneuro-files");
         } else if (sym == XK_l || sym == XK_L) {
             /* Super+L: lock screen */
             if (fork() == 0) {
@@ -0,0 +1,220 @@
+/*
+ * BlazeNeuro Zygote
+ * Pre-initializes GTK and the shared theme once, then forks a child for
+ * every launch request arriving on a Unix socket. The child calls the
+ * requested app's main() directly, so a cold start costs a fork()
+ * instead of exec + dynamic linking + GTK init + CSS parsing.
+ *
+ * Nothing before fork() may open the X display or start threads: each
+ * child opens its own display connection in its gtk_init().
+ *
+ * Usage: blazeneuro-zygote [blazeneuro-<applet>...]
+ * Applets named on the command line are forked as soon as the socket is
+ * up; the session starts the desktop, topbar and dock this way.
+ */
+
+#define _GNU_SOURCE
+
+#include <gtk/gtk.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include "../common/applet.h"
+#include "../common/theme.h"
+#include "../common/zygote.h"
+
+#define MAX_ARGS 64
+
+GtkCssProvider *blazeneuro_zygote_theme = NULL;
+
+/* ── Applet Lookup ──────────────────────────────────────── */
+static const BlazeneuroApplet *find_applet(const char *exec) {
+    return blazeneuro_zygote_applet(exec) ? blazeneuro_find_applet(exec) : NULL;
+}
+
+/* ── Signal Handlers ────────────────────────────────────── */
+static volatile sig_atomic_t running = 1;
+
+static void sigchld_handler(int sig) {
+    (void)sig;
+    int saved_errno = errno;
+    while (waitpid(-1, NULL, WNOHANG) > 0);
+    errno = saved_errno;
+}
+
+static void sigterm_handler(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+/* ── Warm-up (runs once, before any fork) ───────────────── */
+static void prewarm(void) {
+    blazeneuro_zygote_theme = blazeneuro_parse_theme();
+
+    /* Fault the icon theme index and caches into the page cache.
+     * GtkIconTheme instances are per screen, so children build their
+     * own, but they no longer hit the disk to do it. */
+    GtkIconTheme *icons = gtk_icon_theme_new();
+    gtk_icon_theme_set_custom_theme(icons, "Papirus-Dark");
+    static const char *const warm[] = {
+        "folder", "text-x-generic", "utilities-terminal",
+        "system-file-manager", "preferences-system", NULL
+    };
+    for (int i = 0; warm[i]; i++)
+        gtk_icon_theme_has_icon(icons, warm[i]);
+    g_object_unref(icons);
+}
+
+/* ── Child Side ─────────────────────────────────────────── */
+static void run_child(const BlazeneuroApplet *applet, int argc, char *argv[]) {
+    signal(SIGCHLD, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    setsid();
+    if (chdir(g_get_home_dir()) != 0) {
+        /* keep the zygote's working directory */
+    }
+
+    /* prgname and WM_CLASS were fixed when the zygote parsed its own
+     * arguments; give the child the identity of the app it becomes. */
+    gchar *base = g_path_get_basename(argv[0]);
+    g_set_prgname(base);
+    base[0] = g_ascii_toupper(base[0]);
+    gdk_set_program_class(base);
+    g_free(base);
+
+    exit(applet->main(argc, argv));
+}
+
+/* ── Request Handling ───────────────────────────────────── */
+static pid_t fork_applet(int listen_fd, int client_fd, int argc, char *argv[]) {
+    const BlazeneuroApplet *applet = argc > 0 ? find_applet(argv[0]) : NULL;
+    if (!applet) return -1;
+
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(listen_fd);
+        if (client_fd >= 0) close(client_fd);
+        run_child(applet, argc, argv);
+    }
+    return pid;
+}
+
+static void handle_client(int listen_fd, int fd) {
+    struct ucred cred;
+    socklen_t cred_len = sizeof(cred);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) != 0 ||
+        cred.uid != getuid())
+        return;
+
+    struct timeval tv = { 1, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    /* Read until the terminating empty string ("...\0\0") */
+    char buf[BLAZENEURO_ZYGOTE_MAX_REQUEST];
+    size_t len = 0;
+    while (len < 2 || buf[len - 1] != '\0' || buf[len - 2] != '\0') {
+        if (len == sizeof(buf)) return;
+        ssize_t n = recv(fd, buf + len, sizeof(buf) - len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        len += (size_t)n;
+    }
+
+    char *argv[MAX_ARGS + 1];
+    int argc = 0;
+    for (size_t off = 0; off < len && buf[off] && argc < MAX_ARGS;
+         off += strlen(buf + off) + 1)
+        argv[argc++] = buf + off;
+    argv[argc] = NULL;
+
+    pid_t pid = fork_applet(listen_fd, fd, argc, argv);
+    int32_t reply = pid > 0 ? (int32_t)pid : -1;
+    send(fd, &reply, sizeof(reply), MSG_NOSIGNAL);
+}
+
+/* ── Main ───────────────────────────────────────────────── */
+int BLAZENEURO_MAIN(zygote)(int argc, char *argv[]) {
+    if (!gtk_parse_args(&argc, &argv)) {
+        fprintf(stderr, "BlazeNeuro Zygote: GTK initialization failed\n");
+        return 1;
+    }
+    prewarm();
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (blazeneuro_zygote_socket_path(addr.sun_path, sizeof(addr.sun_path)) != 0) {
+        fprintf(stderr, "BlazeNeuro Zygote: socket path too long\n");
+        return 1;
+    }
+
+    /* Refuse to run twice; otherwise clear a stale socket */
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe >= 0 && connect(probe, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+        fprintf(stderr, "BlazeNeuro Zygote: already running\n");
+        close(probe);
+        for (int i = 1; i < argc; i++) {
+            const char *child_argv[] = { argv[i], NULL };
+            blazeneuro_zygote_launch(child_argv);
+        }
+        return 0;
+    }
+    if (probe >= 0) close(probe);
+    unlink(addr.sun_path);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        perror("BlazeNeuro Zygote: socket");
+        return 1;
+    }
+    mode_t old_mask = umask(077);
+    int bound = bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr));
+    umask(old_mask);
+    if (bound != 0 || listen(listen_fd, 16) != 0) {
+        perror("BlazeNeuro Zygote: bind");
+        close(listen_fd);
+        return 1;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = sigchld_handler;
+    sa.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigaction(SIGCHLD, &sa, NULL);
+
+    /* No SA_RESTART: SIGTERM must interrupt accept() */
+    sa.sa_handler = sigterm_handler;
+    sa.sa_flags = 0;
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+
+    printf("BlazeNeuro Zygote ready on %s\n", addr.sun_path);
+    fflush(stdout);
+
+    for (int i = 1; i < argc; i++) {
+        char *child_argv[] = { argv[i], NULL };
+        if (fork_applet(listen_fd, -1, 1, child_argv) < 0)
+            fprintf(stderr, "BlazeNeuro Zygote: cannot start %s\n", argv[i]);
+    }
+
+    while (running) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        handle_client(listen_fd, fd);
+        close(fd);
+    }
+
+    close(listen_fd);
+    unlink(addr.sun_path);
+    return 0;
+}
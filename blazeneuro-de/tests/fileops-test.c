@@ -0,0 +1,184 @@
+/*
+ * fileops.h against a scratch folder: jobs run on the real queue and
+ * copiers, conflicts are answered from the main loop.
+ * Run with `make test`.
+ */
+
+#include <glib/gstdio.h>
+
+#include "../src/files/fileops.h"
+
+static gchar *scratch;
+static GMainLoop *loop;
+static FileOpChoice conflict_choice;
+static guint conflicts;
+
+static void on_conflict(FileOp *op, const char *src, const char *dest, gpointer data) {
+    (void)src; (void)dest; (void)data;
+    conflicts++;
+    fileop_resolve(op, conflict_choice, FALSE);
+}
+
+static void on_done(FileOp *op, const char *error, gpointer data) {
+    (void)op;
+    *(gchar **)data = g_strdup(error);
+    g_main_loop_quit(loop);
+}
+
+static const FileOpCallbacks callbacks = { on_conflict, on_done };
+
+static gchar *run_move(const char *src, const char *dest_dir) {
+    const char *sources[] = { src, NULL };
+    gchar *error = NULL;
+    fileop_move(sources, dest_dir, &callbacks, &error);
+    g_main_loop_run(loop);
+    return error;
+}
+
+static gchar *run_copy(const char *src, const char *dest_dir) {
+    const char *sources[] = { src, NULL };
+    gchar *error = NULL;
+    fileop_copy(sources, dest_dir, &callbacks, &error);
+    g_main_loop_run(loop);
+    return error;
+}
+
+static gchar *path(const char *rel) {
+    return g_build_filename(scratch, rel, NULL);
+}
+
+static void make_file(const char *rel, const char *contents) {
+    gchar *p = path(rel);
+    gchar *dir = g_path_get_dirname(p);
+    g_assert_cmpint(g_mkdir_with_parents(dir, 0755), ==, 0);
+    g_assert_true(g_file_set_contents(p, contents, -1, NULL));
+    g_free(dir);
+    g_free(p);
+}
+
+static void assert_contents(const char *rel, const char *expected) {
+    gchar *p = path(rel), *contents = NULL;
+    g_assert_true(g_file_get_contents(p, &contents, NULL, NULL));
+    g_assert_cmpstr(contents, ==, expected);
+    g_free(contents);
+    g_free(p);
+}
+
+static void assert_missing(const char *rel) {
+    gchar *p = path(rel);
+    g_assert_false(g_file_test(p, G_FILE_TEST_EXISTS));
+    g_free(p);
+}
+
+/* A merge that skips a conflict must leave the skipped file, and the
+ * folders holding it, in the source */
+static void test_move_skip_keeps_source(void) {
+    make_file("from/docs/a.txt", "new a");
+    make_file("from/docs/b.txt", "b");
+    make_file("from/docs/sub/c.txt", "c");
+    make_file("to/docs/a.txt", "old a");
+
+    conflict_choice = FILEOP_SKIP;
+    conflicts = 0;
+    gchar *src = path("from/docs"), *dest = path("to");
+    gchar *error = run_move(src, dest);
+    g_assert_null(error);
+    g_assert_cmpuint(conflicts, ==, 1);
+
+    assert_contents("to/docs/a.txt", "old a");
+    assert_contents("to/docs/b.txt", "b");
+    assert_contents("to/docs/sub/c.txt", "c");
+    assert_contents("from/docs/a.txt", "new a");
+    assert_missing("from/docs/b.txt");
+    assert_missing("from/docs/sub");
+    g_free(src);
+    g_free(dest);
+}
+
+/* Nothing skipped: the whole source goes */
+static void test_move_merge_removes_source(void) {
+    make_file("from2/docs/a.txt", "a");
+    make_file("to2/docs/b.txt", "b");
+
+    gchar *src = path("from2/docs"), *dest = path("to2");
+    gchar *error = run_move(src, dest);
+    g_assert_null(error);
+    assert_contents("to2/docs/a.txt", "a");
+    assert_contents("to2/docs/b.txt", "b");
+    assert_missing("from2/docs");
+    g_free(src);
+    g_free(dest);
+}
+
+/* ~/foo/foo moved into ~: replacing the folder ~/foo would delete the
+ * file being moved, so the job refuses and the source stays */
+static void test_move_into_own_parent_name(void) {
+    make_file("self/foo/foo", "inner");
+
+    conflict_choice = FILEOP_REPLACE;
+    conflicts = 0;
+    gchar *src = path("self/foo/foo"), *dest = path("self");
+    gchar *error = run_move(src, dest);
+    g_assert_nonnull(error);
+    g_assert_nonnull(strstr(error, "the source is inside the destination"));
+    g_assert_cmpuint(conflicts, ==, 0);
+    assert_contents("self/foo/foo", "inner");
+    g_free(error);
+    g_free(src);
+    g_free(dest);
+}
+
+static void assert_mode(const char *rel, mode_t mode) {
+    gchar *p = path(rel);
+    struct stat st;
+    g_assert_cmpint(lstat(p, &st), ==, 0);
+    g_assert_cmpint(st.st_mode & 07777, ==, mode);
+    g_free(p);
+}
+
+/* Read-only folders get their mode only once their files are in */
+static void test_copy_read_only_tree(void) {
+    make_file("ro/top/f1", "1");
+    make_file("ro/top/inner/f2", "2");
+    gchar *inner = path("ro/top/inner"), *top = path("ro/top");
+    g_assert_cmpint(chmod(inner, 0555), ==, 0);
+    g_assert_cmpint(chmod(top, 0555), ==, 0);
+    make_file("ro-copy/.keep", "");
+
+    gchar *dest = path("ro-copy");
+    gchar *error = run_copy(top, dest);
+    g_assert_null(error);
+    assert_contents("ro-copy/top/f1", "1");
+    assert_contents("ro-copy/top/inner/f2", "2");
+    assert_mode("ro-copy/top", 0555);
+    assert_mode("ro-copy/top/inner", 0555);
+    g_free(inner);
+    g_free(top);
+    g_free(dest);
+}
+
+static gboolean remove_scratch(const char *dir) {
+    gchar *argv[] = { "chmod", "-R", "u+w", (gchar *)dir, NULL };
+    g_spawn_sync(NULL, argv, NULL, G_SPAWN_SEARCH_PATH, NULL, NULL, NULL, NULL, NULL, NULL);
+    gchar *rm[] = { "rm", "-rf", (gchar *)dir, NULL };
+    return g_spawn_sync(NULL, rm, NULL, G_SPAWN_SEARCH_PATH, NULL, NULL, NULL, NULL, NULL, NULL);
+}
+
+int main(int argc, char **argv) {
+    g_test_init(&argc, &argv, NULL);
+    fileops_init();
+    loop = g_main_loop_new(NULL, FALSE);
+    scratch = g_dir_make_tmp("fileops-test-XXXXXX", NULL);
+    g_assert_nonnull(scratch);
+
+    g_test_add_func("/fileops/move/skip-keeps-source", test_move_skip_keeps_source);
+    g_test_add_func("/fileops/move/merge-removes-source", test_move_merge_removes_source);
+    g_test_add_func("/fileops/move/into-own-parent-name", test_move_into_own_parent_name);
+    g_test_add_func("/fileops/copy/read-only-tree", test_copy_read_only_tree);
+    int status = g_test_run();
+
+    remove_scratch(scratch);
+    g_free(scratch);
+    g_main_loop_unref(loop);
+    return status;
+}
@@ -0,0 +1,105 @@
+/*
+ * The Files selection helpers against a real icon view: what is picked
+ * is what the menus act on, and it survives the model resyncs that
+ * re-sorts and large flushes go through.
+ * Needs a display; run with `xvfb-run make test` where there is none.
+ */
+
+/* files.c's main becomes blazeneuro_files_main, so the test has its own */
+#define BLAZENEURO_APPLET
+#include "../src/files/files.c"
+
+static const char *const test_names[] = { "alpha", "bravo", "charlie" };
+static gboolean have_display;
+
+static gboolean test_setup(void) {
+    if (!have_display) {
+        g_test_skip("no display");
+        return FALSE;
+    }
+    if (!saved_selection) saved_selection = g_array_new(FALSE, FALSE, sizeof(guint));
+    g_clear_object(&file_model);
+    file_model = files_model_new(on_model_resync, NULL);
+
+    FilesListing *listing = files_listing_new("/test");
+    DirEntry entries[G_N_ELEMENTS(test_names)];
+    memset(entries, 0, sizeof(entries));
+    for (guint i = 0; i < G_N_ELEMENTS(test_names); i++) {
+        entries[i].name = (gchar *)test_names[i];
+        entries[i].icon = "text-x-generic";
+        entries[i].kind = FT_KIND_TEXT;
+        entries[i].type_known = TRUE;
+    }
+    files_listing_append(listing, entries, G_N_ELEMENTS(entries));
+    listing->complete = TRUE;
+
+    details_view = FALSE;
+    icon_view = gtk_icon_view_new_with_model(NULL);
+    gtk_icon_view_set_selection_mode(GTK_ICON_VIEW(icon_view), GTK_SELECTION_MULTIPLE);
+    g_object_ref_sink(icon_view);
+    files_model_set_listing(file_model, listing);
+    files_listing_unref(listing);
+    return TRUE;
+}
+
+static void test_teardown(void) {
+    g_clear_object(&icon_view);
+    g_clear_object(&file_model);
+}
+
+static void select_row(gint row) {
+    GtkTreePath *path = gtk_tree_path_new_from_indices(row, -1);
+    view_select_path(path);
+    gtk_tree_path_free(path);
+}
+
+static void test_icon_view_selected(void) {
+    if (!test_setup()) return;
+    g_assert_null(view_get_selected());
+    g_assert_null(get_selected_path());
+
+    select_row(1);
+    GList *selected = view_get_selected();
+    g_assert_cmpuint(g_list_length(selected), ==, 1);
+    g_assert_cmpint(gtk_tree_path_get_indices(selected->data)[0], ==, 1);
+    g_list_free_full(selected, (GDestroyNotify)gtk_tree_path_free);
+
+    gchar *path = get_selected_path();
+    g_assert_cmpstr(path, ==, "/test/bravo");
+    g_free(path);
+    g_assert_false(get_selected_is_dir());
+
+    select_row(2);
+    gchar **paths = get_selected_paths();
+    g_assert_cmpuint(g_strv_length(paths), ==, 2);
+    g_assert_cmpstr(paths[0], ==, "/test/bravo");
+    g_assert_cmpstr(paths[1], ==, "/test/charlie");
+    g_strfreev(paths);
+    test_teardown();
+}
+
+/* A re-sort detaches the view and puts the selection back by record */
+static void test_icon_view_resync_keeps_selection(void) {
+    if (!test_setup()) return;
+    select_row(0);
+    files_model_set_sort(file_model, FILES_SORT_NAME, TRUE);
+
+    g_assert(gtk_icon_view_get_model(GTK_ICON_VIEW(icon_view)) == GTK_TREE_MODEL(file_model));
+    gchar *path = get_selected_path();
+    g_assert_cmpstr(path, ==, "/test/alpha");
+    g_free(path);
+    GList *selected = view_get_selected();
+    g_assert_cmpuint(g_list_length(selected), ==, 1);
+    g_assert_cmpint(gtk_tree_path_get_indices(selected->data)[0], ==, 2);
+    g_list_free_full(selected, (GDestroyNotify)gtk_tree_path_free);
+    test_teardown();
+}
+
+int main(int argc, char **argv) {
+    g_test_init(&argc, &argv, NULL);
+    have_display = gtk_init_check(&argc, &argv);
+
+    g_test_add_func("/files/icon-view/selected", test_icon_view_selected);
+    g_test_add_func("/files/icon-view/resync-keeps-selection", test_icon_view_resync_keeps_selection);
+    return g_test_run();
+}
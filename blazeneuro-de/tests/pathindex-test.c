@@ -0,0 +1,100 @@
+/*
+ * pathindex.h round trip: an index written with pathindex_write() to a
+ * scratch cache folder, then queried as Files and the Launcher do.
+ * Names must match as the Files walker matches them (walker.h).
+ * Run with `make test`.
+ */
+
+#include <glib/gstdio.h>
+
+#include "../src/common/pathindex.h"
+
+static gchar *scratch;
+static PathIndex *idx;
+
+static const PathIndexItem items[] = {
+    { "Documents", TRUE },
+    { "Documents/Über Plan.txt", FALSE },
+    { "Documents/notes", TRUE },
+    { "Documents/notes/AB test.md", FALSE },
+    { "Documents/report.pdf", FALSE },
+    { "Music", TRUE },
+    { "Music/ab.ogg", FALSE },
+    { "Music/über.mp3", FALSE },
+    { "straße.txt", FALSE },
+};
+
+static gboolean collect(const char *path, guint base, gboolean is_dir, gpointer data) {
+    (void)base; (void)is_dir;
+    GString *out = data;
+    if (out->len) g_string_append_c(out, '|');
+    g_string_append(out, path);
+    return TRUE;
+}
+
+/* Matches of @query below @within, '|'-separated in path order */
+static gchar *query(const char *q, const char *within) {
+    GString *out = g_string_new(NULL);
+    guint n = pathindex_query(idx, q, within, 50, collect, out);
+    guint expected = 0;
+    for (const char *p = out->str; *p; p++) expected += *p == '|';
+    if (out->len) expected++;
+    g_assert_cmpuint(n, ==, expected);
+    return g_string_free(out, FALSE);
+}
+
+static void assert_query(const char *q, const char *within, const char *expected) {
+    gchar *got = query(q, within);
+    g_assert_cmpstr(got, ==, expected);
+    g_free(got);
+}
+
+/* A non-ASCII query goes through the trigrams of casefolded names */
+static void test_query_casefold(void) {
+    assert_query("Über", NULL, "Documents/Über Plan.txt|Music/über.mp3");
+    assert_query("ÜBER", NULL, "Documents/Über Plan.txt|Music/über.mp3");
+    assert_query("REPORT", NULL, "Documents/report.pdf");
+}
+
+/* Under three bytes the names are scanned; an ASCII query ignores ASCII
+ * case only, so "ss" does not find "ß" (nor does the walker) */
+static void test_query_short(void) {
+    assert_query("ab", NULL, "Documents/notes/AB test.md|Music/ab.ogg");
+    assert_query("ss", NULL, "");
+}
+
+static void test_query_within(void) {
+    assert_query("ab", "Music", "Music/ab.ogg");
+    assert_query("über", "Documents", "Documents/Über Plan.txt");
+    assert_query("notes", "Documents", "Documents/notes");
+    assert_query("report", "Music", "");
+}
+
+int main(int argc, char **argv) {
+    g_test_init(&argc, &argv, NULL);
+    scratch = g_dir_make_tmp("pathindex-test-XXXXXX", NULL);
+    g_assert_nonnull(scratch);
+    g_setenv("XDG_CACHE_HOME", scratch, TRUE);
+
+    PathIndexItem copy[G_N_ELEMENTS(items)];
+    memcpy(copy, items, sizeof(items));
+    gchar *file = pathindex_file();
+    g_assert_true(pathindex_write(file, copy, G_N_ELEMENTS(copy), 0));
+    idx = pathindex_open();
+    g_assert_true(pathindex_refresh(idx));
+
+    g_test_add_func("/pathindex/query/casefold", test_query_casefold);
+    g_test_add_func("/pathindex/query/short", test_query_short);
+    g_test_add_func("/pathindex/query/within", test_query_within);
+    int status = g_test_run();
+
+    pathindex_close(idx);
+    g_unlink(file);
+    g_free(file);
+    gchar *dir = g_build_filename(scratch, "blazeneuro", NULL);
+    g_rmdir(dir);
+    g_free(dir);
+    g_rmdir(scratch);
+    g_free(scratch);
+    return status;
+}
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Generate src/files/filetype-table.h: a collision-free (perfect) hash
+table mapping lowercase file extensions to a FileKind.
+
+    tools/gen-filetype.py > src/files/filetype-table.h
+
+Hash-and-displace: the first hash picks a bucket, the bucket's
+displacement seeds the second hash, which picks a unique slot. Both are
+32-bit FNV-1a with different seeds and must match filetype_lookup() in
+src/files/filetype.h.
+"""
+
+KINDS = {
+    "FT_KIND_IMAGE": "png jpg jpeg jpe gif bmp webp svg svgz tif tiff ico heic heif avif xcf psd",
+    "FT_KIND_AUDIO": "mp3 wav flac ogg oga opus m4a aac wma aiff mid midi",
+    "FT_KIND_VIDEO": "mp4 m4v mkv webm avi mov wmv flv mpg mpeg ogv 3gp",
+    "FT_KIND_PDF": "pdf",
+    "FT_KIND_DOCUMENT": "doc docx odt rtf epub djvu",
+    "FT_KIND_SPREADSHEET": "xls xlsx ods csv tsv",
+    "FT_KIND_PRESENTATION": "ppt pptx odp key",
+    "FT_KIND_TEXT": "txt md markdown rst log ini conf cfg nfo",
+    "FT_KIND_CODE": ("c h cc cpp cxx hpp hh py pyw js mjs ts tsx jsx sh bash zsh fish rs go java "
+                     "kt rb pl pm lua php cs swift json xml yaml yml toml html htm css scss "
+                     "sql mk cmake vala patch diff"),
+    "FT_KIND_ARCHIVE": "zip tar gz tgz bz2 tbz2 xz txz zst lz4 lzma 7z rar cpio",
+    "FT_KIND_PACKAGE": "deb rpm flatpak snap",
+    "FT_KIND_DISK_IMAGE": "iso img qcow2 vdi vmdk",
+    "FT_KIND_EXECUTABLE": "appimage run bin exe",
+    "FT_KIND_FONT": "ttf otf woff woff2 pcf",
+}
+
+
+BUCKET_SEED = 2166136261  # the standard FNV offset basis
+
+
+def fnv1a(s, seed):
+    h = seed
+    for c in s.encode():
+        h = ((h ^ c) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def main():
+    table = {}
+    for kind, exts in KINDS.items():
+        for ext in exts.split():
+            assert ext not in table, ext
+            table[ext] = kind
+
+    size = 1
+    while size * 3 < len(table) * 4:     # load factor <= 0.75
+        size *= 2
+    nbuckets = size // 4
+
+    buckets = [[] for _ in range(nbuckets)]
+    for ext in table:
+        buckets[fnv1a(ext, BUCKET_SEED) % nbuckets].append(ext)
+
+    slots = {}
+    disp = [0] * nbuckets
+    for b in sorted(range(nbuckets), key=lambda b: -len(buckets[b])):
+        if not buckets[b]:
+            continue
+        for d in range(1, 1 << 24):
+            idx = [fnv1a(ext, d) & (size - 1) for ext in buckets[b]]
+            if len(set(idx)) == len(idx) and not any(i in slots for i in idx):
+                break
+        else:
+            raise SystemExit("no displacement found; grow the table")
+        disp[b] = d
+        for ext, i in zip(buckets[b], idx):
+            slots[i] = ext
+
+    longest = max(len(e) for e in table)
+    print("/* Generated by tools/gen-filetype.py — do not edit. */")
+    print()
+    print("#define FILETYPE_BUCKET_SEED %uu" % BUCKET_SEED)
+    print("#define FILETYPE_BUCKETS     %d" % nbuckets)
+    print("#define FILETYPE_TABLE_SIZE  %d" % size)
+    print("#define FILETYPE_MAX_EXT     %d" % longest)
+    print()
+    print("static const guint32 filetype_disp[FILETYPE_BUCKETS] = {")
+    for i in range(0, nbuckets, 8):
+        print("    " + " ".join("%u," % d for d in disp[i:i + 8]))
+    print("};")
+    print()
+    print("static const struct { const char *ext; FileKind kind; } filetype_table[FILETYPE_TABLE_SIZE] = {")
+    for i in range(size):
+        if i in slots:
+            ext = slots[i]
+            print('    [%d] = { "%s", %s },' % (i, ext, table[ext]))
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
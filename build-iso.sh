@@ -193,6 +193,8 @@ apt-get install -y \
     libgtk-3-dev \
     libvte-2.91-dev \
     libx11-dev \
+    libarchive-dev \
+    libxxhash-dev \
     pkg-config \
     adwaita-icon-theme \
     papirus-icon-theme \